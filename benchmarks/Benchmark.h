@@ -0,0 +1,25 @@
+#ifndef _BENCHMARK_H_
+#define _BENCHMARK_H_
+
+#include <chrono>
+
+// returns the seconds of one call. the function is called once to warm the caches up
+// and then until `a_minSeconds` have passed, so a short call is averaged over many runs
+template <typename Function>
+double MeasureSeconds(Function a_function, const double a_minSeconds = 0.2)
+{
+	a_function();
+
+	const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	unsigned int runCount = 0;
+	double elapsedSeconds = 0.0;
+	do {
+		a_function();
+		runCount++;
+		elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	} while (elapsedSeconds < a_minSeconds);
+
+	return elapsedSeconds / runCount;
+}
+
+#endif //_BENCHMARK_H_
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "Benchmark.h"
+#include "Direct2D.h"
+#include <cstdio>
+
+namespace
+{
+	const unsigned int ROW_COUNT = 100000;
+	const float ROW_HEIGHT = 20.0f;
+	const int VIEW_WIDTH = 1024;
+	const int VIEW_HEIGHT = 768;
+	const DRect LIST_RECT = { 0.0f, 40.0f, 1024.0f, 768.0f };
+
+	// a row is a background, a check box and a separator
+	void DrawRow(Direct2D &a_direct2D, const unsigned int a_row)
+	{
+		const float top = a_row * ROW_HEIGHT;
+		a_direct2D.SetBrushColor(a_row % 2 ? DColor({ 0.16f, 0.16f, 0.18f, 1.0f }) : DColor({ 0.2f, 0.2f, 0.22f, 1.0f }));
+		a_direct2D.FillRectangle(DRect({ 0.0f, top, LIST_RECT.right, top + ROW_HEIGHT }));
+		a_direct2D.SetBrushColor({ 0.8f, 0.8f, 0.8f, 1.0f });
+		a_direct2D.DrawRectangle(DRect({ 6.0f, top + 4.0f, 18.0f, top + 16.0f }));
+		a_direct2D.DrawLine(DPoint({ 0.0f, top + ROW_HEIGHT - 0.5f }), DPoint({ LIST_RECT.right, top + ROW_HEIGHT - 0.5f }));
+	}
+
+	// the list is scrolled to its middle row and clipped below its header
+	void DrawList(Direct2D &a_direct2D, const unsigned int a_firstRow, const unsigned int a_lastRow)
+	{
+		const float scrollOffset = (ROW_COUNT / 2) * ROW_HEIGHT;
+		a_direct2D.BeginDraw();
+		a_direct2D.PushClipRect(LIST_RECT);
+		a_direct2D.SetMatrixTransform(D2D1::Matrix3x2F::Translation(0.0f, LIST_RECT.top - scrollOffset));
+		for (unsigned int row = a_firstRow; row < a_lastRow; row++) {
+			DrawRow(a_direct2D, row);
+		}
+		a_direct2D.SetMatrixTransform(D2D1::Matrix3x2F::Identity());
+		a_direct2D.PopClipRect();
+		a_direct2D.EndDraw();
+	}
+}
+
+// draws a list of 100k rows which is scrolled to its middle. every row is drawn and the rows outside the clip
+// are culled, compared with drawing only the visible rows like a virtualized list does
+int main()
+{
+	ApplicationCore appCore(::GetModuleHandle(nullptr));
+	if (S_OK != appCore.Create()) {
+		printf("the Direct2D factory can't be created\n");
+		return 1;
+	}
+
+	const HWND h_window = ::CreateWindowEx(
+		0, L"STATIC", L"CullingBenchmark", WS_POPUP, 0, 0, VIEW_WIDTH, VIEW_HEIGHT, nullptr, nullptr, ::GetModuleHandle(nullptr), nullptr
+	);
+	Direct2D direct2D(h_window);
+	if (S_OK != direct2D.Create()) {
+		printf("the render target can't be created\n");
+		return 1;
+	}
+
+	const unsigned int firstVisibleRow = ROW_COUNT / 2;
+	const unsigned int lastVisibleRow = firstVisibleRow + static_cast<unsigned int>((LIST_RECT.bottom - LIST_RECT.top) / ROW_HEIGHT) + 1;
+
+	const double culledSeconds = MeasureSeconds([&]() {
+		DrawList(direct2D, 0, ROW_COUNT);
+	});
+	const DRAW_STATISTICS culledStatistics = direct2D.GetDrawStatistics();
+	const double visibleSeconds = MeasureSeconds([&]() {
+		DrawList(direct2D, firstVisibleRow, lastVisibleRow);
+	});
+	const DRAW_STATISTICS visibleStatistics = direct2D.GetDrawStatistics();
+
+	printf("%16s %12s %12s %12s\n", "rows", "frame (ms)", "submitted", "culled");
+	printf("%16u %12.3f %12u %12u\n", ROW_COUNT, culledSeconds * 1000.0, culledStatistics.submittedCount, culledStatistics.culledCount);
+	printf(
+		"%16u %12.3f %12u %12u\n", lastVisibleRow - firstVisibleRow, visibleSeconds * 1000.0,
+		visibleStatistics.submittedCount, visibleStatistics.culledCount
+	);
+
+	::DestroyWindow(h_window);
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "Benchmark.h"
+#include "Direct2D.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// compares a `SetBrushColor` and `FillRectangle` call per instance with one `FillRectangles` call.
+// the instances have one of 16 colors in a random order, like the points of a scatter plot
+int main()
+{
+	const unsigned int COLOR_COUNT = 16;
+	const int VIEW_SIZE = 1024;
+
+	ApplicationCore appCore(::GetModuleHandle(nullptr));
+	if (S_OK != appCore.Create()) {
+		printf("the Direct2D factory can't be created\n");
+		return 1;
+	}
+
+	const HWND h_window = ::CreateWindowEx(
+		0, L"STATIC", L"DrawBatchBenchmark", WS_POPUP, 0, 0, VIEW_SIZE, VIEW_SIZE, nullptr, nullptr, ::GetModuleHandle(nullptr), nullptr
+	);
+	Direct2D direct2D(h_window);
+	if (S_OK != direct2D.Create()) {
+		printf("the render target can't be created\n");
+		return 1;
+	}
+
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> position(0.0f, static_cast<float>(VIEW_SIZE - 4));
+	DColor palette[COLOR_COUNT];
+	for (unsigned int i = 0; i < COLOR_COUNT; i++) {
+		palette[i] = { (i % 4) / 3.0f, (i / 4) / 3.0f, 0.5f, 1.0f };
+	}
+
+	printf("%10s %14s %14s %8s\n", "instances", "per call (ms)", "batch (ms)", "speedup");
+	for (const unsigned int count : { 1000u, 10000u, 100000u }) {
+		std::vector<DRect> rects(count);
+		std::vector<DColor> colors(count);
+		for (unsigned int i = 0; i < count; i++) {
+			const float left = position(random);
+			const float top = position(random);
+			rects[i] = { left, top, left + 3.0f, top + 3.0f };
+			colors[i] = palette[random() % COLOR_COUNT];
+		}
+
+		const double perCallSeconds = MeasureSeconds([&]() {
+			direct2D.BeginDraw();
+			for (unsigned int i = 0; i < count; i++) {
+				direct2D.SetBrushColor(colors[i]);
+				direct2D.FillRectangle(rects[i]);
+			}
+			direct2D.EndDraw();
+		});
+		const double batchSeconds = MeasureSeconds([&]() {
+			direct2D.BeginDraw();
+			direct2D.FillRectangles(rects.data(), colors.data(), count);
+			direct2D.EndDraw();
+		});
+
+		printf("%10u %14.3f %14.3f %7.2fx\n", count, perCallSeconds * 1000.0, batchSeconds * 1000.0, perCallSeconds / batchSeconds);
+	}
+
+	::DestroyWindow(h_window);
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "Benchmark.h"
+#include "GlyphAtlas.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+	// rasterizes every glyph as a block of the size of a glyph of 12 to 24 pixels
+	class BlockRasterizer : public GlyphRasterizer
+	{
+	public:
+		bool RasterizeGlyph(
+			const void *const ap_fontFace, const unsigned short a_glyphIndex, const float a_size,
+			const float a_offsetX, GLYPH_BITMAP &a_bitmap
+		) override
+		{
+			a_bitmap.width = 4 + a_glyphIndex % 13 + static_cast<int>(a_size) / 2;
+			a_bitmap.height = 6 + a_glyphIndex % 7 + static_cast<int>(a_size) / 2;
+			a_bitmap.advance = static_cast<float>(a_bitmap.width);
+			a_bitmap.alpha.assign(static_cast<size_t>(a_bitmap.width) * a_bitmap.height, 0x80);
+			return true;
+		}
+	};
+}
+
+// measures the packing of glyph-sized rectangles and the lookups of the atlas when every glyph is cached,
+// when the glyphs are rasterized and packed, and when the atlas is evicted again and again
+int main()
+{
+	std::mt19937 random(3);
+	std::vector<int> sizes(4096);
+	for (int &size : sizes) {
+		size = 6 + static_cast<int>(random() % 24);
+	}
+
+	unsigned int packedCount = 0;
+	float occupancy = 0.0f;
+	SkylinePacker packer(1024, 1024);
+	const double packSeconds = MeasureSeconds([&]() {
+		packer.Reset();
+		packedCount = 0;
+		for (size_t i = 0; i < sizes.size(); i++) {
+			int x = 0;
+			int y = 0;
+			if (packer.Insert(sizes[i], sizes[(i + 1) % sizes.size()], x, y)) {
+				packedCount++;
+			}
+		}
+		occupancy = packer.GetOccupancy();
+	});
+	printf("skyline packer: %u rects in %.3f ms, %.1f M inserts/s, occupancy %.2f\n",
+		packedCount, packSeconds * 1000.0, sizes.size() / packSeconds / 1e6, occupancy);
+
+	BlockRasterizer rasterizer;
+	const int fontFace = 0;
+	const unsigned int GLYPH_COUNT = 2048;
+	std::vector<unsigned short> glyphIndices(GLYPH_COUNT);
+	std::vector<float> penPositions(GLYPH_COUNT);
+	for (unsigned int i = 0; i < GLYPH_COUNT; i++) {
+		// the characters of a text repeat, most of them are found in the atlas
+		glyphIndices[i] = static_cast<unsigned short>(random() % 96);
+		penPositions[i] = static_cast<float>(random() % 4096) * 0.25f;
+	}
+
+	GlyphAtlas atlas(&rasterizer, 1024, 1024, 4);
+	ATLAS_GLYPH glyph;
+	const double hitSeconds = MeasureSeconds([&]() {
+		for (unsigned int i = 0; i < GLYPH_COUNT; i++) {
+			atlas.Get(&fontFace, glyphIndices[i], 14.0f, penPositions[i], glyph);
+		}
+	});
+	printf("cached glyphs: %.1f M lookups/s\n", GLYPH_COUNT / hitSeconds / 1e6);
+
+	// every run uses a new size, so the first lookup of each glyph rasterizes and packs it and a full atlas starts over
+	float size = 12.0f;
+	const double missSeconds = MeasureSeconds([&]() {
+		for (unsigned int i = 0; i < GLYPH_COUNT; i++) {
+			atlas.Get(&fontFace, glyphIndices[i], size, penPositions[i], glyph);
+		}
+		size += 0.01f;
+	});
+	const ATLAS_STATISTICS statistics = atlas.GetStatistics();
+	printf("new sizes: %.2f M lookups/s, %u evictions\n", GLYPH_COUNT / missSeconds / 1e6, statistics.evictionCount);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "Benchmark.h"
+#include "ImageResampler.h"
+#include "TaskScheduler.h"
+#include <cstdio>
+#include <random>
+
+// scales a 4K image to a 256 pixels wide thumbnail with every filter and kernel, on the calling thread and in bands
+// on the workers. a kernel which the processor lacks is skipped
+int main()
+{
+	const char *const FILTER_NAMES[] = { "box", "bilinear", "lanczos3" };
+	const char *const KERNEL_NAMES[] = { "scalar", "sse2", "avx2" };
+
+	std::mt19937 random(5);
+	IMAGE_PIXELS source = {};
+	source.width = 3840;
+	source.height = 2160;
+	source.pixels.resize(static_cast<size_t>(source.width) * source.height * 4);
+	for (size_t i = 0; i < source.pixels.size(); i += 4) {
+		const unsigned int alpha = 0 == random() % 4 ? 255 : random() % 256;
+		for (size_t channel = 0; channel < 3; channel++) {
+			source.pixels[i + channel] = static_cast<unsigned char>(random() % (alpha + 1));
+		}
+		source.pixels[i + 3] = static_cast<unsigned char>(alpha);
+	}
+
+	TaskScheduler scheduler;
+	const double sourceMegapixels = source.width * source.height / 1e6;
+	printf("3840x2160 -> 256x144, %u workers\n", scheduler.GetThreadCount());
+	printf("%10s %8s %12s %14s %14s %8s\n", "filter", "kernel", "serial (ms)", "Mpixels/s", "bands (ms)", "speedup");
+	for (const RESAMPLE_FILTER filter : { RESAMPLE_BOX, RESAMPLE_BILINEAR, RESAMPLE_LANCZOS3 }) {
+		double scalarSeconds = 0.0;
+		for (const RESAMPLE_KERNEL kernel : { RESAMPLE_KERNEL_SCALAR, RESAMPLE_KERNEL_SSE2, RESAMPLE_KERNEL_AVX2 }) {
+			if (kernel > ImageResampler::GetSupportedKernel()) {
+				continue;
+			}
+
+			ImageResampler resampler(filter);
+			resampler.SetKernel(kernel);
+			IMAGE_PIXELS image;
+			const double serialSeconds = MeasureSeconds([&]() {
+				resampler.Resample(source, 256, 144, image);
+			});
+			const double bandSeconds = MeasureSeconds([&]() {
+				resampler.Resample(source, 256, 144, image, &scheduler);
+			});
+			if (RESAMPLE_KERNEL_SCALAR == kernel) {
+				scalarSeconds = serialSeconds;
+			}
+
+			printf(
+				"%10s %8s %12.2f %14.1f %14.2f %7.2fx\n", FILTER_NAMES[filter], KERNEL_NAMES[kernel], serialSeconds * 1000.0,
+				sourceMegapixels / serialSeconds, bandSeconds * 1000.0, scalarSeconds / serialSeconds
+			);
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
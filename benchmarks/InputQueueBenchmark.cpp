@@ -0,0 +1,67 @@
+#include "Benchmark.h"
+#include "InputQueue.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// queues the input of a mouse which reports at 1000 to 8000 Hz and takes one batch per frame of a 144 Hz display.
+// the moves carry the raw points of the history, a wheel and a button come now and then
+int main()
+{
+	const unsigned long long FRAME_TIME = 1000000 / 144;
+	const unsigned int FRAME_COUNT = 1024;
+
+	printf("%10s %16s %16s %18s\n", "rate (Hz)", "raw per frame", "batch per frame", "push (ns)");
+	for (const unsigned int rate : { 1000u, 4000u, 8000u }) {
+		std::mt19937 random(rate);
+		const unsigned int rawPerFrame = static_cast<unsigned int>(rate * FRAME_TIME / 1000000);
+
+		std::vector<INPUT_EVENT> events(static_cast<size_t>(rawPerFrame) * FRAME_COUNT);
+		unsigned long long time = 0;
+		float x = 100.0f;
+		for (INPUT_EVENT &event : events) {
+			event = {};
+			time += 1000000 / rate;
+			x += 0.5f;
+			event.time = time;
+			event.x = x;
+			event.y = 200.0f;
+
+			const unsigned int kind = random() % 100;
+			if (kind < 90) {
+				event.type = INPUT_POINTER_MOVE;
+				event.messageID = 0x0200;
+			}
+			else if (kind < 98) {
+				event.type = INPUT_WHEEL;
+				event.messageID = 0x020A;
+				event.delta = 120;
+			}
+			else {
+				event.type = INPUT_OTHER;
+				event.messageID = 0x0201 + kind % 2;
+			}
+		}
+		const INPUT_POINT history[2] = { { x, 200.0f, 0 }, { x, 200.0f, 0 } };
+
+		InputQueue queue;
+		INPUT_BATCH batch;
+		batch.rawCount = 0;
+		unsigned long long batchEventCount = 0;
+		const double seconds = MeasureSeconds([&]() {
+			batchEventCount = 0;
+			for (size_t i = 0; i < events.size(); i++) {
+				queue.Push(events[i], history, INPUT_POINTER_MOVE == events[i].type ? 2 : 0);
+				if (0 == (i + 1) % rawPerFrame) {
+					queue.TakeBatch(batch);
+					batchEventCount += batch.events.size();
+				}
+			}
+		});
+
+		printf("%10u %16u %16.1f %18.2f\n",
+			rate, rawPerFrame, static_cast<double>(batchEventCount) / FRAME_COUNT, seconds / events.size() * 1e9);
+	}
+
+	return 0;
+}
\ No newline at end of file
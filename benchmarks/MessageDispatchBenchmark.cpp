@@ -0,0 +1,102 @@
+#include "Benchmark.h"
+#include "MessageDispatchTable.h"
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace
+{
+	// the IDs of the Windows messages of the stream
+	const unsigned int SET_CURSOR = 0x0020;
+	const unsigned int NC_HIT_TEST = 0x0084;
+	const unsigned int PAINT = 0x000F;
+	const unsigned int TIMER = 0x0113;
+	const unsigned int MOUSE_MOVE = 0x0200;
+	const unsigned int MOUSE_WHEEL = 0x020A;
+	const unsigned int KEY_DOWN = 0x0100;
+	const unsigned int USER = 0x0400;
+	const unsigned int REGISTERED = 0xC100;
+
+	// the handlers are member functions like the ones of `WindowDialog`
+	class Dialog
+	{
+	public:
+		int m_result = 0;
+
+		virtual ~Dialog() {}
+
+		int OnMessage(unsigned long long a_wordParam, long long a_longParam)
+		{
+			m_result += static_cast<int>(a_wordParam);
+			return 0;
+		}
+	};
+
+	typedef int (Dialog:: *MessageHandler)(unsigned long long, long long);
+}
+
+// dispatches a stream which is mostly mouse moves and hit tests, like a window under a moving mouse,
+// through the table and through the std::map which the window used before
+int main()
+{
+	const unsigned int handledIDs[] = {
+		SET_CURSOR, NC_HIT_TEST, PAINT, TIMER, MOUSE_MOVE, MOUSE_WHEEL, KEY_DOWN, USER, USER + 1, USER + 7, REGISTERED, REGISTERED + 3
+	};
+	MessageDispatchTable<MessageHandler> table;
+	std::map<unsigned int, MessageHandler> handlerMap;
+	for (const unsigned int id : handledIDs) {
+		table.Set(id, &Dialog::OnMessage);
+		handlerMap[id] = &Dialog::OnMessage;
+	}
+
+	std::mt19937 random(5);
+	std::vector<unsigned int> stream(1 << 16);
+	for (unsigned int &id : stream) {
+		const unsigned int value = random() % 100;
+		if (value < 40) {
+			id = MOUSE_MOVE;
+		}
+		else if (value < 70) {
+			id = NC_HIT_TEST;
+		}
+		else if (value < 85) {
+			id = SET_CURSOR;
+		}
+		else if (value < 90) {
+			id = PAINT;
+		}
+		else if (value < 94) {
+			id = TIMER;
+		}
+		else if (value < 97) {
+			id = USER + random() % 8;
+		}
+		else {
+			// a registered message or one without a handler
+			id = random() % 2 ? REGISTERED + random() % 4 : 0x0001 + random() % 0x00FF;
+		}
+	}
+
+	Dialog dialog;
+	const double tableSeconds = MeasureSeconds([&]() {
+		for (const unsigned int id : stream) {
+			const MessageHandler handler = table.Get(id);
+			if (handler) {
+				(dialog.*handler)(id, 0);
+			}
+		}
+	});
+	const double mapSeconds = MeasureSeconds([&]() {
+		for (const unsigned int id : stream) {
+			auto entry = handlerMap.find(id);
+			if (handlerMap.end() != entry) {
+				(dialog.*entry->second)(id, 0);
+			}
+		}
+	});
+
+	printf("dispatch table: %.2f ns per message\n", tableSeconds / stream.size() * 1e9);
+	printf("std::map:       %.2f ns per message\n", mapSeconds / stream.size() * 1e9);
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "Benchmark.h"
+#include "PixelCompositor.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// runs every operation over a frame of 1920x1080 pixels with each kernel which the processor supports.
+// the throughput counts the bytes of the target pixels
+int main()
+{
+	const unsigned int COUNT = 1920 * 1080;
+	const char *const KERNEL_NAMES[] = { "scalar", "sse2", "avx2" };
+	const char *const OPERATION_NAMES[] = {
+		"BlendOver", "BlendOver mask", "FillSpan", "FillSpan mask", "ApplyMask", "Premultiply", "Unpremultiply", "BlendOverLinear"
+	};
+
+	std::mt19937 random(7);
+	std::vector<unsigned int> sources(COUNT);
+	std::vector<unsigned int> targets(COUNT);
+	std::vector<unsigned char> mask(COUNT);
+	for (unsigned int i = 0; i < COUNT; i++) {
+		const unsigned int alpha = 0 == random() % 4 ? 255 : random() % 256;
+		sources[i] = alpha << 24 | (random() % (alpha + 1)) << 16 | (random() % (alpha + 1)) << 8 | random() % (alpha + 1);
+		targets[i] = 0xFF3B291E;
+		mask[i] = static_cast<unsigned char>(random());
+	}
+
+	printf("%18s", "GB/s");
+	for (unsigned int kernel = 0; kernel <= PixelCompositor::GetSupportedKernel(); kernel++) {
+		printf(" %8s", KERNEL_NAMES[kernel]);
+	}
+	printf("\n");
+
+	std::vector<unsigned int> pixels(COUNT);
+	for (unsigned int operation = 0; operation < 8; operation++) {
+		printf("%18s", OPERATION_NAMES[operation]);
+		for (unsigned int kernel = 0; kernel <= PixelCompositor::GetSupportedKernel(); kernel++) {
+			PixelCompositor compositor;
+			compositor.SetKernel(static_cast<COMPOSITE_KERNEL>(kernel));
+			pixels = 5 == operation ? sources : targets;
+			// the pixels change with each run, but every operation keeps them valid
+			const double seconds = MeasureSeconds([&]() {
+				switch (operation) {
+				case 0:
+					compositor.BlendOver(pixels.data(), sources.data(), COUNT);
+					break;
+				case 1:
+					compositor.BlendOver(pixels.data(), sources.data(), mask.data(), COUNT);
+					break;
+				case 2:
+					compositor.FillSpan(pixels.data(), 0x80402010, COUNT);
+					break;
+				case 3:
+					compositor.FillSpan(pixels.data(), 0x80402010, mask.data(), COUNT);
+					break;
+				case 4:
+					compositor.ApplyMask(pixels.data(), mask.data(), COUNT);
+					break;
+				case 5:
+					compositor.Premultiply(pixels.data(), COUNT);
+					break;
+				case 6:
+					compositor.Unpremultiply(pixels.data(), COUNT);
+					break;
+				default:
+					compositor.BlendOverLinear(pixels.data(), sources.data(), COUNT);
+					break;
+				}
+			});
+			printf(" %8.2f", COUNT * 4.0 / seconds / 1e9);
+		}
+		printf("\n");
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "Benchmark.h"
+#include "ResizeThrottle.h"
+#include <cstdio>
+
+namespace
+{
+	// a live resize of 2 seconds in which the system reports a size for every mouse move
+	const unsigned int STORM_SECONDS = 2;
+	const unsigned int REPORT_RATE = 1000;
+	// the time of resizing the render target and drawing the first frame of the new size
+	const double RESIZE_MILLISECONDS = 4.0;
+
+	// the timer of the window polls the throttle once per interval during the sizing loop
+	void ReplayStorm(ResizeThrottle &a_throttle)
+	{
+		const unsigned long long reportTime = 1000000 / REPORT_RATE;
+		const unsigned long long pollTime = a_throttle.GetInterval() > reportTime ? a_throttle.GetInterval() : reportTime;
+		unsigned long long nextPollTime = pollTime;
+
+		a_throttle.BeginLiveResize();
+		unsigned long long time = 0;
+		for (unsigned int i = 1; i <= STORM_SECONDS * REPORT_RATE; i++) {
+			time = i * reportTime;
+			a_throttle.Request(400 + i % 800, 300 + i % 600, time);
+			if (time >= nextPollTime) {
+				a_throttle.Poll(time);
+				nextPollTime += pollTime;
+			}
+		}
+		a_throttle.EndLiveResize(time);
+	}
+}
+
+// replays a resize storm with several intervals and counts the sizes which reach the render target.
+// every reported size has to be either applied or dropped
+int main()
+{
+	printf(
+		"%14s %9s %9s %9s %16s %14s %s\n",
+		"interval (ms)", "requests", "applied", "dropped", "resizing (ms/s)", "request (ns)", "counted"
+	);
+	for (const unsigned long long interval : { 0ull, 8333ull, 16667ull, 33333ull, 66667ull }) {
+		ResizeThrottle throttle(interval);
+		ReplayStorm(throttle);
+		const RESIZE_STATISTICS statistics = throttle.GetStatistics();
+
+		const double stormSeconds = MeasureSeconds([&]() {
+			ResizeThrottle stormThrottle(interval);
+			ReplayStorm(stormThrottle);
+		});
+
+		printf(
+			"%14.3f %9llu %9llu %9llu %16.1f %14.2f %s\n",
+			interval / 1000.0, statistics.requestCount, statistics.appliedCount, statistics.droppedCount,
+			statistics.appliedCount * RESIZE_MILLISECONDS / STORM_SECONDS, stormSeconds * 1e9 / (STORM_SECONDS * REPORT_RATE),
+			statistics.requestCount == statistics.appliedCount + statistics.droppedCount ? "yes" : "no"
+		);
+	}
+
+	return 0;
+}
\ No newline at end of file
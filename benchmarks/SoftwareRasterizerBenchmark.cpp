@@ -0,0 +1,178 @@
+#include "Benchmark.h"
+#include "SoftwareRasterizer.h"
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+	const int VIEW_WIDTH = 1920;
+	const int VIEW_HEIGHT = 1080;
+	const int PANEL_COLUMNS = 4;
+	const int PANEL_ROWS = 3;
+	const float PANEL_MARGIN = 12.0f;
+
+	struct DASHBOARD
+	{
+		std::vector<float> values;			// the samples of the line charts and the heights of the bars, in [0, 1]
+		unsigned int lineSampleCount;
+		unsigned int barCount;
+	};
+
+	const RRect GetPanelRect(const int a_column, const int a_row)
+	{
+		const float width = static_cast<float>(VIEW_WIDTH) / PANEL_COLUMNS;
+		const float height = static_cast<float>(VIEW_HEIGHT) / PANEL_ROWS;
+		return RRect({
+			a_column * width + PANEL_MARGIN, a_row * height + PANEL_MARGIN,
+			(a_column + 1) * width - PANEL_MARGIN, (a_row + 1) * height - PANEL_MARGIN
+		});
+	}
+
+	// the rounded panels with their borders and a grid of thin lines
+	unsigned int DrawPanels(SoftwareRasterizer &a_rasterizer)
+	{
+		unsigned int count = 0;
+		for (int row = 0; row < PANEL_ROWS; row++) {
+			for (int column = 0; column < PANEL_COLUMNS; column++) {
+				const RRect rect = GetPanelRect(column, row);
+				a_rasterizer.SetColor({ 0.16f, 0.17f, 0.2f, 1.0f });
+				a_rasterizer.FillRoundedRectangle(rect, 8.0f);
+				a_rasterizer.SetColor({ 0.3f, 0.32f, 0.36f, 1.0f });
+				a_rasterizer.SetStrokeWidth(1.0f);
+				a_rasterizer.DrawRoundedRectangle(rect, 8.0f);
+				a_rasterizer.SetColor({ 1.0f, 1.0f, 1.0f, 0.08f });
+				for (float y = rect.top + 40.0f; y < rect.bottom; y += 40.0f) {
+					a_rasterizer.DrawLine({ rect.left + 8.0f, y + 0.5f }, { rect.right - 8.0f, y + 0.5f });
+					count++;
+				}
+				count += 2;
+			}
+		}
+		return count;
+	}
+
+	// a line chart with a translucent area below it, a bar chart and a gauge take turns in the panels
+	unsigned int DrawCharts(SoftwareRasterizer &a_rasterizer, const DASHBOARD &a_dashboard, std::vector<RPoint> &a_points)
+	{
+		unsigned int count = 0;
+		for (int row = 0; row < PANEL_ROWS; row++) {
+			for (int column = 0; column < PANEL_COLUMNS; column++) {
+				const RRect rect = GetPanelRect(column, row);
+				const float left = rect.left + 12.0f;
+				const float top = rect.top + 24.0f;
+				const float width = rect.right - rect.left - 24.0f;
+				const float height = rect.bottom - rect.top - 36.0f;
+				const unsigned int offset = static_cast<unsigned int>(row * PANEL_COLUMNS + column) * 97;
+
+				switch ((row * PANEL_COLUMNS + column) % 3) {
+				case 0:
+				{
+					const unsigned int sampleCount = a_dashboard.lineSampleCount;
+					a_points.resize(sampleCount + 2);
+					for (unsigned int i = 0; i < sampleCount; i++) {
+						const float value = a_dashboard.values[(offset + i) % a_dashboard.values.size()];
+						a_points[i] = { left + width * i / (sampleCount - 1), top + height * (1.0f - value) };
+					}
+					a_points[sampleCount] = { left + width, top + height };
+					a_points[sampleCount + 1] = { left, top + height };
+
+					const unsigned int areaSize = sampleCount + 2;
+					a_rasterizer.SetColor({ 0.2f, 0.6f, 1.0f, 0.25f });
+					a_rasterizer.FillPolygon(a_points.data(), &areaSize, 1);
+					a_rasterizer.SetColor({ 0.3f, 0.7f, 1.0f, 1.0f });
+					a_rasterizer.SetStrokeWidth(2.0f);
+					a_rasterizer.DrawPolyline(a_points.data(), &sampleCount, 1);
+					count += 2;
+					break;
+				}
+				case 1:
+				{
+					const float barWidth = width / a_dashboard.barCount;
+					a_rasterizer.SetColor({ 0.95f, 0.6f, 0.2f, 1.0f });
+					for (unsigned int i = 0; i < a_dashboard.barCount; i++) {
+						const float value = a_dashboard.values[(offset + i * 7) % a_dashboard.values.size()];
+						a_rasterizer.FillRectangle({ left + barWidth * i + 1.0f, top + height * (1.0f - value), left + barWidth * (i + 1) - 1.0f, top + height });
+						count++;
+					}
+					break;
+				}
+				default:
+				{
+					const float radius = std::fmin(width, height) * 0.45f;
+					const RPoint center = { left + width * 0.5f, top + height * 0.5f };
+					const RRect gaugeRect = { center.x - radius, center.y - radius, center.x + radius, center.y + radius };
+					a_rasterizer.SetColor({ 0.3f, 0.32f, 0.36f, 1.0f });
+					a_rasterizer.SetStrokeWidth(14.0f);
+					a_rasterizer.DrawEllipse(gaugeRect);
+
+					// the value is an arc of line segments and a needle
+					const float value = a_dashboard.values[offset % a_dashboard.values.size()];
+					const unsigned int arcSize = 64;
+					a_points.resize(arcSize);
+					for (unsigned int i = 0; i < arcSize; i++) {
+						const float angle = 2.4f + value * 4.6f * i / (arcSize - 1);
+						a_points[i] = { center.x + radius * std::cos(angle), center.y + radius * std::sin(angle) };
+					}
+					a_rasterizer.SetColor({ 0.3f, 0.9f, 0.5f, 1.0f });
+					a_rasterizer.DrawPolyline(a_points.data(), &arcSize, 1);
+					a_rasterizer.SetStrokeWidth(3.0f);
+					a_rasterizer.DrawLine(center, a_points[arcSize - 1]);
+					a_rasterizer.FillEllipse({ center.x - 6.0f, center.y - 6.0f, center.x + 6.0f, center.y + 6.0f });
+					count += 4;
+					break;
+				}
+				}
+			}
+		}
+		return count;
+	}
+}
+
+// draws a dashboard of 1920x1080 with 12 panels of line charts, bar charts and gauges, and reports the frame time and
+// the primitives per second. the charts are measured with more and more samples and bars
+int main()
+{
+	std::mt19937 random(12);
+	std::normal_distribution<float> step(0.0f, 0.03f);
+	DASHBOARD dashboard = {};
+	dashboard.values.resize(100000);
+	float value = 0.5f;
+	for (float &sample : dashboard.values) {
+		value = std::fmin(1.0f, std::fmax(0.0f, value + step(random)));
+		sample = value;
+	}
+
+	SoftwareRasterizer rasterizer(VIEW_WIDTH, VIEW_HEIGHT);
+	std::vector<RPoint> points;
+	unsigned int panelCount = 0;
+	const double panelSeconds = MeasureSeconds([&]() {
+		rasterizer.Clear({ 0.1f, 0.1f, 0.12f, 1.0f });
+		panelCount = DrawPanels(rasterizer);
+	});
+	printf("panels: %.2f ms for %u primitives\n", panelSeconds * 1000.0, panelCount);
+
+	printf("%14s %10s %12s %12s %16s\n", "line samples", "bars", "charts (ms)", "frame (ms)", "primitives/s");
+	for (const unsigned int sampleCount : { 100u, 400u, 1600u, 6400u }) {
+		dashboard.lineSampleCount = sampleCount;
+		dashboard.barCount = sampleCount / 16;
+
+		unsigned int chartCount = 0;
+		const double chartSeconds = MeasureSeconds([&]() {
+			chartCount = DrawCharts(rasterizer, dashboard, points);
+		});
+		const double frameSeconds = MeasureSeconds([&]() {
+			rasterizer.Clear({ 0.1f, 0.1f, 0.12f, 1.0f });
+			DrawPanels(rasterizer);
+			DrawCharts(rasterizer, dashboard, points);
+		});
+
+		printf(
+			"%14u %10u %12.2f %12.2f %16.0f\n", sampleCount, dashboard.barCount, chartSeconds * 1000.0, frameSeconds * 1000.0,
+			(panelCount + chartCount) / frameSeconds
+		);
+	}
+
+	return 0;
+}
\ No newline at end of file
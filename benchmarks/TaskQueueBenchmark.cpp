@@ -0,0 +1,103 @@
+#include "Benchmark.h"
+#include "TaskQueue.h"
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	const unsigned int TASK_COUNT = 1 << 18;
+
+	// the queue which the lock-free one has replaced
+	class LockedQueue
+	{
+	protected:
+		std::mutex m_mutex;
+		std::deque<std::function<void()>> m_tasks;
+
+	public:
+		template<class Task>
+		void Post(Task &&a_task)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_tasks.emplace_back(std::forward<Task>(a_task));
+		}
+
+		unsigned int Drain()
+		{
+			std::deque<std::function<void()>> tasks;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				tasks.swap(m_tasks);
+			}
+			for (std::function<void()> &task : tasks) {
+				task();
+			}
+			return static_cast<unsigned int>(tasks.size());
+		}
+	};
+
+	// the producers post their share of the tasks at once while the calling thread drains them.
+	// every task checks that it runs after the previous task of its producer
+	template<class Queue>
+	bool Post(Queue &a_queue, const unsigned int a_producerCount)
+	{
+		std::vector<unsigned int> nextSequences(a_producerCount, 0);
+		unsigned int orderErrorCount = 0;
+
+		std::vector<std::thread> producers;
+		for (unsigned int producer = 0; producer < a_producerCount; producer++) {
+			producers.emplace_back([&a_queue, &nextSequences, &orderErrorCount, producer, a_producerCount]() {
+				for (unsigned int sequence = 0; sequence < TASK_COUNT / a_producerCount; sequence++) {
+					a_queue.Post([&nextSequences, &orderErrorCount, producer, sequence]() {
+						if (nextSequences[producer]++ != sequence) {
+							orderErrorCount++;
+						}
+					});
+				}
+			});
+		}
+
+		const unsigned int taskCount = TASK_COUNT / a_producerCount * a_producerCount;
+		for (unsigned int runCount = 0; runCount < taskCount;) {
+			const unsigned int count = a_queue.Drain();
+			runCount += count;
+			if (0 == count) {
+				std::this_thread::yield();
+			}
+		}
+		for (std::thread &producer : producers) {
+			producer.join();
+		}
+
+		return 0 == orderErrorCount;
+	}
+}
+
+// posts the same number of tasks from 1 to 32 threads to one consumer
+int main()
+{
+	printf("%10s %18s %18s\n", "producers", "lock-free (ns)", "mutex (ns)");
+	bool isOrdered = true;
+	for (const unsigned int producerCount : { 1u, 2u, 4u, 8u, 16u, 32u }) {
+		const double lockFreeSeconds = MeasureSeconds([&]() {
+			TaskQueue queue;
+			isOrdered = Post(queue, producerCount) && isOrdered;
+		}, 0.5);
+		const double lockedSeconds = MeasureSeconds([&]() {
+			LockedQueue queue;
+			isOrdered = Post(queue, producerCount) && isOrdered;
+		}, 0.5);
+
+		printf("%10u %18.1f %18.1f\n", producerCount, lockFreeSeconds / TASK_COUNT * 1e9, lockedSeconds / TASK_COUNT * 1e9);
+	}
+
+	if (!isOrdered) {
+		printf("the tasks of a producer have run out of order\n");
+		return 1;
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "Benchmark.h"
+#include "SoftwareRasterizer.h"
+#include "TaskScheduler.h"
+#include "TileRenderer.h"
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+// renders a frame of 1920x1080 with 4000 shapes, strokes and polygons in tiles of 64 pixels on 0 to 16 workers.
+// the calling thread draws tiles too, so 0 workers is the serial renderer
+int main()
+{
+	const int VIEW_WIDTH = 1920;
+	const int VIEW_HEIGHT = 1080;
+
+	std::mt19937 random(4);
+	std::uniform_real_distribution<float> x(0.0f, static_cast<float>(VIEW_WIDTH));
+	std::uniform_real_distribution<float> y(0.0f, static_cast<float>(VIEW_HEIGHT));
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	DisplayList list;
+	list.AddClear({ 0.1f, 0.1f, 0.1f, 1.0f });
+	for (unsigned int i = 0; i < 4000; i++) {
+		const RColor color = { unit(random), unit(random), unit(random), 0.5f + unit(random) * 0.5f };
+		const float left = x(random);
+		const float top = y(random);
+		const RRect rect = { left, top, left + 8.0f + unit(random) * 120.0f, top + 8.0f + unit(random) * 80.0f };
+		switch (random() % 4) {
+		case 0:
+			list.AddShape(DISPLAY_FILL_RECTANGLE, rect, 0.0f, color, 1.0f, IdentityMatrix());
+			break;
+		case 1:
+			list.AddShape(DISPLAY_FILL_ELLIPSE, rect, 0.0f, color, 1.0f, IdentityMatrix());
+			break;
+		case 2:
+			list.AddShape(DISPLAY_DRAW_ROUNDED_RECTANGLE, rect, 6.0f, color, 2.0f, IdentityMatrix());
+			break;
+		default:
+		{
+			RPoint points[8];
+			for (RPoint &point : points) {
+				point = { left + unit(random) * 100.0f, top + unit(random) * 100.0f };
+			}
+			const unsigned int contourSize = 8;
+			list.AddPolygon(DISPLAY_DRAW_POLYLINE, points, &contourSize, 1, color, 1.5f, IdentityMatrix());
+			break;
+		}
+		}
+	}
+
+	std::vector<unsigned int> pixels(static_cast<size_t>(VIEW_WIDTH) * VIEW_HEIGHT);
+	const double untiledSeconds = MeasureSeconds([&]() {
+		SoftwareRasterizer rasterizer(pixels.data(), VIEW_WIDTH, VIEW_HEIGHT, VIEW_WIDTH);
+		list.Replay(&rasterizer);
+	});
+	printf("untiled replay: %.2f ms, %u hardware threads\n", untiledSeconds * 1000.0, std::thread::hardware_concurrency());
+
+	TileRenderer renderer(64);
+	printf("%8s %12s %14s %8s\n", "workers", "frame (ms)", "tiles/s", "speedup");
+	double serialSeconds = 0.0;
+	for (const unsigned int workerCount : { 0u, 1u, 2u, 4u, 8u, 16u }) {
+		TaskScheduler *const p_scheduler = workerCount ? new TaskScheduler(workerCount) : nullptr;
+		const double seconds = MeasureSeconds([&]() {
+			renderer.Render(list, pixels.data(), VIEW_WIDTH, VIEW_HEIGHT, VIEW_WIDTH, p_scheduler);
+		});
+		delete p_scheduler;
+
+		if (0 == workerCount) {
+			serialSeconds = seconds;
+		}
+		printf("%8u %12.2f %14.0f %7.2fx\n", workerCount, seconds * 1000.0, renderer.GetTileCount() / seconds, serialSeconds / seconds);
+	}
+
+	return 0;
+}
\ No newline at end of file
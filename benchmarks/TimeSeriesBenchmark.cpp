@@ -0,0 +1,76 @@
+#include "Benchmark.h"
+#include "SoftwareRasterizer.h"
+#include "TimeSeriesPyramid.h"
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// draws a time series of 1k to 10M samples into a chart of 1024 pixel columns. a frame costs the reduction to the columns
+// and a polyline of at most 4 points per column, so it stays bounded however many samples there are. the polyline of all
+// samples is drawn for comparison up to 100k samples
+int main()
+{
+	const int VIEW_WIDTH = 1024;
+	const int VIEW_HEIGHT = 256;
+	const unsigned int MAX_FULL_COUNT = 100000;
+
+	SoftwareRasterizer rasterizer(VIEW_WIDTH, VIEW_HEIGHT);
+	rasterizer.SetStrokeWidth(1.0f);
+	std::vector<RPoint> points;
+	auto drawPoints = [&]() {
+		rasterizer.BeginDraw();
+		rasterizer.Clear({ 1.0f, 1.0f, 1.0f, 1.0f });
+		rasterizer.SetColor({ 0.1f, 0.3f, 0.8f, 1.0f });
+		const unsigned int size = static_cast<unsigned int>(points.size());
+		rasterizer.DrawPolyline(points.data(), &size, 1);
+		rasterizer.EndDraw();
+	};
+
+	std::mt19937 random(9);
+	std::normal_distribution<float> noise(0.0f, 0.1f);
+	printf("%10s %12s %12s %12s %12s\n", "samples", "build (ms)", "reduce (ms)", "frame (ms)", "full (ms)");
+	for (const unsigned int count : { 1000u, 10000u, 100000u, 1000000u, 10000000u }) {
+		std::vector<float> values(count);
+		for (unsigned int i = 0; i < count; i++) {
+			values[i] = std::sin(i * 20.0f / count) + noise(random);
+		}
+
+		TimeSeriesPyramid series;
+		const double buildSeconds = MeasureSeconds([&]() {
+			series.SetUniformSamples(0.0, 1.0, values.data(), count);
+		}, 0.05);
+
+		TIME_SERIES_VIEW view = {};
+		view.firstX = 0.0;
+		view.lastX = count - 1.0;
+		view.minY = -1.5f;
+		view.maxY = 1.5f;
+		view.rect = { 0.0f, 0.0f, static_cast<float>(VIEW_WIDTH), static_cast<float>(VIEW_HEIGHT) };
+		view.columnCount = VIEW_WIDTH;
+
+		const double reduceSeconds = MeasureSeconds([&]() {
+			series.Reduce(view, points);
+		});
+		const double frameSeconds = MeasureSeconds([&]() {
+			series.Reduce(view, points);
+			drawPoints();
+		});
+
+		if (count > MAX_FULL_COUNT) {
+			printf("%10u %12.3f %12.3f %12.3f %12s\n", count, buildSeconds * 1000.0, reduceSeconds * 1000.0, frameSeconds * 1000.0, "-");
+			continue;
+		}
+
+		// a column for every sample keeps all of them
+		view.columnCount = count;
+		series.Reduce(view, points);
+		const double fullSeconds = MeasureSeconds(drawPoints);
+		printf(
+			"%10u %12.3f %12.3f %12.3f %12.3f\n", count, buildSeconds * 1000.0, reduceSeconds * 1000.0, frameSeconds * 1000.0,
+			fullSeconds * 1000.0
+		);
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -4,9 +4,17 @@
 #include <d2d1.h>
 #include <dwrite.h>
 #include <wincodec.h>
+#include "ImageDecoder.h"
+#include <mutex>
 
 #pragma comment(lib, "Shcore.lib")
 
+class FontCache;
+class TaskScheduler;
+class ImageCache;
+class StartupTimeline;
+struct FONT_FORMAT;
+
 template<class Interface>
 void InterfaceRelease(Interface **ap_interfaceObject)
 {
@@ -16,26 +24,47 @@ void InterfaceRelease(Interface **ap_interfaceObject)
 	}
 }
 
-class ApplicationCore
+// decodes the images of the `ImageCache` with the imaging factory
+class ApplicationCore : protected ImageDecoder
 {
 protected:
 	ID2D1Factory *mp_factory;			// an object that creates various objects composing Direct2D.
-	IDWriteFactory *mp_wirteFactory;	// an object that creates resources related to string output.
-	IWICImagingFactory *mp_wicFactory;	// an object that creates various window imaging components
+	IDWriteFactory *mp_wirteFactory;	// an object that creates resources related to string output. created on its first use
+	IWICImagingFactory *mp_wicFactory;	// an object that creates various window imaging components. created on its first use
+	std::once_flag m_writeFactoryFlag;
+	std::once_flag m_wicFactoryFlag;
+	FontCache *mp_fontCache;			// the text formats and the font faces shared by all windows
+	TaskScheduler *mp_taskScheduler;	// the worker threads which the coroutines of all windows continue on
+	StartupTimeline *mp_startupTimeline;	// how long each phase of the startup took
+	ImageCache *mp_imageCache;			// the decoded images shared by all windows
 
 	HINSTANCE mh_instance;				// handle of application instance to access resources
+	bool m_isMultiThreaded;				// whether the Direct2D factory and its resources can be used by several threads
 
 public:
 	ApplicationCore(HINSTANCE ah_instance);
 	virtual ~ApplicationCore();
 
-	const int Create();
+	// a multi-threaded factory is required to draw on a render thread, see `WindowDialog::EnableThreadedRendering`
+	const int Create(const bool a_isMultiThreaded = false);
+	// creates the write factory and the fonts on a worker thread while the first window is created.
+	// without a font list the default font of `Direct2DEx` is created
+	void Prewarm(const FONT_FORMAT *const ap_formats = nullptr, const unsigned int a_count = 0);
 
 	ID2D1Factory *const GetFactory();
 	IDWriteFactory *const GetWriteFactory();
 	IWICImagingFactory *const GetWICFactory();
+	FontCache *const GetFontCache();
+	TaskScheduler *const GetTaskScheduler();
+	StartupTimeline *const GetStartupTimeline();
+	ImageCache *const GetImageCache();
 
 	const HINSTANCE GetHandleInstance();
+	const bool IsMultiThreaded();
+
+protected:
+	// ImageDecoder, called on the worker threads
+	virtual bool Decode(const wchar_t *const ap_path, const unsigned int a_width, const unsigned int a_height, IMAGE_PIXELS &a_image) override;
 };
 
 #endif //_DIRECT_2D_CORE_
\ No newline at end of file
@@ -2,59 +2,327 @@
 #define _DIRECT_2D_H_
 
 #include "ApplicationCore.h"
+#include "RenderBackend.h"
+#include "DisplayList.h"
+#include "DirtyRegion.h"
+#include "TessellationCache.h"
+#include "TimeSeriesPyramid.h"
+#include <unordered_map>
+#include <vector>
 
 #define DPoint	D2D1_POINT_2F
 #define DRect	D2D1_RECT_F
 #define DColor	D2D1_COLOR_F
 #define DSize	D2D1_SIZE_F
 
+// the portable types of `RenderBackend.h` have the same layout as the Direct2D types
+static_assert(sizeof(RPoint) == sizeof(DPoint), "RPoint should have the layout of D2D1_POINT_2F");
+static_assert(sizeof(RRect) == sizeof(DRect), "RRect should have the layout of D2D1_RECT_F");
+static_assert(sizeof(RColor) == sizeof(DColor), "RColor should have the layout of D2D1_COLOR_F");
+static_assert(sizeof(RMatrix) == sizeof(D2D1_MATRIX_3X2_F), "RMatrix should have the layout of D2D1_MATRIX_3X2_F");
+
+inline const RPoint &ToRenderPoint(const DPoint &a_point) { return reinterpret_cast<const RPoint &>(a_point); }
+inline const RRect &ToRenderRect(const DRect &a_rect) { return reinterpret_cast<const RRect &>(a_rect); }
+inline const RColor &ToRenderColor(const DColor &a_color) { return reinterpret_cast<const RColor &>(a_color); }
+inline const RMatrix &ToRenderMatrix(const D2D1_MATRIX_3X2_F &a_matrix) { return reinterpret_cast<const RMatrix &>(a_matrix); }
+
+inline const DPoint &ToDirect2DPoint(const RPoint &a_point) { return reinterpret_cast<const DPoint &>(a_point); }
+inline const DRect &ToDirect2DRect(const RRect &a_rect) { return reinterpret_cast<const DRect &>(a_rect); }
+inline const DColor &ToDirect2DColor(const RColor &a_color) { return reinterpret_cast<const DColor &>(a_color); }
+inline const D2D1_MATRIX_3X2_F &ToDirect2DMatrix(const RMatrix &a_matrix) { return reinterpret_cast<const D2D1_MATRIX_3X2_F &>(a_matrix); }
+
+// the drawing state which is saved by `PushState`. it holds a reference of the brush and the stroke style
+struct DRAWING_STATE
+{
+	ID2D1Brush *p_brush;
+	DColor brushColor;
+	ID2D1StrokeStyle *p_strokeStyle;
+	float strokeWidth;
+	D2D1_MATRIX_3X2_F transform;
+	unsigned int clipCount;
+};
+
+// the number of state changes since `BeginDraw`
+struct STATE_STATISTICS
+{
+	unsigned int issuedCount;		// the changes which were passed to the render target or the backend
+	unsigned int elidedCount;		// the changes which were skipped because the state was already set
+};
+
+// the number of primitives since `BeginDraw` which have been tested against the region of the frame and the clip
+struct DRAW_STATISTICS
+{
+	unsigned int submittedCount;	// the primitives which touch the region and the clip
+	unsigned int culledCount;		// the primitives which were rejected before they reached the render target or the backend
+	unsigned int elidedClipCount;	// the clips which contain the clip below and weren't passed to the render target or the backend
+};
+
+// a clip of the clip stack
+struct CLIP_ENTRY
+{
+	RRect rect;						// the intersection of the pushed clips in pixels
+	bool isApplied;					// false if it contains the clip below, so the output isn't clipped again
+};
+
+// the number of lookups of a resource cache
+struct CACHE_STATISTICS
+{
+	unsigned int hitCount;
+	unsigned int missCount;
+};
+
+// a device copy of a decoded image of the `ImageCache`
+struct BITMAP_ENTRY
+{
+	ID2D1Bitmap *p_bitmap;
+	unsigned int frameIndex;						// the last frame which has drawn it
+};
+
+// the colors of a batch are grouped by their exact bits
+struct COLOR_KEY
+{
+	unsigned int bits[4];
+
+	bool operator==(const COLOR_KEY &a_key) const
+	{
+		return bits[0] == a_key.bits[0] && bits[1] == a_key.bits[1] && bits[2] == a_key.bits[2] && bits[3] == a_key.bits[3];
+	}
+};
+
+struct ColorKeyHash
+{
+	size_t operator()(const COLOR_KEY &a_key) const
+	{
+		size_t hash = a_key.bits[0];
+		for (int i = 1; i < 4; i++) {
+			hash = hash * 31 + a_key.bits[i];
+		}
+		return hash;
+	}
+};
+
+// a stroke style is a device-independent resource and stays valid after the device is lost.
+// its properties and dashes are compared by their exact bits
+struct STROKE_STYLE_KEY
+{
+	D2D1_STROKE_STYLE_PROPERTIES properties;
+	std::vector<float> dashes;
+
+	bool operator==(const STROKE_STYLE_KEY &a_key) const;
+};
+
+struct StrokeStyleKeyHash
+{
+	size_t operator()(const STROKE_STYLE_KEY &a_key) const;
+};
+
+// a gradient stop collection belongs to the render target. the stops are kept in the key to create it again
+// after the render target has been recreated
+struct GRADIENT_STOP_KEY
+{
+	std::vector<D2D1_GRADIENT_STOP> stops;
+	D2D1_GAMMA gamma;
+	D2D1_EXTEND_MODE extendMode;
+
+	bool operator==(const GRADIENT_STOP_KEY &a_key) const;
+};
+
+struct GradientStopKeyHash
+{
+	size_t operator()(const GRADIENT_STOP_KEY &a_key) const;
+};
+
 class Direct2D
 {
 protected:
 	const HWND mh_window;
 	RECT *mp_viewRect;
+	bool m_isRecorder;								// only records, so it has no render target
+	bool m_isWindowRegionOwner;						// takes, validates and invalidates the update region of the window
 
 	ID2D1RenderTarget *mp_renderTarget;				// instance to draw in window client area
+	ID2D1HwndRenderTarget *mp_hwndRenderTarget;		// `mp_renderTarget` as a window target to resize it. it holds no reference
 	ID2D1Brush *mp_brush;							// used as output brush for lines and strings
+	ID2D1SolidColorBrush *mp_solidBrush;			// `mp_brush` if it is a solid color brush. it holds no reference
 	ID2D1StrokeStyle *mp_strokeStyle;
+	RenderBackend *mp_backend;						// draws instead of the render target if it isn't null
+	DisplayList *mp_displayList;					// records the drawing calls instead of drawing if it isn't null
+	unsigned int m_deviceGeneration;				// increased whenever the device resources are created
+
+	DirtyRegion m_dirtyRegion;						// invalidated rectangles which are drawn by the next frame
+	DirtyRegion m_drawRegion;						// the region of the current frame. the drawing calls outside it are culled
+	ID2D1Geometry *mp_clipGeometry;					// the mask of the clip layer if the region has several rectangles
+
+	// scratch buffers of the batch calls which are reused between calls
+	std::vector<unsigned int> m_batchOrder;			// the instance indices of each color one after another
+	std::vector<unsigned int> m_batchGroupOffsets;
+	std::vector<unsigned int> m_batchGroups;		// the color group of each instance
+	std::unordered_map<COLOR_KEY, unsigned int, ColorKeyHash> m_batchGroupTable;	// cleared by each batch, its buckets are kept
+	std::vector<RPoint> m_seriesPoints;				// the reduced polyline of `DrawTimeSeries`
 
 	DColor m_brushColor;
 	DColor m_backgroundColor;
 	float m_strokeWidth;
+	D2D1_MATRIX_3X2_F m_transform;
+
+	std::vector<DRAWING_STATE> m_stateStack;
+	std::vector<CLIP_ENTRY> m_clipRects;
+	RRect m_drawExtent;								// the extent of the region of the frame, unbounded if the region has no bounds
+	STATE_STATISTICS m_stateStatistics;
+	DRAW_STATISTICS m_drawStatistics;
+	unsigned int m_recordClipCount;					// the number of clips when the recording has begun
+
+	// the caches hold one reference of each resource and hand out an additional reference for every lookup
+	std::unordered_map<STROKE_STYLE_KEY, ID2D1StrokeStyle *, StrokeStyleKeyHash> m_strokeStyleCache;
+	// a collection is null until it is used with the current render target
+	std::unordered_map<GRADIENT_STOP_KEY, ID2D1GradientStopCollection *, GradientStopKeyHash> m_gradientStopCache;
+	GRADIENT_STOP_KEY m_gradientStopKey;			// the key of the last lookup, its buffer is reused
+	CACHE_STATISTICS m_strokeStyleStatistics;
+	CACHE_STATISTICS m_gradientStopStatistics;
+	// the bitmaps belong to the render target and are keyed by the id of their decoded image
+	std::unordered_map<unsigned long long, BITMAP_ENTRY> m_bitmapCache;
+	CACHE_STATISTICS m_bitmapStatistics;
+	unsigned int m_frameIndex;						// increased by `BeginDraw`
+	TessellationCache m_tessellationCache;			// the paths of `DrawPath` and `FillPath`
 
 public:
 	Direct2D(const HWND ah_window, const RECT *const ap_viewRect = nullptr);
 	virtual ~Direct2D();
 
 	virtual int Create();
+	// a recorder of a window which another instance draws has no render target and can't begin a frame.
+	// it has to be set before `Create`
+	void SetRecorder(const bool a_isRecorder);
+	// the instance of a render thread keeps its dirty region to itself. the update region of the window
+	// belongs to the window thread, which records the frames
+	void SetWindowRegionOwner(const bool a_isOwner);
+	// resizes the view and the render target in place, so the brushes and the caches stay valid.
+	// the render target is created again only if it can't be resized. the whole view is drawn by the next frame
+	HRESULT Resize(const unsigned int a_width, const unsigned int a_height);
 
 	void BeginDraw();
 	void EndDraw();
 	void Clear();
 
+	// the return object should be released from the user. the gradient stop collection is shared
+	// with every brush which has the same stops
 	ID2D1LinearGradientBrush *const CreateLinearGradientBrush(
 		const D2D1_GRADIENT_STOP *const a_gradientStopList,
 		const unsigned int gradientStopsCount,
 		const D2D1_LINEAR_GRADIENT_BRUSH_PROPERTIES *const a_gradientPositionData
 	);
+	// the return object should be released from the user. the calls with the same properties return the same object.
+	// `ap_dashes` are used with `D2D1_DASH_STYLE_CUSTOM` only
 	ID2D1StrokeStyle *const CreateUserStrokeStyle(
 		const D2D1_DASH_STYLE a_dashStyle, const D2D1_CAP_STYLE a_sideCap = D2D1_CAP_STYLE_ROUND,
 		const D2D1_CAP_STYLE a_dashCap = D2D1_CAP_STYLE_ROUND, const D2D1_LINE_JOIN a_lineJoin = D2D1_LINE_JOIN_ROUND,
-		const float a_miterLimit = 10.0f, const float a_dashOffset = 0.0f
+		const float a_miterLimit = 10.0f, const float a_dashOffset = 0.0f,
+		const float *const ap_dashes = nullptr, const unsigned int a_dashCount = 0
 	);
 
+	// the setters skip a state which is already set. the color of a brush which isn't a solid color brush isn't changed
 	void SetBrushColor(const DColor &a_color);
 	void SetBackgroundColor(const DColor &a_backgroundColor);
-	// returns the previous brush. must be released from the user
+	// takes over the reference of the brush and returns the previous brush, which must be released from the user.
+	// the brush color becomes the color of a solid color brush
 	ID2D1Brush *SetBrush(ID2D1Brush *const ap_brush);
-	// returns the previous stroke style. must be released from the user
+	// takes over the reference of the stroke style and returns the previous one, which must be released from the user
 	ID2D1StrokeStyle *const SetStrokeStyle(ID2D1StrokeStyle *const ap_strokeStyle);
 	void SetStrokeWidth(const float a_strokeWidth);
 	void SetMatrixTransform(const D2D1_MATRIX_3X2_F &a_transform);
 
+	// saves the brush, the brush color, the stroke style, the stroke width, the transform and the clip.
+	// `PopState` restores only the changed state and pops the clips which were pushed in between.
+	// the saved brush and stroke style are kept alive by the state, the ones which were set in between are released
+	// `EndDraw` drops the states which haven't been popped with their references
+	void PushState();
+	void PopState();
+	// clips the drawing to a rectangle in user space. a rotated transform clips to the bounds of the rectangle
+	void PushClipRect(const DRect &a_rect);
+	void PopClipRect();
+	const STATE_STATISTICS &GetStateStatistics();
+	const DRAW_STATISTICS &GetDrawStatistics();
+	const CACHE_STATISTICS &GetStrokeStyleCacheStatistics();
+	const CACHE_STATISTICS &GetGradientStopCacheStatistics();
+	const CACHE_STATISTICS &GetBitmapCacheStatistics();
+	// releases the cached resources which aren't used by anyone else and the bitmaps which the last frame hasn't drawn
+	void ReleaseUnusedResources();
+	// the paths are added to the cache once and drawn by their ids
+	TessellationCache &GetTessellationCache();
+
+	// returns the previous backend. must be deleted from the user.
+	// a headless instance sets a backend without calling `Create`. the text output needs the render target
+	RenderBackend *const SetRenderBackend(RenderBackend *const ap_backend);
+
+	// the drawing calls between `BeginRecord` and `EndRecord` are appended to the list instead of drawing.
+	// custom brushes and stroke styles aren't recorded, the commands keep the brush color and the stroke width
+	void BeginRecord(DisplayList *const ap_list);
+	void EndRecord();
+	// replays a recorded list with the state of each command and restores the current state afterwards
+	virtual void DrawDisplayList(const DisplayList &a_list);
+	// the content of the render target is lost whenever this value changes
+	const unsigned int GetDeviceGeneration();
+
+	// marks a rectangle in pixels to be drawn by the next frame and requests a WM_PAINT message.
+	// `BeginDraw` clips the frame to the invalidated rectangles and the update region of the window.
+	// a frame without any invalidated rectangle draws the whole view
+	void Invalidate(const DRect &a_rect);
+	void InvalidateAll();
+	const DirtyRegion &GetDrawRegion();
+
 protected:
 	virtual HRESULT CreateDeviceResources();
 	virtual void DestroyDeviceResources();
+	// returns the cached gradient stop collection without an additional reference
+	ID2D1GradientStopCollection *const GetGradientStopCollection(
+		const D2D1_GRADIENT_STOP *const ap_stops, const unsigned int a_stopCount,
+		const D2D1_GAMMA a_gamma, const D2D1_EXTEND_MODE a_extendMode
+	);
+	// flattens the figures of a geometry into polylines for the render backend.
+	// the closed figures repeat their first point at the end
+	bool FlattenGeometry(
+		ID2D1Geometry *const ap_geometry, const bool a_isFilled,
+		std::vector<RPoint> &a_points, std::vector<unsigned int> &a_contourSizes,
+		const D2D1_MATRIX_3X2_F *const ap_transform = nullptr
+	);
+	// returns the cached bitmap of a decoded image without an additional reference, or nullptr if it can't be created
+	ID2D1Bitmap *const GetBitmap(const IMAGE_PIXELS &a_image);
+	// releases the bitmaps which the current frame hasn't drawn
+	void ReleaseUnusedBitmaps();
+	// the notification of the `ImageCache` when an image has been decoded, called from a worker thread
+	static void InvalidateWindow(void *ap_window);
+	// draws polygon data on the backend or as a path geometry on the render target
+	void DrawPolygonData(
+		const RPoint *const ap_points, const unsigned int *const ap_contourSizes,
+		const unsigned int a_contourCount, const bool a_isFilled
+	);
+
+	void RecordShape(const DISPLAY_OPCODE a_opcode, const DRect &a_rect, const float a_radius = 0.0f);
+	void RecordGeometry(const DISPLAY_OPCODE a_opcode, ID2D1Geometry *const ap_geometry);
+	virtual void ReplayCommand(const DisplayList &a_list, const DISPLAY_COMMAND &a_command);
+
+	// sorts the instances of a batch by color into `m_batchOrder`. `m_batchGroupOffsets` keeps the first index
+	// of each color and the end of the order. the instances of the same color keep their order
+	void GroupByColor(const DColor *const ap_colors, const unsigned int a_count);
+	// calls `a_drawFunction` with the index of each instance after the brush color of its group is set.
+	// the render target still gets a call for each instance, but it merges the consecutive primitives
+	// of the same brush into one draw, which the order of the groups allows
+	template <typename DrawFunction>
+	void DrawBatch(const DColor *const ap_colors, const unsigned int a_count, DrawFunction a_drawFunction);
+
+	// moves the update region of the window into the dirty region
+	void AddUpdateRegion();
+	void PushDrawRegionClip();
+	void PopDrawRegionClip();
+	// the backend has a single clip rectangle for the region and the clip stack
+	void ApplyBackendClip();
+	void UpdateDrawExtent();
+	// returns whether a rectangle in user space expanded by `a_margin` touches the region of the current frame and the clip.
+	// every call counts one primitive as submitted or culled
+	const bool IsInDrawRegion(const DRect &a_rect, const float a_margin = 0.0f);
+	// returns how far the stroke of the current style can reach beyond the outline in user space.
+	// the joins of polylines and geometries can reach up to the miter limit
+	const float GetStrokeMargin(const bool a_hasJoins);
 
 // drawing methode
 public:
@@ -73,6 +341,27 @@ public:
 	void FillRoundedRectangle(const DPoint &a_startPoint, const DPoint &a_endPoint, const float radius);
 	void FillEllipse(const DRect &a_rect);
 	void FillGeometry(ID2D1Geometry *const p_geometry);
+	// draw a path of the tessellation cache, which is flattened again only when the scale of the transform changes
+	void DrawPath(const unsigned long long a_pathID);
+	void FillPath(const unsigned long long a_pathID);
+
+	// draws an image file decoded at the size which the rectangle covers in pixels. until the worker threads have decoded it,
+	// the rectangle is filled with the brush color and the window is invalidated when it has been decoded.
+	// a backend has no bitmap output and always draws the placeholder
+	void DrawBitmap(const wchar_t *const ap_path, const DRect &a_rect, const float a_opacity = 1.0f);
+	// draws the samples from `a_firstX` to `a_lastX` as a polyline which maps `a_minY` to the bottom and `a_maxY` to the top
+	// of the rectangle. the polyline is reduced to the few samples per pixel column which cover the same pixels.
+	// a rectangle outside the region of the frame is skipped before the reduction, with the samples which leave it
+	void DrawTimeSeries(
+		TimeSeriesPyramid &a_series, const DRect &a_rect, const double a_firstX, const double a_lastX,
+		const float a_minY, const float a_maxY
+	);
+
+	// the batch calls draw `a_count` instances with one color per instance, or with the brush color if `ap_colors` is null.
+	// the instances are drawn grouped by color, so overlapping instances of different colors can change their order
+	void DrawLines(const DPoint *const ap_startPoints, const DPoint *const ap_endPoints, const DColor *const ap_colors, const unsigned int a_count);
+	void FillRectangles(const DRect *const ap_rects, const DColor *const ap_colors, const unsigned int a_count);
+	void FillEllipses(const DRect *const ap_rects, const DColor *const ap_colors, const unsigned int a_count);
 };
 
 #endif //_DIRECT_2D_H_
\ No newline at end of file
@@ -2,32 +2,44 @@
 #define _DIRECT_2D_EX_H_
 
 #include "Direct2D.h"
+#include "TextLayoutCache.h"
+#include "FontCache.h"
+#include "GlyphOutlineCache.h"
+#include "GlyphAtlas.h"
 #include <string>
+#include <vector>
 
 #define DEFAULT_FONT_NAME	L"Malgun Gothic"
 
-struct FONT_FORMAT
-{
-	std::wstring name;
-	float size;
-	DWRITE_FONT_WEIGHT weight = DWRITE_FONT_WEIGHT_NORMAL;
-	DWRITE_FONT_STYLE style = DWRITE_FONT_STYLE_NORMAL;
-};
-
 // possible draw text
-class Direct2DEx : public Direct2D
+class Direct2DEx : public Direct2D, protected TextMeasurer, protected GlyphOutliner, protected GlyphRasterizer
 {
 protected:
-	IDWriteTextFormat *mp_textFormat;				// font information used as output for strings
-	IDWriteFontFace *mp_fontFace;
+	IDWriteTextFormat *mp_textFormat;				// font information used as output for strings. shared by `FontCache` unless it's a user text format
+	IDWriteFontFace *mp_fontFace;					// shared by `FontCache`
 
 	FONT_FORMAT m_fontFormat;
+	DWRITE_TEXT_ALIGNMENT m_textAlignment;
+	DWRITE_PARAGRAPH_ALIGNMENT m_paragraphAlignment;
+
+	TextLayoutCache m_layoutCache;					// the layouts of `GetTextExtent` and `DrawUserText`
+	bool m_isUserTextFormat;						// the text format was set by `SetTextFormat`, so it isn't described by `m_fontFormat`
+
+	GlyphOutlineCache m_outlineCache;				// the glyph outlines of `CreateTextPathGeometry`
+	GlyphAtlas m_glyphAtlas;						// the rasterized glyphs of `DrawAtlasText`
+	ID2D1Bitmap *mp_atlasBitmap;					// the pixels of `m_glyphAtlas` on the device
+	std::vector<IDWriteFontFace *> m_glyphFontFaces;	// the font faces of the cached glyphs are kept alive, so their addresses stay unique
+
+	std::vector<unsigned int> m_codePoints;			// scratch buffers of the glyph based text output
+	std::vector<unsigned short> m_glyphIndices;
+	std::vector<DRect> m_glyphRects;				// the destination and the source rectangle of each atlas glyph
 
 public:
 	Direct2DEx(const HWND ah_window, const RECT *const ap_viewRect = nullptr);
 	virtual ~Direct2DEx();
 
-	// the return object of 'IDWriteTextFormat *' should be deleted from the user with the function 'InterfaceRelease'
+	// the return object of 'IDWriteTextFormat *' should be deleted from the user with the function 'InterfaceRelease'.
+	// it isn't shared, so it can be changed by the user
 	IDWriteTextFormat *CreateTextFormat(
 		const wchar_t *ap_fontName, float a_fontSize, DWRITE_FONT_WEIGHT a_fontWeight,
 		DWRITE_FONT_STYLE a_fontStyle, DWRITE_FONT_STRETCH a_fontStretch = DWRITE_FONT_STRETCH_NORMAL, const wchar_t *ap_localName = L"en-us"
@@ -48,17 +60,52 @@ public:
 	IDWriteFontFace *const SetFontFace(IDWriteFontFace *const ap_fontFace);
 
 	DSize GetTextExtent(const wchar_t *const ap_str, const float a_maxWidth = 0.0f, const float a_maxHeight = 0.0f);
+	TextLayoutCache *const GetTextLayoutCache();
+	GlyphOutlineCache *const GetGlyphOutlineCache();
+	GlyphAtlas *const GetGlyphAtlas();
+	// releases the cached glyph outlines, the atlas glyphs and their font faces
+	void ClearGlyphCaches();
+
+	// the font format is restored after the text commands have changed it
+	virtual void DrawDisplayList(const DisplayList &a_list) override;
 
 protected:
 	virtual HRESULT CreateDeviceResources() override;
 	virtual void DestroyDeviceResources() override;
 
-	// the return object of `ID2D1PathGeometry *` should be deleted from the user with the function `InterfaceRelease`
-	ID2D1PathGeometry *CreateTextPathGeometry(const wchar_t *const ap_text, const float a_fontSize);
+	// the return object of `ID2D1PathGeometry *` should be deleted from the user with the function `InterfaceRelease`.
+	// the path is composed of the cached glyph outlines of the current font face.
+	// `ap_bounds` receives the tight bounds of the path from the bounds of the cached outlines
+	ID2D1PathGeometry *CreateTextPathGeometry(const wchar_t *const ap_text, const float a_fontSize, DRect *const ap_bounds = nullptr);
+
+	DISPLAY_FONT GetDisplayFont();
+	// returns the cached layout of the text with the current text format. returns nullptr if the layout can't be cached
+	const TEXT_LAYOUT_ENTRY *const GetTextLayout(const wchar_t *const ap_text, const float a_maxWidth, const float a_maxHeight);
+	// creates a `IDWriteTextLayout` with the current text format. `a_font` describes the current text format
+	virtual void *CreateLayout(
+		const wchar_t *const ap_text, const unsigned int a_length, const DISPLAY_FONT &a_font,
+		const float a_maxWidth, const float a_maxHeight, TEXT_METRICS &a_metrics
+	) override;
+	virtual void ReleaseLayout(void *const ap_layout) override;
+	// extracts the outline of a glyph with `GetGlyphRunOutline`
+	virtual bool CreateOutline(const void *const ap_fontFace, const unsigned short a_glyphIndex, const float a_size, GLYPH_OUTLINE &a_outline) override;
+	// rasterizes a glyph with `IDWriteGlyphRunAnalysis` as grayscale
+	virtual bool RasterizeGlyph(
+		const void *const ap_fontFace, const unsigned short a_glyphIndex, const float a_size,
+		const float a_offsetX, GLYPH_BITMAP &a_bitmap
+	) override;
+	// fills `m_glyphIndices` with the glyphs of the text in the current font face
+	bool MapGlyphIndices(const wchar_t *const ap_text);
+	// the font face stays alive as long as the glyph caches can refer to it
+	void RetainGlyphFontFace(IDWriteFontFace *const ap_fontFace);
+	virtual void ReplayCommand(const DisplayList &a_list, const DISPLAY_COMMAND &a_command) override;
 
 // drawing methode
 public:
 	void DrawUserText(const wchar_t *const ap_text, const DRect &ap_rect);
+	// draws a single line from the glyph atlas. `a_position` is the left top of the line.
+	// it's meant for many short labels, the text isn't shaped and an unsupported text falls back to `DrawUserText`
+	void DrawAtlasText(const wchar_t *const ap_text, const DPoint &a_position);
 	DRect DrawTextOutline(const wchar_t *const ap_text, const DPoint &a_startPos, const float a_textHeight = 0.0f);
 };
 
@@ -0,0 +1,51 @@
+#ifndef _DIRTY_REGION_H_
+#define _DIRTY_REGION_H_
+
+#include "RenderBackend.h"
+#include <vector>
+
+// accumulates invalidated rectangles in pixels as a small set of non-overlapping rectangles.
+// overlapping rectangles are merged into their union and the cheapest pairs are merged
+// whenever the number of rectangles exceeds the limit
+class DirtyRegion
+{
+protected:
+	std::vector<RRect> m_rects;
+	RRect m_bounds;						// every rectangle is clipped to it. an empty bounds doesn't clip
+	unsigned int m_maxRectCount;
+	bool m_isFull;						// the whole bounds is dirty
+
+public:
+	DirtyRegion(const unsigned int a_maxRectCount = 8);
+	virtual ~DirtyRegion();
+
+	void SetBounds(const RRect &a_bounds);
+	const RRect &GetBounds() const;
+
+	// the rectangle is expanded to whole pixels
+	void Add(const RRect &a_rect);
+	void Add(const DirtyRegion &a_region);
+	void AddAll();
+	void Reset();
+	void Swap(DirtyRegion &a_region);
+
+	const bool IsEmpty() const;
+	const bool IsFull() const;
+	// a full region has the bounds as its only rectangle
+	const unsigned int GetRectCount() const;
+	const RRect *const GetRects() const;
+	// returns the smallest rectangle which contains all rectangles
+	const RRect GetExtent() const;
+	const float GetArea() const;
+	// a full region intersects everything
+	const bool Intersects(const RRect &a_rect) const;
+
+protected:
+	// adds a rectangle and merges it with every rectangle which overlaps it
+	void Insert(RRect a_rect);
+	// merges the pair with the smallest wasted area until the limit is kept
+	void Reduce();
+	const bool HasBounds() const;
+};
+
+#endif //_DIRTY_REGION_H_
\ No newline at end of file
@@ -0,0 +1,133 @@
+#ifndef _DISPLAY_LIST_H_
+#define _DISPLAY_LIST_H_
+
+#include "RenderBackend.h"
+#include "DirtyRegion.h"
+#include <string>
+#include <vector>
+
+enum DISPLAY_OPCODE : unsigned int
+{
+	DISPLAY_CLEAR = 0,
+	DISPLAY_DRAW_LINE,
+	DISPLAY_DRAW_RECTANGLE,
+	DISPLAY_DRAW_ROUNDED_RECTANGLE,
+	DISPLAY_DRAW_ELLIPSE,
+	DISPLAY_DRAW_POLYLINE,
+	DISPLAY_DRAW_TEXT,
+	DISPLAY_FILL_RECTANGLE,
+	DISPLAY_FILL_ROUNDED_RECTANGLE,
+	DISPLAY_FILL_ELLIPSE,
+	DISPLAY_FILL_POLYGON,
+	DISPLAY_PUSH_CLIP,
+	DISPLAY_POP_CLIP,
+	DISPLAY_DRAW_BITMAP
+};
+
+// a recorded drawing call with the resolved state of the moment it was recorded
+struct DISPLAY_COMMAND
+{
+	DISPLAY_OPCODE opcode;
+	unsigned int transformIndex;		// index of the transform table
+	// a line keeps its start point in (left, top) and its end point in (right, bottom). a polygon keeps its bounds
+	RRect rect;
+	float radius;						// bitmaps: the opacity
+	float strokeWidth;
+	RColor color;
+	// polygons: the first contour size and the contour count. text and bitmaps: the first letter and the length of the text or the path
+	unsigned int dataIndex;
+	unsigned int dataCount;
+	// polygons: the first point. text: index of the font table.
+	// bitmaps: the id of the decoded image, or 0 while the placeholder is drawn, so a landed decode changes the command
+	unsigned int pointIndex;
+};
+
+// the portable description of a font which is used by `DISPLAY_DRAW_TEXT`
+struct DISPLAY_FONT
+{
+	std::wstring name;
+	float size;
+	int weight;
+	int style;
+	int textAlignment;
+	int paragraphAlignment;
+	int stretch;
+	std::wstring locale;
+
+	bool operator==(const DISPLAY_FONT &a_font) const;
+};
+
+// records drawing calls into contiguous buffers so that a frame can be replayed, compared with
+// the previous frame or skipped when nothing has changed
+class DisplayList
+{
+protected:
+	std::vector<DISPLAY_COMMAND> m_commands;
+	std::vector<RMatrix> m_transforms;
+	std::vector<RPoint> m_points;
+	std::vector<unsigned int> m_contourSizes;
+	std::wstring m_text;
+	std::vector<DISPLAY_FONT> m_fonts;
+
+public:
+	DisplayList();
+	virtual ~DisplayList();
+
+	// removes all commands but keeps the allocated memory for the next frame
+	void Reset();
+	void Swap(DisplayList &a_list);
+
+	void AddClear(const RColor &a_color);
+	void AddShape(
+		const DISPLAY_OPCODE a_opcode, const RRect &a_rect, const float a_radius,
+		const RColor &a_color, const float a_strokeWidth, const RMatrix &a_transform
+	);
+	void AddPolygon(
+		const DISPLAY_OPCODE a_opcode, const RPoint *const ap_points, const unsigned int *const ap_contourSizes,
+		const unsigned int a_contourCount, const RColor &a_color, const float a_strokeWidth, const RMatrix &a_transform
+	);
+	void AddText(
+		const wchar_t *const ap_text, const unsigned int a_length, const RRect &a_rect, const DISPLAY_FONT &a_font,
+		const RColor &a_color, const RMatrix &a_transform
+	);
+	// `a_color` is the color of the placeholder which is drawn until the image is decoded
+	void AddBitmap(
+		const wchar_t *const ap_path, const unsigned int a_length, const RRect &a_rect, const float a_opacity,
+		const unsigned long long a_imageID, const RColor &a_color, const RMatrix &a_transform
+	);
+
+	const unsigned int GetCommandCount() const;
+	const DISPLAY_COMMAND *const GetCommands() const;
+	const RMatrix &GetTransform(const DISPLAY_COMMAND &a_command) const;
+	const RPoint *const GetPoints(const DISPLAY_COMMAND &a_command) const;
+	const unsigned int *const GetContourSizes(const DISPLAY_COMMAND &a_command) const;
+	const wchar_t *const GetText(const DISPLAY_COMMAND &a_command) const;
+	const DISPLAY_FONT &GetFont(const DISPLAY_COMMAND &a_command) const;
+
+	// returns the index of the first command which differs from `a_list`, or the command count if both are equal
+	const unsigned int FindFirstDifference(const DisplayList &a_list) const;
+	const bool IsEqual(const DisplayList &a_list) const;
+	// returns the bounds of a command after its transform. the strokes are expanded by their half width.
+	// the text commands return their layout rectangle
+	const RRect GetBounds(const DISPLAY_COMMAND &a_command) const;
+	// adds the bounds of the commands which differ from `a_list` in both lists to a region.
+	// a changed clear command invalidates the whole region
+	void AddDifference(const DisplayList &a_list, DirtyRegion &a_region) const;
+
+	// draws all commands on a backend. the text commands are skipped because a backend has no text output,
+	// the bitmaps are drawn as their placeholder
+	void Replay(RenderBackend *const ap_backend) const;
+	// draws the commands of `ap_indices` in their order, which have to keep the clip commands balanced
+	void Replay(RenderBackend *const ap_backend, const unsigned int *const ap_indices, const unsigned int a_count) const;
+
+protected:
+	const unsigned int AddTransform(const RMatrix &a_transform);
+	const bool IsEqualCommand(const DisplayList &a_list, const DISPLAY_COMMAND &a_command, const DISPLAY_COMMAND &a_otherCommand) const;
+	// `ap_prevCommand` is the command which has been drawn before, or nullptr. `a_clipRects` are the pushed clips in pixels
+	void ReplayCommand(
+		RenderBackend *const ap_backend, const DISPLAY_COMMAND &a_command, const DISPLAY_COMMAND *const ap_prevCommand,
+		std::vector<RRect> &a_clipRects
+	) const;
+};
+
+#endif //_DISPLAY_LIST_H_
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef _FONT_CACHE_H_
+#define _FONT_CACHE_H_
+
+#include <dwrite.h>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct FONT_FORMAT
+{
+	std::wstring name;
+	float size;
+	DWRITE_FONT_WEIGHT weight = DWRITE_FONT_WEIGHT_NORMAL;
+	DWRITE_FONT_STYLE style = DWRITE_FONT_STYLE_NORMAL;
+	DWRITE_FONT_STRETCH stretch = DWRITE_FONT_STRETCH_NORMAL;
+	std::wstring locale = L"en-us";
+
+	bool operator==(const FONT_FORMAT &a_format) const
+	{
+		return name == a_format.name && size == a_format.size && weight == a_format.weight &&
+			style == a_format.style && stretch == a_format.stretch && locale == a_format.locale;
+	}
+};
+
+struct TEXT_FORMAT_ENTRY
+{
+	FONT_FORMAT format;
+	DWRITE_TEXT_ALIGNMENT textAlignment;
+	DWRITE_PARAGRAPH_ALIGNMENT paragraphAlignment;
+	IDWriteTextFormat *p_textFormat;
+};
+
+// a font face doesn't depend on the size, the stretch and the locale
+struct FONT_FACE_ENTRY
+{
+	std::wstring name;
+	DWRITE_FONT_WEIGHT weight;
+	DWRITE_FONT_STYLE style;
+	IDWriteFontFace *p_fontFace;
+};
+
+// shares the text formats and the font faces of all `Direct2DEx` instances of the process.
+// the objects are created once per format and are handed out with an additional reference.
+// a shared text format must not be changed, so every alignment has its own text format
+class FontCache
+{
+protected:
+	std::mutex m_mutex;
+	std::vector<TEXT_FORMAT_ENTRY> m_textFormats;
+	std::vector<FONT_FACE_ENTRY> m_fontFaces;
+
+	unsigned int m_hitCount;
+	unsigned int m_missCount;
+
+public:
+	FontCache();
+	virtual ~FontCache();
+
+	// the return object must be released from the user with the function `InterfaceRelease`
+	IDWriteTextFormat *const GetTextFormat(
+		const FONT_FORMAT &a_format,
+		const DWRITE_TEXT_ALIGNMENT a_textAlignment = DWRITE_TEXT_ALIGNMENT_LEADING,
+		const DWRITE_PARAGRAPH_ALIGNMENT a_paragraphAlignment = DWRITE_PARAGRAPH_ALIGNMENT_NEAR
+	);
+	// the return object must be released from the user with the function `InterfaceRelease`
+	IDWriteFontFace *const GetFontFace(const FONT_FORMAT &a_format);
+	// creates the text formats and the font faces of a font list in advance, for example at startup
+	void WarmUp(const FONT_FORMAT *const ap_formats, const unsigned int a_count);
+	// releases the references of the cache. the objects which are used by anyone else stay valid
+	void Clear();
+
+	const unsigned int GetHitCount();
+	const unsigned int GetMissCount();
+
+	// create a new object which isn't shared
+	static IDWriteTextFormat *CreateTextFormat(const FONT_FORMAT &a_format);
+	static IDWriteFontFace *CreateFontFace(const wchar_t *const ap_name, const DWRITE_FONT_WEIGHT a_weight, const DWRITE_FONT_STYLE a_style);
+};
+
+#endif //_FONT_CACHE_H_
\ No newline at end of file
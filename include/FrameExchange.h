@@ -0,0 +1,150 @@
+#ifndef _FRAME_EXCHANGE_H_
+#define _FRAME_EXCHANGE_H_
+
+#include <atomic>
+
+// hands frames from one producer thread to one consumer thread without copying them.
+// the producer fills the back frame and publishes it, the consumer takes the newest published frame as its front frame.
+// a third frame is in the middle, so neither side waits for the other
+template<class Frame>
+class FrameExchange
+{
+protected:
+	enum : unsigned int
+	{
+		INDEX_MASK = 0x3,
+		FRESH_FLAG = 0x4,		// the middle frame is published and not taken yet
+		CLOSED_FLAG = 0x8
+	};
+
+	Frame m_frames[3];
+	unsigned int m_backIndex;				// used by the producer only
+	unsigned int m_frontIndex;				// used by the consumer only
+	std::atomic<unsigned int> m_middleState;	// the index of the middle frame and the flags
+	bool m_isTripleBuffered;
+
+	std::atomic<unsigned long long> m_publishedCount;
+	std::atomic<unsigned long long> m_droppedCount;
+
+public:
+	FrameExchange(const bool a_isTripleBuffered = true) :
+		m_middleState(1),
+		m_publishedCount(0),
+		m_droppedCount(0)
+	{
+		m_backIndex = 0;
+		m_frontIndex = 2;
+		m_isTripleBuffered = a_isTripleBuffered;
+	}
+
+	// has to be called while no thread uses the exchange. without triple buffering `Publish` waits until
+	// the previous frame has been taken like a double buffer, so no frame is dropped
+	void SetTripleBuffered(const bool a_isTripleBuffered)
+	{
+		m_isTripleBuffered = a_isTripleBuffered;
+	}
+
+	// the frame which the producer fills. it still holds the content of an older frame
+	Frame &GetBackFrame()
+	{
+		return m_frames[m_backIndex];
+	}
+
+	// the frame which the consumer has taken last
+	Frame &GetFrontFrame()
+	{
+		return m_frames[m_frontIndex];
+	}
+
+	// called by the producer. a published frame which hasn't been taken yet is replaced and dropped.
+	// returns false if the exchange has been closed
+	bool Publish()
+	{
+		unsigned int state = m_middleState.load(std::memory_order_acquire);
+		if (!m_isTripleBuffered) {
+			while (FRESH_FLAG == (state & (FRESH_FLAG | CLOSED_FLAG))) {
+				m_middleState.wait(state, std::memory_order_acquire);
+				state = m_middleState.load(std::memory_order_acquire);
+			}
+		}
+
+		do {
+			if (state & CLOSED_FLAG) {
+				return false;
+			}
+		} while (!m_middleState.compare_exchange_weak(state, m_backIndex | FRESH_FLAG, std::memory_order_acq_rel, std::memory_order_acquire));
+
+		if (state & FRESH_FLAG) {
+			m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		m_backIndex = state & INDEX_MASK;
+		m_publishedCount.fetch_add(1, std::memory_order_relaxed);
+		m_middleState.notify_all();
+
+		return true;
+	}
+
+	// called by the consumer. returns false if no frame has been published since the last call
+	bool Acquire()
+	{
+		unsigned int state = m_middleState.load(std::memory_order_acquire);
+		do {
+			if (!(state & FRESH_FLAG)) {
+				return false;
+			}
+		} while (!m_middleState.compare_exchange_weak(
+			state, m_frontIndex | (state & CLOSED_FLAG), std::memory_order_acq_rel, std::memory_order_acquire
+		));
+
+		m_frontIndex = state & INDEX_MASK;
+		if (!m_isTripleBuffered) {
+			// the producer may wait for the middle frame to be taken
+			m_middleState.notify_all();
+		}
+
+		return true;
+	}
+
+	// called by the consumer. blocks until a frame is published and takes it. returns false if the exchange has been closed
+	bool WaitFrame()
+	{
+		while (true) {
+			if (Acquire()) {
+				return true;
+			}
+
+			const unsigned int state = m_middleState.load(std::memory_order_acquire);
+			if (state & CLOSED_FLAG) {
+				return false;
+			}
+			if (!(state & FRESH_FLAG)) {
+				m_middleState.wait(state, std::memory_order_acquire);
+			}
+		}
+	}
+
+	// wakes both threads. no frame is published anymore and `WaitFrame` returns false
+	void Close()
+	{
+		m_middleState.fetch_or(CLOSED_FLAG, std::memory_order_acq_rel);
+		m_middleState.notify_all();
+	}
+
+	const bool IsClosed()
+	{
+		return 0 != (m_middleState.load(std::memory_order_acquire) & CLOSED_FLAG);
+	}
+
+	const unsigned long long GetPublishedCount()
+	{
+		return m_publishedCount.load(std::memory_order_relaxed);
+	}
+
+	// the published frames which have been replaced before the consumer took them
+	const unsigned long long GetDroppedCount()
+	{
+		return m_droppedCount.load(std::memory_order_relaxed);
+	}
+};
+
+#endif //_FRAME_EXCHANGE_H_
\ No newline at end of file
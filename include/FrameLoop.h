@@ -0,0 +1,100 @@
+#ifndef _FRAME_LOOP_H_
+#define _FRAME_LOOP_H_
+
+// returns the current time in microseconds from any fixed point
+class FrameClock
+{
+public:
+	virtual ~FrameClock() {}
+
+	virtual const unsigned long long GetTime() = 0;
+};
+
+class MessageSource
+{
+public:
+	virtual ~MessageSource() {}
+
+	// handles the pending messages without blocking. returns false when the loop has to end
+	virtual bool PumpMessages() = 0;
+	// blocks until a message arrives or the timeout in microseconds has passed. `a_isInfinite` ignores the timeout
+	virtual void WaitMessage(const unsigned long long a_timeout, const bool a_isInfinite) = 0;
+};
+
+class FrameHandler
+{
+public:
+	virtual ~FrameHandler() {}
+
+	// advances the animations by the step in seconds
+	virtual void OnFrameUpdate(const double a_step) = 0;
+	// draws the frame. `a_alpha` is the part of a fixed step which isn't updated yet, to interpolate between two steps
+	virtual void OnFrameRender(const double a_alpha) = 0;
+};
+
+typedef enum FRAME_STEP_MODE
+{
+	FRAME_VARIABLE_STEP,		// one update per frame by the measured time
+	FRAME_FIXED_STEP			// as many updates of the fixed step as the measured time contains
+} FRAME_STEP_MODE;
+
+struct FRAME_STATISTICS
+{
+	unsigned long long frameCount;
+	unsigned long long updateCount;
+	unsigned long long missedCount;		// the frames which started more than one interval after their due time
+	unsigned long long idleCount;		// the blocking waits without any animation
+	unsigned long long lastInterval;	// microseconds between the last two frames
+	double averageInterval;
+	double averageJitter;				// the average difference between the interval and the target interval
+	unsigned long long maxJitter;
+};
+
+// a frame loop which paces the frames to a target interval while an animation is active and blocks otherwise,
+// so an idle window doesn't use the processor. the messages are handled between the frames
+class FrameLoop
+{
+protected:
+	FrameClock *mp_clock;
+	MessageSource *mp_source;
+	FrameHandler *mp_handler;
+
+	FRAME_STEP_MODE m_stepMode;
+	unsigned long long m_interval;		// microseconds between two frames. 0 doesn't wait at all
+	unsigned long long m_fixedStep;		// microseconds of one update in the fixed step mode
+	unsigned int m_maxStepCount;		// the updates of a frame are limited, so a slow update can't fall further behind
+	unsigned int m_animationCount;
+
+	bool m_isRestarted;					// the next frame is the first one after idle, so there is no interval to measure
+	unsigned long long m_nextFrameTime;
+	unsigned long long m_prevFrameTime;
+	unsigned long long m_accumulatedTime;
+	unsigned long long m_intervalCount;	// the measured intervals, the first frame after idle has none
+	FRAME_STATISTICS m_statistics;
+
+public:
+	FrameLoop(FrameClock *const ap_clock, MessageSource *const ap_source, FrameHandler *const ap_handler);
+	virtual ~FrameLoop();
+
+	// runs until `PumpMessages` returns false
+	void Run();
+	// handles the messages and runs or waits for one frame. returns false when the loop has to end
+	bool RunOnce();
+
+	void SetInterval(const unsigned long long a_interval);
+	void SetStepMode(const FRAME_STEP_MODE a_mode, const unsigned long long a_fixedStep = 0, const unsigned int a_maxStepCount = 5);
+	// the frames run while at least one animation has begun and not ended yet
+	void BeginAnimation();
+	void EndAnimation();
+	const bool IsAnimating();
+
+	const unsigned long long GetInterval();
+	const FRAME_STATISTICS &GetStatistics();
+	void ResetStatistics();
+
+protected:
+	void RunFrame(const unsigned long long a_time);
+	void AddInterval(const unsigned long long a_interval);
+};
+
+#endif //_FRAME_LOOP_H_
\ No newline at end of file
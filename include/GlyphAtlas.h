@@ -0,0 +1,107 @@
+#ifndef _GLYPH_ATLAS_H_
+#define _GLYPH_ATLAS_H_
+
+#include "SkylinePacker.h"
+#include <unordered_map>
+#include <vector>
+
+// an alpha bitmap of a rasterized glyph
+struct GLYPH_BITMAP
+{
+	int left;				// the offset of the bitmap from the pen position on the baseline
+	int top;
+	int width;
+	int height;
+	float advance;
+	std::vector<unsigned char> alpha;	// `width` * `height` bytes
+};
+
+// a glyph placed in the atlas
+struct ATLAS_GLYPH
+{
+	const void *p_fontFace;
+	unsigned short glyphIndex;
+	float size;
+	unsigned char subpixel;
+	int x;					// the position in the atlas
+	int y;
+	int left;
+	int top;
+	int width;
+	int height;
+	float advance;
+};
+
+struct ATLAS_STATISTICS
+{
+	unsigned int glyphCount;
+	float occupancy;		// the packed area in relation to the atlas area
+	unsigned int hitCount;
+	unsigned int missCount;
+	unsigned int evictionCount;
+};
+
+// an interface which rasterizes glyphs for `GlyphAtlas`
+class GlyphRasterizer
+{
+public:
+	virtual ~GlyphRasterizer() {}
+
+	// `a_offsetX` is the subpixel position of the pen between 0 and 1. returns false if it has failed
+	virtual bool RasterizeGlyph(
+		const void *const ap_fontFace, const unsigned short a_glyphIndex, const float a_size,
+		const float a_offsetX, GLYPH_BITMAP &a_bitmap
+	) = 0;
+};
+
+// keeps rasterized glyphs per (font face, glyph index, size, subpixel position) in one alpha bitmap.
+// when the bitmap is full, all glyphs are evicted at once and the generation changes
+class GlyphAtlas
+{
+protected:
+	GlyphRasterizer *mp_rasterizer;
+	SkylinePacker m_packer;
+	unsigned int m_subpixelCount;
+
+	std::vector<unsigned char> m_pixels;
+	std::vector<ATLAS_GLYPH> m_glyphs;
+	std::unordered_multimap<unsigned long long, unsigned int> m_glyphTable;
+	GLYPH_BITMAP m_bitmap;				// a scratch bitmap of the rasterizer
+
+	int m_dirtyTop;						// the rows which have changed since `ClearDirtyRows`
+	int m_dirtyBottom;
+	unsigned int m_generation;
+
+	unsigned int m_hitCount;
+	unsigned int m_missCount;
+	unsigned int m_evictionCount;
+
+public:
+	GlyphAtlas(GlyphRasterizer *const ap_rasterizer, const int a_width = 1024, const int a_height = 1024, const unsigned int a_subpixelCount = 4);
+	virtual ~GlyphAtlas();
+
+	// finds or rasterizes the glyph for the pen position `a_penX`. returns false if the glyph can't be placed.
+	// the glyphs which have been returned before are invalid if the generation has changed
+	bool Get(const void *const ap_fontFace, const unsigned short a_glyphIndex, const float a_size, const float a_penX, ATLAS_GLYPH &a_glyph);
+	// evicts all glyphs
+	void Clear();
+
+	// returns false if no row has changed. `a_bottom` is exclusive
+	bool GetDirtyRows(int &a_top, int &a_bottom);
+	void ClearDirtyRows();
+	// all rows are uploaded again, for example after the bitmap has been recreated
+	void InvalidateRows();
+
+	const unsigned char *const GetPixels();
+	const int GetWidth();
+	const int GetHeight();
+	const unsigned int GetSubpixelCount();
+	const unsigned int GetGeneration();
+	ATLAS_STATISTICS GetStatistics();
+
+protected:
+	unsigned long long GetKey(const void *const ap_fontFace, const unsigned short a_glyphIndex, const float a_size, const unsigned char a_subpixel);
+	void AddDirtyRows(const int a_top, const int a_bottom);
+};
+
+#endif //_GLYPH_ATLAS_H_
\ No newline at end of file
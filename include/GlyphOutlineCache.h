@@ -0,0 +1,67 @@
+#ifndef _GLYPH_OUTLINE_CACHE_H_
+#define _GLYPH_OUTLINE_CACHE_H_
+
+#include "VectorPath.h"
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+// the outline of a glyph relative to its origin on the baseline
+struct GLYPH_OUTLINE
+{
+	const void *p_fontFace;
+	unsigned short glyphIndex;
+	float size;
+	float advance;			// the default advance of the glyph
+	VECTOR_PATH path;
+	RRect bounds;			// the tight bounds of the path, set by the cache
+};
+
+// an interface which extracts glyph outlines for `GlyphOutlineCache`
+class GlyphOutliner
+{
+public:
+	virtual ~GlyphOutliner() {}
+
+	// returns false if the outline can't be extracted
+	virtual bool CreateOutline(const void *const ap_fontFace, const unsigned short a_glyphIndex, const float a_size, GLYPH_OUTLINE &a_outline) = 0;
+};
+
+// keeps the most recently used glyph outlines per (font face, glyph index, size)
+class GlyphOutlineCache
+{
+protected:
+	GlyphOutliner *mp_outliner;
+	unsigned int m_capacity;
+
+	std::list<GLYPH_OUTLINE> m_entries;				// the most recently used entry is the first one
+	std::unordered_multimap<unsigned long long, std::list<GLYPH_OUTLINE>::iterator> m_entryTable;
+
+	unsigned int m_hitCount;
+	unsigned int m_missCount;
+
+public:
+	GlyphOutlineCache(GlyphOutliner *const ap_outliner, const unsigned int a_capacity = 2048);
+	virtual ~GlyphOutlineCache();
+
+	// returns the cached outline or extracts a new one. returns nullptr if the outliner has failed.
+	// the entry is valid until the next call of `Get` or `Clear`
+	const GLYPH_OUTLINE *const Get(const void *const ap_fontFace, const unsigned short a_glyphIndex, const float a_size);
+	void Clear();
+
+	void SetCapacity(const unsigned int a_capacity);
+	const unsigned int GetCount();
+	const unsigned int GetHitCount();
+	const unsigned int GetMissCount();
+
+protected:
+	unsigned long long GetKey(const void *const ap_fontFace, const unsigned short a_glyphIndex, const float a_size);
+	void RemoveLastEntry();
+};
+
+// decodes UTF-16 into code points. an unpaired surrogate becomes U+FFFD.
+// `a_codePoints` keeps its storage, so a reused vector doesn't allocate after the first calls
+void DecodeUtf16(const wchar_t *const ap_text, const size_t a_length, std::vector<unsigned int> &a_codePoints);
+
+#endif //_GLYPH_OUTLINE_CACHE_H_
\ No newline at end of file
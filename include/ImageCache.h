@@ -0,0 +1,115 @@
+#ifndef _IMAGE_CACHE_H_
+#define _IMAGE_CACHE_H_
+
+#include "ImageDecoder.h"
+#include "ImageResampler.h"
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+class TaskScheduler;
+
+struct IMAGE_KEY
+{
+	std::wstring path;
+	unsigned int width;
+	unsigned int height;
+
+	bool operator==(const IMAGE_KEY &a_key) const
+	{
+		return width == a_key.width && height == a_key.height && path == a_key.path;
+	}
+};
+
+struct IMAGE_KEY_HASH
+{
+	size_t operator()(const IMAGE_KEY &a_key) const
+	{
+		return std::hash<std::wstring>()(a_key.path) ^ (static_cast<size_t>(a_key.width) * 0x9E3779B1 + a_key.height);
+	}
+};
+
+struct IMAGE_CACHE_STATISTICS
+{
+	unsigned long long hitCount;
+	unsigned long long missCount;		// requests which have started a decode
+	unsigned long long decodedCount;
+	unsigned long long resampledCount;	// the decoded images which were resampled from a larger image of the same path
+	unsigned long long failedCount;
+	unsigned long long evictedCount;
+};
+
+// decodes images on the worker threads and keeps them by path and target size until they exceed the byte budget.
+// the least recently requested images are evicted first. a smaller size of an image which is already decoded
+// is resampled from it instead of decoding the file again
+class ImageCache
+{
+protected:
+	enum IMAGE_STATE
+	{
+		IMAGE_PENDING,
+		IMAGE_READY,
+		IMAGE_FAILED
+	};
+
+	struct NOTIFY_ENTRY
+	{
+		void (*p_notify)(void *);
+		void *p_data;
+	};
+
+	struct IMAGE_ENTRY
+	{
+		IMAGE_STATE state;
+		std::shared_ptr<const IMAGE_PIXELS> p_image;
+		size_t byteCount;
+		std::list<IMAGE_KEY>::iterator lruPosition;		// valid unless the image is pending
+		std::vector<NOTIFY_ENTRY> notifies;				// called when the pending image has been decoded or failed
+	};
+
+	std::mutex m_mutex;
+	ImageDecoder *mp_decoder;
+	TaskScheduler *mp_scheduler;
+	size_t m_byteBudget;
+	size_t m_byteCount;
+	std::unordered_map<IMAGE_KEY, IMAGE_ENTRY, IMAGE_KEY_HASH> m_entries;
+	std::list<IMAGE_KEY> m_lruKeys;						// the most recently requested first, without the pending images
+	unsigned long long m_nextID;
+	IMAGE_CACHE_STATISTICS m_statistics;
+	ImageResampler m_resampler;
+
+public:
+	// without a scheduler the images are decoded at once on the calling thread.
+	// the scheduler has to be stopped before the cache is destroyed
+	ImageCache(ImageDecoder *const ap_decoder, TaskScheduler *const ap_scheduler = nullptr, const size_t a_byteBudget = 64 * 1024 * 1024);
+	virtual ~ImageCache();
+
+	// returns the image if it has been decoded, otherwise nullptr and starts decoding it if it isn't yet.
+	// `ap_notify` is called from a worker thread once the pending image has been decoded or failed, also when the same
+	// notify and data have been passed several times meanwhile
+	std::shared_ptr<const IMAGE_PIXELS> Request(
+		const wchar_t *const ap_path, const unsigned int a_width, const unsigned int a_height,
+		void (*ap_notify)(void *) = nullptr, void *const ap_notifyData = nullptr
+	);
+
+	// the images in use stay alive until they are released, even when they have been evicted
+	void SetByteBudget(const size_t a_byteBudget);
+	const size_t GetByteBudget();
+	const size_t GetByteCount();
+	// removes all images except the pending ones, so failed images are tried again
+	void Clear();
+
+	IMAGE_CACHE_STATISTICS GetStatistics();
+	void ResetStatistics();
+
+protected:
+	void Decode(const IMAGE_KEY &a_key);
+	// has to be called with the lock. returns the smallest decoded image of the path which covers the size of the key
+	std::shared_ptr<const IMAGE_PIXELS> FindLargerImage(const IMAGE_KEY &a_key);
+	// has to be called with the lock. keeps at least the most recent image even if it exceeds the budget alone
+	void Evict();
+};
+
+#endif //_IMAGE_CACHE_H_
\ No newline at end of file
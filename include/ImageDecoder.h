@@ -0,0 +1,47 @@
+#ifndef _IMAGE_DECODER_H_
+#define _IMAGE_DECODER_H_
+
+#include <vector>
+
+// decoded pixels in premultiplied BGRA, 4 bytes per pixel without padding between the rows
+struct IMAGE_PIXELS
+{
+	unsigned int width;
+	unsigned int height;
+	std::vector<unsigned char> pixels;
+	unsigned long long id;				// set by `ImageCache`, unique among the images which it has decoded
+};
+
+// decodes image files on worker threads, possibly several at once
+class ImageDecoder
+{
+public:
+	virtual ~ImageDecoder() {}
+
+	// a target size of 0 keeps the size of the image. if only one side is 0, it keeps the aspect ratio
+	virtual bool Decode(const wchar_t *const ap_path, const unsigned int a_width, const unsigned int a_height, IMAGE_PIXELS &a_image) = 0;
+};
+
+// resolves a target size of `ImageDecoder::Decode` against the size of an image
+void GetTargetSize(
+	const unsigned int a_width, const unsigned int a_height, const unsigned int a_targetWidth, const unsigned int a_targetHeight,
+	unsigned int &a_resultWidth, unsigned int &a_resultHeight
+);
+// multiplies the color channels of straight BGRA pixels by their alpha
+void PremultiplyPixels(IMAGE_PIXELS &a_image);
+
+// decodes binary PPM files and uncompressed 24 and 32 bit BMP files without any platform codec
+class StandInImageDecoder : public ImageDecoder
+{
+public:
+	StandInImageDecoder();
+	virtual ~StandInImageDecoder();
+
+	virtual bool Decode(const wchar_t *const ap_path, const unsigned int a_width, const unsigned int a_height, IMAGE_PIXELS &a_image) override;
+
+protected:
+	bool DecodePPM(const std::vector<unsigned char> &a_data, IMAGE_PIXELS &a_image);
+	bool DecodeBMP(const std::vector<unsigned char> &a_data, IMAGE_PIXELS &a_image);
+};
+
+#endif //_IMAGE_DECODER_H_
\ No newline at end of file
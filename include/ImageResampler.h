@@ -0,0 +1,67 @@
+#ifndef _IMAGE_RESAMPLER_H_
+#define _IMAGE_RESAMPLER_H_
+
+#include "ImageDecoder.h"
+#include <vector>
+
+class TaskScheduler;
+
+enum RESAMPLE_FILTER
+{
+	RESAMPLE_BOX,
+	RESAMPLE_BILINEAR,
+	RESAMPLE_LANCZOS3
+};
+
+enum RESAMPLE_KERNEL
+{
+	RESAMPLE_KERNEL_SCALAR,
+	RESAMPLE_KERNEL_SSE2,
+	RESAMPLE_KERNEL_AVX2
+};
+
+// the contributions of the source pixels to each target pixel along one axis
+struct RESAMPLE_TAPS
+{
+	unsigned int tapCount;						// the same for every target pixel, the unused taps weigh 0
+	std::vector<unsigned int> starts;			// the first source pixel of each target pixel
+	std::vector<short> weights;					// `tapCount` weights of each target pixel in 14 bit fixed point
+};
+
+// scales premultiplied BGRA pixels with a separable filter, first along the rows and then along the columns.
+// the target is split into bands of rows which can be resampled on several threads
+class ImageResampler
+{
+protected:
+	RESAMPLE_FILTER m_filter;
+	RESAMPLE_KERNEL m_kernel;
+
+public:
+	// the best kernel which the processor supports is chosen
+	ImageResampler(const RESAMPLE_FILTER a_filter = RESAMPLE_LANCZOS3);
+	virtual ~ImageResampler();
+
+	void SetFilter(const RESAMPLE_FILTER a_filter);
+	const RESAMPLE_FILTER GetFilter();
+	// a lower kernel can be chosen to compare it with the others. a kernel which isn't supported is lowered
+	void SetKernel(const RESAMPLE_KERNEL a_kernel);
+	const RESAMPLE_KERNEL GetKernel();
+	static const RESAMPLE_KERNEL GetSupportedKernel();
+
+	// with a scheduler the workers resample the bands together with the calling thread, which returns
+	// once all bands are done. it can be called from a worker thread too
+	bool Resample(
+		const IMAGE_PIXELS &a_source, const unsigned int a_width, const unsigned int a_height, IMAGE_PIXELS &a_image,
+		TaskScheduler *const ap_scheduler = nullptr
+	);
+
+protected:
+	void ComputeTaps(const unsigned int a_sourceSize, const unsigned int a_targetSize, RESAMPLE_TAPS &a_taps);
+	// resamples the target rows from `a_firstRow` to `a_lastRow` without `a_lastRow`
+	void ResampleBand(
+		const IMAGE_PIXELS &a_source, const RESAMPLE_TAPS &a_columnTaps, const RESAMPLE_TAPS &a_rowTaps,
+		IMAGE_PIXELS &a_image, const unsigned int a_firstRow, const unsigned int a_lastRow
+	);
+};
+
+#endif //_IMAGE_RESAMPLER_H_
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef _INPUT_QUEUE_H_
+#define _INPUT_QUEUE_H_
+
+#include <vector>
+
+typedef enum INPUT_TYPE
+{
+	INPUT_POINTER_MOVE,		// coalesced with a previous move of the same button state
+	INPUT_WHEEL,			// the deltas are summed up
+	INPUT_RESIZE,			// only the last size is kept
+	INPUT_OTHER				// buttons, keys and characters are never coalesced
+} INPUT_TYPE;
+
+// a raw position of the pointer
+struct INPUT_POINT
+{
+	float x;
+	float y;
+	unsigned long long time;		// microseconds
+};
+
+struct INPUT_EVENT
+{
+	INPUT_TYPE type;
+	unsigned int messageID;			// the platform message and its parameters of the last coalesced event
+	unsigned long long wordParam;
+	long long longParam;
+	unsigned long long time;		// microseconds
+	float x;						// the pointer position or the new size
+	float y;
+	int delta;						// the summed up wheel delta
+	unsigned int modifiers;			// the state of the buttons and the keys. only equal states are coalesced
+	unsigned int coalescedCount;	// the number of raw events in this event
+	unsigned int historyIndex;		// the raw points of a pointer move in `INPUT_BATCH::points`
+	unsigned int historyCount;
+};
+
+struct INPUT_BATCH
+{
+	std::vector<INPUT_EVENT> events;
+	std::vector<INPUT_POINT> points;
+	unsigned int rawCount;			// the number of raw events before the coalescing
+
+	void Clear()
+	{
+		events.clear();
+		points.clear();
+		rawCount = 0;
+	}
+};
+
+// collects input events and coalesces the redundant ones until they are taken as one batch.
+// only the last event of the queue is coalesced, so the order of the events is kept
+class InputQueue
+{
+protected:
+	INPUT_BATCH m_batch;
+	unsigned long long m_rawCount;
+	unsigned long long m_deliveredCount;
+
+public:
+	InputQueue();
+	virtual ~InputQueue();
+
+	// `ap_history` are the raw points of a pointer move before the position of the event, oldest first
+	void Push(const INPUT_EVENT &a_event, const INPUT_POINT *const ap_history = nullptr, const unsigned int a_historyCount = 0);
+	const bool IsEmpty();
+	// moves the queued events to `a_batch`. the previous storage of `a_batch` is reused by the queue
+	void TakeBatch(INPUT_BATCH &a_batch);
+	void Clear();
+
+	const unsigned long long GetRawCount();
+	const unsigned long long GetDeliveredCount();
+
+protected:
+	bool Coalesce(INPUT_EVENT &a_lastEvent, const INPUT_EVENT &a_event);
+	void AddHistory(INPUT_EVENT &a_event, const INPUT_EVENT &a_source, const INPUT_POINT *const ap_history, const unsigned int a_historyCount);
+};
+
+#endif //_INPUT_QUEUE_H_
\ No newline at end of file
@@ -0,0 +1,153 @@
+#ifndef _MESSAGE_DISPATCH_TABLE_H_
+#define _MESSAGE_DISPATCH_TABLE_H_
+
+#include <cstddef>
+#include <vector>
+
+// maps message IDs to handlers in constant time.
+// the IDs below `DenseCount` (the system messages below WM_USER) are an index of a flat array,
+// the other IDs (WM_USER, WM_APP and registered messages) are in a small open addressed table
+template<class Handler, unsigned int DenseCount = 0x0400>
+class MessageDispatchTable
+{
+protected:
+	struct SPARSE_ENTRY
+	{
+		unsigned int id;		// 0 is an empty slot, because every ID below `DenseCount` is in the flat array
+		Handler handler;
+	};
+
+	std::vector<Handler> m_denseHandlers;
+	std::vector<SPARSE_ENTRY> m_sparseEntries;	// linear probing, the size is a power of 2
+	unsigned int m_sparseCount;
+	unsigned int m_count;
+
+public:
+	MessageDispatchTable() :
+		m_denseHandlers(DenseCount, nullptr),
+		m_sparseEntries(8, SPARSE_ENTRY({ 0, nullptr }))
+	{
+		m_sparseCount = 0;
+		m_count = 0;
+	}
+
+	// returns nullptr if no handler is registered
+	Handler Get(const unsigned int a_id) const
+	{
+		if (a_id < DenseCount) {
+			return m_denseHandlers[a_id];
+		}
+
+		const size_t mask = m_sparseEntries.size() - 1;
+		for (size_t index = GetSlot(a_id, mask); m_sparseEntries[index].id; index = (index + 1) & mask) {
+			if (a_id == m_sparseEntries[index].id) {
+				return m_sparseEntries[index].handler;
+			}
+		}
+
+		return nullptr;
+	}
+
+	// replaces the handler of a registered ID. a nullptr handler removes the ID
+	void Set(const unsigned int a_id, const Handler a_handler)
+	{
+		if (nullptr == a_handler) {
+			Remove(a_id);
+			return;
+		}
+
+		if (a_id < DenseCount) {
+			if (nullptr == m_denseHandlers[a_id]) {
+				m_count++;
+			}
+			m_denseHandlers[a_id] = a_handler;
+			return;
+		}
+
+		// the load factor stays below 1/2, so a probe sequence is short
+		if ((m_sparseCount + 1) * 2 > m_sparseEntries.size()) {
+			Rehash(m_sparseEntries.size() * 2);
+		}
+
+		const size_t mask = m_sparseEntries.size() - 1;
+		size_t index = GetSlot(a_id, mask);
+		for (; m_sparseEntries[index].id; index = (index + 1) & mask) {
+			if (a_id == m_sparseEntries[index].id) {
+				m_sparseEntries[index].handler = a_handler;
+				return;
+			}
+		}
+
+		m_sparseEntries[index] = SPARSE_ENTRY({ a_id, a_handler });
+		m_sparseCount++;
+		m_count++;
+	}
+
+	void Remove(const unsigned int a_id)
+	{
+		if (a_id < DenseCount) {
+			if (m_denseHandlers[a_id]) {
+				m_denseHandlers[a_id] = nullptr;
+				m_count--;
+			}
+			return;
+		}
+
+		const size_t mask = m_sparseEntries.size() - 1;
+		size_t index = GetSlot(a_id, mask);
+		for (; m_sparseEntries[index].id; index = (index + 1) & mask) {
+			if (a_id == m_sparseEntries[index].id) {
+				break;
+			}
+		}
+		if (0 == m_sparseEntries[index].id) {
+			return;
+		}
+
+		// the following entries of the probe sequence are shifted back, so no tombstone is needed
+		size_t emptyIndex = index;
+		for (size_t nextIndex = (index + 1) & mask; m_sparseEntries[nextIndex].id; nextIndex = (nextIndex + 1) & mask) {
+			const size_t slot = GetSlot(m_sparseEntries[nextIndex].id, mask);
+			// the entry can move if its slot isn't cyclically between the empty index and itself
+			if (((nextIndex - slot) & mask) >= ((nextIndex - emptyIndex) & mask)) {
+				m_sparseEntries[emptyIndex] = m_sparseEntries[nextIndex];
+				emptyIndex = nextIndex;
+			}
+		}
+		m_sparseEntries[emptyIndex] = SPARSE_ENTRY({ 0, nullptr });
+
+		m_sparseCount--;
+		m_count--;
+	}
+
+	const unsigned int GetCount() const
+	{
+		return m_count;
+	}
+
+protected:
+	static size_t GetSlot(const unsigned int a_id, const size_t a_mask)
+	{
+		// the IDs are often consecutive, so they are spread by a multiplicative hash
+		return static_cast<size_t>((a_id * 2654435769u) >> 16) & a_mask;
+	}
+
+	void Rehash(const size_t a_size)
+	{
+		std::vector<SPARSE_ENTRY> entries(a_size, SPARSE_ENTRY({ 0, nullptr }));
+		entries.swap(m_sparseEntries);
+
+		const size_t mask = a_size - 1;
+		for (const SPARSE_ENTRY &entry : entries) {
+			if (entry.id) {
+				size_t index = GetSlot(entry.id, mask);
+				while (m_sparseEntries[index].id) {
+					index = (index + 1) & mask;
+				}
+				m_sparseEntries[index] = entry;
+			}
+		}
+	}
+};
+
+#endif //_MESSAGE_DISPATCH_TABLE_H_
\ No newline at end of file
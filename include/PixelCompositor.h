@@ -0,0 +1,50 @@
+#ifndef _PIXEL_COMPOSITOR_H_
+#define _PIXEL_COMPOSITOR_H_
+
+enum COMPOSITE_KERNEL
+{
+	COMPOSITE_KERNEL_SCALAR,
+	COMPOSITE_KERNEL_SSE2,
+	COMPOSITE_KERNEL_AVX2
+};
+
+// blends and converts rows of premultiplied BGRA pixels for layers, cached bitmaps and the software rasterizer.
+// every kernel returns exactly the pixels of the scalar one. the table lookups of `Unpremultiply` and
+// `BlendOverLinear` need the gathers of AVX2, so the SSE2 kernel uses the scalar code for them
+class PixelCompositor
+{
+protected:
+	COMPOSITE_KERNEL m_kernel;
+
+public:
+	// the best kernel which the processor supports is chosen
+	PixelCompositor();
+	virtual ~PixelCompositor();
+
+	// a lower kernel can be chosen to compare it with the others. a kernel which isn't supported is lowered
+	void SetKernel(const COMPOSITE_KERNEL a_kernel);
+	const COMPOSITE_KERNEL GetKernel();
+	static const COMPOSITE_KERNEL GetSupportedKernel();
+
+	// source-over: the target becomes the source plus the target scaled by the inverse alpha of the source.
+	// with a mask the source is scaled by the 8 bit coverage of each pixel first
+	void BlendOver(unsigned int *const ap_target, const unsigned int *const ap_source, const unsigned int a_count);
+	void BlendOver(
+		unsigned int *const ap_target, const unsigned int *const ap_source, const unsigned char *const ap_mask, const unsigned int a_count
+	);
+	// blends a premultiplied pixel over a span. an opaque pixel is stored without blending
+	void FillSpan(unsigned int *const ap_target, const unsigned int a_pixel, const unsigned int a_count);
+	void FillSpan(unsigned int *const ap_target, const unsigned int a_pixel, const unsigned char *const ap_mask, const unsigned int a_count);
+	// scales the pixels by the 8 bit coverage of each pixel
+	void ApplyMask(unsigned int *const ap_pixels, const unsigned char *const ap_mask, const unsigned int a_count);
+
+	void Premultiply(unsigned int *const ap_pixels, const unsigned int a_count);
+	// a color above its alpha becomes 255 and a transparent pixel becomes 0
+	void Unpremultiply(unsigned int *const ap_pixels, const unsigned int a_count);
+
+	// source-over in linear light, so a translucent color over another keeps its brightness.
+	// the pixels stay premultiplied sRGB, the colors are decoded and encoded through tables
+	void BlendOverLinear(unsigned int *const ap_target, const unsigned int *const ap_source, const unsigned int a_count);
+};
+
+#endif //_PIXEL_COMPOSITOR_H_
\ No newline at end of file
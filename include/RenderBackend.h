@@ -0,0 +1,134 @@
+#ifndef _RENDER_BACKEND_H_
+#define _RENDER_BACKEND_H_
+
+// portable counterparts of the Direct2D types. they have the same memory layout as
+// D2D1_POINT_2F, D2D1_RECT_F, D2D1_COLOR_F and D2D1_MATRIX_3X2_F but don't need any windows header
+struct RENDER_POINT
+{
+	float x;
+	float y;
+};
+
+struct RENDER_RECT
+{
+	float left;
+	float top;
+	float right;
+	float bottom;
+};
+
+struct RENDER_COLOR
+{
+	float r;
+	float g;
+	float b;
+	float a;
+};
+
+struct RENDER_MATRIX
+{
+	float _11, _12;
+	float _21, _22;
+	float _31, _32;
+};
+
+#define RPoint	RENDER_POINT
+#define RRect	RENDER_RECT
+#define RColor	RENDER_COLOR
+#define RMatrix	RENDER_MATRIX
+
+inline RMatrix IdentityMatrix()
+{
+	return RMatrix({ 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f });
+}
+
+inline RPoint TransformPoint(const RMatrix &a_matrix, const RPoint &a_point)
+{
+	return RPoint({
+		a_point.x * a_matrix._11 + a_point.y * a_matrix._21 + a_matrix._31,
+		a_point.x * a_matrix._12 + a_point.y * a_matrix._22 + a_matrix._32
+	});
+}
+
+// returns the transform which applies `a_first` and then `a_second`
+inline RMatrix MultiplyMatrix(const RMatrix &a_first, const RMatrix &a_second)
+{
+	return RMatrix({
+		a_first._11 * a_second._11 + a_first._12 * a_second._21,
+		a_first._11 * a_second._12 + a_first._12 * a_second._22,
+		a_first._21 * a_second._11 + a_first._22 * a_second._21,
+		a_first._21 * a_second._12 + a_first._22 * a_second._22,
+		a_first._31 * a_second._11 + a_first._32 * a_second._21 + a_second._31,
+		a_first._31 * a_second._12 + a_first._32 * a_second._22 + a_second._32
+	});
+}
+
+// returns the overlapping part of two rectangles. the result is empty if they don't overlap
+inline RRect IntersectBounds(const RRect &a_rect, const RRect &a_otherRect)
+{
+	RRect rect = {
+		a_rect.left > a_otherRect.left ? a_rect.left : a_otherRect.left,
+		a_rect.top > a_otherRect.top ? a_rect.top : a_otherRect.top,
+		a_rect.right < a_otherRect.right ? a_rect.right : a_otherRect.right,
+		a_rect.bottom < a_otherRect.bottom ? a_rect.bottom : a_otherRect.bottom
+	};
+	rect.right = rect.right < rect.left ? rect.left : rect.right;
+	rect.bottom = rect.bottom < rect.top ? rect.top : rect.bottom;
+
+	return rect;
+}
+
+// returns the axis-aligned bounds of a transformed rectangle
+inline RRect TransformBounds(const RMatrix &a_matrix, const RRect &a_rect)
+{
+	const RPoint points[4] = {
+		TransformPoint(a_matrix, RPoint({ a_rect.left, a_rect.top })),
+		TransformPoint(a_matrix, RPoint({ a_rect.right, a_rect.top })),
+		TransformPoint(a_matrix, RPoint({ a_rect.right, a_rect.bottom })),
+		TransformPoint(a_matrix, RPoint({ a_rect.left, a_rect.bottom }))
+	};
+
+	RRect bounds = { points[0].x, points[0].y, points[0].x, points[0].y };
+	for (int i = 1; i < 4; i++) {
+		bounds.left = points[i].x < bounds.left ? points[i].x : bounds.left;
+		bounds.top = points[i].y < bounds.top ? points[i].y : bounds.top;
+		bounds.right = points[i].x > bounds.right ? points[i].x : bounds.right;
+		bounds.bottom = points[i].y > bounds.bottom ? points[i].y : bounds.bottom;
+	}
+
+	return bounds;
+}
+
+// an interface which receives the primitives of `Direct2D` instead of the render target.
+// all colors are straight (not premultiplied) and all coordinates are in DIPs before the transform
+class RenderBackend
+{
+public:
+	virtual ~RenderBackend() {}
+
+	virtual void BeginDraw() = 0;
+	virtual void EndDraw() = 0;
+	virtual void Clear(const RColor &a_color) = 0;
+
+	virtual void SetColor(const RColor &a_color) = 0;
+	virtual void SetStrokeWidth(const float a_strokeWidth) = 0;
+	virtual void SetTransform(const RMatrix &a_transform) = 0;
+	// limits the drawing to a rectangle in pixels. the transform isn't applied to it
+	virtual void SetClipRect(const RRect &a_rect) = 0;
+	virtual void ResetClipRect() = 0;
+
+	virtual void DrawLine(const RPoint &a_startPoint, const RPoint &a_endPoint) = 0;
+	virtual void DrawRectangle(const RRect &a_rect) = 0;
+	virtual void DrawRoundedRectangle(const RRect &a_rect, const float a_radius) = 0;
+	virtual void DrawEllipse(const RRect &a_rect) = 0;
+	// strokes every contour as an open polyline. a closed contour repeats its first point at the end
+	virtual void DrawPolyline(const RPoint *const ap_points, const unsigned int *const ap_contourSizes, const unsigned int a_contourCount) = 0;
+
+	virtual void FillRectangle(const RRect &a_rect) = 0;
+	virtual void FillRoundedRectangle(const RRect &a_rect, const float a_radius) = 0;
+	virtual void FillEllipse(const RRect &a_rect) = 0;
+	// fills all contours together with the non-zero winding rule
+	virtual void FillPolygon(const RPoint *const ap_points, const unsigned int *const ap_contourSizes, const unsigned int a_contourCount) = 0;
+};
+
+#endif //_RENDER_BACKEND_H_
\ No newline at end of file
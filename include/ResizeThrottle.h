@@ -0,0 +1,52 @@
+#ifndef _RESIZE_THROTTLE_H_
+#define _RESIZE_THROTTLE_H_
+
+struct RESIZE_STATISTICS
+{
+	unsigned long long requestCount;	// the sizes which the window has reported
+	unsigned long long appliedCount;	// the sizes which the render target has been resized to
+	unsigned long long droppedCount;	// the sizes which have been replaced by a newer one before they were applied
+};
+
+// decides when a new size of a window is applied to its render target. outside a live resize every size is applied
+// at once. during a live resize at most one size per interval is applied, the others wait and only the newest one
+// is kept, so dragging the frame of a window doesn't resize the render target for every mouse move
+class ResizeThrottle
+{
+protected:
+	unsigned long long m_interval;		// microseconds between two applied sizes during a live resize
+	bool m_isLiveResize;
+	bool m_isPending;
+	unsigned int m_pendingWidth;
+	unsigned int m_pendingHeight;
+	unsigned int m_width;				// the size which has been applied last
+	unsigned int m_height;
+	unsigned long long m_applyTime;
+	RESIZE_STATISTICS m_statistics;
+
+public:
+	ResizeThrottle(const unsigned long long a_interval = 33333);
+	virtual ~ResizeThrottle();
+
+	void SetInterval(const unsigned long long a_interval);
+	void BeginLiveResize();
+	// returns true if the waiting size has to be applied now
+	bool EndLiveResize(const unsigned long long a_time);
+	// returns true if the size has to be applied now. otherwise it waits until `Poll` or `EndLiveResize`
+	bool Request(const unsigned int a_width, const unsigned int a_height, const unsigned long long a_time);
+	// called periodically during a live resize. returns true if the waiting size has to be applied now
+	bool Poll(const unsigned long long a_time);
+
+	// the size to apply after a call which has returned true
+	const unsigned int GetWidth();
+	const unsigned int GetHeight();
+	const bool IsLiveResize();
+	const unsigned long long GetInterval();
+	const RESIZE_STATISTICS &GetStatistics();
+	void ResetStatistics();
+
+protected:
+	void Apply(const unsigned int a_width, const unsigned int a_height, const unsigned long long a_time);
+};
+
+#endif //_RESIZE_THROTTLE_H_
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef _SKYLINE_PACKER_H_
+#define _SKYLINE_PACKER_H_
+
+#include <cstddef>
+#include <vector>
+
+// a horizontal segment of the skyline. the space above `y` is free
+struct SKYLINE_NODE
+{
+	int x;
+	int y;
+	int width;
+};
+
+// packs rectangles into a fixed area with the bottom-left skyline heuristic.
+// the rectangles can't be removed one by one, only the whole area can be reset
+class SkylinePacker
+{
+protected:
+	int m_width;
+	int m_height;
+	std::vector<SKYLINE_NODE> m_skyline;		// sorted by x and covers the whole width
+	unsigned long long m_usedArea;
+	unsigned int m_rectCount;
+
+public:
+	SkylinePacker(const int a_width = 1024, const int a_height = 1024);
+	virtual ~SkylinePacker();
+
+	// returns false if the rectangle doesn't fit anymore
+	bool Insert(const int a_width, const int a_height, int &a_x, int &a_y);
+	void Reset();
+	void Reset(const int a_width, const int a_height);
+
+	const int GetWidth();
+	const int GetHeight();
+	const unsigned int GetRectCount();
+	const unsigned long long GetUsedArea();
+	// the used area in relation to the whole area between 0 and 1
+	const float GetOccupancy();
+
+protected:
+	// returns the y position of the rectangle placed on the node or -1 if it doesn't fit there
+	int GetFitPosition(const size_t a_index, const int a_width, const int a_height);
+	void AddNode(const size_t a_index, const int a_x, const int a_y, const int a_width, const int a_height);
+};
+
+#endif //_SKYLINE_PACKER_H_
\ No newline at end of file
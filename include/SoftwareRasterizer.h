@@ -0,0 +1,117 @@
+#ifndef _SOFTWARE_RASTERIZER_H_
+#define _SOFTWARE_RASTERIZER_H_
+
+#include "RenderBackend.h"
+#include "PixelCompositor.h"
+#include <vector>
+
+// a portable anti-aliased rasterizer which draws into a premultiplied BGRA8 pixel buffer.
+// every primitive is converted to polygons, the polygon edges are accumulated into coverage cells
+// and each scanline is swept to blend constant coverage runs as spans.
+class SoftwareRasterizer : public RenderBackend
+{
+protected:
+	struct RASTER_CELL
+	{
+		int x;
+		int y;
+		float cover;		// signed height of the edges crossing the cell
+		float area;			// signed height weighted by the horizontal position of the edges in the cell
+	};
+
+	unsigned int *mp_pixels;
+	int m_width;
+	int m_height;
+	int m_stride;						// the number of pixels of a row
+	bool m_isOwnBuffer;
+
+	// the part of the buffer which can be drawn and which bounds every clip rectangle
+	int m_limitLeft;
+	int m_limitTop;
+	int m_limitRight;
+	int m_limitBottom;
+	// the clip rectangle in pixels (exclusive right and bottom)
+	int m_clipLeft;
+	int m_clipTop;
+	int m_clipRight;
+	int m_clipBottom;
+
+	RColor m_color;
+	unsigned int m_solidPixel;			// the premultiplied pixel of `m_color` with full coverage
+	float m_strokeWidth;
+	RMatrix m_transform;
+	float m_tolerance;					// the maximum distance between a curve and its flattened polygon in pixels
+	PixelCompositor m_compositor;
+
+	// scratch buffers which are reused between primitives
+	std::vector<RPoint> m_points;
+	std::vector<unsigned int> m_contourSizes;
+	std::vector<RASTER_CELL> m_cells;
+	std::vector<RASTER_CELL> m_sortedCells;
+	std::vector<unsigned int> m_rowOffsets;
+
+public:
+	SoftwareRasterizer(const int a_width, const int a_height);
+	// draws into a buffer of the user. `a_stride` is the number of pixels of a row
+	SoftwareRasterizer(unsigned int *const ap_pixels, const int a_width, const int a_height, const int a_stride);
+	virtual ~SoftwareRasterizer();
+
+	unsigned int *const GetPixels();
+	const int GetWidth();
+	const int GetHeight();
+	const int GetStride();
+
+	// the right and bottom sides are exclusive
+	void SetClipRect(const int a_left, const int a_top, const int a_right, const int a_bottom);
+	// limits the drawing to a part of the buffer, so rasterizers of different parts can share a buffer. resets the clip rectangle
+	void SetLimitRect(const int a_left, const int a_top, const int a_right, const int a_bottom);
+	void SetTolerance(const float a_tolerance);
+
+	virtual void BeginDraw() override;
+	virtual void EndDraw() override;
+	virtual void Clear(const RColor &a_color) override;
+
+	virtual void SetColor(const RColor &a_color) override;
+	virtual void SetStrokeWidth(const float a_strokeWidth) override;
+	virtual void SetTransform(const RMatrix &a_transform) override;
+	// the partially covered pixels of the rectangle are included
+	virtual void SetClipRect(const RRect &a_rect) override;
+	virtual void ResetClipRect() override;
+
+	virtual void DrawLine(const RPoint &a_startPoint, const RPoint &a_endPoint) override;
+	virtual void DrawRectangle(const RRect &a_rect) override;
+	virtual void DrawRoundedRectangle(const RRect &a_rect, const float a_radius) override;
+	virtual void DrawEllipse(const RRect &a_rect) override;
+	virtual void DrawPolyline(const RPoint *const ap_points, const unsigned int *const ap_contourSizes, const unsigned int a_contourCount) override;
+
+	virtual void FillRectangle(const RRect &a_rect) override;
+	virtual void FillRoundedRectangle(const RRect &a_rect, const float a_radius) override;
+	virtual void FillEllipse(const RRect &a_rect) override;
+	virtual void FillPolygon(const RPoint *const ap_points, const unsigned int *const ap_contourSizes, const unsigned int a_contourCount) override;
+
+protected:
+	// path building in user space. the points are transformed when they are added
+	void AddPoint(const float a_x, const float a_y);
+	void CloseContour(const unsigned int a_startIndex);
+	// adds an elliptic arc around (a_centerX, a_centerY). the angles are in radians
+	void AddArc(const float a_centerX, const float a_centerY, const float a_radiusX, const float a_radiusY, const float a_startAngle, const float a_sweepAngle);
+	void AddRoundedRectangle(const RRect &a_rect, const float a_radiusX, const float a_radiusY, const bool a_isReversed);
+	void AddEllipse(const RRect &a_rect, const bool a_isReversed);
+	// adds a stroke of a segment with round caps. the joins of a polyline become round as well
+	void AddCapsule(const RPoint &a_startPoint, const RPoint &a_endPoint, const float a_halfWidth);
+	int GetArcSegmentCount(const float a_radius, const float a_sweepAngle);
+	const bool IsAxisAligned();
+
+	// rasterizes the current path and clears it
+	void FillPath();
+	void AddEdge(float a_x0, float a_y0, float a_x1, float a_y1);
+	void AddClippedEdge(float a_x0, float a_y0, float a_x1, float a_y1);
+	void AddCellEdge(const int a_row, float a_x0, float a_y0, float a_x1, float a_y1);
+	void SweepCells();
+
+	void BlendSpan(const int a_y, const int a_x, const int a_length, const float a_coverage);
+	// fills an axis-aligned rectangle in pixels with anti-aliased borders
+	void FillPixelRect(float a_left, float a_top, float a_right, float a_bottom);
+};
+
+#endif //_SOFTWARE_RASTERIZER_H_
\ No newline at end of file
@@ -0,0 +1,47 @@
+#ifndef _STARTUP_TIMELINE_H_
+#define _STARTUP_TIMELINE_H_
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct STARTUP_PHASE
+{
+	std::wstring name;
+	unsigned long long startTime;		// microseconds since the timeline has been created
+	unsigned long long duration;		// 0 for a mark
+	bool isBackground;					// the phase ran on another thread than the one which has created the timeline
+};
+
+// records how long each phase of the startup took, from any thread
+class StartupTimeline
+{
+protected:
+	std::mutex m_mutex;
+	std::chrono::steady_clock::time_point m_originTime;
+	std::thread::id m_mainThreadID;
+	std::vector<STARTUP_PHASE> m_phases;
+	unsigned long long m_finishTime;	// 0 until `Finish`
+
+public:
+	StartupTimeline();
+	virtual ~StartupTimeline();
+
+	// microseconds since the timeline has been created
+	const unsigned long long GetTime();
+	// adds a phase which has started at `a_startTime` of `GetTime` and ends now
+	void AddPhase(const wchar_t *const ap_name, const unsigned long long a_startTime);
+	// adds a mark at the current time
+	void AddMark(const wchar_t *const ap_name);
+	// marks the end of the startup, for example the first paint. only the first call counts
+	void Finish(const wchar_t *const ap_name);
+
+	const bool IsFinished();
+	const unsigned long long GetFinishTime();
+	// a copy of the phases in the order of their end
+	std::vector<STARTUP_PHASE> GetPhases();
+};
+
+#endif //_STARTUP_TIMELINE_H_
\ No newline at end of file
@@ -0,0 +1,72 @@
+#ifndef _TASK_QUEUE_H_
+#define _TASK_QUEUE_H_
+
+#include <atomic>
+#include <utility>
+
+// a queued task. the queue links the nodes without any other allocation
+class TaskNode
+{
+public:
+	std::atomic<TaskNode *> mp_next;
+
+public:
+	TaskNode() : mp_next(nullptr) {}
+	virtual ~TaskNode() {}
+
+	virtual void Run() {}
+};
+
+template<class Task>
+class CallableTaskNode : public TaskNode
+{
+protected:
+	Task m_task;
+
+public:
+	CallableTaskNode(Task &&a_task) : m_task(std::move(a_task)) {}
+
+	virtual void Run() override
+	{
+		m_task();
+	}
+};
+
+// a lock-free queue which many threads post to and one thread drains.
+// the tasks are move-only callables without parameters, they run in the order of posting per thread
+class TaskQueue
+{
+protected:
+	std::atomic<TaskNode *> mp_head;				// the last posted node, changed by the producers
+	TaskNode *mp_tail;								// the next node to run, changed by the consumer only
+	TaskNode m_stub;
+	std::atomic<unsigned int> m_pendingCount;
+
+	unsigned long long m_runCount;
+
+public:
+	TaskQueue();
+	virtual ~TaskQueue();
+
+	// can be called from any thread. returns true if the queue was empty, then the consumer has to be woken
+	template<class Task>
+	bool Post(Task &&a_task)
+	{
+		return Push(new CallableTaskNode<typename std::decay<Task>::type>(std::forward<Task>(a_task)));
+	}
+
+	// runs the tasks on the consumer thread until the queue is empty or the budget in microseconds is used up.
+	// a budget of 0 runs all tasks. returns the number of tasks which have run
+	unsigned int Drain(const unsigned int a_budget = 0);
+	// returns whether a posted task hasn't run yet
+	const bool HasPendingTask();
+	const unsigned long long GetRunCount();
+
+protected:
+	bool Push(TaskNode *const ap_node);
+	// returns nullptr if the queue is empty or a producer hasn't finished linking its node yet
+	TaskNode *Pop();
+	void PushNode(TaskNode *const ap_node);
+};
+
+#endif //_TASK_QUEUE_H_
\ No newline at end of file
@@ -0,0 +1,122 @@
+#ifndef _TASK_SCHEDULER_H_
+#define _TASK_SCHEDULER_H_
+
+#include "TaskQueue.h"
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ResumeContext;
+
+// resumes a suspended coroutine when it runs. a task which is released without running destroys the coroutine,
+// so a coroutine never leaks when its queue goes away
+class ResumeTask
+{
+protected:
+	std::coroutine_handle<> m_handle;
+	std::shared_ptr<ResumeContext> mp_context;		// the coroutine is destroyed instead if the context has been closed
+
+public:
+	ResumeTask(const std::coroutine_handle<> a_handle, const std::shared_ptr<ResumeContext> &ap_context = nullptr);
+	ResumeTask(ResumeTask &&a_task);
+	ResumeTask(const ResumeTask &) = delete;
+	virtual ~ResumeTask();
+
+	void operator()();
+};
+
+// a pool of worker threads which runs tasks and coroutines in the order of posting
+class TaskScheduler
+{
+protected:
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::deque<TaskNode *> m_tasks;
+	bool m_isStopped;
+
+public:
+	// 0 threads use all processors except the one of the UI thread
+	TaskScheduler(const unsigned int a_threadCount = 0);
+	virtual ~TaskScheduler();
+
+	// can be called from any thread. the task is a move-only callable without parameters
+	template<class Task>
+	void Post(Task &&a_task)
+	{
+		Push(new CallableTaskNode<typename std::decay<Task>::type>(std::forward<Task>(a_task)));
+	}
+
+	const unsigned int GetThreadCount();
+
+protected:
+	void Push(TaskNode *const ap_node);
+	void WorkerProcedure();
+};
+
+// a thread which resumes coroutines through its `TaskQueue`, for example the thread of a window.
+// after `Close` no coroutine is resumed there anymore, they are destroyed instead
+class ResumeContext : public std::enable_shared_from_this<ResumeContext>
+{
+protected:
+	std::mutex m_mutex;
+	TaskQueue *mp_queue;
+	void (*mp_wake)(void *);		// called when a task is posted to the empty queue
+	void *mp_wakeData;
+	std::atomic<bool> m_isClosed;
+
+public:
+	ResumeContext(TaskQueue *const ap_queue, void (*ap_wake)(void *) = nullptr, void *const ap_wakeData = nullptr);
+	virtual ~ResumeContext();
+
+	// can be called from any thread
+	void Resume(const std::coroutine_handle<> a_handle);
+	// has to be called on the thread of the queue before the queue is destroyed
+	void Close();
+	const bool IsClosed();
+};
+
+// a coroutine which starts at once and releases itself at the end. nobody waits for it
+struct AsyncTask
+{
+	struct promise_type
+	{
+		AsyncTask get_return_object() { return AsyncTask(); }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+	};
+};
+
+// `co_await` continues the coroutine on a worker thread
+struct WORKER_AWAITER
+{
+	TaskScheduler *p_scheduler;
+
+	bool await_ready() const noexcept { return false; }
+	void await_suspend(std::coroutine_handle<> a_handle) const { p_scheduler->Post(ResumeTask(a_handle)); }
+	void await_resume() const noexcept {}
+};
+
+// `co_await` continues the coroutine on the thread of the context, or destroys it if the context has been closed
+struct CONTEXT_AWAITER
+{
+	std::shared_ptr<ResumeContext> p_context;
+
+	bool await_ready() const noexcept { return false; }
+	void await_suspend(std::coroutine_handle<> a_handle) const
+	{
+		// the coroutine can end on the other thread before `Resume` returns, so the awaiter isn't used anymore
+		const std::shared_ptr<ResumeContext> p_resumeContext = p_context;
+		p_resumeContext->Resume(a_handle);
+	}
+	void await_resume() const noexcept {}
+};
+
+#endif //_TASK_SCHEDULER_H_
\ No newline at end of file
@@ -0,0 +1,76 @@
+#ifndef _TESSELLATION_CACHE_H_
+#define _TESSELLATION_CACHE_H_
+
+#include "VectorPath.h"
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+// a path flattened for a range of scales. the points are in the coordinates of the path
+struct PATH_TESSELLATION
+{
+	unsigned long long pathID;
+	int scaleBucket;
+	float tolerance;						// the distance in the coordinates of the path which any scale of the bucket keeps below a pixel tolerance
+	std::vector<RPoint> points;
+	std::vector<unsigned int> contourSizes;
+	unsigned int filledContourCount;		// the filled figures come first
+	unsigned int filledPointCount;
+	bool isTriangulated;
+	std::vector<RPoint> triangles;			// the filled figures, three points per triangle
+};
+
+// owns vector paths by id and keeps their most recently used tessellations per (path id, scale bucket).
+// a bucket covers a quarter of an octave, so a path is flattened again only when its scale changes by more than about 19%
+class TessellationCache
+{
+protected:
+	struct PATH_ENTRY
+	{
+		VECTOR_PATH path;
+		RRect bounds;
+	};
+
+	std::unordered_map<unsigned long long, PATH_ENTRY> m_paths;
+	unsigned long long m_nextID;
+	float m_tolerance;
+	unsigned int m_capacity;
+
+	std::list<PATH_TESSELLATION> m_entries;		// the most recently used entry is the first one
+	std::unordered_map<unsigned long long, std::list<PATH_TESSELLATION>::iterator> m_entryTable;
+
+	unsigned int m_hitCount;
+	unsigned int m_missCount;
+
+public:
+	// `a_tolerance` is the largest distance in pixels between a curve and its polyline
+	TessellationCache(const unsigned int a_capacity = 256, const float a_tolerance = 0.25f);
+	virtual ~TessellationCache();
+
+	// returns the id of a copy of the path, which is never 0
+	unsigned long long AddPath(const VECTOR_PATH &a_path);
+	// removes the path with its tessellations
+	void RemovePath(const unsigned long long a_pathID);
+	// returns nullptr if there is no path of the id
+	const VECTOR_PATH *const GetPath(const unsigned long long a_pathID);
+	// returns the tight bounds of the path which are kept since it has been added
+	const bool GetBounds(const unsigned long long a_pathID, RRect &a_bounds);
+
+	// returns the cached tessellation for a transform of `a_scale` or flattens the path again. returns nullptr if there is no path.
+	// the triangles are created only if they are asked for. the entry is valid until the next call of `Get`, `RemovePath` or `Clear`
+	const PATH_TESSELLATION *const Get(const unsigned long long a_pathID, const float a_scale, const bool a_needsTriangles = false);
+	// removes the tessellations but keeps the paths
+	void Clear();
+
+	void SetCapacity(const unsigned int a_capacity);
+	const unsigned int GetCount();
+	const unsigned int GetHitCount();
+	const unsigned int GetMissCount();
+
+protected:
+	static int GetScaleBucket(const float a_scale);
+	static unsigned long long GetKey(const unsigned long long a_pathID, const int a_scaleBucket);
+	void RemoveEntry(const std::list<PATH_TESSELLATION>::iterator &a_entry);
+};
+
+#endif //_TESSELLATION_CACHE_H_
\ No newline at end of file
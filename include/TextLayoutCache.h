@@ -0,0 +1,79 @@
+#ifndef _TEXT_LAYOUT_CACHE_H_
+#define _TEXT_LAYOUT_CACHE_H_
+
+#include "DisplayList.h"
+#include <list>
+#include <string>
+#include <unordered_map>
+
+struct TEXT_METRICS
+{
+	float width;		// the width including the trailing whitespaces
+	float height;
+};
+
+// a prepared layout of a text with its metrics
+struct TEXT_LAYOUT_ENTRY
+{
+	std::wstring text;
+	DISPLAY_FONT font;
+	float maxWidth;
+	float maxHeight;
+	TEXT_METRICS metrics;
+	void *p_layout;		// the layout object of the measurer
+};
+
+// an interface which lays out texts for `TextLayoutCache`
+class TextMeasurer
+{
+public:
+	virtual ~TextMeasurer() {}
+
+	// returns the layout object of the text or nullptr if it has failed
+	virtual void *CreateLayout(
+		const wchar_t *const ap_text, const unsigned int a_length, const DISPLAY_FONT &a_font,
+		const float a_maxWidth, const float a_maxHeight, TEXT_METRICS &a_metrics
+	) = 0;
+	virtual void ReleaseLayout(void *const ap_layout) = 0;
+};
+
+// keeps the most recently used layouts. a lookup of a cached text doesn't allocate any memory
+class TextLayoutCache
+{
+protected:
+	TextMeasurer *mp_measurer;
+	unsigned int m_capacity;
+
+	std::list<TEXT_LAYOUT_ENTRY> m_entries;			// the most recently used entry is the first one
+	std::unordered_multimap<unsigned long long, std::list<TEXT_LAYOUT_ENTRY>::iterator> m_entryTable;
+
+	unsigned int m_hitCount;
+	unsigned int m_missCount;
+
+public:
+	TextLayoutCache(TextMeasurer *const ap_measurer, const unsigned int a_capacity = 512);
+	virtual ~TextLayoutCache();
+
+	// returns the cached layout of the text or prepares a new one. returns nullptr if the measurer has failed.
+	// the entry is valid until the next call of `Get` or `Clear`
+	const TEXT_LAYOUT_ENTRY *const Get(
+		const wchar_t *const ap_text, const unsigned int a_length, const DISPLAY_FONT &a_font,
+		const float a_maxWidth, const float a_maxHeight
+	);
+	// releases all layouts through the measurer
+	void Clear();
+
+	void SetCapacity(const unsigned int a_capacity);
+	const unsigned int GetCount();
+	const unsigned int GetHitCount();
+	const unsigned int GetMissCount();
+
+protected:
+	unsigned long long GetHash(
+		const wchar_t *const ap_text, const unsigned int a_length, const DISPLAY_FONT &a_font,
+		const float a_maxWidth, const float a_maxHeight
+	);
+	void RemoveLastEntry();
+};
+
+#endif //_TEXT_LAYOUT_CACHE_H_
\ No newline at end of file
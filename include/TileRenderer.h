@@ -0,0 +1,61 @@
+#ifndef _TILE_RENDERER_H_
+#define _TILE_RENDERER_H_
+
+#include "DisplayList.h"
+#include <vector>
+
+class TaskScheduler;
+
+// rasterizes a display list into square tiles of a pixel buffer which don't depend on each other.
+// the commands are binned into the tiles which their bounds touch, and each tile is drawn by a `SoftwareRasterizer`
+// which is limited to it, so the threads share the buffer without locks. an edge which crosses a tile border is split there,
+// so a few pixels of a primitive which crosses a border can differ by 1 from an untiled replay
+class TileRenderer
+{
+protected:
+	// a range of tiles (exclusive right and bottom)
+	struct TILE_RANGE
+	{
+		int left;
+		int top;
+		int right;
+		int bottom;
+	};
+
+	int m_tileSize;
+	int m_columnCount;
+	int m_rowCount;
+
+	// the indices of the commands of each tile in the order of the list. the memory is kept for the next frame
+	std::vector<std::vector<unsigned int>> m_tileCommands;
+	std::vector<unsigned int> m_tileOrder;			// the tiles with the most commands come first
+	// the pushed clips while binning with the tiles which their push commands have been added to
+	std::vector<RRect> m_clipRects;
+	std::vector<TILE_RANGE> m_clipRanges;
+	unsigned int m_binnedCount;
+
+public:
+	TileRenderer(const int a_tileSize = 64);
+	virtual ~TileRenderer();
+
+	// with a scheduler the workers draw the tiles together with the calling thread, which returns
+	// once all tiles are done. `a_stride` is the number of pixels of a row
+	void Render(
+		const DisplayList &a_list, unsigned int *const ap_pixels, const int a_width, const int a_height, const int a_stride,
+		TaskScheduler *const ap_scheduler = nullptr
+	);
+
+	const int GetTileSize();
+	// the tiles of the last frame
+	const unsigned int GetTileCount();
+	// the commands which have been added to the tiles of the last frame, counted once per tile
+	const unsigned int GetBinnedCount();
+
+protected:
+	void BinCommands(const DisplayList &a_list);
+	// returns the tiles which the pixels of the bounds touch
+	const TILE_RANGE GetTileRange(const RRect &a_bounds);
+	void AddToTiles(const unsigned int a_commandIndex, const TILE_RANGE &a_range);
+};
+
+#endif //_TILE_RENDERER_H_
\ No newline at end of file
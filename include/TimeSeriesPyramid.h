@@ -0,0 +1,60 @@
+#ifndef _TIME_SERIES_PYRAMID_H_
+#define _TIME_SERIES_PYRAMID_H_
+
+#include "RenderBackend.h"
+#include <vector>
+
+// the part of a time series which is drawn and the rectangle which it is mapped to.
+// the larger values are drawn upward
+struct TIME_SERIES_VIEW
+{
+	double firstX;
+	double lastX;
+	float minY;
+	float maxY;
+	RRect rect;
+	unsigned int columnCount;			// usually the width of the rectangle in pixels
+};
+
+// the samples of a time series with the indices of their minimum and maximum over blocks of 2, 4, 8 and more samples,
+// so the polyline of any range is reduced to a few points per pixel column in O(columns * log(samples)).
+// each column keeps its first, minimum, maximum and last sample (M4), which rasterizes the same pixels as all samples
+// without antialiasing. an antialiased column can lose some coverage at its sides
+class TimeSeriesPyramid
+{
+protected:
+	std::vector<double> m_xValues;		// empty if the samples are uniform
+	std::vector<float> m_yValues;
+	double m_firstX;
+	double m_stepX;
+	// level k keeps the blocks of 2^(k + 1) samples
+	std::vector<std::vector<unsigned int>> m_minIndices;
+	std::vector<std::vector<unsigned int>> m_maxIndices;
+
+public:
+	TimeSeriesPyramid();
+	virtual ~TimeSeriesPyramid();
+
+	// the x values must not decrease and no value may be NaN
+	void SetSamples(const double *const ap_xValues, const float *const ap_yValues, const unsigned int a_count);
+	// the x value of sample i is `a_firstX + i * a_stepX`
+	void SetUniformSamples(const double a_firstX, const double a_stepX, const float *const ap_yValues, const unsigned int a_count);
+
+	const unsigned int GetCount();
+	const double GetX(const unsigned int a_index);
+	const float GetY(const unsigned int a_index);
+	// the first sample whose x value isn't less than `a_x`, or the count if there is none
+	const unsigned int FindIndex(const double a_x);
+	// the indices of the minimum and the maximum of the samples from `a_first` to `a_last` without `a_last`
+	void FindRange(unsigned int a_first, const unsigned int a_last, unsigned int &a_minIndex, unsigned int &a_maxIndex);
+
+	// replaces the points with the reduced polyline of a view in the coordinates of its rectangle.
+	// the samples right before and after the view are included so the polyline leaves the rectangle at its sides
+	void Reduce(const TIME_SERIES_VIEW &a_view, std::vector<RPoint> &a_points);
+
+protected:
+	void BuildLevels();
+	const RPoint ToViewPoint(const TIME_SERIES_VIEW &a_view, const unsigned int a_index);
+};
+
+#endif //_TIME_SERIES_PYRAMID_H_
\ No newline at end of file
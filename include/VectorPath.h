@@ -0,0 +1,58 @@
+#ifndef _VECTOR_PATH_H_
+#define _VECTOR_PATH_H_
+
+#include "RenderBackend.h"
+#include <vector>
+
+typedef enum PATH_COMMAND
+{
+	PATH_BEGIN_FILLED,		// takes 1 point
+	PATH_BEGIN_HOLLOW,		// takes 1 point
+	PATH_LINE,				// takes 1 point
+	PATH_BEZIER,			// takes 3 points
+	PATH_END_OPEN,
+	PATH_END_CLOSED,
+	PATH_QUADRATIC			// takes 2 points
+} PATH_COMMAND;
+
+// figures of lines and quadratic or cubic beziers which can be replayed with any offset
+struct VECTOR_PATH
+{
+	std::vector<unsigned char> commands;
+	std::vector<RPoint> points;
+};
+
+// the part of a row which is inside a filled polygon
+struct PATH_SPAN
+{
+	float y;
+	float left;
+	float right;
+};
+
+// returns the largest factor by which a transform stretches a length
+float GetMatrixScale(const RMatrix &a_matrix);
+
+// returns the tight bounds of the curves, not of their control points. an empty path has empty bounds at the origin
+RRect GetPathBounds(const VECTOR_PATH &a_path);
+
+// flattens the figures into polylines which are at most `a_tolerance` away from the curves.
+// the filled figures come first and the closed figures repeat their first point at the end,
+// so the first `a_filledContourCount` contours can be filled and all contours can be stroked
+void FlattenPath(
+	const VECTOR_PATH &a_path, const float a_tolerance,
+	std::vector<RPoint> &a_points, std::vector<unsigned int> &a_contourSizes, unsigned int &a_filledContourCount
+);
+
+// split polygons into triangles or into spans of the rows with the non-zero winding rule like `RenderBackend::FillPolygon`.
+// every three points of `a_triangles` are a triangle. the spans are sampled at the centers of rows of `a_rowHeight`
+void TessellatePolygon(
+	const RPoint *const ap_points, const unsigned int *const ap_contourSizes, const unsigned int a_contourCount,
+	std::vector<RPoint> &a_triangles
+);
+void TessellateSpans(
+	const RPoint *const ap_points, const unsigned int *const ap_contourSizes, const unsigned int a_contourCount,
+	const float a_rowHeight, std::vector<PATH_SPAN> &a_spans
+);
+
+#endif //_VECTOR_PATH_H_
\ No newline at end of file
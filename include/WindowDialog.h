@@ -3,8 +3,15 @@
 
 #include "framework.h"
 #include "targetver.h"
-#include <map>
 #include <Direct2DEx.h>
+#include "MessageDispatchTable.h"
+#include "InputQueue.h"
+#include "TaskScheduler.h"
+#include "FrameLoop.h"
+#include "FrameExchange.h"
+#include "ResizeThrottle.h"
+#include <thread>
+#include <vector>
 
 // type modifier for message handlers
 #ifndef msg_handler
@@ -15,7 +22,7 @@ class WindowDialog; // for typedef of 'MessageHandler'
 
 typedef int (WindowDialog:: *MessageHandler)(WPARAM, LPARAM);
 
-class WindowDialog
+class WindowDialog : protected FrameClock, protected MessageSource, protected FrameHandler
 {
 public:
     enum THEME_MODE
@@ -30,7 +37,7 @@ protected:
     int m_showType;                         // the initial output state of the application
     
     HWND mh_window;                         // to save the main window handle
-    std::map<unsigned int, MessageHandler> m_messageMap;
+    MessageDispatchTable<MessageHandler> m_messageMap;  // the handlers of the messages below WM_USER are found by index
 
     Direct2DEx *mp_direct2d;
     THEME_MODE m_themeMode;
@@ -39,6 +46,36 @@ protected:
     unsigned long m_style;
     unsigned long m_extendStyle;
 
+    bool m_isRetainedPaint;                 // whether `OnPaint` is recorded and drawn only when the frame has changed
+    DisplayList m_frameList;
+    DisplayList m_prevFrameList;            // the last frame which was drawn in the retained paint mode
+    unsigned int m_prevFrameGeneration;     // the device generation of `Direct2D` when the last frame was drawn
+
+    bool m_isThreadedRendering;             // `OnPaint` is recorded and drawn by `m_renderThread`
+    FrameExchange<DisplayList> m_frameExchange;
+    std::thread m_renderThread;             // owns the render target of the window while threaded rendering is enabled
+    std::atomic<unsigned long long> m_renderSize;   // the width and the height for the render thread in the high and the low 32 bits
+
+    ResizeThrottle m_resizeThrottle;        // limits the resizing of the render target while the frame of the window is dragged
+
+    bool m_isInputBatched;                  // the pointer moves and the wheels are queued and delivered once per frame to `OnInputBatch`
+    bool m_isPointerHistory;                // the pointer moves carry the raw points of `GetMouseMovePointsEx`
+    bool m_isDeliveringInput;
+    InputQueue m_inputQueue;
+    INPUT_BATCH m_inputBatch;
+    std::vector<INPUT_POINT> m_pointerHistory;
+    DWORD m_lastMoveTime;                   // the message time of the last queued pointer move
+
+    TaskQueue m_taskQueue;                  // the tasks which other threads have posted to this window
+    HANDLE mh_taskEvent;
+    unsigned int m_taskBudget;              // the time in microseconds which `Run` spends on the tasks between two message checks
+    std::shared_ptr<ResumeContext> mp_resumeContext;    // resumes the coroutines through `m_taskQueue` until the window is destroyed
+
+    FrameLoop m_frameLoop;                  // runs the frames while an animation is active and blocks otherwise
+    unsigned int m_frameRate;               // 0 follows the refresh rate of the display
+    bool m_isTimerPeriodRaised;             // the system timer runs at 1ms while the frames are paced
+    int m_exitCode;                         // the exit code of the WM_QUIT message
+
 public:
     static LRESULT CALLBACK WindowProcedure(HWND ah_window, UINT a_messageID, WPARAM a_wordParam, LPARAM a_longParam);
 
@@ -59,6 +96,48 @@ public:
     void SetExtendStyle(const unsigned long a_extendStyle);
     int SetThemeMode(const THEME_MODE a_mode);
     void InheritDirect2D(Direct2DEx *const ap_direct2d);
+    // records the drawing calls of `OnPaint` and skips the drawing if they are equal to the previous frame
+    void EnableRetainedPaint(const bool a_isEnabled);
+    // records `OnPaint` on the window thread and draws the frames on a render thread, so a slow drawing doesn't block
+    // the messages. it has to be called before `InitInstance` and needs `ApplicationCore::Create(true)`, otherwise the
+    // window paints on its own thread. `a_isTripleBuffered` drops the frames which the render thread can't keep up with,
+    // without it `OnPaint` waits for the render thread
+    void EnableThreadedRendering(const bool a_isEnabled, const bool a_isTripleBuffered = true);
+    // queues the pointer moves and the wheels which have a handler, coalesces the redundant ones and delivers them before
+    // the next paint. any other message with a handler delivers the queue first and is handled at once, a message without
+    // a handler goes to `DefWindowProc`. `a_isPointerHistory` adds the raw points between two pointer moves for drawing applications
+    void EnableInputBatching(const bool a_isEnabled, const bool a_isPointerHistory = false);
+    // 0 runs all pending tasks at once
+    void SetTaskBudget(const unsigned int a_budget);
+    // the frames per second of the animations. 0 follows the refresh rate of the display
+    void SetFrameRate(const unsigned int a_frameRate);
+    // the fixed step mode updates the animations in steps of `a_fixedStep` microseconds, 0 is one frame
+    void SetFrameStep(const FRAME_STEP_MODE a_mode, const unsigned long long a_fixedStep = 0);
+    // `Run` calls `OnFrameUpdate` and paints the window every frame between these calls. they can be nested
+    void BeginAnimation();
+    void EndAnimation();
+    const FRAME_STATISTICS &GetFrameStatistics();
+    // the microseconds between two resizes of the render target while the frame of the window is dragged
+    void SetResizeInterval(const unsigned long long a_interval);
+    const RESIZE_STATISTICS &GetResizeStatistics();
+
+    // can be called from any thread. the task is a move-only callable without parameters and runs on the thread of `Run`
+    template<class Task>
+    void PostTask(Task &&a_task)
+    {
+        // only the first task of an empty queue wakes the thread
+        if (m_taskQueue.Post(std::forward<Task>(a_task))) {
+            ::SetEvent(mh_taskEvent);
+        }
+    }
+    // `co_await SwitchToWorker()` continues a coroutine on a worker thread of the application
+    WORKER_AWAITER SwitchToWorker();
+    // `co_await SwitchToWindow()` continues a coroutine on the thread of `Run`. if the window has been destroyed meanwhile,
+    // the coroutine is destroyed instead. the awaiter keeps the window context, so it can be taken on the window thread
+    // before switching to a worker and awaited later even if the window object has been deleted
+    CONTEXT_AWAITER SwitchToWindow();
+    // returns whether the coroutines of this window are destroyed instead of resumed
+    const bool IsTaskCanceled();
     const THEME_MODE GetThemeMode();
 
     void DisableMove();
@@ -82,6 +161,33 @@ public:
     virtual void OnDestroy();
     virtual void OnPaint();
     virtual void OnSetThemeMode();
+    // handles the queued input of a frame. every event is dispatched to its message handler by default
+    virtual void OnInputBatch(const INPUT_BATCH &a_batch);
+    // advances the animations by the step in seconds
+    virtual void OnFrameUpdate(const double a_step) override;
+    // paints the window at once by default. a recorded paint draws only the commands which have changed,
+    // otherwise the area which `OnFrameUpdate` has invalidated is painted, or the whole window if nothing is invalidated
+    virtual void OnFrameRender(const double a_alpha) override;
+
+protected:
+    // returns false if the message isn't a pointer move or a wheel
+    bool QueueInput(const UINT a_messageID, const WPARAM a_wordParam, const LPARAM a_longParam);
+    void DeliverInput();
+    // draws the commands which differ from the previous frame and swaps the frames
+    void DrawFrame(Direct2DEx *const ap_direct2d, DisplayList &a_frameList, DisplayList &a_prevFrameList, unsigned int &a_prevGeneration);
+    void RenderProcedure();
+    void StopRenderThread();
+    // follows WM_SIZE, WM_ENTERSIZEMOVE and WM_EXITSIZEMOVE before the message handlers see them
+    void TrackResize(const UINT a_messageID, const WPARAM a_wordParam, const LPARAM a_longParam);
+    void ApplySize();
+
+    static void CALLBACK ResizeTimerProcedure(HWND ah_window, UINT a_messageID, UINT_PTR a_timerID, DWORD a_time);
+
+    virtual const unsigned long long GetTime() override;
+    virtual bool PumpMessages() override;
+    virtual void WaitMessage(const unsigned long long a_timeout, const bool a_isInfinite) override;
+
+    static void WakeProcedure(void *ap_event);
 };
 
 #endif //_WINDOW_DIALOG_H_ 
\ No newline at end of file
@@ -1,4 +1,9 @@
 #include "ApplicationCore.h"
+#include "FontCache.h"
+#include "TaskScheduler.h"
+#include "StartupTimeline.h"
+#include "ImageCache.h"
+#include "Direct2DEx.h"
 
 // to use D2D functions
 #pragma comment(lib, "D2D1.lib")	// to draw
@@ -6,68 +11,122 @@
 
 ApplicationCore *gp_appCore;
 
+namespace
+{
+	// initializes COM once on each worker thread which decodes an image
+	class COM_APARTMENT
+	{
+	protected:
+		bool m_isInitialized;
+
+	public:
+		COM_APARTMENT()
+		{
+			m_isInitialized = SUCCEEDED(CoInitializeEx(nullptr, COINIT_MULTITHREADED));
+		}
+
+		~COM_APARTMENT()
+		{
+			if (m_isInitialized) {
+				CoUninitialize();
+			}
+		}
+	};
+}
+
 ApplicationCore::ApplicationCore(HINSTANCE ah_instance)
 {
 	mh_instance = ah_instance;
 	gp_appCore = this;
+	// the startup is measured from the construction of the application
+	mp_startupTimeline = new StartupTimeline();
 
 	mp_factory = nullptr;
 	mp_wirteFactory = nullptr;
 	mp_wicFactory = nullptr;
+	mp_fontCache = nullptr;
+	mp_taskScheduler = nullptr;
+	mp_imageCache = nullptr;
+	m_isMultiThreaded = false;
 }
 
 ApplicationCore::~ApplicationCore()
 {
+	// the workers are joined first, a running task may still use the factories
+	if (mp_taskScheduler) {
+		delete mp_taskScheduler;
+	}
+
+	// the cached objects are released before their factory
+	if (mp_imageCache) {
+		delete mp_imageCache;
+	}
+	if (mp_fontCache) {
+		delete mp_fontCache;
+	}
+
 	InterfaceRelease(&mp_factory);
 	InterfaceRelease(&mp_wirteFactory);
 	InterfaceRelease(&mp_wicFactory);
 
+	delete mp_startupTimeline;
+
 	CoUninitialize();
 }
 
-const int ApplicationCore::Create()
+const int ApplicationCore::Create(const bool a_isMultiThreaded)
 {
+	unsigned long long startTime = mp_startupTimeline->GetTime();
 	// call a function to initialize COM	
 	int hResult = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
 	if (S_OK != hResult) {
 		return hResult;
 	}
+	mp_startupTimeline->AddPhase(L"COM", startTime);
 
-	// create a factory instance to use D2D
-	hResult = D2D1CreateFactory(D2D1_FACTORY_TYPE_SINGLE_THREADED, &mp_factory);
+	// create a factory instance to use D2D. the multi-threaded factory serializes the calls of all threads
+	startTime = mp_startupTimeline->GetTime();
+	hResult = D2D1CreateFactory(
+		a_isMultiThreaded ? D2D1_FACTORY_TYPE_MULTI_THREADED : D2D1_FACTORY_TYPE_SINGLE_THREADED,
+		&mp_factory
+	);
 	if (S_OK != hResult) {
 		CoUninitialize();
 
 		return hResult;
 	}
+	m_isMultiThreaded = a_isMultiThreaded;
+	mp_startupTimeline->AddPhase(L"Direct2D factory", startTime);
 
-	// create a write factory instance for string output
-	hResult = DWriteCreateFactory(
-		DWRITE_FACTORY_TYPE_SHARED,
-		__uuidof(mp_wirteFactory),
-		reinterpret_cast<IUnknown **>(&mp_wirteFactory)
-	);
-	if (S_OK != hResult) {
-		mp_factory->Release();
-		CoUninitialize();
+	// the write factory and the imaging factory are created on their first use, see `GetWriteFactory`
+	mp_fontCache = new FontCache();
+	mp_taskScheduler = new TaskScheduler();
+	mp_imageCache = new ImageCache(this, mp_taskScheduler);
 
-		return hResult;
-	}
-	
-	// an object that creates various window imaging components
-	hResult = CoCreateInstance(
-		CLSID_WICImagingFactory, nullptr,
-		CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&mp_wicFactory)
-	);
-	if (S_OK != hResult) {
-		mp_factory->Release();
-		mp_wirteFactory->Release();
-		CoUninitialize();
+	return S_OK;
+}
 
-		return hResult;
+void ApplicationCore::Prewarm(const FONT_FORMAT *const ap_formats, const unsigned int a_count)
+{
+	std::vector<FONT_FORMAT> formats;
+	if (ap_formats) {
+		formats.assign(ap_formats, ap_formats + a_count);
+	}
+	else {
+		// the font which `Direct2DEx` uses by default
+		formats.push_back(FONT_FORMAT({ DEFAULT_FONT_NAME, 20.0f }));
 	}
 
-	return S_OK;
+	mp_taskScheduler->Post([this, formats = std::move(formats)]() {
+		// the write factory is created here if the window thread doesn't need it first
+		if (!GetWriteFactory()) {
+			return;
+		}
+
+		const unsigned long long startTime = mp_startupTimeline->GetTime();
+		mp_fontCache->WarmUp(formats.data(), static_cast<unsigned int>(formats.size()));
+		mp_startupTimeline->AddPhase(L"font warm-up", startTime);
+	});
 }
 
 ID2D1Factory *const ApplicationCore::GetFactory()
@@ -77,15 +136,146 @@ ID2D1Factory *const ApplicationCore::GetFactory()
 
 IDWriteFactory *const ApplicationCore::GetWriteFactory()
 {
+	// the worker of `Prewarm` and the window thread can ask for it at the same time
+	std::call_once(m_writeFactoryFlag, [this]() {
+		const unsigned long long startTime = mp_startupTimeline->GetTime();
+		// create a write factory instance for string output
+		if (S_OK != DWriteCreateFactory(
+			DWRITE_FACTORY_TYPE_SHARED,
+			__uuidof(mp_wirteFactory),
+			reinterpret_cast<IUnknown **>(&mp_wirteFactory)
+		)) {
+			mp_wirteFactory = nullptr;
+			return;
+		}
+		mp_startupTimeline->AddPhase(L"DirectWrite factory", startTime);
+	});
+
 	return mp_wirteFactory;
 }
 
 IWICImagingFactory *const ApplicationCore::GetWICFactory()
 {
+	// the calling thread must have initialized COM
+	std::call_once(m_wicFactoryFlag, [this]() {
+		const unsigned long long startTime = mp_startupTimeline->GetTime();
+		// an object that creates various window imaging components
+		if (S_OK != CoCreateInstance(
+			CLSID_WICImagingFactory, nullptr,
+			CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&mp_wicFactory)
+		)) {
+			mp_wicFactory = nullptr;
+			return;
+		}
+		mp_startupTimeline->AddPhase(L"WIC factory", startTime);
+	});
+
 	return mp_wicFactory;
 }
 
+FontCache *const ApplicationCore::GetFontCache()
+{
+	return mp_fontCache;
+}
+
+TaskScheduler *const ApplicationCore::GetTaskScheduler()
+{
+	return mp_taskScheduler;
+}
+
+StartupTimeline *const ApplicationCore::GetStartupTimeline()
+{
+	return mp_startupTimeline;
+}
+
+ImageCache *const ApplicationCore::GetImageCache()
+{
+	return mp_imageCache;
+}
+
 const HINSTANCE ApplicationCore::GetHandleInstance()
 {
 	return mh_instance;
+}
+
+const bool ApplicationCore::IsMultiThreaded()
+{
+	return m_isMultiThreaded;
+}
+
+bool ApplicationCore::Decode(const wchar_t *const ap_path, const unsigned int a_width, const unsigned int a_height, IMAGE_PIXELS &a_image)
+{
+	static thread_local COM_APARTMENT apartment;
+
+	IWICImagingFactory *const p_wicFactory = GetWICFactory();
+	if (!p_wicFactory) {
+		return false;
+	}
+
+	IWICBitmapDecoder *p_decoder;
+	if (S_OK != p_wicFactory->CreateDecoderFromFilename(ap_path, nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, &p_decoder)) {
+		return false;
+	}
+
+	IWICBitmapFrameDecode *p_frame;
+	const HRESULT frameResult = p_decoder->GetFrame(0, &p_frame);
+	InterfaceRelease(&p_decoder);
+	if (S_OK != frameResult) {
+		return false;
+	}
+
+	unsigned int width;
+	unsigned int height;
+	if (S_OK != p_frame->GetSize(&width, &height)) {
+		InterfaceRelease(&p_frame);
+
+		return false;
+	}
+	GetTargetSize(width, height, a_width, a_height, a_image.width, a_image.height);
+
+	// the scaler runs before the conversion so that only the pixels of the target size are converted
+	IWICBitmapSource *p_source = p_frame;
+	if (a_image.width != width || a_image.height != height) {
+		IWICBitmapScaler *p_scaler;
+		if (S_OK != p_wicFactory->CreateBitmapScaler(&p_scaler)) {
+			InterfaceRelease(&p_frame);
+
+			return false;
+		}
+		const HRESULT scaleResult = p_scaler->Initialize(p_frame, a_image.width, a_image.height, WICBitmapInterpolationModeFant);
+		// the scaler keeps its own reference of the frame
+		InterfaceRelease(&p_frame);
+		p_source = p_scaler;
+		if (S_OK != scaleResult) {
+			InterfaceRelease(&p_source);
+
+			return false;
+		}
+	}
+
+	// the bitmaps of Direct2D use premultiplied BGRA
+	IWICFormatConverter *p_converter;
+	if (S_OK != p_wicFactory->CreateFormatConverter(&p_converter)) {
+		InterfaceRelease(&p_source);
+
+		return false;
+	}
+	const HRESULT convertResult = p_converter->Initialize(
+		p_source, GUID_WICPixelFormat32bppPBGRA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom
+	);
+	InterfaceRelease(&p_source);
+	if (S_OK != convertResult) {
+		InterfaceRelease(&p_converter);
+
+		return false;
+	}
+
+	const unsigned int stride = a_image.width * 4;
+	a_image.pixels.resize(static_cast<size_t>(stride) * a_image.height);
+	const HRESULT copyResult = p_converter->CopyPixels(
+		nullptr, stride, static_cast<unsigned int>(a_image.pixels.size()), a_image.pixels.data()
+	);
+	InterfaceRelease(&p_converter);
+
+	return S_OK == copyResult;
 }
\ No newline at end of file
@@ -1,8 +1,150 @@
 #include "Direct2D.h"
 #include "ColorPalette.h"
+#include "ImageCache.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <cwchar>
 
 extern ApplicationCore *gp_appCore;
 
+namespace
+{
+	// the bitmaps which the current frame hasn't drawn are released above this count
+	const size_t MAX_BITMAP_COUNT = 256;
+	// the miter limit of the default stroke style, which is the ratio of the miter length to half the stroke width
+	const float DEFAULT_MITER_LIMIT = 10.0f;
+	const float SQUARE_CAP_FACTOR = 1.4143f;
+
+	// collects the flattened figures of a geometry
+	class PolygonSink : public ID2D1SimplifiedGeometrySink
+	{
+	protected:
+		std::vector<RPoint> &m_points;
+		std::vector<unsigned int> &m_contourSizes;
+		size_t m_figureStart;
+		bool m_isFilled;
+		bool m_isHollow;
+
+	public:
+		PolygonSink(std::vector<RPoint> &a_points, std::vector<unsigned int> &a_contourSizes, const bool a_isFilled) :
+			m_points(a_points), m_contourSizes(a_contourSizes)
+		{
+			m_figureStart = 0;
+			m_isFilled = a_isFilled;
+			m_isHollow = false;
+		}
+
+		// the sink lives on the stack only during `Simplify`
+		HRESULT STDMETHODCALLTYPE QueryInterface(REFIID a_interfaceID, void **ap_object) override
+		{
+			if (__uuidof(ID2D1SimplifiedGeometrySink) == a_interfaceID || __uuidof(IUnknown) == a_interfaceID) {
+				*ap_object = this;
+				return S_OK;
+			}
+
+			*ap_object = nullptr;
+			return E_NOINTERFACE;
+		}
+		ULONG STDMETHODCALLTYPE AddRef() override { return 1; }
+		ULONG STDMETHODCALLTYPE Release() override { return 1; }
+
+		void STDMETHODCALLTYPE SetFillMode(D2D1_FILL_MODE a_fillMode) override {}
+		void STDMETHODCALLTYPE SetSegmentFlags(D2D1_PATH_SEGMENT a_vertexFlags) override {}
+
+		void STDMETHODCALLTYPE BeginFigure(D2D1_POINT_2F a_startPoint, D2D1_FIGURE_BEGIN a_figureBegin) override
+		{
+			m_figureStart = m_points.size();
+			m_isHollow = D2D1_FIGURE_BEGIN_HOLLOW == a_figureBegin;
+			m_points.push_back(ToRenderPoint(a_startPoint));
+		}
+
+		void STDMETHODCALLTYPE AddLines(const D2D1_POINT_2F *ap_points, UINT32 a_pointsCount) override
+		{
+			for (UINT32 i = 0; i < a_pointsCount; i++) {
+				m_points.push_back(ToRenderPoint(ap_points[i]));
+			}
+		}
+
+		// `Simplify` is called with lines only, the end points are enough for any other case
+		void STDMETHODCALLTYPE AddBeziers(const D2D1_BEZIER_SEGMENT *ap_beziers, UINT32 a_beziersCount) override
+		{
+			for (UINT32 i = 0; i < a_beziersCount; i++) {
+				m_points.push_back(ToRenderPoint(ap_beziers[i].point3));
+			}
+		}
+
+		void STDMETHODCALLTYPE EndFigure(D2D1_FIGURE_END a_figureEnd) override
+		{
+			if (m_isFilled && m_isHollow) {
+				m_points.resize(m_figureStart);
+				return;
+			}
+
+			if (!m_isFilled && D2D1_FIGURE_END_CLOSED == a_figureEnd) {
+				const RPoint startPoint = m_points[m_figureStart];
+				m_points.push_back(startPoint);
+			}
+			m_contourSizes.push_back(static_cast<unsigned int>(m_points.size() - m_figureStart));
+		}
+
+		HRESULT STDMETHODCALLTYPE Close() override
+		{
+			return S_OK;
+		}
+	};
+
+	COLOR_KEY ToColorKey(const DColor &a_color)
+	{
+		COLOR_KEY key;
+		memcpy(key.bits, &a_color, sizeof(key.bits));
+		return key;
+	}
+
+	// FNV-1a over the bytes of the cache keys
+	unsigned long long HashBytes(const void *const ap_data, const size_t a_size, unsigned long long a_hash = 14695981039346656037ULL)
+	{
+		const unsigned char *const p_bytes = static_cast<const unsigned char *>(ap_data);
+		for (size_t i = 0; i < a_size; i++) {
+			a_hash = (a_hash ^ p_bytes[i]) * 1099511628211ULL;
+		}
+		return a_hash;
+	}
+
+	// returns whether only the cache holds the object
+	bool IsUnusedResource(IUnknown *const ap_resource)
+	{
+		ap_resource->AddRef();
+		return 1 == ap_resource->Release();
+	}
+}
+
+bool STROKE_STYLE_KEY::operator==(const STROKE_STYLE_KEY &a_key) const
+{
+	return 0 == memcmp(&properties, &a_key.properties, sizeof(D2D1_STROKE_STYLE_PROPERTIES)) &&
+		dashes.size() == a_key.dashes.size() && 0 == memcmp(dashes.data(), a_key.dashes.data(), sizeof(float) * dashes.size());
+}
+
+size_t StrokeStyleKeyHash::operator()(const STROKE_STYLE_KEY &a_key) const
+{
+	const unsigned long long hash = HashBytes(&a_key.properties, sizeof(D2D1_STROKE_STYLE_PROPERTIES));
+	return static_cast<size_t>(HashBytes(a_key.dashes.data(), sizeof(float) * a_key.dashes.size(), hash));
+}
+
+bool GRADIENT_STOP_KEY::operator==(const GRADIENT_STOP_KEY &a_key) const
+{
+	return gamma == a_key.gamma && extendMode == a_key.extendMode && stops.size() == a_key.stops.size() &&
+		0 == memcmp(stops.data(), a_key.stops.data(), sizeof(D2D1_GRADIENT_STOP) * stops.size());
+}
+
+size_t GradientStopKeyHash::operator()(const GRADIENT_STOP_KEY &a_key) const
+{
+	unsigned long long hash = HashBytes(a_key.stops.data(), sizeof(D2D1_GRADIENT_STOP) * a_key.stops.size());
+	hash = HashBytes(&a_key.gamma, sizeof(a_key.gamma), hash);
+	return static_cast<size_t>(HashBytes(&a_key.extendMode, sizeof(a_key.extendMode), hash));
+}
+
 Direct2D::Direct2D(const HWND ah_window, const RECT *const ap_viewRect) :
 	mh_window(ah_window)
 {
@@ -13,20 +155,47 @@ Direct2D::Direct2D(const HWND ah_window, const RECT *const ap_viewRect) :
 	else {
 		mp_viewRect = nullptr;
 	}
+	m_isRecorder = false;
+	m_isWindowRegionOwner = true;
 
 	mp_renderTarget = nullptr;
+	mp_hwndRenderTarget = nullptr;
 	mp_brush = nullptr;
+	mp_solidBrush = nullptr;
 	mp_strokeStyle = nullptr;
+	mp_backend = nullptr;
+	mp_displayList = nullptr;
+	m_deviceGeneration = 0;
+	mp_clipGeometry = nullptr;
+	// everything is drawn until the region of a frame is known
+	m_drawRegion.AddAll();
+	UpdateDrawExtent();
 
 	m_brushColor = RGB_TO_COLORF(NEUTRAL_50);
 	m_backgroundColor = RGB_TO_COLORF(NEUTRAL_800);
 	m_strokeWidth = 1.0f;
+	m_transform = D2D1::Matrix3x2F::Identity();
+	m_stateStatistics = { 0, 0 };
+	m_drawStatistics = { 0, 0, 0 };
+	m_recordClipCount = 0;
+	m_strokeStyleStatistics = { 0, 0 };
+	m_gradientStopStatistics = { 0, 0 };
+	m_bitmapStatistics = { 0, 0 };
+	m_frameIndex = 0;
 }
 
 Direct2D::~Direct2D()
 {
 	DestroyDeviceResources();
 
+	for (DRAWING_STATE &state : m_stateStack) {
+		InterfaceRelease(&state.p_brush);
+		InterfaceRelease(&state.p_strokeStyle);
+	}
+	for (auto &strokeStylePair : m_strokeStyleCache) {
+		InterfaceRelease(&strokeStylePair.second);
+	}
+
 	if (mp_viewRect) {
 		delete mp_viewRect;
 	}
@@ -42,19 +211,109 @@ int Direct2D::Create()
 		*mp_viewRect = viewRect;
 	}
 
+	const RRect bounds = {
+		0.0f, 0.0f,
+		static_cast<float>(mp_viewRect->right - mp_viewRect->left),
+		static_cast<float>(mp_viewRect->bottom - mp_viewRect->top)
+	};
+	m_dirtyRegion.SetBounds(bounds);
+	m_drawRegion.SetBounds(bounds);
+	UpdateDrawExtent();
+
 	return static_cast<int>(CreateDeviceResources());
 }
 
+void Direct2D::SetRecorder(const bool a_isRecorder)
+{
+	m_isRecorder = a_isRecorder;
+}
+
+void Direct2D::SetWindowRegionOwner(const bool a_isOwner)
+{
+	m_isWindowRegionOwner = a_isOwner;
+}
+
+HRESULT Direct2D::Resize(const unsigned int a_width, const unsigned int a_height)
+{
+	if (!mp_viewRect) {
+		return E_FAIL;
+	}
+
+	mp_viewRect->right = mp_viewRect->left + static_cast<LONG>(a_width);
+	mp_viewRect->bottom = mp_viewRect->top + static_cast<LONG>(a_height);
+
+	const RRect bounds = { 0.0f, 0.0f, static_cast<float>(a_width), static_cast<float>(a_height) };
+	m_dirtyRegion.SetBounds(bounds);
+	m_drawRegion.SetBounds(bounds);
+	UpdateDrawExtent();
+
+	HRESULT hResult = S_OK;
+	if (mp_hwndRenderTarget) {
+		if (S_OK != mp_hwndRenderTarget->Resize(D2D1::SizeU(a_width, a_height))) {
+			DestroyDeviceResources();
+			hResult = CreateDeviceResources();
+		}
+	}
+	// the content of the resized render target isn't valid anymore
+	m_deviceGeneration++;
+	InvalidateAll();
+
+	return hResult;
+}
+
 void Direct2D::BeginDraw()
 {
-	// disable the WM_PAINT flag
-	::ValidateRect(mh_window, nullptr);
+	if (mh_window && m_isWindowRegionOwner) {
+		AddUpdateRegion();
+		// disable the WM_PAINT flag
+		::ValidateRect(mh_window, nullptr);
+	}
+
+	// a frame without any invalidated rectangle draws the whole view
+	if (m_dirtyRegion.IsEmpty()) {
+		m_dirtyRegion.AddAll();
+	}
+	m_drawRegion.Swap(m_dirtyRegion);
+	m_dirtyRegion.Reset();
+	UpdateDrawExtent();
+	m_stateStatistics = { 0, 0 };
+	m_drawStatistics = { 0, 0, 0 };
+	m_frameIndex++;
+
+	if (mp_backend) {
+		mp_backend->BeginDraw();
+		PushDrawRegionClip();
+		return;
+	}
 
 	mp_renderTarget->BeginDraw();
+	PushDrawRegionClip();
 }
 
 void Direct2D::EndDraw()
 {
+	// the clips must be popped before the render target ends drawing. the states which haven't been popped hold references
+	for (DRAWING_STATE &state : m_stateStack) {
+		InterfaceRelease(&state.p_brush);
+		InterfaceRelease(&state.p_strokeStyle);
+	}
+	m_stateStack.clear();
+	while (!m_clipRects.empty()) {
+		PopClipRect();
+	}
+	PopDrawRegionClip();
+	m_drawRegion.AddAll();
+	UpdateDrawExtent();
+
+	if (mp_backend) {
+		mp_backend->EndDraw();
+		return;
+	}
+
+	if (m_bitmapCache.size() > MAX_BITMAP_COUNT) {
+		ReleaseUnusedBitmaps();
+	}
+
 	if (D2DERR_RECREATE_TARGET == mp_renderTarget->EndDraw()) {
 		DestroyDeviceResources();
 		if (S_OK != CreateDeviceResources()) {
@@ -62,17 +321,33 @@ void Direct2D::EndDraw()
 			return;
 		}
 
-		::InvalidateRect(mh_window, mp_viewRect, FALSE);
+		InvalidateAll();
 	}
 }
 
 void Direct2D::Clear()
 {
+	if (mp_displayList) {
+		mp_displayList->AddClear(ToRenderColor(m_backgroundColor));
+		return;
+	}
+
+	if (mp_backend) {
+		mp_backend->Clear(ToRenderColor(m_backgroundColor));
+		return;
+	}
+
 	mp_renderTarget->Clear(m_backgroundColor);
 }
 
 HRESULT Direct2D::CreateDeviceResources()
 {
+	// the recorded commands only need the device-independent resources
+	if (m_isRecorder) {
+		mp_strokeStyle = CreateUserStrokeStyle(D2D1_DASH_STYLE_SOLID);
+		return mp_strokeStyle ? S_OK : D2DERR_WIN32_ERROR;
+	}
+
 	// declaring a pointer for a window-based render target and to get its address
 	ID2D1HwndRenderTarget *p_hwndRenderTarget;
 	D2D1_RENDER_TARGET_PROPERTIES properties = D2D1::RenderTargetProperties();
@@ -85,12 +360,16 @@ HRESULT Direct2D::CreateDeviceResources()
 
 	auto factory = gp_appCore->GetFactory();
 	if (S_OK != factory->CreateHwndRenderTarget(
-		properties, D2D1::HwndRenderTargetProperties(mh_window, viewSize), &p_hwndRenderTarget
+		properties,
+		// the content outside the region of a frame is kept until the next frame
+		D2D1::HwndRenderTargetProperties(mh_window, viewSize, D2D1_PRESENT_OPTIONS_RETAIN_CONTENTS),
+		&p_hwndRenderTarget
 	)) {
 		return D2DERR_WIN32_ERROR;
 	}
 	// set its address to a parent interface if HwndRenderTagre is created
 	mp_renderTarget = p_hwndRenderTarget;
+	mp_renderTarget->SetTransform(m_transform);
 
 	ID2D1SolidColorBrush *p_solidBrush;
 	if (S_OK != mp_renderTarget->CreateSolidColorBrush(m_brushColor, &p_solidBrush)) {
@@ -99,28 +378,76 @@ HRESULT Direct2D::CreateDeviceResources()
 		return D2DERR_WIN32_ERROR;
 	}
 	mp_brush = p_solidBrush;
+	mp_solidBrush = p_solidBrush;
 
-	D2D1_STROKE_STYLE_PROPERTIES storkeStypeProperties = {
-		D2D1_CAP_STYLE_ROUND, D2D1_CAP_STYLE_ROUND,
-		D2D1_CAP_STYLE_ROUND, D2D1_LINE_JOIN_ROUND,
-		10.0f, D2D1_DASH_STYLE_SOLID, 0.0f
-	};
-
-	if (S_OK != factory->CreateStrokeStyle(storkeStypeProperties, nullptr, 0, &mp_strokeStyle)) {
+	mp_strokeStyle = CreateUserStrokeStyle(D2D1_DASH_STYLE_SOLID);
+	if (!mp_strokeStyle) {
 		InterfaceRelease(&mp_renderTarget);
 		InterfaceRelease(&mp_brush);
+		mp_solidBrush = nullptr;
 
 		return D2DERR_WIN32_ERROR;
 	}
+	mp_hwndRenderTarget = p_hwndRenderTarget;
+	m_deviceGeneration++;
+	// the content of a new render target is undefined
+	m_dirtyRegion.AddAll();
 
 	return S_OK;
 }
 
 void Direct2D::DestroyDeviceResources()
 {
+	mp_hwndRenderTarget = nullptr;
 	InterfaceRelease(&mp_renderTarget);
 	InterfaceRelease(&mp_brush);
+	mp_solidBrush = nullptr;
 	InterfaceRelease(&mp_strokeStyle);
+	InterfaceRelease(&mp_clipGeometry);
+
+	// the collections of the lost render target are created again when they are used
+	for (auto &collectionPair : m_gradientStopCache) {
+		InterfaceRelease(&collectionPair.second);
+	}
+	for (auto &bitmapPair : m_bitmapCache) {
+		InterfaceRelease(&bitmapPair.second.p_bitmap);
+	}
+	m_bitmapCache.clear();
+}
+
+ID2D1GradientStopCollection *const Direct2D::GetGradientStopCollection(
+	const D2D1_GRADIENT_STOP *const ap_stops, const unsigned int a_stopCount,
+	const D2D1_GAMMA a_gamma, const D2D1_EXTEND_MODE a_extendMode
+)
+{
+	// a recorder has no render target to create the device resources with
+	if (!mp_renderTarget) {
+		return nullptr;
+	}
+
+	m_gradientStopKey.stops.assign(ap_stops, ap_stops + a_stopCount);
+	m_gradientStopKey.gamma = a_gamma;
+	m_gradientStopKey.extendMode = a_extendMode;
+	const auto entryIterator = m_gradientStopCache.find(m_gradientStopKey);
+	if (m_gradientStopCache.end() != entryIterator && entryIterator->second) {
+		m_gradientStopStatistics.hitCount++;
+		return entryIterator->second;
+	}
+	m_gradientStopStatistics.missCount++;
+
+	ID2D1GradientStopCollection *p_collection = nullptr;
+	if (S_OK != mp_renderTarget->CreateGradientStopCollection(ap_stops, a_stopCount, a_gamma, a_extendMode, &p_collection)) {
+		return nullptr;
+	}
+
+	if (m_gradientStopCache.end() != entryIterator) {
+		entryIterator->second = p_collection;
+	}
+	else {
+		m_gradientStopCache.emplace(m_gradientStopKey, p_collection);
+	}
+
+	return p_collection;
 }
 
 ID2D1LinearGradientBrush *const Direct2D::CreateLinearGradientBrush(
@@ -129,56 +456,78 @@ ID2D1LinearGradientBrush *const Direct2D::CreateLinearGradientBrush(
 	const D2D1_LINEAR_GRADIENT_BRUSH_PROPERTIES *const a_gradientPositionData
 )
 {
-	ID2D1GradientStopCollection *p_gradientStop = nullptr;
-	HRESULT hResult = mp_renderTarget->CreateGradientStopCollection(
+	ID2D1GradientStopCollection *const p_gradientStop = GetGradientStopCollection(
 		a_gradientStopList, gradientStopsCount,
-		D2D1_GAMMA_2_2, D2D1_EXTEND_MODE_CLAMP,
-		&p_gradientStop
+		D2D1_GAMMA_2_2, D2D1_EXTEND_MODE_CLAMP
 	);
 
-	if (S_OK != hResult) {
+	if (nullptr == p_gradientStop) {
 		return nullptr;
 	}
 
 	ID2D1LinearGradientBrush *p_lineGradientBrush;
-	hResult = mp_renderTarget->CreateLinearGradientBrush(
+	HRESULT hResult = mp_renderTarget->CreateLinearGradientBrush(
 		*a_gradientPositionData, p_gradientStop, &p_lineGradientBrush
 	);
 	if (S_OK != hResult) {
 		p_lineGradientBrush = nullptr;
 	}
 
-	InterfaceRelease(&p_gradientStop);
-
 	return p_lineGradientBrush;
 }
 
 ID2D1StrokeStyle *const Direct2D::CreateUserStrokeStyle(
 	const D2D1_DASH_STYLE a_dashStyle, const D2D1_CAP_STYLE a_sideCap,
 	const D2D1_CAP_STYLE a_dashCap, const D2D1_LINE_JOIN a_lineJoin,
-	const float a_miterLimit, const float a_dashOffset
+	const float a_miterLimit, const float a_dashOffset, const float *const ap_dashes, const unsigned int a_dashCount
 )
 {
-	D2D1_STROKE_STYLE_PROPERTIES storkeStypeProperties = {
-		a_sideCap, a_sideCap, a_dashCap,
-		a_lineJoin, a_miterLimit, a_dashStyle,
-		a_dashOffset
+	STROKE_STYLE_KEY key = {
+		{
+			a_sideCap, a_sideCap, a_dashCap,
+			a_lineJoin, a_miterLimit, a_dashStyle,
+			a_dashOffset
+		},
+		std::vector<float>(ap_dashes, ap_dashes + a_dashCount)
 	};
 
+	const auto entryIterator = m_strokeStyleCache.find(key);
+	if (m_strokeStyleCache.end() != entryIterator) {
+		m_strokeStyleStatistics.hitCount++;
+		entryIterator->second->AddRef();
+
+		return entryIterator->second;
+	}
+	m_strokeStyleStatistics.missCount++;
+
 	ID2D1StrokeStyle *p_strokeStype;
 	if (S_OK != gp_appCore->GetFactory()->CreateStrokeStyle(
-		storkeStypeProperties, nullptr, 0, &p_strokeStype
+		key.properties, ap_dashes, a_dashCount, &p_strokeStype
 	)) {
 		return nullptr;
 	}
 
+	p_strokeStype->AddRef();
+	m_strokeStyleCache.emplace(std::move(key), p_strokeStype);
+
 	return p_strokeStype;
 }
 
 void Direct2D::SetBrushColor(const DColor &a_color)
 {
+	if (0 == memcmp(&m_brushColor, &a_color, sizeof(DColor))) {
+		m_stateStatistics.elidedCount++;
+		return;
+	}
+
+	m_stateStatistics.issuedCount++;
 	m_brushColor = a_color;
-	static_cast<ID2D1SolidColorBrush *>(mp_brush)->SetColor(a_color);
+	if (mp_backend) {
+		mp_backend->SetColor(ToRenderColor(a_color));
+	}
+	if (mp_solidBrush) {
+		mp_solidBrush->SetColor(a_color);
+	}
 }
 
 void Direct2D::SetBackgroundColor(const DColor &a_backgroundColor)
@@ -189,6 +538,13 @@ void Direct2D::SetBackgroundColor(const DColor &a_backgroundColor)
 // returns the previous stroke style. must be released from the user
 ID2D1StrokeStyle *const Direct2D::SetStrokeStyle(ID2D1StrokeStyle *const ap_strokeStyle)
 {
+	// the same object is returned, so the reference which has been passed in is released by the user
+	if (mp_strokeStyle == ap_strokeStyle) {
+		m_stateStatistics.elidedCount++;
+		return ap_strokeStyle;
+	}
+
+	m_stateStatistics.issuedCount++;
 	ID2D1StrokeStyle *const prevFStrokeStyle = mp_strokeStyle;
 	mp_strokeStyle = ap_strokeStyle;
 
@@ -197,20 +553,731 @@ ID2D1StrokeStyle *const Direct2D::SetStrokeStyle(ID2D1StrokeStyle *const ap_stro
 
 void Direct2D::SetStrokeWidth(const float a_strokeWidth)
 {
+	if (m_strokeWidth == a_strokeWidth) {
+		m_stateStatistics.elidedCount++;
+		return;
+	}
+
+	m_stateStatistics.issuedCount++;
 	m_strokeWidth = a_strokeWidth;
+	if (mp_backend) {
+		mp_backend->SetStrokeWidth(a_strokeWidth);
+	}
 }
 
 void Direct2D::SetMatrixTransform(const D2D1_MATRIX_3X2_F &a_transform)
 {
-	mp_renderTarget->SetTransform(a_transform);
+	if (0 == memcmp(&m_transform, &a_transform, sizeof(D2D1_MATRIX_3X2_F))) {
+		m_stateStatistics.elidedCount++;
+		return;
+	}
+
+	m_stateStatistics.issuedCount++;
+	m_transform = a_transform;
+	if (mp_backend) {
+		mp_backend->SetTransform(ToRenderMatrix(a_transform));
+	}
+	if (mp_renderTarget) {
+		mp_renderTarget->SetTransform(a_transform);
+	}
+}
+
+void Direct2D::PushState()
+{
+	// the user can release the current objects after replacing them, so the state keeps its own reference
+	if (mp_brush) {
+		mp_brush->AddRef();
+	}
+	if (mp_strokeStyle) {
+		mp_strokeStyle->AddRef();
+	}
+	m_stateStack.push_back(DRAWING_STATE({
+		mp_brush, m_brushColor, mp_strokeStyle, m_strokeWidth, m_transform,
+		static_cast<unsigned int>(m_clipRects.size())
+	}));
+}
+
+void Direct2D::PopState()
+{
+	if (m_stateStack.empty()) {
+		return;
+	}
+
+	const DRAWING_STATE state = m_stateStack.back();
+	m_stateStack.pop_back();
+
+	while (m_clipRects.size() > state.clipCount) {
+		PopClipRect();
+	}
+	// the references of the state are taken over, the objects which were set in between are released
+	ID2D1Brush *p_brush = SetBrush(state.p_brush);
+	InterfaceRelease(&p_brush);
+	SetBrushColor(state.brushColor);
+	ID2D1StrokeStyle *p_strokeStyle = SetStrokeStyle(state.p_strokeStyle);
+	InterfaceRelease(&p_strokeStyle);
+	SetStrokeWidth(state.strokeWidth);
+	SetMatrixTransform(state.transform);
+}
+
+void Direct2D::PushClipRect(const DRect &a_rect)
+{
+	RRect clipRect = TransformBounds(ToRenderMatrix(m_transform), ToRenderRect(a_rect));
+	// a list is replayed in another frame, so its clips are always applied
+	const RRect &outerRect = m_clipRects.empty() ? m_drawExtent : m_clipRects.back().rect;
+	const bool isApplied = mp_displayList ||
+		clipRect.left > outerRect.left || clipRect.top > outerRect.top || clipRect.right < outerRect.right || clipRect.bottom < outerRect.bottom;
+	if (!m_clipRects.empty()) {
+		clipRect = IntersectBounds(clipRect, m_clipRects.back().rect);
+	}
+	m_clipRects.push_back(CLIP_ENTRY({ clipRect, isApplied }));
+
+	if (mp_displayList) {
+		RecordShape(DISPLAY_PUSH_CLIP, a_rect);
+		return;
+	}
+
+	if (!isApplied) {
+		m_drawStatistics.elidedClipCount++;
+		return;
+	}
+
+	if (mp_backend) {
+		ApplyBackendClip();
+		return;
+	}
+
+	mp_renderTarget->PushAxisAlignedClip(a_rect, D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
+}
+
+void Direct2D::PopClipRect()
+{
+	if (m_clipRects.empty()) {
+		return;
+	}
+	const bool isApplied = m_clipRects.back().isApplied;
+	m_clipRects.pop_back();
+
+	if (mp_displayList) {
+		RecordShape(DISPLAY_POP_CLIP, DRect({ 0.0f, 0.0f, 0.0f, 0.0f }));
+		return;
+	}
+
+	if (!isApplied) {
+		return;
+	}
+
+	if (mp_backend) {
+		ApplyBackendClip();
+		return;
+	}
+
+	mp_renderTarget->PopAxisAlignedClip();
+}
+
+const STATE_STATISTICS &Direct2D::GetStateStatistics()
+{
+	return m_stateStatistics;
+}
+
+const DRAW_STATISTICS &Direct2D::GetDrawStatistics()
+{
+	return m_drawStatistics;
+}
+
+const CACHE_STATISTICS &Direct2D::GetStrokeStyleCacheStatistics()
+{
+	return m_strokeStyleStatistics;
+}
+
+const CACHE_STATISTICS &Direct2D::GetGradientStopCacheStatistics()
+{
+	return m_gradientStopStatistics;
+}
+
+const CACHE_STATISTICS &Direct2D::GetBitmapCacheStatistics()
+{
+	return m_bitmapStatistics;
+}
+
+void Direct2D::ReleaseUnusedResources()
+{
+	for (auto entryIterator = m_strokeStyleCache.begin(); entryIterator != m_strokeStyleCache.end();) {
+		if (IsUnusedResource(entryIterator->second)) {
+			InterfaceRelease(&entryIterator->second);
+			entryIterator = m_strokeStyleCache.erase(entryIterator);
+		}
+		else {
+			entryIterator++;
+		}
+	}
+
+	// a collection is still used by the brushes which have been created with it
+	for (auto entryIterator = m_gradientStopCache.begin(); entryIterator != m_gradientStopCache.end();) {
+		if (!entryIterator->second || IsUnusedResource(entryIterator->second)) {
+			InterfaceRelease(&entryIterator->second);
+			entryIterator = m_gradientStopCache.erase(entryIterator);
+		}
+		else {
+			entryIterator++;
+		}
+	}
+
+	ReleaseUnusedBitmaps();
+}
+
+TessellationCache &Direct2D::GetTessellationCache()
+{
+	return m_tessellationCache;
+}
+
+// returns the previous backend. must be deleted from the user
+RenderBackend *const Direct2D::SetRenderBackend(RenderBackend *const ap_backend)
+{
+	RenderBackend *const p_prevBackend = mp_backend;
+	mp_backend = ap_backend;
+
+	// the new backend continues with the current state
+	if (mp_backend) {
+		mp_backend->SetColor(ToRenderColor(m_brushColor));
+		mp_backend->SetStrokeWidth(m_strokeWidth);
+		mp_backend->SetTransform(ToRenderMatrix(m_transform));
+	}
+
+	return p_prevBackend;
+}
+
+void Direct2D::BeginRecord(DisplayList *const ap_list)
+{
+	mp_displayList = ap_list;
+	m_recordClipCount = static_cast<unsigned int>(m_clipRects.size());
+}
+
+void Direct2D::EndRecord()
+{
+	// the clips which are left by the recorded calls are closed in the list
+	while (m_clipRects.size() > m_recordClipCount) {
+		PopClipRect();
+	}
+	mp_displayList = nullptr;
+}
+
+void Direct2D::DrawDisplayList(const DisplayList &a_list)
+{
+	DisplayList *const p_recordList = mp_displayList;
+	const DColor brushColor = m_brushColor;
+	const float strokeWidth = m_strokeWidth;
+	const D2D1_MATRIX_3X2_F transform = m_transform;
+	const size_t clipCount = m_clipRects.size();
+	mp_displayList = nullptr;
+
+	const DISPLAY_COMMAND *const p_commands = a_list.GetCommands();
+	for (unsigned int i = 0; i < a_list.GetCommandCount(); i++) {
+		ReplayCommand(a_list, p_commands[i]);
+	}
+
+	// a list can leave its clips pushed
+	while (m_clipRects.size() > clipCount) {
+		PopClipRect();
+	}
+
+	SetBrushColor(brushColor);
+	SetStrokeWidth(strokeWidth);
+	SetMatrixTransform(transform);
+	mp_displayList = p_recordList;
+}
+
+const unsigned int Direct2D::GetDeviceGeneration()
+{
+	return m_deviceGeneration;
+}
+
+void Direct2D::Invalidate(const DRect &a_rect)
+{
+	m_dirtyRegion.Add(ToRenderRect(a_rect));
+
+	if (mh_window && m_isWindowRegionOwner) {
+		const RECT rect = {
+			static_cast<LONG>(std::floor(a_rect.left)), static_cast<LONG>(std::floor(a_rect.top)),
+			static_cast<LONG>(std::ceil(a_rect.right)), static_cast<LONG>(std::ceil(a_rect.bottom))
+		};
+		::InvalidateRect(mh_window, &rect, FALSE);
+	}
+}
+
+void Direct2D::InvalidateAll()
+{
+	m_dirtyRegion.AddAll();
+
+	if (mh_window && m_isWindowRegionOwner) {
+		::InvalidateRect(mh_window, nullptr, FALSE);
+	}
+}
+
+const DirtyRegion &Direct2D::GetDrawRegion()
+{
+	return m_drawRegion;
+}
+
+void Direct2D::AddUpdateRegion()
+{
+	HRGN h_region = ::CreateRectRgn(0, 0, 0, 0);
+	if (!h_region) {
+		InvalidateAll();
+		return;
+	}
+
+	const int regionType = ::GetUpdateRgn(mh_window, h_region, FALSE);
+	if (SIMPLEREGION == regionType || COMPLEXREGION == regionType) {
+		const DWORD dataSize = ::GetRegionData(h_region, 0, nullptr);
+		std::vector<char> data(dataSize);
+		RGNDATA *const p_regionData = reinterpret_cast<RGNDATA *>(data.data());
+
+		if (dataSize && ::GetRegionData(h_region, dataSize, p_regionData)) {
+			const RECT *const p_rects = reinterpret_cast<const RECT *>(p_regionData->Buffer);
+			for (DWORD i = 0; i < p_regionData->rdh.nCount; i++) {
+				m_dirtyRegion.Add(RRect({
+					static_cast<float>(p_rects[i].left), static_cast<float>(p_rects[i].top),
+					static_cast<float>(p_rects[i].right), static_cast<float>(p_rects[i].bottom)
+				}));
+			}
+		}
+		else {
+			m_dirtyRegion.AddAll();
+		}
+	}
+
+	::DeleteObject(h_region);
+}
+
+void Direct2D::PushDrawRegionClip()
+{
+	if (m_drawRegion.IsFull()) {
+		return;
+	}
+
+	if (mp_backend) {
+		ApplyBackendClip();
+		return;
+	}
+
+	// the region is given in pixels and the clip is transformed by the current transform
+	mp_renderTarget->SetTransform(D2D1::Matrix3x2F::Identity());
+
+	if (1 < m_drawRegion.GetRectCount()) {
+		ID2D1PathGeometry *p_pathGeometry = nullptr;
+		if (S_OK == gp_appCore->GetFactory()->CreatePathGeometry(&p_pathGeometry)) {
+			ID2D1GeometrySink *p_sink = nullptr;
+			if (S_OK == p_pathGeometry->Open(&p_sink)) {
+				const RRect *const p_rects = m_drawRegion.GetRects();
+				for (unsigned int i = 0; i < m_drawRegion.GetRectCount(); i++) {
+					const DPoint points[3] = {
+						{ p_rects[i].right, p_rects[i].top },
+						{ p_rects[i].right, p_rects[i].bottom },
+						{ p_rects[i].left, p_rects[i].bottom }
+					};
+					p_sink->BeginFigure(DPoint({ p_rects[i].left, p_rects[i].top }), D2D1_FIGURE_BEGIN_FILLED);
+					p_sink->AddLines(points, 3);
+					p_sink->EndFigure(D2D1_FIGURE_END_CLOSED);
+				}
+
+				if (S_OK == p_sink->Close()) {
+					mp_clipGeometry = p_pathGeometry;
+				}
+				InterfaceRelease(&p_sink);
+			}
+			if (!mp_clipGeometry) {
+				InterfaceRelease(&p_pathGeometry);
+			}
+		}
+	}
+
+	if (mp_clipGeometry) {
+		mp_renderTarget->PushLayer(
+			D2D1::LayerParameters(D2D1::InfiniteRect(), mp_clipGeometry, D2D1_ANTIALIAS_MODE_ALIASED),
+			nullptr
+		);
+	}
+	else {
+		mp_renderTarget->PushAxisAlignedClip(ToDirect2DRect(m_drawRegion.GetExtent()), D2D1_ANTIALIAS_MODE_ALIASED);
+	}
+
+	mp_renderTarget->SetTransform(m_transform);
+}
+
+void Direct2D::PopDrawRegionClip()
+{
+	if (m_drawRegion.IsFull()) {
+		return;
+	}
+
+	if (mp_backend) {
+		mp_backend->ResetClipRect();
+		return;
+	}
+
+	if (mp_clipGeometry) {
+		mp_renderTarget->PopLayer();
+		InterfaceRelease(&mp_clipGeometry);
+	}
+	else {
+		mp_renderTarget->PopAxisAlignedClip();
+	}
+}
+
+void Direct2D::ApplyBackendClip()
+{
+	if (m_drawRegion.IsFull() && m_clipRects.empty()) {
+		mp_backend->ResetClipRect();
+		return;
+	}
+
+	RRect clipRect = m_drawRegion.IsFull() ? m_clipRects.back().rect : m_drawRegion.GetExtent();
+	if (!m_clipRects.empty()) {
+		clipRect = IntersectBounds(clipRect, m_clipRects.back().rect);
+	}
+	mp_backend->SetClipRect(clipRect);
+}
+
+void Direct2D::UpdateDrawExtent()
+{
+	m_drawExtent = m_drawRegion.GetExtent();
+	if (m_drawRegion.IsFull() && (m_drawExtent.right <= m_drawExtent.left || m_drawExtent.bottom <= m_drawExtent.top)) {
+		m_drawExtent = { -FLT_MAX, -FLT_MAX, FLT_MAX, FLT_MAX };
+	}
+}
+
+const bool Direct2D::IsInDrawRegion(const DRect &a_rect, const float a_margin)
+{
+	const RRect rect = {
+		std::min(a_rect.left, a_rect.right) - a_margin, std::min(a_rect.top, a_rect.bottom) - a_margin,
+		std::max(a_rect.left, a_rect.right) + a_margin, std::max(a_rect.top, a_rect.bottom) + a_margin
+	};
+	const RRect bounds = TransformBounds(ToRenderMatrix(m_transform), rect);
+
+	// the extent of the region and the innermost clip reject most primitives, even if the whole view is drawn.
+	// only a region of several rectangles needs to test each of them
+	const RRect &clipRect = m_clipRects.empty() ? m_drawExtent : m_clipRects.back().rect;
+	const bool isVisible =
+		bounds.right > m_drawExtent.left && m_drawExtent.right > bounds.left && bounds.bottom > m_drawExtent.top && m_drawExtent.bottom > bounds.top &&
+		bounds.right > clipRect.left && clipRect.right > bounds.left && bounds.bottom > clipRect.top && clipRect.bottom > bounds.top &&
+		(1 >= m_drawRegion.GetRectCount() || m_drawRegion.Intersects(bounds));
+
+	if (isVisible) {
+		m_drawStatistics.submittedCount++;
+	}
+	else {
+		m_drawStatistics.culledCount++;
+	}
+	return isVisible;
+}
+
+const float Direct2D::GetStrokeMargin(const bool a_hasJoins)
+{
+	// the default stroke style has flat caps and miter joins
+	float factor = a_hasJoins ? DEFAULT_MITER_LIMIT : 1.0f;
+	if (mp_strokeStyle) {
+		// the corners of a square cap reach half the width along and across the line
+		const bool hasSquareCap = D2D1_CAP_STYLE_SQUARE == mp_strokeStyle->GetStartCap() ||
+			D2D1_CAP_STYLE_SQUARE == mp_strokeStyle->GetEndCap() || D2D1_CAP_STYLE_SQUARE == mp_strokeStyle->GetDashCap();
+		const D2D1_LINE_JOIN lineJoin = mp_strokeStyle->GetLineJoin();
+		const bool hasMiterJoin = a_hasJoins && (D2D1_LINE_JOIN_MITER == lineJoin || D2D1_LINE_JOIN_MITER_OR_BEVEL == lineJoin);
+
+		factor = hasSquareCap ? SQUARE_CAP_FACTOR : 1.0f;
+		if (hasMiterJoin) {
+			factor = std::max(factor, mp_strokeStyle->GetMiterLimit());
+		}
+	}
+
+	return m_strokeWidth * 0.5f * factor;
+}
+
+ID2D1Bitmap *const Direct2D::GetBitmap(const IMAGE_PIXELS &a_image)
+{
+	const auto entryIterator = m_bitmapCache.find(a_image.id);
+	if (m_bitmapCache.end() != entryIterator) {
+		entryIterator->second.frameIndex = m_frameIndex;
+		m_bitmapStatistics.hitCount++;
+		return entryIterator->second.p_bitmap;
+	}
+	m_bitmapStatistics.missCount++;
+
+	// the decoded pixels are already premultiplied BGRA, so they are copied without any conversion
+	ID2D1Bitmap *p_bitmap;
+	if (S_OK != mp_renderTarget->CreateBitmap(
+		D2D1::SizeU(a_image.width, a_image.height), a_image.pixels.data(), a_image.width * 4,
+		D2D1::BitmapProperties(D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED)),
+		&p_bitmap
+	)) {
+		return nullptr;
+	}
+	m_bitmapCache[a_image.id] = BITMAP_ENTRY({ p_bitmap, m_frameIndex });
+
+	return p_bitmap;
+}
+
+void Direct2D::ReleaseUnusedBitmaps()
+{
+	for (auto entryIterator = m_bitmapCache.begin(); entryIterator != m_bitmapCache.end();) {
+		if (m_frameIndex != entryIterator->second.frameIndex) {
+			InterfaceRelease(&entryIterator->second.p_bitmap);
+			entryIterator = m_bitmapCache.erase(entryIterator);
+		}
+		else {
+			entryIterator++;
+		}
+	}
+}
+
+void Direct2D::InvalidateWindow(void *ap_window)
+{
+	// the display list of the next frame limits the drawing to the commands which have changed
+	::InvalidateRect(static_cast<HWND>(ap_window), nullptr, FALSE);
+}
+
+bool Direct2D::FlattenGeometry(
+	ID2D1Geometry *const ap_geometry, const bool a_isFilled,
+	std::vector<RPoint> &a_points, std::vector<unsigned int> &a_contourSizes,
+	const D2D1_MATRIX_3X2_F *const ap_transform
+)
+{
+	PolygonSink sink(a_points, a_contourSizes, a_isFilled);
+
+	return S_OK == ap_geometry->Simplify(
+		D2D1_GEOMETRY_SIMPLIFICATION_OPTION_LINES, ap_transform, D2D1_DEFAULT_FLATTENING_TOLERANCE, &sink
+	);
+}
+
+void Direct2D::DrawPolygonData(
+	const RPoint *const ap_points, const unsigned int *const ap_contourSizes,
+	const unsigned int a_contourCount, const bool a_isFilled
+)
+{
+	if (mp_backend) {
+		if (a_isFilled) {
+			mp_backend->FillPolygon(ap_points, ap_contourSizes, a_contourCount);
+		}
+		else {
+			mp_backend->DrawPolyline(ap_points, ap_contourSizes, a_contourCount);
+		}
+		return;
+	}
+
+	ID2D1PathGeometry *p_pathGeometry = nullptr;
+	if (S_OK != gp_appCore->GetFactory()->CreatePathGeometry(&p_pathGeometry)) {
+		return;
+	}
+
+	ID2D1GeometrySink *p_sink = nullptr;
+	if (S_OK == p_pathGeometry->Open(&p_sink)) {
+		p_sink->SetFillMode(D2D1_FILL_MODE_WINDING);
+
+		const RPoint *p_point = ap_points;
+		for (unsigned int i = 0; i < a_contourCount; i++) {
+			const unsigned int size = ap_contourSizes[i];
+			if (size) {
+				p_sink->BeginFigure(ToDirect2DPoint(p_point[0]), a_isFilled ? D2D1_FIGURE_BEGIN_FILLED : D2D1_FIGURE_BEGIN_HOLLOW);
+				p_sink->AddLines(reinterpret_cast<const D2D1_POINT_2F *>(p_point + 1), size - 1);
+				p_sink->EndFigure(a_isFilled ? D2D1_FIGURE_END_CLOSED : D2D1_FIGURE_END_OPEN);
+			}
+			p_point += size;
+		}
+
+		if (S_OK == p_sink->Close()) {
+			if (a_isFilled) {
+				mp_renderTarget->FillGeometry(p_pathGeometry, mp_brush);
+			}
+			else {
+				mp_renderTarget->DrawGeometry(p_pathGeometry, mp_brush, m_strokeWidth, mp_strokeStyle);
+			}
+		}
+		InterfaceRelease(&p_sink);
+	}
+	InterfaceRelease(&p_pathGeometry);
+}
+
+void Direct2D::RecordShape(const DISPLAY_OPCODE a_opcode, const DRect &a_rect, const float a_radius)
+{
+	mp_displayList->AddShape(
+		a_opcode, ToRenderRect(a_rect), a_radius,
+		ToRenderColor(m_brushColor), m_strokeWidth, ToRenderMatrix(m_transform)
+	);
+}
+
+void Direct2D::RecordGeometry(const DISPLAY_OPCODE a_opcode, ID2D1Geometry *const ap_geometry)
+{
+	std::vector<RPoint> points;
+	std::vector<unsigned int> contourSizes;
+	if (FlattenGeometry(ap_geometry, DISPLAY_FILL_POLYGON == a_opcode, points, contourSizes)) {
+		mp_displayList->AddPolygon(
+			a_opcode, points.data(), contourSizes.data(), static_cast<unsigned int>(contourSizes.size()),
+			ToRenderColor(m_brushColor), m_strokeWidth, ToRenderMatrix(m_transform)
+		);
+	}
+}
+
+void Direct2D::ReplayCommand(const DisplayList &a_list, const DISPLAY_COMMAND &a_command)
+{
+	SetBrushColor(ToDirect2DColor(a_command.color));
+	SetStrokeWidth(a_command.strokeWidth);
+	SetMatrixTransform(ToDirect2DMatrix(a_list.GetTransform(a_command)));
+
+	const DRect &rect = ToDirect2DRect(a_command.rect);
+	switch (a_command.opcode) {
+	case DISPLAY_CLEAR:
+		if (mp_backend) {
+			mp_backend->Clear(a_command.color);
+		}
+		else {
+			mp_renderTarget->Clear(ToDirect2DColor(a_command.color));
+		}
+		break;
+	case DISPLAY_DRAW_LINE:
+		DrawLine(DPoint({ rect.left, rect.top }), DPoint({ rect.right, rect.bottom }));
+		break;
+	case DISPLAY_DRAW_RECTANGLE:
+		DrawRectangle(rect);
+		break;
+	case DISPLAY_DRAW_ROUNDED_RECTANGLE:
+		DrawRoundedRectangle(rect, a_command.radius);
+		break;
+	case DISPLAY_DRAW_ELLIPSE:
+		DrawEllipse(rect);
+		break;
+	case DISPLAY_DRAW_POLYLINE:
+		if (!IsInDrawRegion(rect, GetStrokeMargin(true))) {
+			break;
+		}
+		DrawPolygonData(a_list.GetPoints(a_command), a_list.GetContourSizes(a_command), a_command.dataCount, false);
+		break;
+	case DISPLAY_FILL_RECTANGLE:
+		FillRectangle(rect);
+		break;
+	case DISPLAY_FILL_ROUNDED_RECTANGLE:
+		FillRoundedRectangle(rect, a_command.radius);
+		break;
+	case DISPLAY_FILL_ELLIPSE:
+		FillEllipse(rect);
+		break;
+	case DISPLAY_FILL_POLYGON:
+		if (!IsInDrawRegion(rect)) {
+			break;
+		}
+		DrawPolygonData(a_list.GetPoints(a_command), a_list.GetContourSizes(a_command), a_command.dataCount, true);
+		break;
+	case DISPLAY_PUSH_CLIP:
+		PushClipRect(rect);
+		break;
+	case DISPLAY_POP_CLIP:
+		PopClipRect();
+		break;
+	case DISPLAY_DRAW_BITMAP:
+		DrawBitmap(a_list.GetText(a_command), rect, a_command.radius);
+		break;
+	default:
+		break;
+	}
+}
+
+void Direct2D::GroupByColor(const DColor *const ap_colors, const unsigned int a_count)
+{
+	// `clear` keeps the buckets, so a batch of as many colors as the last one doesn't allocate them again
+	m_batchGroupTable.clear();
+	m_batchGroups.resize(a_count);
+	m_batchGroupOffsets.clear();
+
+	// the group of each instance in the order of the first appearance of its color
+	COLOR_KEY prevKey;
+	unsigned int prevGroup = 0;
+	for (unsigned int i = 0; i < a_count; i++) {
+		const COLOR_KEY key = ToColorKey(ap_colors[i]);
+		// neighbours share their color in most data layers
+		if (0 == i || !(key == prevKey)) {
+			auto result = m_batchGroupTable.emplace(key, static_cast<unsigned int>(m_batchGroupOffsets.size()));
+			if (result.second) {
+				m_batchGroupOffsets.push_back(0);
+			}
+			prevKey = key;
+			prevGroup = result.first->second;
+		}
+		m_batchGroups[i] = prevGroup;
+		m_batchGroupOffsets[prevGroup]++;
+	}
+
+	// counting sort by the group
+	unsigned int offset = 0;
+	for (unsigned int &groupOffset : m_batchGroupOffsets) {
+		const unsigned int count = groupOffset;
+		groupOffset = offset;
+		offset += count;
+	}
+	m_batchGroupOffsets.push_back(offset);
+
+	m_batchOrder.resize(a_count);
+	for (unsigned int i = 0; i < a_count; i++) {
+		m_batchOrder[m_batchGroupOffsets[m_batchGroups[i]]++] = i;
+	}
+	// the offsets have moved to the end of their group
+	for (size_t i = m_batchGroupOffsets.size() - 1; i > 0; i--) {
+		m_batchGroupOffsets[i] = m_batchGroupOffsets[i - 1];
+	}
+	m_batchGroupOffsets[0] = 0;
+}
+
+template <typename DrawFunction>
+void Direct2D::DrawBatch(const DColor *const ap_colors, const unsigned int a_count, DrawFunction a_drawFunction)
+{
+	if (!ap_colors) {
+		for (unsigned int i = 0; i < a_count; i++) {
+			a_drawFunction(i);
+		}
+		return;
+	}
+
+	const DColor brushColor = m_brushColor;
+	GroupByColor(ap_colors, a_count);
+
+	for (size_t group = 0; group + 1 < m_batchGroupOffsets.size(); group++) {
+		const unsigned int *p_index = m_batchOrder.data() + m_batchGroupOffsets[group];
+		const unsigned int *const p_end = m_batchOrder.data() + m_batchGroupOffsets[group + 1];
+
+		SetBrushColor(ap_colors[*p_index]);
+		for (; p_index < p_end; p_index++) {
+			a_drawFunction(*p_index);
+		}
+	}
+
+	SetBrushColor(brushColor);
 }
 
 // returns the previous brush. must be released from the user
 ID2D1Brush *Direct2D::SetBrush(ID2D1Brush *const ap_brush)
 {
+	// the same object is returned, so the reference which has been passed in is released by the user
+	if (mp_brush == ap_brush) {
+		m_stateStatistics.elidedCount++;
+		return ap_brush;
+	}
+
+	m_stateStatistics.issuedCount++;
 	ID2D1Brush *p_prevBrush = mp_brush;
 	mp_brush = ap_brush;
 
+	// `SetBrushColor` compares with the color of the new brush, so it doesn't skip a color which the brush doesn't have
+	ID2D1SolidColorBrush *p_solidBrush = nullptr;
+	if (ap_brush && S_OK == ap_brush->QueryInterface(__uuidof(ID2D1SolidColorBrush), reinterpret_cast<void **>(&p_solidBrush))) {
+		// the reference of the query isn't kept, `mp_brush` holds one
+		p_solidBrush->Release();
+
+		const DColor color = p_solidBrush->GetColor();
+		if (0 != memcmp(&m_brushColor, &color, sizeof(DColor))) {
+			m_brushColor = color;
+			if (mp_backend) {
+				mp_backend->SetColor(ToRenderColor(color));
+			}
+		}
+	}
+	mp_solidBrush = p_solidBrush;
+
 	return p_prevBrush;
 }
 
@@ -220,6 +1287,20 @@ ID2D1Brush *Direct2D::SetBrush(ID2D1Brush *const ap_brush)
 
 void Direct2D::DrawLine(const DPoint &a_startPoint, const DPoint &a_endPoint)
 {
+	if (mp_displayList) {
+		RecordShape(DISPLAY_DRAW_LINE, DRect({ a_startPoint.x, a_startPoint.y, a_endPoint.x, a_endPoint.y }));
+		return;
+	}
+
+	if (!IsInDrawRegion(DRect({ a_startPoint.x, a_startPoint.y, a_endPoint.x, a_endPoint.y }), GetStrokeMargin(false))) {
+		return;
+	}
+
+	if (mp_backend) {
+		mp_backend->DrawLine(ToRenderPoint(a_startPoint), ToRenderPoint(a_endPoint));
+		return;
+	}
+
 	mp_renderTarget->DrawLine(a_startPoint, a_endPoint, mp_brush, m_strokeWidth, mp_strokeStyle);
 }
 
@@ -230,6 +1311,20 @@ void Direct2D::DrawRectangle(const DPoint &a_startPoint, const DPoint &a_endPoin
 
 void Direct2D::DrawRectangle(const DRect &a_rect)
 {
+	if (mp_displayList) {
+		RecordShape(DISPLAY_DRAW_RECTANGLE, a_rect);
+		return;
+	}
+
+	if (!IsInDrawRegion(a_rect, m_strokeWidth * 0.5f)) {
+		return;
+	}
+
+	if (mp_backend) {
+		mp_backend->DrawRectangle(ToRenderRect(a_rect));
+		return;
+	}
+
 	mp_renderTarget->DrawRectangle(a_rect, mp_brush, m_strokeWidth, mp_strokeStyle);
 }
 
@@ -243,6 +1338,20 @@ void Direct2D::DrawRoundedRectangle(const DPoint &a_startPoint, const DPoint &a_
 
 void Direct2D::DrawRoundedRectangle(const DRect &a_rect, const float radius)
 {
+	if (mp_displayList) {
+		RecordShape(DISPLAY_DRAW_ROUNDED_RECTANGLE, a_rect, radius);
+		return;
+	}
+
+	if (!IsInDrawRegion(a_rect, m_strokeWidth * 0.5f)) {
+		return;
+	}
+
+	if (mp_backend) {
+		mp_backend->DrawRoundedRectangle(ToRenderRect(a_rect), radius);
+		return;
+	}
+
 	mp_renderTarget->DrawRoundedRectangle(
 		D2D1_ROUNDED_RECT({ a_rect, radius, radius }), 
 		mp_brush,
@@ -253,23 +1362,25 @@ void Direct2D::DrawRoundedRectangle(const DRect &a_rect, const float radius)
 
 void Direct2D::DrawEllipse(const DPoint &a_startPoint, const DPoint &a_endPoint)
 {
-	const float radiusX = (a_endPoint.x - a_startPoint.x) / 2;
-	const float radiusY = (a_endPoint.y - a_startPoint.y) / 2;
-
-	mp_renderTarget->DrawEllipse(
-		D2D1_ELLIPSE({
-			{ a_startPoint.x + radiusX, a_startPoint.y + radiusY },
-			radiusX,
-			radiusY
-		}), 
-		mp_brush,
-		m_strokeWidth,
-		mp_strokeStyle
-	);
+	DrawEllipse(DRect({ a_startPoint.x, a_startPoint.y, a_endPoint.x, a_endPoint.y }));
 }
 
 void Direct2D::DrawEllipse(const DRect &a_rect)
 {
+	if (mp_displayList) {
+		RecordShape(DISPLAY_DRAW_ELLIPSE, a_rect);
+		return;
+	}
+
+	if (!IsInDrawRegion(a_rect, m_strokeWidth * 0.5f)) {
+		return;
+	}
+
+	if (mp_backend) {
+		mp_backend->DrawEllipse(ToRenderRect(a_rect));
+		return;
+	}
+
 	const float radiusX = (a_rect.right - a_rect.left) / 2;
 	const float radiusY = (a_rect.bottom - a_rect.top) / 2;
 
@@ -287,11 +1398,44 @@ void Direct2D::DrawEllipse(const DRect &a_rect)
 
 void Direct2D::DrawGeometry(ID2D1Geometry *const ap_geometry)
 {
+	if (mp_displayList) {
+		RecordGeometry(DISPLAY_DRAW_POLYLINE, ap_geometry);
+		return;
+	}
+
+	DRect bounds;
+	if (S_OK == ap_geometry->GetBounds(nullptr, &bounds) && !IsInDrawRegion(bounds, GetStrokeMargin(true))) {
+		return;
+	}
+
+	if (mp_backend) {
+		std::vector<RPoint> points;
+		std::vector<unsigned int> contourSizes;
+		if (FlattenGeometry(ap_geometry, false, points, contourSizes)) {
+			mp_backend->DrawPolyline(points.data(), contourSizes.data(), static_cast<unsigned int>(contourSizes.size()));
+		}
+		return;
+	}
+
 	mp_renderTarget->DrawGeometry(ap_geometry, mp_brush, m_strokeWidth, mp_strokeStyle);
 }
 
 void Direct2D::FillRectangle(const DRect &a_rect)
 {
+	if (mp_displayList) {
+		RecordShape(DISPLAY_FILL_RECTANGLE, a_rect);
+		return;
+	}
+
+	if (!IsInDrawRegion(a_rect)) {
+		return;
+	}
+
+	if (mp_backend) {
+		mp_backend->FillRectangle(ToRenderRect(a_rect));
+		return;
+	}
+
 	mp_renderTarget->FillRectangle(a_rect, mp_brush);
 }
 
@@ -302,6 +1446,20 @@ void Direct2D::FillRectangle(const DPoint &a_startPoint, const DPoint &a_endPoin
 
 void Direct2D::FillRoundedRectangle(const DRect &a_rect, const float radius)
 {
+	if (mp_displayList) {
+		RecordShape(DISPLAY_FILL_ROUNDED_RECTANGLE, a_rect, radius);
+		return;
+	}
+
+	if (!IsInDrawRegion(a_rect)) {
+		return;
+	}
+
+	if (mp_backend) {
+		mp_backend->FillRoundedRectangle(ToRenderRect(a_rect), radius);
+		return;
+	}
+
 	mp_renderTarget->FillRoundedRectangle(
 		D2D1_ROUNDED_RECT({ a_rect, radius, radius }),
 		mp_brush
@@ -310,18 +1468,25 @@ void Direct2D::FillRoundedRectangle(const DRect &a_rect, const float radius)
 
 void Direct2D::FillRoundedRectangle(const DPoint &a_startPoint, const DPoint &a_endPoint, const float radius)
 {
-	mp_renderTarget->FillRoundedRectangle(
-		D2D1_ROUNDED_RECT({
-			{ a_startPoint.x, a_startPoint.y, a_endPoint.x, a_endPoint.y },
-			radius,
-			radius
-		}), 
-		mp_brush
-	);
+	FillRoundedRectangle(DRect({ a_startPoint.x, a_startPoint.y, a_endPoint.x, a_endPoint.y }), radius);
 }
 
 void Direct2D::FillEllipse(const DRect &a_rect)
 {
+	if (mp_displayList) {
+		RecordShape(DISPLAY_FILL_ELLIPSE, a_rect);
+		return;
+	}
+
+	if (!IsInDrawRegion(a_rect)) {
+		return;
+	}
+
+	if (mp_backend) {
+		mp_backend->FillEllipse(ToRenderRect(a_rect));
+		return;
+	}
+
 	const float radiusX = (a_rect.right - a_rect.left) / 2;
 	const float radiusY = (a_rect.bottom - a_rect.top) / 2;
 
@@ -337,5 +1502,171 @@ void Direct2D::FillEllipse(const DRect &a_rect)
 
 void Direct2D::FillGeometry(ID2D1Geometry *const p_geometry)
 {
+	if (mp_displayList) {
+		RecordGeometry(DISPLAY_FILL_POLYGON, p_geometry);
+		return;
+	}
+
+	DRect bounds;
+	if (S_OK == p_geometry->GetBounds(nullptr, &bounds) && !IsInDrawRegion(bounds)) {
+		return;
+	}
+
+	if (mp_backend) {
+		std::vector<RPoint> points;
+		std::vector<unsigned int> contourSizes;
+		if (FlattenGeometry(p_geometry, true, points, contourSizes)) {
+			mp_backend->FillPolygon(points.data(), contourSizes.data(), static_cast<unsigned int>(contourSizes.size()));
+		}
+		return;
+	}
+
 	mp_renderTarget->FillGeometry(p_geometry, mp_brush);
 }
+
+void Direct2D::DrawPath(const unsigned long long a_pathID)
+{
+	RRect bounds;
+	if (!m_tessellationCache.GetBounds(a_pathID, bounds) || (!mp_displayList && !IsInDrawRegion(ToDirect2DRect(bounds), GetStrokeMargin(true)))) {
+		return;
+	}
+
+	const PATH_TESSELLATION *const p_entry = m_tessellationCache.Get(a_pathID, GetMatrixScale(ToRenderMatrix(m_transform)));
+	if (p_entry->contourSizes.empty()) {
+		return;
+	}
+
+	if (mp_displayList) {
+		mp_displayList->AddPolygon(
+			DISPLAY_DRAW_POLYLINE, p_entry->points.data(), p_entry->contourSizes.data(), static_cast<unsigned int>(p_entry->contourSizes.size()),
+			ToRenderColor(m_brushColor), m_strokeWidth, ToRenderMatrix(m_transform)
+		);
+		return;
+	}
+
+	DrawPolygonData(p_entry->points.data(), p_entry->contourSizes.data(), static_cast<unsigned int>(p_entry->contourSizes.size()), false);
+}
+
+void Direct2D::FillPath(const unsigned long long a_pathID)
+{
+	RRect bounds;
+	if (!m_tessellationCache.GetBounds(a_pathID, bounds) || (!mp_displayList && !IsInDrawRegion(ToDirect2DRect(bounds)))) {
+		return;
+	}
+
+	// the hollow figures follow the filled ones and aren't filled
+	const PATH_TESSELLATION *const p_entry = m_tessellationCache.Get(a_pathID, GetMatrixScale(ToRenderMatrix(m_transform)));
+	if (0 == p_entry->filledContourCount) {
+		return;
+	}
+
+	if (mp_displayList) {
+		mp_displayList->AddPolygon(
+			DISPLAY_FILL_POLYGON, p_entry->points.data(), p_entry->contourSizes.data(), p_entry->filledContourCount,
+			ToRenderColor(m_brushColor), m_strokeWidth, ToRenderMatrix(m_transform)
+		);
+		return;
+	}
+
+	DrawPolygonData(p_entry->points.data(), p_entry->contourSizes.data(), p_entry->filledContourCount, true);
+}
+
+void Direct2D::DrawBitmap(const wchar_t *const ap_path, const DRect &a_rect, const float a_opacity)
+{
+	ImageCache *const p_imageCache = gp_appCore ? gp_appCore->GetImageCache() : nullptr;
+	if (!p_imageCache) {
+		FillRectangle(a_rect);
+		return;
+	}
+
+	// a culled image isn't decoded, but the recording can't know the region of the frame yet
+	if (!mp_displayList && !IsInDrawRegion(a_rect)) {
+		return;
+	}
+
+	// the size in pixels keeps the aspect ratio of the rectangle, a rotated rectangle uses its bounds
+	const RRect bounds = TransformBounds(ToRenderMatrix(m_transform), ToRenderRect(a_rect));
+	const unsigned int width = static_cast<unsigned int>(std::ceil(bounds.right - bounds.left));
+	const unsigned int height = static_cast<unsigned int>(std::ceil(bounds.bottom - bounds.top));
+	if (0 == width || 0 == height) {
+		return;
+	}
+
+	const std::shared_ptr<const IMAGE_PIXELS> p_image = p_imageCache->Request(
+		ap_path, width, height, mh_window ? &Direct2D::InvalidateWindow : nullptr, mh_window
+	);
+
+	if (mp_displayList) {
+		mp_displayList->AddBitmap(
+			ap_path, static_cast<unsigned int>(wcslen(ap_path)), ToRenderRect(a_rect), a_opacity, p_image ? p_image->id : 0,
+			ToRenderColor(m_brushColor), ToRenderMatrix(m_transform)
+		);
+		return;
+	}
+
+	ID2D1Bitmap *const p_bitmap = p_image && !mp_backend ? GetBitmap(*p_image) : nullptr;
+	if (!p_bitmap) {
+		// the placeholder until the image has been decoded
+		if (mp_backend) {
+			mp_backend->FillRectangle(ToRenderRect(a_rect));
+		}
+		else {
+			mp_renderTarget->FillRectangle(a_rect, mp_brush);
+		}
+		return;
+	}
+
+	mp_renderTarget->DrawBitmap(p_bitmap, &a_rect, a_opacity, D2D1_BITMAP_INTERPOLATION_MODE_LINEAR);
+}
+
+void Direct2D::DrawTimeSeries(
+	TimeSeriesPyramid &a_series, const DRect &a_rect, const double a_firstX, const double a_lastX,
+	const float a_minY, const float a_maxY
+)
+{
+	// a rectangle outside the region of the frame isn't reduced. the recording can't know the region yet
+	if (!mp_displayList && !IsInDrawRegion(a_rect, GetStrokeMargin(true))) {
+		return;
+	}
+
+	// one column per pixel which the rectangle covers
+	const RRect bounds = TransformBounds(ToRenderMatrix(m_transform), ToRenderRect(a_rect));
+	const unsigned int columnCount = static_cast<unsigned int>(std::ceil(bounds.right - bounds.left));
+	const TIME_SERIES_VIEW view = { a_firstX, a_lastX, a_minY, a_maxY, ToRenderRect(a_rect), columnCount };
+	a_series.Reduce(view, m_seriesPoints);
+	if (m_seriesPoints.size() < 2) {
+		return;
+	}
+
+	const unsigned int pointCount = static_cast<unsigned int>(m_seriesPoints.size());
+	if (mp_displayList) {
+		mp_displayList->AddPolygon(
+			DISPLAY_DRAW_POLYLINE, m_seriesPoints.data(), &pointCount, 1,
+			ToRenderColor(m_brushColor), m_strokeWidth, ToRenderMatrix(m_transform)
+		);
+		return;
+	}
+
+	DrawPolygonData(m_seriesPoints.data(), &pointCount, 1, false);
+}
+
+void Direct2D::DrawLines(const DPoint *const ap_startPoints, const DPoint *const ap_endPoints, const DColor *const ap_colors, const unsigned int a_count)
+{
+	DrawBatch(ap_colors, a_count, [this, ap_startPoints, ap_endPoints](const unsigned int a_index) {
+		DrawLine(ap_startPoints[a_index], ap_endPoints[a_index]);
+	});
+}
+
+void Direct2D::FillRectangles(const DRect *const ap_rects, const DColor *const ap_colors, const unsigned int a_count)
+{
+	DrawBatch(ap_colors, a_count, [this, ap_rects](const unsigned int a_index) {
+		FillRectangle(ap_rects[a_index]);
+	});
+}
+
+void Direct2D::FillEllipses(const DRect *const ap_rects, const DColor *const ap_colors, const unsigned int a_count)
+{
+	DrawBatch(ap_colors, a_count, [this, ap_rects](const unsigned int a_index) {
+		FillEllipse(ap_rects[a_index]);
+	});
+}
\ No newline at end of file
@@ -1,19 +1,133 @@
 #include "Direct2DEx.h"
+#include <algorithm>
+#include <cmath>
 
 extern ApplicationCore *gp_appCore;
 
+namespace
+{
+	// records the outline of a glyph
+	class OutlineSink : public ID2D1SimplifiedGeometrySink
+	{
+	protected:
+		VECTOR_PATH &m_path;
+
+	public:
+		OutlineSink(VECTOR_PATH &a_path) :
+			m_path(a_path)
+		{
+		}
+
+		// the sink lives on the stack only during `GetGlyphRunOutline`
+		HRESULT STDMETHODCALLTYPE QueryInterface(REFIID a_interfaceID, void **ap_object) override
+		{
+			if (__uuidof(ID2D1SimplifiedGeometrySink) == a_interfaceID || __uuidof(IUnknown) == a_interfaceID) {
+				*ap_object = this;
+				return S_OK;
+			}
+
+			*ap_object = nullptr;
+			return E_NOINTERFACE;
+		}
+		ULONG STDMETHODCALLTYPE AddRef() override { return 1; }
+		ULONG STDMETHODCALLTYPE Release() override { return 1; }
+
+		void STDMETHODCALLTYPE SetFillMode(D2D1_FILL_MODE a_fillMode) override {}
+		void STDMETHODCALLTYPE SetSegmentFlags(D2D1_PATH_SEGMENT a_vertexFlags) override {}
+
+		void STDMETHODCALLTYPE BeginFigure(D2D1_POINT_2F a_startPoint, D2D1_FIGURE_BEGIN a_figureBegin) override
+		{
+			m_path.commands.push_back(D2D1_FIGURE_BEGIN_HOLLOW == a_figureBegin ? PATH_BEGIN_HOLLOW : PATH_BEGIN_FILLED);
+			m_path.points.push_back(ToRenderPoint(a_startPoint));
+		}
+
+		void STDMETHODCALLTYPE AddLines(const D2D1_POINT_2F *ap_points, UINT32 a_pointsCount) override
+		{
+			for (UINT32 i = 0; i < a_pointsCount; i++) {
+				m_path.commands.push_back(PATH_LINE);
+				m_path.points.push_back(ToRenderPoint(ap_points[i]));
+			}
+		}
+
+		void STDMETHODCALLTYPE AddBeziers(const D2D1_BEZIER_SEGMENT *ap_beziers, UINT32 a_beziersCount) override
+		{
+			for (UINT32 i = 0; i < a_beziersCount; i++) {
+				m_path.commands.push_back(PATH_BEZIER);
+				m_path.points.push_back(ToRenderPoint(ap_beziers[i].point1));
+				m_path.points.push_back(ToRenderPoint(ap_beziers[i].point2));
+				m_path.points.push_back(ToRenderPoint(ap_beziers[i].point3));
+			}
+		}
+
+		void STDMETHODCALLTYPE EndFigure(D2D1_FIGURE_END a_figureEnd) override
+		{
+			m_path.commands.push_back(D2D1_FIGURE_END_CLOSED == a_figureEnd ? PATH_END_CLOSED : PATH_END_OPEN);
+		}
+
+		HRESULT STDMETHODCALLTYPE Close() override
+		{
+			return S_OK;
+		}
+	};
+
+	// adds the figures of a path to a sink with an offset
+	void AddVectorPath(ID2D1GeometrySink *const ap_sink, const VECTOR_PATH &a_path, const float a_offsetX, const float a_offsetY)
+	{
+		auto ToOffsetPoint = [a_offsetX, a_offsetY](const RPoint &a_point) {
+			return DPoint({ a_point.x + a_offsetX, a_point.y + a_offsetY });
+		};
+
+		const RPoint *p_point = a_path.points.data();
+		for (const unsigned char command : a_path.commands) {
+			switch (command) {
+			case PATH_BEGIN_FILLED:
+			case PATH_BEGIN_HOLLOW:
+				ap_sink->BeginFigure(
+					ToOffsetPoint(*p_point++), PATH_BEGIN_HOLLOW == command ? D2D1_FIGURE_BEGIN_HOLLOW : D2D1_FIGURE_BEGIN_FILLED
+				);
+				break;
+			case PATH_LINE:
+				ap_sink->AddLine(ToOffsetPoint(*p_point++));
+				break;
+			case PATH_BEZIER:
+				ap_sink->AddBezier(D2D1::BezierSegment(ToOffsetPoint(p_point[0]), ToOffsetPoint(p_point[1]), ToOffsetPoint(p_point[2])));
+				p_point += 3;
+				break;
+			case PATH_QUADRATIC:
+				ap_sink->AddQuadraticBezier(D2D1_QUADRATIC_BEZIER_SEGMENT({ ToOffsetPoint(p_point[0]), ToOffsetPoint(p_point[1]) }));
+				p_point += 2;
+				break;
+			case PATH_END_OPEN:
+			case PATH_END_CLOSED:
+				ap_sink->EndFigure(PATH_END_CLOSED == command ? D2D1_FIGURE_END_CLOSED : D2D1_FIGURE_END_OPEN);
+				break;
+			}
+		}
+	}
+}
+
 Direct2DEx::Direct2DEx(const HWND ah_window, const RECT *const ap_viewRect) :
-	Direct2D(ah_window, ap_viewRect)
+	Direct2D(ah_window, ap_viewRect),
+	m_layoutCache(this),
+	m_outlineCache(this),
+	m_glyphAtlas(this)
 {
 	mp_textFormat = nullptr;
 	mp_fontFace = nullptr;
+	mp_atlasBitmap = nullptr;
 
 	m_fontFormat.name = DEFAULT_FONT_NAME;
 	m_fontFormat.size = 20.0f;
+	m_textAlignment = DWRITE_TEXT_ALIGNMENT_LEADING;
+	m_paragraphAlignment = DWRITE_PARAGRAPH_ALIGNMENT_NEAR;
+	m_isUserTextFormat = false;
 }
 
 Direct2DEx::~Direct2DEx()
 {
+	// the layouts are released through this object, so it can't wait for the destructor of the cache
+	m_layoutCache.Clear();
+	ClearGlyphCaches();
 	DestroyDeviceResources();
 }
 
@@ -23,17 +137,14 @@ HRESULT Direct2DEx::CreateDeviceResources()
 		return D2DERR_WIN32_ERROR;
 	}
 
-	// create a instance for a string output format 
-	mp_textFormat = CreateTextFormat(
-		m_fontFormat.name.c_str(), m_fontFormat.size, m_fontFormat.weight, m_fontFormat.style
-	);
+	// the string output format is shared with all instances which use the same font format
+	FontCache *const p_fontCache = gp_appCore->GetFontCache();
+	mp_textFormat = p_fontCache->GetTextFormat(m_fontFormat, m_textAlignment, m_paragraphAlignment);
 	if (nullptr == mp_textFormat) {
 		return D2DERR_WIN32_ERROR;
 	}
 
-	mp_fontFace = CreateFontFace(
-		m_fontFormat.name.c_str(), m_fontFormat.weight, m_fontFormat.style
-	);
+	mp_fontFace = p_fontCache->GetFontFace(m_fontFormat);
 	if (nullptr == mp_fontFace) {
 		InterfaceRelease(&mp_textFormat);
 
@@ -47,6 +158,9 @@ void Direct2DEx::DestroyDeviceResources()
 {
 	InterfaceRelease(&mp_textFormat);
 	InterfaceRelease(&mp_fontFace);
+	InterfaceRelease(&mp_atlasBitmap);
+	// the text format is created again from `m_fontFormat`
+	m_isUserTextFormat = false;
 
 	Direct2D::DestroyDeviceResources();
 }
@@ -56,100 +170,82 @@ IDWriteTextFormat *Direct2DEx::CreateTextFormat(
 	DWRITE_FONT_STYLE a_fontStyle, DWRITE_FONT_STRETCH a_fontStretch, const wchar_t *ap_localName
 )
 {
-	IDWriteTextFormat *p_textFormat = nullptr;
-	if (S_OK != gp_appCore->GetWriteFactory()->CreateTextFormat(
-		ap_fontName, nullptr, a_fontWeight, a_fontStyle,
-		a_fontStretch, a_fontSize, ap_localName, &p_textFormat
-	)) {
-		return nullptr;
-	}
-
-	return p_textFormat;
+	return FontCache::CreateTextFormat(
+		FONT_FORMAT({ ap_fontName, a_fontSize, a_fontWeight, a_fontStyle, a_fontStretch, ap_localName })
+	);
 }
 
 IDWriteFontFace *Direct2DEx::CreateFontFace(const wchar_t *const ap_name, const DWRITE_FONT_WEIGHT a_weight, const DWRITE_FONT_STYLE a_style)
 {
-	IDWriteGdiInterop *p_gdiInterop = nullptr;
-	if (S_OK == gp_appCore->GetWriteFactory()->GetGdiInterop(&p_gdiInterop)) {
-		LOGFONT logFont = {};
-		wcscpy_s(logFont.lfFaceName, ap_name);
-		logFont.lfWeight = static_cast<long>(a_weight);
-		logFont.lfCharSet = DEFAULT_CHARSET;
-		logFont.lfOutPrecision = OUT_DEFAULT_PRECIS;
-		logFont.lfClipPrecision = CLIP_DEFAULT_PRECIS;
-		logFont.lfQuality = ANTIALIASED_QUALITY;
-		logFont.lfPitchAndFamily = VARIABLE_PITCH;
-		logFont.lfItalic = 
-			a_style == DWRITE_FONT_STYLE::DWRITE_FONT_STYLE_ITALIC || 
-			a_style == DWRITE_FONT_STYLE::DWRITE_FONT_STYLE_OBLIQUE;
-
-		IDWriteFont *font;
-		if (S_OK == p_gdiInterop->CreateFontFromLOGFONT(&logFont, &font)) {
-			IDWriteFontFace *p_fontFace;
-
-			if (S_OK == font->CreateFontFace(&p_fontFace)) {
-				InterfaceRelease(&font);
-				InterfaceRelease(&p_gdiInterop);
-
-				return p_fontFace;
-			}
-
-			InterfaceRelease(&font);
-		}
-
-		InterfaceRelease(&p_gdiInterop);
-	}
-
-	return nullptr;
+	return FontCache::CreateFontFace(ap_name, a_weight, a_style);
 }
 
-ID2D1PathGeometry *Direct2DEx::CreateTextPathGeometry(const wchar_t *const ap_text, const float a_fontSize)
+ID2D1PathGeometry *Direct2DEx::CreateTextPathGeometry(const wchar_t *const ap_text, const float a_fontSize, DRect *const ap_bounds)
 {
-	const size_t textLength = wcslen(ap_text);
-	unsigned int *p_codePoints = new unsigned int[textLength];
-	unsigned short *p_glyphIndices = new unsigned short[textLength];
-
-	for (size_t i = 0; i < textLength; i++) {
-		p_codePoints[i] = static_cast<unsigned int>(ap_text[i]);
+	if (!MapGlyphIndices(ap_text)) {
+		return nullptr;
 	}
-	mp_fontFace->GetGlyphIndicesW(p_codePoints, textLength, p_glyphIndices);
 
-	ID2D1PathGeometry *p_pathGeometry;
+	ID2D1PathGeometry *p_pathGeometry = nullptr;
 	bool result = false;
 
 	if (S_OK == gp_appCore->GetFactory()->CreatePathGeometry(&p_pathGeometry)) {
 		ID2D1GeometrySink *p_sink = nullptr;
 		if (S_OK == p_pathGeometry->Open(&p_sink)) {
-			if (S_OK == mp_fontFace->GetGlyphRunOutline(
-				a_fontSize, p_glyphIndices,
-				nullptr, nullptr,
-				textLength, false,
-				false, p_sink
-			)) {
-				result = true;
+			// the same fill mode as `GetGlyphRunOutline`
+			p_sink->SetFillMode(D2D1_FILL_MODE_WINDING);
+
+			// the glyphs are placed with their default advances
+			float originX = 0.0f;
+			bool hasBounds = false;
+			result = true;
+			for (const unsigned short glyphIndex : m_glyphIndices) {
+				const GLYPH_OUTLINE *const p_outline = m_outlineCache.Get(mp_fontFace, glyphIndex, a_fontSize);
+				if (nullptr == p_outline) {
+					result = false;
+					break;
+				}
+
+				AddVectorPath(p_sink, p_outline->path, originX, 0.0f);
+				// a glyph without any figure like a space has no bounds
+				if (ap_bounds && !p_outline->path.points.empty()) {
+					const RRect &bounds = p_outline->bounds;
+					if (!hasBounds) {
+						*ap_bounds = DRect({ originX + bounds.left, bounds.top, originX + bounds.right, bounds.bottom });
+						hasBounds = true;
+					}
+					else {
+						ap_bounds->left = std::min(ap_bounds->left, originX + bounds.left);
+						ap_bounds->top = std::min(ap_bounds->top, bounds.top);
+						ap_bounds->right = std::max(ap_bounds->right, originX + bounds.right);
+						ap_bounds->bottom = std::max(ap_bounds->bottom, bounds.bottom);
+					}
+				}
+				originX += p_outline->advance;
 			}
+
 			p_sink->Close();
 			InterfaceRelease(&p_sink);
+
+			if (ap_bounds && !hasBounds) {
+				*ap_bounds = DRect({ 0.0f, 0.0f, 0.0f, 0.0f });
+			}
 		}
 	}
 
 	if (!result) {
 		InterfaceRelease(&p_pathGeometry);
 	}
-	delete[] p_codePoints;
-	delete[] p_glyphIndices;
 
 	return p_pathGeometry;
 }
 
 bool Direct2DEx::SetFontFormat(const FONT_FORMAT &a_fontFormat)
 {
-	IDWriteTextFormat *const p_textFormat = CreateTextFormat(
-		a_fontFormat.name.c_str(), a_fontFormat.size, a_fontFormat.weight, a_fontFormat.style
-	);
-	IDWriteFontFace *const p_fontFace = CreateFontFace(
-		a_fontFormat.name.c_str(), a_fontFormat.weight, a_fontFormat.style
-	);
+	FontCache *const p_fontCache = gp_appCore->GetFontCache();
+	// a new text format starts with the default alignment
+	IDWriteTextFormat *p_textFormat = p_fontCache->GetTextFormat(a_fontFormat);
+	IDWriteFontFace *p_fontFace = p_fontCache->GetFontFace(a_fontFormat);
 
 	if (nullptr != p_textFormat && nullptr != p_fontFace) {
 		InterfaceRelease(&mp_textFormat);
@@ -158,47 +254,73 @@ bool Direct2DEx::SetFontFormat(const FONT_FORMAT &a_fontFormat)
 		m_fontFormat = a_fontFormat;
 		mp_textFormat = p_textFormat;
 		mp_fontFace = p_fontFace;
+		m_isUserTextFormat = false;
+		m_textAlignment = DWRITE_TEXT_ALIGNMENT_LEADING;
+		m_paragraphAlignment = DWRITE_PARAGRAPH_ALIGNMENT_NEAR;
 
 		return true;
 	}
 
+	InterfaceRelease(&p_textFormat);
+	InterfaceRelease(&p_fontFace);
+
 	return false;
 }
 
 bool Direct2DEx::SetFontName(const wchar_t *const ap_name)
 {
-	const FONT_FORMAT fontFormat({ ap_name, m_fontFormat.size, m_fontFormat.weight, m_fontFormat.style });
+	FONT_FORMAT fontFormat = m_fontFormat;
+	fontFormat.name = ap_name;
 	return SetFontFormat(fontFormat);
 }
 
 bool Direct2DEx::SetFontSize(const float a_size)
 {
-	const FONT_FORMAT fontFormat({ m_fontFormat.name, a_size, m_fontFormat.weight, m_fontFormat.style });
+	FONT_FORMAT fontFormat = m_fontFormat;
+	fontFormat.size = a_size;
 	return SetFontFormat(fontFormat);
 }
 
 bool Direct2DEx::SetFontWeight(const DWRITE_FONT_WEIGHT a_weight)
 {
-	const FONT_FORMAT fontFormat({ m_fontFormat.name, m_fontFormat.size, a_weight, m_fontFormat.style });
+	FONT_FORMAT fontFormat = m_fontFormat;
+	fontFormat.weight = a_weight;
 	return SetFontFormat(fontFormat);
 }
 
 bool Direct2DEx::SetFontStyle(const DWRITE_FONT_STYLE a_style)
 {
-	const FONT_FORMAT fontFormat({ m_fontFormat.name, m_fontFormat.size, m_fontFormat.weight, a_style });
+	FONT_FORMAT fontFormat = m_fontFormat;
+	fontFormat.style = a_style;
 	return SetFontFormat(fontFormat);
 }
 
 void Direct2DEx::SetTextAlignment(const DWRITE_TEXT_ALIGNMENT a_hType, const DWRITE_PARAGRAPH_ALIGNMENT a_vType)
 {
-	mp_textFormat->SetTextAlignment(a_hType);
-	mp_textFormat->SetParagraphAlignment(a_vType);
+	m_textAlignment = a_hType;
+	m_paragraphAlignment = a_vType;
+
+	if (m_isUserTextFormat) {
+		mp_textFormat->SetTextAlignment(a_hType);
+		mp_textFormat->SetParagraphAlignment(a_vType);
+		return;
+	}
+
+	// a shared text format must not be changed, so the text format of the alignment is taken from the cache
+	IDWriteTextFormat *const p_textFormat = gp_appCore->GetFontCache()->GetTextFormat(m_fontFormat, a_hType, a_vType);
+	if (nullptr != p_textFormat) {
+		InterfaceRelease(&mp_textFormat);
+		mp_textFormat = p_textFormat;
+	}
 }
 
 IDWriteTextFormat *const Direct2DEx::SetTextFormat(IDWriteTextFormat *const ap_textFormat)
 {
 	IDWriteTextFormat *const prevTextFormat = mp_textFormat;
 	mp_textFormat = ap_textFormat;
+	// the layouts of a user text format can't be described by a key
+	m_isUserTextFormat = true;
+	m_layoutCache.Clear();
 
 	return prevTextFormat;
 }
@@ -213,8 +335,6 @@ IDWriteFontFace *const Direct2DEx::SetFontFace(IDWriteFontFace *const ap_fontFac
 
 DSize Direct2DEx::GetTextExtent(const wchar_t *const ap_str, const float a_maxWidth, const float a_maxHeight)
 {
-	IDWriteTextLayout *p_textLayout;
-	DWRITE_TEXT_METRICS textMetrics;
 	DSize displaySize = { 0, 0 };
 	const float maxWidth = a_maxWidth
 		? a_maxWidth
@@ -222,17 +342,26 @@ DSize Direct2DEx::GetTextExtent(const wchar_t *const ap_str, const float a_maxWi
 	const float maxHeight = a_maxHeight
 		? a_maxHeight
 		: static_cast<float>(mp_viewRect->bottom - mp_viewRect->top);
-	const unsigned int strLength = static_cast<unsigned int>(wcslen(ap_str));
 
-	if (S_OK == gp_appCore->GetWriteFactory()->CreateTextLayout(
-		ap_str, strLength, mp_textFormat, maxWidth, maxHeight, &p_textLayout
-	)) {
-		if (S_OK == p_textLayout->GetMetrics(&textMetrics)) {
-			displaySize.width = textMetrics.widthIncludingTrailingWhitespace;
-			displaySize.height = textMetrics.height;
+	auto MeasureText = [this, maxWidth, maxHeight](const wchar_t *const ap_text, DSize &a_size) {
+		const TEXT_LAYOUT_ENTRY *const p_entry = GetTextLayout(ap_text, maxWidth, maxHeight);
+		if (p_entry) {
+			a_size = { p_entry->metrics.width, p_entry->metrics.height };
+			return;
 		}
-		p_textLayout->Release();
-	}
+
+		// a layout of a user text format isn't cached
+		TEXT_METRICS metrics;
+		void *const p_layout = CreateLayout(
+			ap_text, static_cast<unsigned int>(wcslen(ap_text)), GetDisplayFont(), maxWidth, maxHeight, metrics
+		);
+		if (p_layout) {
+			a_size = { metrics.width, metrics.height };
+			ReleaseLayout(p_layout);
+		}
+	};
+
+	MeasureText(ap_str, displaySize);
 
 	if (!a_maxWidth) return displaySize;
 
@@ -258,18 +387,227 @@ DSize Direct2DEx::GetTextExtent(const wchar_t *const ap_str, const float a_maxWi
 			letter = L'1';
 		}
 
-		if (S_OK == gp_appCore->GetWriteFactory()->CreateTextLayout(
-			text.c_str(), strLength, mp_textFormat, maxWidth, maxHeight, &p_textLayout
-		)) {
-			if (S_OK == p_textLayout->GetMetrics(&textMetrics)) {
-				displaySize.width = textMetrics.widthIncludingTrailingWhitespace;
-				displaySize.height = textMetrics.height;
+		MeasureText(text.c_str(), displaySize);
+	}
+
+	return displaySize;
+}
+
+TextLayoutCache *const Direct2DEx::GetTextLayoutCache()
+{
+	return &m_layoutCache;
+}
+
+const TEXT_LAYOUT_ENTRY *const Direct2DEx::GetTextLayout(const wchar_t *const ap_text, const float a_maxWidth, const float a_maxHeight)
+{
+	if (m_isUserTextFormat) {
+		return nullptr;
+	}
+
+	return m_layoutCache.Get(ap_text, static_cast<unsigned int>(wcslen(ap_text)), GetDisplayFont(), a_maxWidth, a_maxHeight);
+}
+
+void *Direct2DEx::CreateLayout(
+	const wchar_t *const ap_text, const unsigned int a_length, const DISPLAY_FONT &a_font,
+	const float a_maxWidth, const float a_maxHeight, TEXT_METRICS &a_metrics
+)
+{
+	IDWriteTextLayout *p_textLayout = nullptr;
+	if (S_OK != gp_appCore->GetWriteFactory()->CreateTextLayout(
+		ap_text, a_length, mp_textFormat, a_maxWidth, a_maxHeight, &p_textLayout
+	)) {
+		return nullptr;
+	}
+
+	DWRITE_TEXT_METRICS textMetrics;
+	if (S_OK != p_textLayout->GetMetrics(&textMetrics)) {
+		InterfaceRelease(&p_textLayout);
+		return nullptr;
+	}
+	a_metrics.width = textMetrics.widthIncludingTrailingWhitespace;
+	a_metrics.height = textMetrics.height;
+
+	return p_textLayout;
+}
+
+void Direct2DEx::ReleaseLayout(void *const ap_layout)
+{
+	static_cast<IDWriteTextLayout *>(ap_layout)->Release();
+}
+
+GlyphOutlineCache *const Direct2DEx::GetGlyphOutlineCache()
+{
+	return &m_outlineCache;
+}
+
+GlyphAtlas *const Direct2DEx::GetGlyphAtlas()
+{
+	return &m_glyphAtlas;
+}
+
+void Direct2DEx::ClearGlyphCaches()
+{
+	m_outlineCache.Clear();
+	m_glyphAtlas.Clear();
+	for (IDWriteFontFace *&p_fontFace : m_glyphFontFaces) {
+		InterfaceRelease(&p_fontFace);
+	}
+	m_glyphFontFaces.clear();
+}
+
+bool Direct2DEx::MapGlyphIndices(const wchar_t *const ap_text)
+{
+	// the scratch buffers keep their storage between the calls
+	DecodeUtf16(ap_text, wcslen(ap_text), m_codePoints);
+	m_glyphIndices.resize(m_codePoints.size());
+	if (m_codePoints.empty()) {
+		return true;
+	}
+
+	return S_OK == mp_fontFace->GetGlyphIndicesW(
+		m_codePoints.data(), static_cast<UINT32>(m_codePoints.size()), m_glyphIndices.data()
+	);
+}
+
+void Direct2DEx::RetainGlyphFontFace(IDWriteFontFace *const ap_fontFace)
+{
+	if (m_glyphFontFaces.end() == std::find(m_glyphFontFaces.begin(), m_glyphFontFaces.end(), ap_fontFace)) {
+		ap_fontFace->AddRef();
+		m_glyphFontFaces.push_back(ap_fontFace);
+	}
+}
+
+bool Direct2DEx::CreateOutline(const void *const ap_fontFace, const unsigned short a_glyphIndex, const float a_size, GLYPH_OUTLINE &a_outline)
+{
+	IDWriteFontFace *const p_fontFace = static_cast<IDWriteFontFace *>(const_cast<void *>(ap_fontFace));
+
+	DWRITE_FONT_METRICS fontMetrics;
+	DWRITE_GLYPH_METRICS glyphMetrics;
+	p_fontFace->GetMetrics(&fontMetrics);
+	if (S_OK != p_fontFace->GetDesignGlyphMetrics(&a_glyphIndex, 1, &glyphMetrics)) {
+		return false;
+	}
+
+	OutlineSink sink(a_outline.path);
+	if (S_OK != p_fontFace->GetGlyphRunOutline(a_size, &a_glyphIndex, nullptr, nullptr, 1, false, false, &sink)) {
+		return false;
+	}
+	a_outline.advance = a_size * glyphMetrics.advanceWidth / fontMetrics.designUnitsPerEm;
+	RetainGlyphFontFace(p_fontFace);
+
+	return true;
+}
+
+bool Direct2DEx::RasterizeGlyph(
+	const void *const ap_fontFace, const unsigned short a_glyphIndex, const float a_size,
+	const float a_offsetX, GLYPH_BITMAP &a_bitmap
+)
+{
+	IDWriteFontFace *const p_fontFace = static_cast<IDWriteFontFace *>(const_cast<void *>(ap_fontFace));
+
+	DWRITE_FONT_METRICS fontMetrics;
+	DWRITE_GLYPH_METRICS glyphMetrics;
+	p_fontFace->GetMetrics(&fontMetrics);
+	if (S_OK != p_fontFace->GetDesignGlyphMetrics(&a_glyphIndex, 1, &glyphMetrics)) {
+		return false;
+	}
+	a_bitmap.advance = a_size * glyphMetrics.advanceWidth / fontMetrics.designUnitsPerEm;
+
+	const float advance = 0.0f;
+	const DWRITE_GLYPH_RUN glyphRun = { p_fontFace, a_size, 1, &a_glyphIndex, &advance, nullptr, FALSE, 0 };
+	IDWriteGlyphRunAnalysis *p_analysis = nullptr;
+	if (S_OK != gp_appCore->GetWriteFactory()->CreateGlyphRunAnalysis(
+		&glyphRun, 1.0f, nullptr, DWRITE_RENDERING_MODE_CLEARTYPE_NATURAL_SYMMETRIC,
+		DWRITE_MEASURING_MODE_NATURAL, a_offsetX, 0.0f, &p_analysis
+	)) {
+		return false;
+	}
+
+	bool result = false;
+	RECT bounds;
+	if (S_OK == p_analysis->GetAlphaTextureBounds(DWRITE_TEXTURE_CLEARTYPE_3x1, &bounds)) {
+		result = true;
+		a_bitmap.left = bounds.left;
+		a_bitmap.top = bounds.top;
+
+		if (bounds.right > bounds.left && bounds.bottom > bounds.top) {
+			const int width = bounds.right - bounds.left;
+			const int height = bounds.bottom - bounds.top;
+			std::vector<unsigned char> clearTypeAlpha(static_cast<size_t>(width) * height * 3);
+
+			result = S_OK == p_analysis->CreateAlphaTexture(
+				DWRITE_TEXTURE_CLEARTYPE_3x1, &bounds, clearTypeAlpha.data(), static_cast<UINT32>(clearTypeAlpha.size())
+			);
+			if (result) {
+				// the atlas is grayscale, so the coverages of the three subpixels are averaged
+				a_bitmap.width = width;
+				a_bitmap.height = height;
+				a_bitmap.alpha.resize(static_cast<size_t>(width) * height);
+				for (size_t i = 0; i < a_bitmap.alpha.size(); i++) {
+					a_bitmap.alpha[i] = static_cast<unsigned char>(
+						(clearTypeAlpha[i * 3] + clearTypeAlpha[i * 3 + 1] + clearTypeAlpha[i * 3 + 2]) / 3
+					);
+				}
 			}
-			p_textLayout->Release();
 		}
 	}
+	InterfaceRelease(&p_analysis);
 
-	return displaySize;
+	if (result) {
+		RetainGlyphFontFace(p_fontFace);
+	}
+
+	return result;
+}
+
+DISPLAY_FONT Direct2DEx::GetDisplayFont()
+{
+	return DISPLAY_FONT({
+		m_fontFormat.name, m_fontFormat.size,
+		static_cast<int>(m_fontFormat.weight), static_cast<int>(m_fontFormat.style),
+		static_cast<int>(m_textAlignment), static_cast<int>(m_paragraphAlignment),
+		static_cast<int>(m_fontFormat.stretch), m_fontFormat.locale
+	});
+}
+
+void Direct2DEx::DrawDisplayList(const DisplayList &a_list)
+{
+	const FONT_FORMAT fontFormat = m_fontFormat;
+	const DWRITE_TEXT_ALIGNMENT textAlignment = m_textAlignment;
+	const DWRITE_PARAGRAPH_ALIGNMENT paragraphAlignment = m_paragraphAlignment;
+	const DISPLAY_FONT displayFont = GetDisplayFont();
+
+	Direct2D::DrawDisplayList(a_list);
+
+	if (!(GetDisplayFont() == displayFont)) {
+		SetFontFormat(fontFormat);
+		SetTextAlignment(textAlignment, paragraphAlignment);
+	}
+}
+
+void Direct2DEx::ReplayCommand(const DisplayList &a_list, const DISPLAY_COMMAND &a_command)
+{
+	if (DISPLAY_DRAW_TEXT != a_command.opcode) {
+		Direct2D::ReplayCommand(a_list, a_command);
+		return;
+	}
+
+	const DISPLAY_FONT &font = a_list.GetFont(a_command);
+	if (!(GetDisplayFont() == font)) {
+		SetFontFormat(FONT_FORMAT({
+			font.name, font.size,
+			static_cast<DWRITE_FONT_WEIGHT>(font.weight), static_cast<DWRITE_FONT_STYLE>(font.style),
+			static_cast<DWRITE_FONT_STRETCH>(font.stretch), font.locale
+		}));
+		SetTextAlignment(
+			static_cast<DWRITE_TEXT_ALIGNMENT>(font.textAlignment),
+			static_cast<DWRITE_PARAGRAPH_ALIGNMENT>(font.paragraphAlignment)
+		);
+	}
+
+	SetBrushColor(ToDirect2DColor(a_command.color));
+	SetMatrixTransform(ToDirect2DMatrix(a_list.GetTransform(a_command)));
+	DrawUserText(a_list.GetText(a_command), ToDirect2DRect(a_command.rect));
 }
 
 ////////////////////////////////////
@@ -278,15 +616,40 @@ DSize Direct2DEx::GetTextExtent(const wchar_t *const ap_str, const float a_maxWi
 
 void Direct2DEx::DrawUserText(const wchar_t *const ap_text, const DRect &ap_rect)
 {
-	mp_renderTarget->DrawText(ap_text, wcslen(ap_text), mp_textFormat, ap_rect, mp_brush);
+	if (mp_displayList) {
+		mp_displayList->AddText(
+			ap_text, static_cast<unsigned int>(wcslen(ap_text)), ToRenderRect(ap_rect), GetDisplayFont(),
+			ToRenderColor(m_brushColor), ToRenderMatrix(m_transform)
+		);
+		return;
+	}
+
+	if (!IsInDrawRegion(ap_rect)) {
+		return;
+	}
+
+	// the layout box of `DrawText` is the rectangle
+	const TEXT_LAYOUT_ENTRY *const p_entry = GetTextLayout(
+		ap_text, ap_rect.right - ap_rect.left, ap_rect.bottom - ap_rect.top
+	);
+	if (p_entry) {
+		mp_renderTarget->DrawTextLayout(
+			DPoint({ ap_rect.left, ap_rect.top }), static_cast<IDWriteTextLayout *>(p_entry->p_layout), mp_brush
+		);
+		return;
+	}
+
+	mp_renderTarget->DrawText(ap_text, static_cast<UINT32>(wcslen(ap_text)), mp_textFormat, ap_rect, mp_brush);
 }
 
 DRect Direct2DEx::DrawTextOutline(const wchar_t *const ap_text, const DPoint &a_startPos, const float a_textHeight)
 {
-	ID2D1PathGeometry *p_textPathGeometry = CreateTextPathGeometry(ap_text, m_fontFormat.size);
-	
 	DRect rect;
-	p_textPathGeometry->GetBounds(nullptr, &rect);
+	ID2D1PathGeometry *p_textPathGeometry = CreateTextPathGeometry(ap_text, m_fontFormat.size, &rect);
+	if (nullptr == p_textPathGeometry) {
+		return DRect({ a_startPos.x, a_startPos.y, a_startPos.x, a_startPos.y });
+	}
+
 	rect.left = a_startPos.x;
 	rect.right = rect.left + (rect.right - rect.left) + m_strokeWidth;
 
@@ -294,11 +657,113 @@ DRect Direct2DEx::DrawTextOutline(const wchar_t *const ap_text, const DPoint &a_
 		? m_fontFormat.size
 		: a_textHeight;
 
-	mp_renderTarget->SetTransform(D2D1::Matrix3x2F::Translation(a_startPos.x, a_startPos.y + (textHeight + rect.bottom - rect.top) * 0.5f));
-	mp_renderTarget->DrawGeometry(p_textPathGeometry, mp_brush, m_strokeWidth, mp_strokeStyle);
-	mp_renderTarget->SetTransform(D2D1::Matrix3x2F::Translation(0.0f, 0.0f));
+	const D2D1_MATRIX_3X2_F translation = D2D1::Matrix3x2F::Translation(
+		a_startPos.x, a_startPos.y + (textHeight + rect.bottom - rect.top) * 0.5f
+	);
+	// the outline is placed in the coordinates of the caller's transform
+	PushState();
+	SetMatrixTransform(ToDirect2DMatrix(MultiplyMatrix(ToRenderMatrix(translation), ToRenderMatrix(m_transform))));
+	DrawGeometry(p_textPathGeometry);
+	PopState();
 
 	InterfaceRelease(&p_textPathGeometry);
 
 	return rect;
+}
+
+void Direct2DEx::DrawAtlasText(const wchar_t *const ap_text, const DPoint &a_position)
+{
+	if (mp_displayList) {
+		const DSize size = GetTextExtent(ap_text);
+		DrawUserText(ap_text, DRect({ a_position.x, a_position.y, a_position.x + size.width, a_position.y + size.height }));
+		return;
+	}
+
+	if (!MapGlyphIndices(ap_text)) {
+		return;
+	}
+
+	DWRITE_FONT_METRICS fontMetrics;
+	mp_fontFace->GetMetrics(&fontMetrics);
+	const float scale = m_fontFormat.size / fontMetrics.designUnitsPerEm;
+	const float baseline = std::round(a_position.y + fontMetrics.ascent * scale);
+	const float subpixelCount = static_cast<float>(m_glyphAtlas.GetSubpixelCount());
+
+	// the glyphs of a text have to be in the same generation of the atlas, so it starts over once after an eviction
+	bool result = false;
+	float penX = a_position.x;
+	for (int attempt = 0; attempt < 2 && !result; attempt++) {
+		const unsigned int generation = m_glyphAtlas.GetGeneration();
+		m_glyphRects.clear();
+		penX = a_position.x;
+		result = true;
+
+		for (const unsigned short glyphIndex : m_glyphIndices) {
+			// the pen is placed on the nearest subpixel position of the atlas
+			const float originX = std::round(penX * subpixelCount) / subpixelCount;
+			ATLAS_GLYPH glyph;
+			if (!m_glyphAtlas.Get(mp_fontFace, glyphIndex, m_fontFormat.size, originX, glyph)) {
+				result = false;
+				break;
+			}
+
+			if (glyph.width > 0) {
+				const float left = std::floor(originX) + glyph.left;
+				const float top = baseline + glyph.top;
+				m_glyphRects.push_back(DRect({ left, top, left + glyph.width, top + glyph.height }));
+				m_glyphRects.push_back(DRect({
+					static_cast<float>(glyph.x), static_cast<float>(glyph.y),
+					static_cast<float>(glyph.x + glyph.width), static_cast<float>(glyph.y + glyph.height)
+				}));
+			}
+			penX += glyph.advance;
+		}
+
+		if (generation != m_glyphAtlas.GetGeneration()) {
+			result = false;
+		}
+	}
+
+	if (!result) {
+		const DSize size = GetTextExtent(ap_text);
+		DrawUserText(ap_text, DRect({ a_position.x, a_position.y, a_position.x + size.width, a_position.y + size.height }));
+		return;
+	}
+
+	const DRect bounds = {
+		a_position.x, a_position.y, penX, a_position.y + (fontMetrics.ascent + fontMetrics.descent) * scale
+	};
+	if (m_glyphRects.empty() || !IsInDrawRegion(bounds)) {
+		return;
+	}
+
+	if (nullptr == mp_atlasBitmap) {
+		if (S_OK != mp_renderTarget->CreateBitmap(
+			D2D1::SizeU(m_glyphAtlas.GetWidth(), m_glyphAtlas.GetHeight()), nullptr, 0,
+			D2D1::BitmapProperties(D2D1::PixelFormat(DXGI_FORMAT_A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED)),
+			&mp_atlasBitmap
+		)) {
+			return;
+		}
+		m_glyphAtlas.InvalidateRows();
+	}
+
+	// only the rows of the new glyphs are uploaded
+	int top, bottom;
+	if (m_glyphAtlas.GetDirtyRows(top, bottom)) {
+		const UINT32 pitch = static_cast<UINT32>(m_glyphAtlas.GetWidth());
+		const D2D1_RECT_U rect = D2D1::RectU(0, top, pitch, bottom);
+		mp_atlasBitmap->CopyFromMemory(&rect, m_glyphAtlas.GetPixels() + static_cast<size_t>(top) * pitch, pitch);
+		m_glyphAtlas.ClearDirtyRows();
+	}
+
+	// an opacity mask is only filled without antialiasing. all glyphs come from one bitmap, so they are batched
+	const D2D1_ANTIALIAS_MODE antialiasMode = mp_renderTarget->GetAntialiasMode();
+	mp_renderTarget->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
+	for (size_t i = 0; i < m_glyphRects.size(); i += 2) {
+		mp_renderTarget->FillOpacityMask(
+			mp_atlasBitmap, mp_brush, D2D1_OPACITY_MASK_CONTENT_TEXT_NATURAL, &m_glyphRects[i], &m_glyphRects[i + 1]
+		);
+	}
+	mp_renderTarget->SetAntialiasMode(antialiasMode);
 }
\ No newline at end of file
@@ -0,0 +1,245 @@
+#include "DirtyRegion.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	float GetRectArea(const RRect &a_rect)
+	{
+		return (a_rect.right - a_rect.left) * (a_rect.bottom - a_rect.top);
+	}
+
+	RRect GetUnion(const RRect &a_rect, const RRect &a_otherRect)
+	{
+		return RRect({
+			std::min(a_rect.left, a_otherRect.left), std::min(a_rect.top, a_otherRect.top),
+			std::max(a_rect.right, a_otherRect.right), std::max(a_rect.bottom, a_otherRect.bottom)
+		});
+	}
+
+	bool IsOverlapped(const RRect &a_rect, const RRect &a_otherRect)
+	{
+		return a_rect.left < a_otherRect.right && a_otherRect.left < a_rect.right &&
+			a_rect.top < a_otherRect.bottom && a_otherRect.top < a_rect.bottom;
+	}
+
+	bool IsContained(const RRect &a_rect, const RRect &a_outerRect)
+	{
+		return a_outerRect.left <= a_rect.left && a_outerRect.top <= a_rect.top &&
+			a_rect.right <= a_outerRect.right && a_rect.bottom <= a_outerRect.bottom;
+	}
+
+	// two neighbours which share a whole side are merged without any wasted area
+	bool IsAdjoined(const RRect &a_rect, const RRect &a_otherRect)
+	{
+		if (a_rect.top == a_otherRect.top && a_rect.bottom == a_otherRect.bottom) {
+			return a_rect.right == a_otherRect.left || a_otherRect.right == a_rect.left;
+		}
+		if (a_rect.left == a_otherRect.left && a_rect.right == a_otherRect.right) {
+			return a_rect.bottom == a_otherRect.top || a_otherRect.bottom == a_rect.top;
+		}
+
+		return false;
+	}
+}
+
+DirtyRegion::DirtyRegion(const unsigned int a_maxRectCount)
+{
+	m_bounds = { 0.0f, 0.0f, 0.0f, 0.0f };
+	m_maxRectCount = std::max(a_maxRectCount, 1u);
+	m_isFull = false;
+}
+
+DirtyRegion::~DirtyRegion()
+{
+
+}
+
+void DirtyRegion::SetBounds(const RRect &a_bounds)
+{
+	m_bounds = a_bounds;
+	if (m_isFull) {
+		m_rects.assign(1, m_bounds);
+	}
+}
+
+const RRect &DirtyRegion::GetBounds() const
+{
+	return m_bounds;
+}
+
+void DirtyRegion::Add(const RRect &a_rect)
+{
+	if (m_isFull) {
+		return;
+	}
+
+	RRect rect = {
+		std::floor(std::min(a_rect.left, a_rect.right)), std::floor(std::min(a_rect.top, a_rect.bottom)),
+		std::ceil(std::max(a_rect.left, a_rect.right)), std::ceil(std::max(a_rect.top, a_rect.bottom))
+	};
+	if (HasBounds()) {
+		rect.left = std::max(rect.left, m_bounds.left);
+		rect.top = std::max(rect.top, m_bounds.top);
+		rect.right = std::min(rect.right, m_bounds.right);
+		rect.bottom = std::min(rect.bottom, m_bounds.bottom);
+	}
+	if (rect.right <= rect.left || rect.bottom <= rect.top) {
+		return;
+	}
+
+	Insert(rect);
+	Reduce();
+
+	if (HasBounds() && 1 == m_rects.size() && IsContained(m_bounds, m_rects[0])) {
+		AddAll();
+	}
+}
+
+void DirtyRegion::Add(const DirtyRegion &a_region)
+{
+	if (a_region.m_isFull) {
+		AddAll();
+		return;
+	}
+
+	for (const RRect &rect : a_region.m_rects) {
+		Add(rect);
+	}
+}
+
+void DirtyRegion::AddAll()
+{
+	m_isFull = true;
+	m_rects.assign(1, m_bounds);
+}
+
+void DirtyRegion::Reset()
+{
+	m_isFull = false;
+	m_rects.clear();
+}
+
+void DirtyRegion::Swap(DirtyRegion &a_region)
+{
+	m_rects.swap(a_region.m_rects);
+	std::swap(m_bounds, a_region.m_bounds);
+	std::swap(m_maxRectCount, a_region.m_maxRectCount);
+	std::swap(m_isFull, a_region.m_isFull);
+}
+
+const bool DirtyRegion::IsEmpty() const
+{
+	return !m_isFull && m_rects.empty();
+}
+
+const bool DirtyRegion::IsFull() const
+{
+	return m_isFull;
+}
+
+const unsigned int DirtyRegion::GetRectCount() const
+{
+	return static_cast<unsigned int>(m_rects.size());
+}
+
+const RRect *const DirtyRegion::GetRects() const
+{
+	return m_rects.data();
+}
+
+const RRect DirtyRegion::GetExtent() const
+{
+	if (m_rects.empty()) {
+		return RRect({ 0.0f, 0.0f, 0.0f, 0.0f });
+	}
+
+	RRect extent = m_rects[0];
+	for (const RRect &rect : m_rects) {
+		extent = GetUnion(extent, rect);
+	}
+
+	return extent;
+}
+
+const float DirtyRegion::GetArea() const
+{
+	float area = 0.0f;
+	for (const RRect &rect : m_rects) {
+		area += GetRectArea(rect);
+	}
+
+	return area;
+}
+
+const bool DirtyRegion::Intersects(const RRect &a_rect) const
+{
+	if (m_isFull) {
+		return true;
+	}
+
+	for (const RRect &rect : m_rects) {
+		if (IsOverlapped(rect, a_rect)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void DirtyRegion::Insert(RRect a_rect)
+{
+	size_t index = 0;
+	while (index < m_rects.size()) {
+		const RRect &rect = m_rects[index];
+		if (IsContained(a_rect, rect)) {
+			return;
+		}
+
+		// the union can overlap a rectangle which has already been checked
+		if (IsOverlapped(a_rect, rect) || IsAdjoined(a_rect, rect)) {
+			a_rect = GetUnion(a_rect, rect);
+			m_rects[index] = m_rects.back();
+			m_rects.pop_back();
+			index = 0;
+		}
+		else {
+			index++;
+		}
+	}
+
+	m_rects.push_back(a_rect);
+}
+
+void DirtyRegion::Reduce()
+{
+	while (m_rects.size() > m_maxRectCount) {
+		size_t firstIndex = 0;
+		size_t secondIndex = 1;
+		float minWaste = -1.0f;
+
+		for (size_t i = 0; i < m_rects.size(); i++) {
+			for (size_t j = i + 1; j < m_rects.size(); j++) {
+				const float waste = GetRectArea(GetUnion(m_rects[i], m_rects[j])) -
+					GetRectArea(m_rects[i]) - GetRectArea(m_rects[j]);
+				if (minWaste < 0.0f || waste < minWaste) {
+					minWaste = waste;
+					firstIndex = i;
+					secondIndex = j;
+				}
+			}
+		}
+
+		const RRect rect = GetUnion(m_rects[firstIndex], m_rects[secondIndex]);
+		m_rects[secondIndex] = m_rects.back();
+		m_rects.pop_back();
+		m_rects[firstIndex] = m_rects.back();
+		m_rects.pop_back();
+		Insert(rect);
+	}
+}
+
+const bool DirtyRegion::HasBounds() const
+{
+	return m_bounds.right > m_bounds.left && m_bounds.bottom > m_bounds.top;
+}
\ No newline at end of file
@@ -0,0 +1,417 @@
+#include "DisplayList.h"
+#include <cstring>
+
+bool DISPLAY_FONT::operator==(const DISPLAY_FONT &a_font) const
+{
+	return name == a_font.name && size == a_font.size && weight == a_font.weight && style == a_font.style &&
+		textAlignment == a_font.textAlignment && paragraphAlignment == a_font.paragraphAlignment &&
+		stretch == a_font.stretch && locale == a_font.locale;
+}
+
+DisplayList::DisplayList()
+{
+
+}
+
+DisplayList::~DisplayList()
+{
+
+}
+
+void DisplayList::Reset()
+{
+	m_commands.clear();
+	m_transforms.clear();
+	m_points.clear();
+	m_contourSizes.clear();
+	m_text.clear();
+	m_fonts.clear();
+}
+
+void DisplayList::Swap(DisplayList &a_list)
+{
+	m_commands.swap(a_list.m_commands);
+	m_transforms.swap(a_list.m_transforms);
+	m_points.swap(a_list.m_points);
+	m_contourSizes.swap(a_list.m_contourSizes);
+	m_text.swap(a_list.m_text);
+	m_fonts.swap(a_list.m_fonts);
+}
+
+const unsigned int DisplayList::AddTransform(const RMatrix &a_transform)
+{
+	// most commands share the transform of the previous command
+	if (m_transforms.empty() || 0 != memcmp(&m_transforms.back(), &a_transform, sizeof(RMatrix))) {
+		m_transforms.push_back(a_transform);
+	}
+
+	return static_cast<unsigned int>(m_transforms.size() - 1);
+}
+
+void DisplayList::AddClear(const RColor &a_color)
+{
+	DISPLAY_COMMAND command = {};
+	command.opcode = DISPLAY_CLEAR;
+	command.transformIndex = AddTransform(IdentityMatrix());
+	command.color = a_color;
+
+	m_commands.push_back(command);
+}
+
+void DisplayList::AddShape(
+	const DISPLAY_OPCODE a_opcode, const RRect &a_rect, const float a_radius,
+	const RColor &a_color, const float a_strokeWidth, const RMatrix &a_transform
+)
+{
+	DISPLAY_COMMAND command = {};
+	command.opcode = a_opcode;
+	command.transformIndex = AddTransform(a_transform);
+	command.rect = a_rect;
+	command.radius = a_radius;
+	command.strokeWidth = a_strokeWidth;
+	command.color = a_color;
+
+	m_commands.push_back(command);
+}
+
+void DisplayList::AddPolygon(
+	const DISPLAY_OPCODE a_opcode, const RPoint *const ap_points, const unsigned int *const ap_contourSizes,
+	const unsigned int a_contourCount, const RColor &a_color, const float a_strokeWidth, const RMatrix &a_transform
+)
+{
+	DISPLAY_COMMAND command = {};
+	command.opcode = a_opcode;
+	command.transformIndex = AddTransform(a_transform);
+	command.strokeWidth = a_strokeWidth;
+	command.color = a_color;
+	command.dataIndex = static_cast<unsigned int>(m_contourSizes.size());
+	command.dataCount = a_contourCount;
+	command.pointIndex = static_cast<unsigned int>(m_points.size());
+
+	// the bounding rectangle of the points is kept in `rect`
+	unsigned int pointCount = 0;
+	for (unsigned int i = 0; i < a_contourCount; i++) {
+		pointCount += ap_contourSizes[i];
+	}
+	m_contourSizes.insert(m_contourSizes.end(), ap_contourSizes, ap_contourSizes + a_contourCount);
+	m_points.insert(m_points.end(), ap_points, ap_points + pointCount);
+
+	if (pointCount) {
+		command.rect = { ap_points[0].x, ap_points[0].y, ap_points[0].x, ap_points[0].y };
+		for (unsigned int i = 1; i < pointCount; i++) {
+			if (ap_points[i].x < command.rect.left) command.rect.left = ap_points[i].x;
+			if (ap_points[i].y < command.rect.top) command.rect.top = ap_points[i].y;
+			if (ap_points[i].x > command.rect.right) command.rect.right = ap_points[i].x;
+			if (ap_points[i].y > command.rect.bottom) command.rect.bottom = ap_points[i].y;
+		}
+	}
+
+	m_commands.push_back(command);
+}
+
+void DisplayList::AddText(
+	const wchar_t *const ap_text, const unsigned int a_length, const RRect &a_rect, const DISPLAY_FONT &a_font,
+	const RColor &a_color, const RMatrix &a_transform
+)
+{
+	DISPLAY_COMMAND command = {};
+	command.opcode = DISPLAY_DRAW_TEXT;
+	command.transformIndex = AddTransform(a_transform);
+	command.rect = a_rect;
+	command.color = a_color;
+	command.dataIndex = static_cast<unsigned int>(m_text.size());
+	command.dataCount = a_length;
+
+	if (m_fonts.empty() || !(m_fonts.back() == a_font)) {
+		m_fonts.push_back(a_font);
+	}
+	command.pointIndex = static_cast<unsigned int>(m_fonts.size() - 1);
+	m_text.append(ap_text, a_length);
+	// each text ends with a null character so that it can be passed as a string
+	m_text.push_back(L'\0');
+
+	m_commands.push_back(command);
+}
+
+void DisplayList::AddBitmap(
+	const wchar_t *const ap_path, const unsigned int a_length, const RRect &a_rect, const float a_opacity,
+	const unsigned long long a_imageID, const RColor &a_color, const RMatrix &a_transform
+)
+{
+	DISPLAY_COMMAND command = {};
+	command.opcode = DISPLAY_DRAW_BITMAP;
+	command.transformIndex = AddTransform(a_transform);
+	command.rect = a_rect;
+	command.radius = a_opacity;
+	command.color = a_color;
+	command.dataIndex = static_cast<unsigned int>(m_text.size());
+	command.dataCount = a_length;
+	// the ids of the decoded images don't wrap around in practice, the low bits are enough to tell them apart
+	command.pointIndex = static_cast<unsigned int>(a_imageID);
+	m_text.append(ap_path, a_length);
+	m_text.push_back(L'\0');
+
+	m_commands.push_back(command);
+}
+
+const unsigned int DisplayList::GetCommandCount() const
+{
+	return static_cast<unsigned int>(m_commands.size());
+}
+
+const DISPLAY_COMMAND *const DisplayList::GetCommands() const
+{
+	return m_commands.data();
+}
+
+const RMatrix &DisplayList::GetTransform(const DISPLAY_COMMAND &a_command) const
+{
+	return m_transforms[a_command.transformIndex];
+}
+
+const RPoint *const DisplayList::GetPoints(const DISPLAY_COMMAND &a_command) const
+{
+	return m_points.data() + a_command.pointIndex;
+}
+
+const unsigned int *const DisplayList::GetContourSizes(const DISPLAY_COMMAND &a_command) const
+{
+	return m_contourSizes.data() + a_command.dataIndex;
+}
+
+const wchar_t *const DisplayList::GetText(const DISPLAY_COMMAND &a_command) const
+{
+	return m_text.c_str() + a_command.dataIndex;
+}
+
+const DISPLAY_FONT &DisplayList::GetFont(const DISPLAY_COMMAND &a_command) const
+{
+	return m_fonts[a_command.pointIndex];
+}
+
+const bool DisplayList::IsEqualCommand(const DisplayList &a_list, const DISPLAY_COMMAND &a_command, const DISPLAY_COMMAND &a_otherCommand) const
+{
+	// the fields are compared bitwise so that a changed NaN or a signed zero counts as a change
+	if (a_command.opcode != a_otherCommand.opcode || a_command.dataCount != a_otherCommand.dataCount ||
+		0 != memcmp(&a_command.rect, &a_otherCommand.rect, sizeof(RRect)) ||
+		0 != memcmp(&a_command.radius, &a_otherCommand.radius, sizeof(float)) ||
+		0 != memcmp(&a_command.strokeWidth, &a_otherCommand.strokeWidth, sizeof(float)) ||
+		0 != memcmp(&a_command.color, &a_otherCommand.color, sizeof(RColor)) ||
+		0 != memcmp(&GetTransform(a_command), &a_list.GetTransform(a_otherCommand), sizeof(RMatrix))) {
+		return false;
+	}
+
+	if (DISPLAY_DRAW_POLYLINE == a_command.opcode || DISPLAY_FILL_POLYGON == a_command.opcode) {
+		const unsigned int *const p_sizes = GetContourSizes(a_command);
+		if (0 != memcmp(p_sizes, a_list.GetContourSizes(a_otherCommand), sizeof(unsigned int) * a_command.dataCount)) {
+			return false;
+		}
+
+		size_t pointCount = 0;
+		for (unsigned int i = 0; i < a_command.dataCount; i++) {
+			pointCount += p_sizes[i];
+		}
+		return 0 == memcmp(GetPoints(a_command), a_list.GetPoints(a_otherCommand), sizeof(RPoint) * pointCount);
+	}
+
+	if (DISPLAY_DRAW_TEXT == a_command.opcode) {
+		return 0 == memcmp(GetText(a_command), a_list.GetText(a_otherCommand), sizeof(wchar_t) * a_command.dataCount) &&
+			GetFont(a_command) == a_list.GetFont(a_otherCommand);
+	}
+
+	if (DISPLAY_DRAW_BITMAP == a_command.opcode) {
+		return a_command.pointIndex == a_otherCommand.pointIndex &&
+			0 == memcmp(GetText(a_command), a_list.GetText(a_otherCommand), sizeof(wchar_t) * a_command.dataCount);
+	}
+
+	return true;
+}
+
+const unsigned int DisplayList::FindFirstDifference(const DisplayList &a_list) const
+{
+	const size_t count = m_commands.size() < a_list.m_commands.size() ? m_commands.size() : a_list.m_commands.size();
+	for (size_t i = 0; i < count; i++) {
+		if (!IsEqualCommand(a_list, m_commands[i], a_list.m_commands[i])) {
+			return static_cast<unsigned int>(i);
+		}
+	}
+
+	return static_cast<unsigned int>(count);
+}
+
+const bool DisplayList::IsEqual(const DisplayList &a_list) const
+{
+	// the lists which are recorded by the same calls have the same tables, so this is the usual fast path
+	if (m_commands.size() == a_list.m_commands.size() &&
+		m_transforms.size() == a_list.m_transforms.size() &&
+		m_points.size() == a_list.m_points.size() &&
+		m_contourSizes.size() == a_list.m_contourSizes.size() &&
+		m_fonts == a_list.m_fonts && m_text == a_list.m_text &&
+		0 == memcmp(m_commands.data(), a_list.m_commands.data(), sizeof(DISPLAY_COMMAND) * m_commands.size()) &&
+		0 == memcmp(m_transforms.data(), a_list.m_transforms.data(), sizeof(RMatrix) * m_transforms.size()) &&
+		0 == memcmp(m_points.data(), a_list.m_points.data(), sizeof(RPoint) * m_points.size()) &&
+		0 == memcmp(m_contourSizes.data(), a_list.m_contourSizes.data(), sizeof(unsigned int) * m_contourSizes.size())) {
+		return true;
+	}
+
+	return m_commands.size() == a_list.m_commands.size() && FindFirstDifference(a_list) == m_commands.size();
+}
+
+const RRect DisplayList::GetBounds(const DISPLAY_COMMAND &a_command) const
+{
+	float margin = 0.0f;
+	switch (a_command.opcode) {
+	case DISPLAY_DRAW_LINE:
+	case DISPLAY_DRAW_RECTANGLE:
+	case DISPLAY_DRAW_ROUNDED_RECTANGLE:
+	case DISPLAY_DRAW_ELLIPSE:
+	case DISPLAY_DRAW_POLYLINE:
+		margin = a_command.strokeWidth * 0.5f;
+		break;
+	default:
+		break;
+	}
+
+	const RRect &rect = a_command.rect;
+	const RRect bounds = {
+		(rect.left < rect.right ? rect.left : rect.right) - margin,
+		(rect.top < rect.bottom ? rect.top : rect.bottom) - margin,
+		(rect.left < rect.right ? rect.right : rect.left) + margin,
+		(rect.top < rect.bottom ? rect.bottom : rect.top) + margin
+	};
+
+	return TransformBounds(GetTransform(a_command), bounds);
+}
+
+void DisplayList::AddDifference(const DisplayList &a_list, DirtyRegion &a_region) const
+{
+	const size_t count = m_commands.size() < a_list.m_commands.size() ? m_commands.size() : a_list.m_commands.size();
+	for (size_t i = 0; i < count && !a_region.IsFull(); i++) {
+		const DISPLAY_COMMAND &command = m_commands[i];
+		const DISPLAY_COMMAND &otherCommand = a_list.m_commands[i];
+		if (IsEqualCommand(a_list, command, otherCommand)) {
+			continue;
+		}
+
+		if (DISPLAY_CLEAR == command.opcode || DISPLAY_CLEAR == otherCommand.opcode) {
+			a_region.AddAll();
+			return;
+		}
+		a_region.Add(GetBounds(command));
+		a_region.Add(a_list.GetBounds(otherCommand));
+	}
+
+	// the remaining commands of the longer list have no counterpart
+	const DisplayList &longerList = m_commands.size() < a_list.m_commands.size() ? a_list : *this;
+	for (size_t i = count; i < longerList.m_commands.size() && !a_region.IsFull(); i++) {
+		if (DISPLAY_CLEAR == longerList.m_commands[i].opcode) {
+			a_region.AddAll();
+			return;
+		}
+		a_region.Add(longerList.GetBounds(longerList.m_commands[i]));
+	}
+}
+
+void DisplayList::Replay(RenderBackend *const ap_backend) const
+{
+	const DISPLAY_COMMAND *p_prevCommand = nullptr;
+	// the intersection of the pushed clips in pixels
+	std::vector<RRect> clipRects;
+
+	for (const DISPLAY_COMMAND &command : m_commands) {
+		ReplayCommand(ap_backend, command, p_prevCommand, clipRects);
+		p_prevCommand = &command;
+	}
+
+	if (!clipRects.empty()) {
+		ap_backend->ResetClipRect();
+	}
+}
+
+void DisplayList::Replay(RenderBackend *const ap_backend, const unsigned int *const ap_indices, const unsigned int a_count) const
+{
+	const DISPLAY_COMMAND *p_prevCommand = nullptr;
+	std::vector<RRect> clipRects;
+
+	for (unsigned int i = 0; i < a_count; i++) {
+		const DISPLAY_COMMAND &command = m_commands[ap_indices[i]];
+		ReplayCommand(ap_backend, command, p_prevCommand, clipRects);
+		p_prevCommand = &command;
+	}
+
+	if (!clipRects.empty()) {
+		ap_backend->ResetClipRect();
+	}
+}
+
+void DisplayList::ReplayCommand(
+	RenderBackend *const ap_backend, const DISPLAY_COMMAND &a_command, const DISPLAY_COMMAND *const ap_prevCommand,
+	std::vector<RRect> &a_clipRects
+) const
+{
+	// only the changed state is passed to the backend
+	if (!ap_prevCommand || 0 != memcmp(&ap_prevCommand->color, &a_command.color, sizeof(RColor))) {
+		ap_backend->SetColor(a_command.color);
+	}
+	if (!ap_prevCommand || ap_prevCommand->strokeWidth != a_command.strokeWidth) {
+		ap_backend->SetStrokeWidth(a_command.strokeWidth);
+	}
+	if (!ap_prevCommand || ap_prevCommand->transformIndex != a_command.transformIndex) {
+		ap_backend->SetTransform(GetTransform(a_command));
+	}
+
+	const RRect &rect = a_command.rect;
+	switch (a_command.opcode) {
+	case DISPLAY_CLEAR:
+		ap_backend->Clear(a_command.color);
+		break;
+	case DISPLAY_DRAW_LINE:
+		ap_backend->DrawLine(RPoint({ rect.left, rect.top }), RPoint({ rect.right, rect.bottom }));
+		break;
+	case DISPLAY_DRAW_RECTANGLE:
+		ap_backend->DrawRectangle(rect);
+		break;
+	case DISPLAY_DRAW_ROUNDED_RECTANGLE:
+		ap_backend->DrawRoundedRectangle(rect, a_command.radius);
+		break;
+	case DISPLAY_DRAW_ELLIPSE:
+		ap_backend->DrawEllipse(rect);
+		break;
+	case DISPLAY_DRAW_POLYLINE:
+		ap_backend->DrawPolyline(GetPoints(a_command), GetContourSizes(a_command), a_command.dataCount);
+		break;
+	case DISPLAY_FILL_RECTANGLE:
+	case DISPLAY_DRAW_BITMAP:
+		ap_backend->FillRectangle(rect);
+		break;
+	case DISPLAY_FILL_ROUNDED_RECTANGLE:
+		ap_backend->FillRoundedRectangle(rect, a_command.radius);
+		break;
+	case DISPLAY_FILL_ELLIPSE:
+		ap_backend->FillEllipse(rect);
+		break;
+	case DISPLAY_FILL_POLYGON:
+		ap_backend->FillPolygon(GetPoints(a_command), GetContourSizes(a_command), a_command.dataCount);
+		break;
+	case DISPLAY_PUSH_CLIP:
+		a_clipRects.push_back(TransformBounds(GetTransform(a_command), rect));
+		if (1 < a_clipRects.size()) {
+			a_clipRects.back() = IntersectBounds(a_clipRects.back(), a_clipRects[a_clipRects.size() - 2]);
+		}
+		ap_backend->SetClipRect(a_clipRects.back());
+		break;
+	case DISPLAY_POP_CLIP:
+		if (!a_clipRects.empty()) {
+			a_clipRects.pop_back();
+			if (a_clipRects.empty()) {
+				ap_backend->ResetClipRect();
+			}
+			else {
+				ap_backend->SetClipRect(a_clipRects.back());
+			}
+		}
+		break;
+	default:
+		break;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "FontCache.h"
+#include "ApplicationCore.h"
+
+extern ApplicationCore *gp_appCore;
+
+FontCache::FontCache()
+{
+	m_hitCount = 0;
+	m_missCount = 0;
+}
+
+FontCache::~FontCache()
+{
+	Clear();
+}
+
+IDWriteTextFormat *const FontCache::GetTextFormat(
+	const FONT_FORMAT &a_format,
+	const DWRITE_TEXT_ALIGNMENT a_textAlignment,
+	const DWRITE_PARAGRAPH_ALIGNMENT a_paragraphAlignment
+)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (TEXT_FORMAT_ENTRY &entry : m_textFormats) {
+		if (entry.textAlignment == a_textAlignment && entry.paragraphAlignment == a_paragraphAlignment && entry.format == a_format) {
+			m_hitCount++;
+			entry.p_textFormat->AddRef();
+
+			return entry.p_textFormat;
+		}
+	}
+	m_missCount++;
+
+	IDWriteTextFormat *const p_textFormat = CreateTextFormat(a_format);
+	if (nullptr == p_textFormat) {
+		return nullptr;
+	}
+	p_textFormat->SetTextAlignment(a_textAlignment);
+	p_textFormat->SetParagraphAlignment(a_paragraphAlignment);
+
+	p_textFormat->AddRef();
+	m_textFormats.push_back(TEXT_FORMAT_ENTRY({ a_format, a_textAlignment, a_paragraphAlignment, p_textFormat }));
+
+	return p_textFormat;
+}
+
+IDWriteFontFace *const FontCache::GetFontFace(const FONT_FORMAT &a_format)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (FONT_FACE_ENTRY &entry : m_fontFaces) {
+		if (entry.weight == a_format.weight && entry.style == a_format.style && entry.name == a_format.name) {
+			m_hitCount++;
+			entry.p_fontFace->AddRef();
+
+			return entry.p_fontFace;
+		}
+	}
+	m_missCount++;
+
+	IDWriteFontFace *const p_fontFace = CreateFontFace(a_format.name.c_str(), a_format.weight, a_format.style);
+	if (nullptr == p_fontFace) {
+		return nullptr;
+	}
+
+	p_fontFace->AddRef();
+	m_fontFaces.push_back(FONT_FACE_ENTRY({ a_format.name, a_format.weight, a_format.style, p_fontFace }));
+
+	return p_fontFace;
+}
+
+void FontCache::WarmUp(const FONT_FORMAT *const ap_formats, const unsigned int a_count)
+{
+	for (unsigned int i = 0; i < a_count; i++) {
+		IDWriteTextFormat *p_textFormat = GetTextFormat(ap_formats[i]);
+		IDWriteFontFace *p_fontFace = GetFontFace(ap_formats[i]);
+
+		InterfaceRelease(&p_textFormat);
+		InterfaceRelease(&p_fontFace);
+	}
+}
+
+void FontCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (TEXT_FORMAT_ENTRY &entry : m_textFormats) {
+		InterfaceRelease(&entry.p_textFormat);
+	}
+	for (FONT_FACE_ENTRY &entry : m_fontFaces) {
+		InterfaceRelease(&entry.p_fontFace);
+	}
+	m_textFormats.clear();
+	m_fontFaces.clear();
+}
+
+const unsigned int FontCache::GetHitCount()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_hitCount;
+}
+
+const unsigned int FontCache::GetMissCount()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_missCount;
+}
+
+IDWriteTextFormat *FontCache::CreateTextFormat(const FONT_FORMAT &a_format)
+{
+	IDWriteTextFormat *p_textFormat = nullptr;
+	if (S_OK != gp_appCore->GetWriteFactory()->CreateTextFormat(
+		a_format.name.c_str(), nullptr, a_format.weight, a_format.style,
+		a_format.stretch, a_format.size, a_format.locale.c_str(), &p_textFormat
+	)) {
+		return nullptr;
+	}
+
+	return p_textFormat;
+}
+
+IDWriteFontFace *FontCache::CreateFontFace(const wchar_t *const ap_name, const DWRITE_FONT_WEIGHT a_weight, const DWRITE_FONT_STYLE a_style)
+{
+	IDWriteGdiInterop *p_gdiInterop = nullptr;
+	if (S_OK == gp_appCore->GetWriteFactory()->GetGdiInterop(&p_gdiInterop)) {
+		LOGFONT logFont = {};
+		wcscpy_s(logFont.lfFaceName, ap_name);
+		logFont.lfWeight = static_cast<long>(a_weight);
+		logFont.lfCharSet = DEFAULT_CHARSET;
+		logFont.lfOutPrecision = OUT_DEFAULT_PRECIS;
+		logFont.lfClipPrecision = CLIP_DEFAULT_PRECIS;
+		logFont.lfQuality = ANTIALIASED_QUALITY;
+		logFont.lfPitchAndFamily = VARIABLE_PITCH;
+		logFont.lfItalic =
+			a_style == DWRITE_FONT_STYLE::DWRITE_FONT_STYLE_ITALIC ||
+			a_style == DWRITE_FONT_STYLE::DWRITE_FONT_STYLE_OBLIQUE;
+
+		IDWriteFont *font;
+		if (S_OK == p_gdiInterop->CreateFontFromLOGFONT(&logFont, &font)) {
+			IDWriteFontFace *p_fontFace;
+
+			if (S_OK == font->CreateFontFace(&p_fontFace)) {
+				InterfaceRelease(&font);
+				InterfaceRelease(&p_gdiInterop);
+
+				return p_fontFace;
+			}
+
+			InterfaceRelease(&font);
+		}
+
+		InterfaceRelease(&p_gdiInterop);
+	}
+
+	return nullptr;
+}
\ No newline at end of file
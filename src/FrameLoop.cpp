@@ -0,0 +1,181 @@
+#include "FrameLoop.h"
+
+namespace
+{
+	// the step when neither a fixed step nor an interval is set, about 60 frames per second
+	const unsigned long long DEFAULT_FRAME_STEP = 16667;
+}
+
+FrameLoop::FrameLoop(FrameClock *const ap_clock, MessageSource *const ap_source, FrameHandler *const ap_handler)
+{
+	mp_clock = ap_clock;
+	mp_source = ap_source;
+	mp_handler = ap_handler;
+
+	m_stepMode = FRAME_VARIABLE_STEP;
+	m_interval = DEFAULT_FRAME_STEP;
+	m_fixedStep = 0;
+	m_maxStepCount = 5;
+	m_animationCount = 0;
+
+	m_isRestarted = true;
+	m_nextFrameTime = 0;
+	m_prevFrameTime = 0;
+	m_accumulatedTime = 0;
+	ResetStatistics();
+}
+
+FrameLoop::~FrameLoop()
+{
+}
+
+void FrameLoop::Run()
+{
+	while (RunOnce());
+}
+
+bool FrameLoop::RunOnce()
+{
+	if (!mp_source->PumpMessages()) {
+		return false;
+	}
+
+	if (0 == m_animationCount) {
+		// nothing moves, so the loop sleeps until the next message like a plain message loop
+		m_isRestarted = true;
+		m_statistics.idleCount++;
+		mp_source->WaitMessage(0, true);
+		return true;
+	}
+
+	const unsigned long long time = mp_clock->GetTime();
+	if (m_isRestarted) {
+		m_nextFrameTime = time;
+	}
+
+	if (time < m_nextFrameTime) {
+		// a message which arrives meanwhile is handled before the frame
+		mp_source->WaitMessage(m_nextFrameTime - time, false);
+		return true;
+	}
+
+	RunFrame(time);
+	return true;
+}
+
+void FrameLoop::SetInterval(const unsigned long long a_interval)
+{
+	m_interval = a_interval;
+	m_isRestarted = true;
+}
+
+void FrameLoop::SetStepMode(const FRAME_STEP_MODE a_mode, const unsigned long long a_fixedStep, const unsigned int a_maxStepCount)
+{
+	m_stepMode = a_mode;
+	m_fixedStep = a_fixedStep;
+	m_maxStepCount = a_maxStepCount ? a_maxStepCount : 1;
+	m_accumulatedTime = 0;
+}
+
+void FrameLoop::BeginAnimation()
+{
+	m_animationCount++;
+}
+
+void FrameLoop::EndAnimation()
+{
+	if (m_animationCount) {
+		m_animationCount--;
+	}
+}
+
+const bool FrameLoop::IsAnimating()
+{
+	return 0 != m_animationCount;
+}
+
+const unsigned long long FrameLoop::GetInterval()
+{
+	return m_interval;
+}
+
+const FRAME_STATISTICS &FrameLoop::GetStatistics()
+{
+	return m_statistics;
+}
+
+void FrameLoop::ResetStatistics()
+{
+	m_statistics = {};
+	m_intervalCount = 0;
+}
+
+void FrameLoop::RunFrame(const unsigned long long a_time)
+{
+	unsigned long long step = m_interval ? m_interval : DEFAULT_FRAME_STEP;
+	if (FRAME_FIXED_STEP == m_stepMode && m_fixedStep) {
+		step = m_fixedStep;
+	}
+
+	// the first frame after idle advances by one step instead of the whole idle time
+	unsigned long long elapsedTime = step;
+	if (m_isRestarted) {
+		m_isRestarted = false;
+		m_accumulatedTime = 0;
+	}
+	else {
+		elapsedTime = a_time - m_prevFrameTime;
+		AddInterval(elapsedTime);
+	}
+	m_prevFrameTime = a_time;
+
+	if (FRAME_FIXED_STEP == m_stepMode) {
+		m_accumulatedTime += elapsedTime;
+
+		unsigned int stepCount = 0;
+		while (m_accumulatedTime >= step && stepCount < m_maxStepCount) {
+			mp_handler->OnFrameUpdate(static_cast<double>(step) / 1000000.0);
+			m_accumulatedTime -= step;
+			stepCount++;
+		}
+		// the steps beyond the limit are dropped, the animation slows down instead of stalling the loop
+		m_accumulatedTime %= step;
+		m_statistics.updateCount += stepCount;
+
+		mp_handler->OnFrameRender(static_cast<double>(m_accumulatedTime) / static_cast<double>(step));
+	}
+	else {
+		const unsigned long long maxTime = step * m_maxStepCount;
+		mp_handler->OnFrameUpdate(static_cast<double>(elapsedTime < maxTime ? elapsedTime : maxTime) / 1000000.0);
+		m_statistics.updateCount++;
+
+		mp_handler->OnFrameRender(0.0);
+	}
+	m_statistics.frameCount++;
+
+	// the frames are due on a fixed grid. a frame later than one interval restarts the grid instead of catching up
+	m_nextFrameTime += m_interval;
+	if (a_time >= m_nextFrameTime) {
+		if (m_interval) {
+			m_statistics.missedCount++;
+		}
+		m_nextFrameTime = a_time + m_interval;
+	}
+}
+
+void FrameLoop::AddInterval(const unsigned long long a_interval)
+{
+	FRAME_STATISTICS &statistics = m_statistics;
+	m_intervalCount++;
+	const double count = static_cast<double>(m_intervalCount);
+	statistics.lastInterval = a_interval;
+	statistics.averageInterval += (static_cast<double>(a_interval) - statistics.averageInterval) / count;
+
+	const double target = m_interval ? static_cast<double>(m_interval) : statistics.averageInterval;
+	const double difference = static_cast<double>(a_interval) - target;
+	const double jitter = difference < 0.0 ? -difference : difference;
+	statistics.averageJitter += (jitter - statistics.averageJitter) / count;
+	if (static_cast<unsigned long long>(jitter) > statistics.maxJitter) {
+		statistics.maxJitter = static_cast<unsigned long long>(jitter);
+	}
+}
\ No newline at end of file
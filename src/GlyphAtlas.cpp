@@ -0,0 +1,186 @@
+#include "GlyphAtlas.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+	// the glyphs are separated by a transparent pixel, so a filtered edge doesn't take its neighbour
+	const int ATLAS_PADDING = 1;
+}
+
+GlyphAtlas::GlyphAtlas(GlyphRasterizer *const ap_rasterizer, const int a_width, const int a_height, const unsigned int a_subpixelCount) :
+	m_packer(a_width, a_height)
+{
+	mp_rasterizer = ap_rasterizer;
+	m_subpixelCount = a_subpixelCount ? a_subpixelCount : 1;
+	m_pixels.assign(static_cast<size_t>(m_packer.GetWidth()) * m_packer.GetHeight(), 0);
+
+	m_dirtyTop = 0;
+	m_dirtyBottom = m_packer.GetHeight();
+	m_generation = 0;
+
+	m_hitCount = 0;
+	m_missCount = 0;
+	m_evictionCount = 0;
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+}
+
+bool GlyphAtlas::Get(const void *const ap_fontFace, const unsigned short a_glyphIndex, const float a_size, const float a_penX, ATLAS_GLYPH &a_glyph)
+{
+	const float fraction = a_penX - std::floor(a_penX);
+	unsigned int subpixel = static_cast<unsigned int>(fraction * m_subpixelCount + 0.5f);
+	// the last step rounds to the next whole pixel, which is the first step
+	if (subpixel >= m_subpixelCount) {
+		subpixel = 0;
+	}
+
+	const unsigned long long key = GetKey(ap_fontFace, a_glyphIndex, a_size, static_cast<unsigned char>(subpixel));
+	auto range = m_glyphTable.equal_range(key);
+	for (auto tableEntry = range.first; tableEntry != range.second; tableEntry++) {
+		const ATLAS_GLYPH &glyph = m_glyphs[tableEntry->second];
+		if (glyph.p_fontFace == ap_fontFace && glyph.glyphIndex == a_glyphIndex && glyph.size == a_size && glyph.subpixel == subpixel) {
+			m_hitCount++;
+			a_glyph = glyph;
+
+			return true;
+		}
+	}
+	m_missCount++;
+
+	m_bitmap.left = 0;
+	m_bitmap.top = 0;
+	m_bitmap.width = 0;
+	m_bitmap.height = 0;
+	m_bitmap.advance = 0.0f;
+	m_bitmap.alpha.clear();
+	if (!mp_rasterizer->RasterizeGlyph(ap_fontFace, a_glyphIndex, a_size, static_cast<float>(subpixel) / m_subpixelCount, m_bitmap)) {
+		return false;
+	}
+
+	ATLAS_GLYPH glyph = {
+		ap_fontFace, a_glyphIndex, a_size, static_cast<unsigned char>(subpixel),
+		0, 0, m_bitmap.left, m_bitmap.top, m_bitmap.width, m_bitmap.height, m_bitmap.advance
+	};
+
+	// a blank glyph like a space only has an advance
+	if (m_bitmap.width > 0 && m_bitmap.height > 0) {
+		const int width = m_bitmap.width + ATLAS_PADDING;
+		const int height = m_bitmap.height + ATLAS_PADDING;
+		if (width > m_packer.GetWidth() || height > m_packer.GetHeight()) {
+			return false;
+		}
+
+		if (!m_packer.Insert(width, height, glyph.x, glyph.y)) {
+			// the packer can't free single rectangles, so the atlas starts over
+			Clear();
+			m_evictionCount++;
+			m_packer.Insert(width, height, glyph.x, glyph.y);
+		}
+
+		const int atlasWidth = m_packer.GetWidth();
+		for (int row = 0; row < m_bitmap.height; row++) {
+			memcpy(
+				&m_pixels[static_cast<size_t>(glyph.y + row) * atlasWidth + glyph.x],
+				&m_bitmap.alpha[static_cast<size_t>(row) * m_bitmap.width], m_bitmap.width
+			);
+		}
+		AddDirtyRows(glyph.y, glyph.y + m_bitmap.height);
+	}
+
+	m_glyphTable.emplace(key, static_cast<unsigned int>(m_glyphs.size()));
+	m_glyphs.push_back(glyph);
+	a_glyph = glyph;
+
+	return true;
+}
+
+void GlyphAtlas::Clear()
+{
+	m_packer.Reset();
+	m_glyphs.clear();
+	m_glyphTable.clear();
+	// the old pixels stay in the padding of the new glyphs otherwise
+	memset(m_pixels.data(), 0, m_pixels.size());
+	InvalidateRows();
+	m_generation++;
+}
+
+bool GlyphAtlas::GetDirtyRows(int &a_top, int &a_bottom)
+{
+	if (m_dirtyTop >= m_dirtyBottom) {
+		return false;
+	}
+
+	a_top = m_dirtyTop;
+	a_bottom = m_dirtyBottom;
+	return true;
+}
+
+void GlyphAtlas::ClearDirtyRows()
+{
+	m_dirtyTop = m_packer.GetHeight();
+	m_dirtyBottom = 0;
+}
+
+void GlyphAtlas::InvalidateRows()
+{
+	m_dirtyTop = 0;
+	m_dirtyBottom = m_packer.GetHeight();
+}
+
+const unsigned char *const GlyphAtlas::GetPixels()
+{
+	return m_pixels.data();
+}
+
+const int GlyphAtlas::GetWidth()
+{
+	return m_packer.GetWidth();
+}
+
+const int GlyphAtlas::GetHeight()
+{
+	return m_packer.GetHeight();
+}
+
+const unsigned int GlyphAtlas::GetSubpixelCount()
+{
+	return m_subpixelCount;
+}
+
+const unsigned int GlyphAtlas::GetGeneration()
+{
+	return m_generation;
+}
+
+ATLAS_STATISTICS GlyphAtlas::GetStatistics()
+{
+	return ATLAS_STATISTICS({
+		static_cast<unsigned int>(m_glyphs.size()), m_packer.GetOccupancy(), m_hitCount, m_missCount, m_evictionCount
+	});
+}
+
+unsigned long long GlyphAtlas::GetKey(const void *const ap_fontFace, const unsigned short a_glyphIndex, const float a_size, const unsigned char a_subpixel)
+{
+	unsigned int sizeBits;
+	memcpy(&sizeBits, &a_size, sizeof(sizeBits));
+
+	unsigned long long key = static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(ap_fontFace));
+	key = key * 1099511628211ULL ^ (static_cast<unsigned long long>(a_glyphIndex) << 8 | a_subpixel);
+
+	return key * 1099511628211ULL ^ sizeBits;
+}
+
+void GlyphAtlas::AddDirtyRows(const int a_top, const int a_bottom)
+{
+	if (a_top < m_dirtyTop) {
+		m_dirtyTop = a_top;
+	}
+	if (a_bottom > m_dirtyBottom) {
+		m_dirtyBottom = a_bottom;
+	}
+}
\ No newline at end of file
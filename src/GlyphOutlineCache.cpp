@@ -0,0 +1,131 @@
+#include "GlyphOutlineCache.h"
+#include <cstdint>
+#include <cstring>
+
+GlyphOutlineCache::GlyphOutlineCache(GlyphOutliner *const ap_outliner, const unsigned int a_capacity)
+{
+	mp_outliner = ap_outliner;
+	m_capacity = a_capacity ? a_capacity : 1;
+
+	m_hitCount = 0;
+	m_missCount = 0;
+}
+
+GlyphOutlineCache::~GlyphOutlineCache()
+{
+	Clear();
+}
+
+const GLYPH_OUTLINE *const GlyphOutlineCache::Get(const void *const ap_fontFace, const unsigned short a_glyphIndex, const float a_size)
+{
+	const unsigned long long key = GetKey(ap_fontFace, a_glyphIndex, a_size);
+
+	auto range = m_entryTable.equal_range(key);
+	for (auto tableEntry = range.first; tableEntry != range.second; tableEntry++) {
+		const GLYPH_OUTLINE &entry = *tableEntry->second;
+		if (entry.p_fontFace == ap_fontFace && entry.glyphIndex == a_glyphIndex && entry.size == a_size) {
+			m_hitCount++;
+			m_entries.splice(m_entries.begin(), m_entries, tableEntry->second);
+
+			return &m_entries.front();
+		}
+	}
+	m_missCount++;
+
+	GLYPH_OUTLINE outline = {};
+	outline.p_fontFace = ap_fontFace;
+	outline.glyphIndex = a_glyphIndex;
+	outline.size = a_size;
+	if (!mp_outliner->CreateOutline(ap_fontFace, a_glyphIndex, a_size, outline)) {
+		return nullptr;
+	}
+	outline.bounds = GetPathBounds(outline.path);
+
+	while (m_entries.size() >= m_capacity) {
+		RemoveLastEntry();
+	}
+
+	m_entries.push_front(std::move(outline));
+	m_entryTable.emplace(key, m_entries.begin());
+
+	return &m_entries.front();
+}
+
+void GlyphOutlineCache::Clear()
+{
+	m_entries.clear();
+	m_entryTable.clear();
+}
+
+void GlyphOutlineCache::SetCapacity(const unsigned int a_capacity)
+{
+	m_capacity = a_capacity ? a_capacity : 1;
+	while (m_entries.size() > m_capacity) {
+		RemoveLastEntry();
+	}
+}
+
+const unsigned int GlyphOutlineCache::GetCount()
+{
+	return static_cast<unsigned int>(m_entries.size());
+}
+
+const unsigned int GlyphOutlineCache::GetHitCount()
+{
+	return m_hitCount;
+}
+
+const unsigned int GlyphOutlineCache::GetMissCount()
+{
+	return m_missCount;
+}
+
+unsigned long long GlyphOutlineCache::GetKey(const void *const ap_fontFace, const unsigned short a_glyphIndex, const float a_size)
+{
+	unsigned int sizeBits;
+	memcpy(&sizeBits, &a_size, sizeof(sizeBits));
+
+	unsigned long long key = static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(ap_fontFace));
+	key = key * 1099511628211ULL ^ a_glyphIndex;
+
+	return key * 1099511628211ULL ^ sizeBits;
+}
+
+void GlyphOutlineCache::RemoveLastEntry()
+{
+	GLYPH_OUTLINE &entry = m_entries.back();
+
+	auto range = m_entryTable.equal_range(GetKey(entry.p_fontFace, entry.glyphIndex, entry.size));
+	for (auto tableEntry = range.first; tableEntry != range.second; tableEntry++) {
+		if (&*tableEntry->second == &entry) {
+			m_entryTable.erase(tableEntry);
+			break;
+		}
+	}
+
+	m_entries.pop_back();
+}
+
+void DecodeUtf16(const wchar_t *const ap_text, const size_t a_length, std::vector<unsigned int> &a_codePoints)
+{
+	a_codePoints.clear();
+
+	for (size_t i = 0; i < a_length; i++) {
+		const unsigned int unit = static_cast<unsigned int>(ap_text[i]);
+
+		if (unit >= 0xD800 && unit <= 0xDBFF && i + 1 < a_length) {
+			const unsigned int nextUnit = static_cast<unsigned int>(ap_text[i + 1]);
+			if (nextUnit >= 0xDC00 && nextUnit <= 0xDFFF) {
+				a_codePoints.push_back(0x10000 + ((unit - 0xD800) << 10) + (nextUnit - 0xDC00));
+				i++;
+				continue;
+			}
+		}
+
+		if (unit >= 0xD800 && unit <= 0xDFFF) {
+			a_codePoints.push_back(0xFFFD);
+		} else {
+			a_codePoints.push_back(unit);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,191 @@
+#include "ImageCache.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+
+ImageCache::ImageCache(ImageDecoder *const ap_decoder, TaskScheduler *const ap_scheduler, const size_t a_byteBudget)
+{
+	mp_decoder = ap_decoder;
+	mp_scheduler = ap_scheduler;
+	m_byteBudget = a_byteBudget;
+	m_byteCount = 0;
+	m_nextID = 1;
+	ResetStatistics();
+}
+
+ImageCache::~ImageCache()
+{
+}
+
+std::shared_ptr<const IMAGE_PIXELS> ImageCache::Request(
+	const wchar_t *const ap_path, const unsigned int a_width, const unsigned int a_height,
+	void (*ap_notify)(void *), void *const ap_notifyData
+)
+{
+	IMAGE_KEY key = { ap_path, a_width, a_height };
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		const auto entryIterator = m_entries.find(key);
+		if (m_entries.end() != entryIterator) {
+			IMAGE_ENTRY &entry = entryIterator->second;
+			if (IMAGE_PENDING == entry.state) {
+				// the image is requested again on every paint until it lands, so each notify is kept only once
+				if (ap_notify && entry.notifies.end() == std::find_if(entry.notifies.begin(), entry.notifies.end(),
+					[ap_notify, ap_notifyData](const NOTIFY_ENTRY &a_notify) {
+						return ap_notify == a_notify.p_notify && ap_notifyData == a_notify.p_data;
+					})) {
+					entry.notifies.push_back({ ap_notify, ap_notifyData });
+				}
+				return nullptr;
+			}
+
+			m_lruKeys.splice(m_lruKeys.begin(), m_lruKeys, entry.lruPosition);
+			if (IMAGE_READY == entry.state) {
+				m_statistics.hitCount++;
+			}
+			return entry.p_image;
+		}
+
+		IMAGE_ENTRY &entry = m_entries[key];
+		entry.state = IMAGE_PENDING;
+		entry.byteCount = 0;
+		if (ap_notify && mp_scheduler) {
+			entry.notifies.push_back({ ap_notify, ap_notifyData });
+		}
+		m_statistics.missCount++;
+	}
+
+	if (mp_scheduler) {
+		mp_scheduler->Post([this, key]() { Decode(key); });
+		return nullptr;
+	}
+
+	Decode(key);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	const auto entryIterator = m_entries.find(key);
+	return m_entries.end() != entryIterator ? entryIterator->second.p_image : nullptr;
+}
+
+void ImageCache::SetByteBudget(const size_t a_byteBudget)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_byteBudget = a_byteBudget;
+	Evict();
+}
+
+const size_t ImageCache::GetByteBudget()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_byteBudget;
+}
+
+const size_t ImageCache::GetByteCount()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_byteCount;
+}
+
+void ImageCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (const IMAGE_KEY &key : m_lruKeys) {
+		m_entries.erase(key);
+	}
+	m_lruKeys.clear();
+	m_byteCount = 0;
+}
+
+IMAGE_CACHE_STATISTICS ImageCache::GetStatistics()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_statistics;
+}
+
+void ImageCache::ResetStatistics()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_statistics = { 0, 0, 0, 0, 0, 0 };
+}
+
+void ImageCache::Decode(const IMAGE_KEY &a_key)
+{
+	std::shared_ptr<const IMAGE_PIXELS> p_largerImage;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		p_largerImage = FindLargerImage(a_key);
+	}
+
+	std::shared_ptr<IMAGE_PIXELS> p_image = std::make_shared<IMAGE_PIXELS>();
+	const bool isDecoded = p_largerImage ?
+		m_resampler.Resample(*p_largerImage, a_key.width, a_key.height, *p_image) :
+		mp_decoder->Decode(a_key.path.c_str(), a_key.width, a_key.height, *p_image);
+
+	std::vector<NOTIFY_ENTRY> notifies;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		// `Clear` keeps the pending images, so the entry is still there
+		IMAGE_ENTRY &entry = m_entries[a_key];
+		if (isDecoded) {
+			p_image->id = m_nextID++;
+			entry.state = IMAGE_READY;
+			entry.p_image = p_image;
+			entry.byteCount = p_image->pixels.size();
+			m_byteCount += entry.byteCount;
+			m_statistics.decodedCount++;
+			if (p_largerImage) {
+				m_statistics.resampledCount++;
+			}
+		}
+		else {
+			entry.state = IMAGE_FAILED;
+			m_statistics.failedCount++;
+		}
+
+		m_lruKeys.push_front(a_key);
+		entry.lruPosition = m_lruKeys.begin();
+		notifies.swap(entry.notifies);
+
+		Evict();
+	}
+
+	for (const NOTIFY_ENTRY &notify : notifies) {
+		notify.p_notify(notify.p_data);
+	}
+}
+
+std::shared_ptr<const IMAGE_PIXELS> ImageCache::FindLargerImage(const IMAGE_KEY &a_key)
+{
+	// a size of 0 depends on the size of the file
+	if (0 == a_key.width || 0 == a_key.height) {
+		return nullptr;
+	}
+
+	std::shared_ptr<const IMAGE_PIXELS> p_largerImage;
+	for (const IMAGE_KEY &key : m_lruKeys) {
+		if (key.path != a_key.path) {
+			continue;
+		}
+
+		const IMAGE_ENTRY &entry = m_entries.find(key)->second;
+		if (IMAGE_READY == entry.state && entry.p_image->width >= a_key.width && entry.p_image->height >= a_key.height &&
+			(!p_largerImage || static_cast<size_t>(entry.p_image->width) * entry.p_image->height <
+				static_cast<size_t>(p_largerImage->width) * p_largerImage->height)) {
+			p_largerImage = entry.p_image;
+		}
+	}
+
+	return p_largerImage;
+}
+
+void ImageCache::Evict()
+{
+	while (m_byteCount > m_byteBudget && m_lruKeys.size() > 1) {
+		const auto entryIterator = m_entries.find(m_lruKeys.back());
+		m_byteCount -= entryIterator->second.byteCount;
+		m_entries.erase(entryIterator);
+		m_lruKeys.pop_back();
+		m_statistics.evictedCount++;
+	}
+}
\ No newline at end of file
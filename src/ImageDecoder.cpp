@@ -0,0 +1,239 @@
+#include "ImageDecoder.h"
+#include "ImageResampler.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+	unsigned int ReadUInt16(const unsigned char *const ap_data)
+	{
+		return ap_data[0] | ap_data[1] << 8;
+	}
+
+	unsigned int ReadUInt32(const unsigned char *const ap_data)
+	{
+		return ap_data[0] | ap_data[1] << 8 | ap_data[2] << 16 | static_cast<unsigned int>(ap_data[3]) << 24;
+	}
+
+	// reads the next number of a PPM header. the comments start with '#' and end with the line
+	bool ReadPPMNumber(const std::vector<unsigned char> &a_data, size_t &a_offset, unsigned int &a_value)
+	{
+		while (a_offset < a_data.size()) {
+			if ('#' == a_data[a_offset]) {
+				while (a_offset < a_data.size() && '\n' != a_data[a_offset]) {
+					a_offset++;
+				}
+			}
+			else if (a_data[a_offset] <= ' ') {
+				a_offset++;
+			}
+			else {
+				break;
+			}
+		}
+
+		if (a_offset >= a_data.size() || a_data[a_offset] < '0' || a_data[a_offset] > '9') {
+			return false;
+		}
+
+		a_value = 0;
+		while (a_offset < a_data.size() && a_data[a_offset] >= '0' && a_data[a_offset] <= '9') {
+			a_value = a_value * 10 + (a_data[a_offset] - '0');
+			if (a_value > 0xFFFFFF) {
+				return false;
+			}
+			a_offset++;
+		}
+
+		return true;
+	}
+}
+
+void GetTargetSize(
+	const unsigned int a_width, const unsigned int a_height, const unsigned int a_targetWidth, const unsigned int a_targetHeight,
+	unsigned int &a_resultWidth, unsigned int &a_resultHeight
+)
+{
+	a_resultWidth = a_targetWidth;
+	a_resultHeight = a_targetHeight;
+
+	if (0 == a_targetWidth && 0 == a_targetHeight) {
+		a_resultWidth = a_width;
+		a_resultHeight = a_height;
+	}
+	else if (0 == a_targetWidth) {
+		a_resultWidth = static_cast<unsigned int>((static_cast<unsigned long long>(a_width) * a_targetHeight + a_height / 2) / a_height);
+	}
+	else if (0 == a_targetHeight) {
+		a_resultHeight = static_cast<unsigned int>((static_cast<unsigned long long>(a_height) * a_targetWidth + a_width / 2) / a_width);
+	}
+
+	if (0 == a_resultWidth) {
+		a_resultWidth = 1;
+	}
+	if (0 == a_resultHeight) {
+		a_resultHeight = 1;
+	}
+}
+
+void PremultiplyPixels(IMAGE_PIXELS &a_image)
+{
+	unsigned char *p_pixel = a_image.pixels.data();
+	const unsigned char *const p_end = p_pixel + a_image.pixels.size();
+
+	for (; p_pixel < p_end; p_pixel += 4) {
+		const unsigned int alpha = p_pixel[3];
+		if (255 == alpha) {
+			continue;
+		}
+
+		// rounds x * alpha / 255
+		for (unsigned int i = 0; i < 3; i++) {
+			const unsigned int value = p_pixel[i] * alpha + 128;
+			p_pixel[i] = static_cast<unsigned char>((value + (value >> 8)) >> 8);
+		}
+	}
+}
+
+StandInImageDecoder::StandInImageDecoder()
+{
+}
+
+StandInImageDecoder::~StandInImageDecoder()
+{
+}
+
+bool StandInImageDecoder::Decode(const wchar_t *const ap_path, const unsigned int a_width, const unsigned int a_height, IMAGE_PIXELS &a_image)
+{
+	std::ifstream file(std::filesystem::path(ap_path), std::ios::binary);
+	if (!file) {
+		return false;
+	}
+	const std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	IMAGE_PIXELS image = {};
+	if (data.size() < 2) {
+		return false;
+	}
+	if ('P' == data[0] && '6' == data[1]) {
+		if (!DecodePPM(data, image)) {
+			return false;
+		}
+	}
+	else if ('B' == data[0] && 'M' == data[1]) {
+		if (!DecodeBMP(data, image)) {
+			return false;
+		}
+	}
+	else {
+		return false;
+	}
+	PremultiplyPixels(image);
+
+	unsigned int width;
+	unsigned int height;
+	GetTargetSize(image.width, image.height, a_width, a_height, width, height);
+	if (width == image.width && height == image.height) {
+		a_image.width = width;
+		a_image.height = height;
+		a_image.pixels.swap(image.pixels);
+	}
+	else {
+		// a pixel of the result averages the pixels which it covers
+		ImageResampler resampler(RESAMPLE_BOX);
+		resampler.Resample(image, width, height, a_image);
+	}
+
+	return true;
+}
+
+bool StandInImageDecoder::DecodePPM(const std::vector<unsigned char> &a_data, IMAGE_PIXELS &a_image)
+{
+	size_t offset = 2;
+	unsigned int width;
+	unsigned int height;
+	unsigned int maxValue;
+	if (!ReadPPMNumber(a_data, offset, width) || !ReadPPMNumber(a_data, offset, height) ||
+		!ReadPPMNumber(a_data, offset, maxValue)) {
+		return false;
+	}
+	// one whitespace separates the header from the samples. only 8 bit samples are supported
+	offset++;
+	if (0 == width || 0 == height || 0 == maxValue || maxValue > 255 ||
+		a_data.size() < offset || a_data.size() - offset < static_cast<size_t>(width) * height * 3) {
+		return false;
+	}
+
+	a_image.width = width;
+	a_image.height = height;
+	a_image.pixels.resize(static_cast<size_t>(width) * height * 4);
+
+	const unsigned char *p_source = a_data.data() + offset;
+	unsigned char *p_target = a_image.pixels.data();
+	for (size_t i = 0; i < static_cast<size_t>(width) * height; i++, p_source += 3, p_target += 4) {
+		p_target[0] = static_cast<unsigned char>(p_source[2] * 255 / maxValue);
+		p_target[1] = static_cast<unsigned char>(p_source[1] * 255 / maxValue);
+		p_target[2] = static_cast<unsigned char>(p_source[0] * 255 / maxValue);
+		p_target[3] = 255;
+	}
+
+	return true;
+}
+
+bool StandInImageDecoder::DecodeBMP(const std::vector<unsigned char> &a_data, IMAGE_PIXELS &a_image)
+{
+	// the file header and the BITMAPINFOHEADER
+	if (a_data.size() < 54) {
+		return false;
+	}
+
+	const unsigned char *const p_data = a_data.data();
+	const unsigned int pixelOffset = ReadUInt32(p_data + 10);
+	const int width = static_cast<int>(ReadUInt32(p_data + 18));
+	const int height = static_cast<int>(ReadUInt32(p_data + 22));
+	const unsigned int bitCount = ReadUInt16(p_data + 28);
+	const unsigned int compression = ReadUInt32(p_data + 30);
+
+	// BI_RGB, or BI_BITFIELDS with the usual BGRA masks of 32 bit files
+	if ((24 != bitCount && 32 != bitCount) || (0 != compression && !(3 == compression && 32 == bitCount)) ||
+		width <= 0 || 0 == height || width > 0xFFFF || height > 0xFFFF || height < -0xFFFF) {
+		return false;
+	}
+
+	// the rows are bottom-up unless the height is negative
+	const bool isTopDown = height < 0;
+	const unsigned int rowCount = static_cast<unsigned int>(isTopDown ? -height : height);
+	const unsigned int byteCount = bitCount / 8;
+	const size_t stride = (static_cast<size_t>(width) * byteCount + 3) & ~static_cast<size_t>(3);
+	if (pixelOffset > a_data.size() || a_data.size() - pixelOffset < stride * rowCount) {
+		return false;
+	}
+
+	a_image.width = static_cast<unsigned int>(width);
+	a_image.height = rowCount;
+	a_image.pixels.resize(static_cast<size_t>(width) * rowCount * 4);
+
+	bool hasAlpha = false;
+	for (unsigned int y = 0; y < rowCount; y++) {
+		const unsigned char *p_source = p_data + pixelOffset + stride * (isTopDown ? y : rowCount - 1 - y);
+		unsigned char *p_target = a_image.pixels.data() + static_cast<size_t>(y) * width * 4;
+
+		for (int x = 0; x < width; x++, p_source += byteCount, p_target += 4) {
+			p_target[0] = p_source[0];
+			p_target[1] = p_source[1];
+			p_target[2] = p_source[2];
+			p_target[3] = 32 == bitCount ? p_source[3] : 255;
+			hasAlpha = hasAlpha || 0 != p_target[3];
+		}
+	}
+
+	// most 32 bit files leave the fourth byte 0, they are opaque
+	if (!hasAlpha) {
+		for (size_t i = 3; i < a_image.pixels.size(); i += 4) {
+			a_image.pixels[i] = 255;
+		}
+	}
+
+	return true;
+}
\ No newline at end of file
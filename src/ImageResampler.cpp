@@ -0,0 +1,581 @@
+#include "ImageResampler.h"
+#include "TaskScheduler.h"
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define RESAMPLE_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+// the intrinsics of any instruction set can be used without a compiler option
+#define RESAMPLE_TARGET(a_instructionSet)
+#else
+#define RESAMPLE_TARGET(a_instructionSet) __attribute__((target(a_instructionSet)))
+#endif
+#endif
+
+namespace
+{
+	const int WEIGHT_BITS = 14;
+	const int WEIGHT_ONE = 1 << WEIGHT_BITS;
+	const int WEIGHT_ROUND = 1 << (WEIGHT_BITS - 1);
+	// the target rows which a thread resamples at once per unit of the filter support. two bands both resample
+	// the source rows which they share, about 1/8 of a band
+	const unsigned int BAND_ROW_COUNT = 16;
+
+	double GetSupport(const RESAMPLE_FILTER a_filter)
+	{
+		switch (a_filter) {
+		case RESAMPLE_BOX:
+			return 0.5;
+		case RESAMPLE_BILINEAR:
+			return 1.0;
+		default:
+			return 3.0;
+		}
+	}
+
+	double Sinc(const double a_value)
+	{
+		if (0.0 == a_value) {
+			return 1.0;
+		}
+
+		const double value = a_value * 3.14159265358979323846;
+		return std::sin(value) / value;
+	}
+
+	double Weigh(const RESAMPLE_FILTER a_filter, const double a_distance)
+	{
+		const double distance = std::fabs(a_distance);
+		switch (a_filter) {
+		case RESAMPLE_BOX:
+			// the right edge belongs to the next pixel
+			return -0.5 < a_distance && a_distance <= 0.5 ? 1.0 : 0.0;
+		case RESAMPLE_BILINEAR:
+			return distance < 1.0 ? 1.0 - distance : 0.0;
+		default:
+			return distance < 3.0 ? Sinc(distance) * Sinc(distance / 3.0) : 0.0;
+		}
+	}
+
+	unsigned char ClampByte(const int a_value)
+	{
+		return static_cast<unsigned char>(a_value < 0 ? 0 : a_value > 255 ? 255 : a_value);
+	}
+
+	void ResampleRowScalar(const unsigned char *const ap_source, const RESAMPLE_TAPS &a_taps, unsigned char *const ap_target)
+	{
+		const unsigned int tapCount = a_taps.tapCount;
+		for (size_t x = 0; x < a_taps.starts.size(); x++) {
+			const unsigned char *const p_pixels = ap_source + static_cast<size_t>(a_taps.starts[x]) * 4;
+			const short *const p_weights = a_taps.weights.data() + x * tapCount;
+
+			int sum[4] = { WEIGHT_ROUND, WEIGHT_ROUND, WEIGHT_ROUND, WEIGHT_ROUND };
+			for (unsigned int i = 0; i < tapCount; i++) {
+				for (unsigned int channel = 0; channel < 4; channel++) {
+					sum[channel] += p_pixels[i * 4 + channel] * p_weights[i];
+				}
+			}
+			for (unsigned int channel = 0; channel < 4; channel++) {
+				ap_target[x * 4 + channel] = ClampByte(sum[channel] >> WEIGHT_BITS);
+			}
+		}
+	}
+
+	// the negative lobes of the filter can leave a color above the alpha, which isn't valid premultiplied
+	void ResampleColumnScalar(
+		const unsigned char *const *const ap_rows, const short *const ap_weights, const unsigned int a_tapCount,
+		const unsigned int a_firstByte, const unsigned int a_byteCount, unsigned char *const ap_target
+	)
+	{
+		for (unsigned int x = a_firstByte; x < a_byteCount; x += 4) {
+			int sum[4] = { WEIGHT_ROUND, WEIGHT_ROUND, WEIGHT_ROUND, WEIGHT_ROUND };
+			for (unsigned int i = 0; i < a_tapCount; i++) {
+				for (unsigned int channel = 0; channel < 4; channel++) {
+					sum[channel] += ap_rows[i][x + channel] * ap_weights[i];
+				}
+			}
+
+			const unsigned char alpha = ClampByte(sum[3] >> WEIGHT_BITS);
+			for (unsigned int channel = 0; channel < 3; channel++) {
+				const unsigned char value = ClampByte(sum[channel] >> WEIGHT_BITS);
+				ap_target[x + channel] = value < alpha ? value : alpha;
+			}
+			ap_target[x + 3] = alpha;
+		}
+	}
+
+#ifdef RESAMPLE_X86
+	// two weights for `_mm_madd_epi16`, which multiplies pairs of 16 bit values and adds each pair
+	int PackWeights(const short a_firstWeight, const short a_secondWeight)
+	{
+		return static_cast<int>(
+			static_cast<unsigned int>(static_cast<unsigned short>(a_firstWeight)) |
+			static_cast<unsigned int>(static_cast<unsigned short>(a_secondWeight)) << 16
+		);
+	}
+
+	RESAMPLE_TARGET("sse2")
+	__m128i SumPixelSSE2(const unsigned char *const ap_pixels, const short *const ap_weights, const unsigned int a_tapCount)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		__m128i sum = _mm_set1_epi32(WEIGHT_ROUND);
+
+		unsigned int i = 0;
+		for (; i + 2 <= a_tapCount; i += 2) {
+			// b0 g0 r0 a0 b1 g1 r1 a1 into b0 b1 g0 g1 r0 r1 a0 a1
+			__m128i pixels = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(ap_pixels + i * 4)), zero);
+			pixels = _mm_unpacklo_epi16(pixels, _mm_srli_si128(pixels, 8));
+			sum = _mm_add_epi32(sum, _mm_madd_epi16(pixels, _mm_set1_epi32(PackWeights(ap_weights[i], ap_weights[i + 1]))));
+		}
+		if (i < a_tapCount) {
+			int pixel;
+			memcpy(&pixel, ap_pixels + i * 4, sizeof(pixel));
+			const __m128i pixels = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(pixel), zero), zero);
+			sum = _mm_add_epi32(sum, _mm_madd_epi16(pixels, _mm_set1_epi32(PackWeights(ap_weights[i], 0))));
+		}
+
+		return sum;
+	}
+
+	RESAMPLE_TARGET("sse2")
+	void StorePixelSSE2(const __m128i a_sum, unsigned char *const ap_target)
+	{
+		__m128i pixel = _mm_srai_epi32(a_sum, WEIGHT_BITS);
+		pixel = _mm_packs_epi32(pixel, pixel);
+		pixel = _mm_packus_epi16(pixel, pixel);
+
+		const int value = _mm_cvtsi128_si32(pixel);
+		memcpy(ap_target, &value, sizeof(value));
+	}
+
+	RESAMPLE_TARGET("sse2")
+	void ResampleRowSSE2(const unsigned char *const ap_source, const RESAMPLE_TAPS &a_taps, unsigned char *const ap_target)
+	{
+		const unsigned int tapCount = a_taps.tapCount;
+		for (size_t x = 0; x < a_taps.starts.size(); x++) {
+			const __m128i sum = SumPixelSSE2(
+				ap_source + static_cast<size_t>(a_taps.starts[x]) * 4, a_taps.weights.data() + x * tapCount, tapCount
+			);
+			StorePixelSSE2(sum, ap_target + x * 4);
+		}
+	}
+
+	// limits each color to the alpha of its pixel
+	RESAMPLE_TARGET("sse2")
+	__m128i ClampToAlphaSSE2(const __m128i a_pixels)
+	{
+		__m128i alpha = _mm_srli_epi32(a_pixels, 24);
+		alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 8));
+		alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+		return _mm_min_epu8(a_pixels, alpha);
+	}
+
+	// four pixels at once, the rest is left to the scalar kernel. returns the first byte which isn't resampled
+	RESAMPLE_TARGET("sse2")
+	unsigned int ResampleColumnSSE2(
+		const unsigned char *const *const ap_rows, const short *const ap_weights, const unsigned int a_tapCount,
+		const unsigned int a_byteCount, unsigned char *const ap_target
+	)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		unsigned int x = 0;
+		for (; x + 16 <= a_byteCount; x += 16) {
+			__m128i sums[4] = {
+				_mm_set1_epi32(WEIGHT_ROUND), _mm_set1_epi32(WEIGHT_ROUND), _mm_set1_epi32(WEIGHT_ROUND), _mm_set1_epi32(WEIGHT_ROUND)
+			};
+
+			for (unsigned int i = 0; i < a_tapCount; i += 2) {
+				const __m128i firstRow = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ap_rows[i] + x));
+				const __m128i secondRow = i + 1 < a_tapCount ? _mm_loadu_si128(reinterpret_cast<const __m128i *>(ap_rows[i + 1] + x)) : zero;
+				const __m128i weights = _mm_set1_epi32(PackWeights(ap_weights[i], i + 1 < a_tapCount ? ap_weights[i + 1] : 0));
+
+				// the channels of both rows are interleaved so that each pair is weighed by both taps
+				const __m128i lowFirst = _mm_unpacklo_epi8(firstRow, zero);
+				const __m128i lowSecond = _mm_unpacklo_epi8(secondRow, zero);
+				const __m128i highFirst = _mm_unpackhi_epi8(firstRow, zero);
+				const __m128i highSecond = _mm_unpackhi_epi8(secondRow, zero);
+				sums[0] = _mm_add_epi32(sums[0], _mm_madd_epi16(_mm_unpacklo_epi16(lowFirst, lowSecond), weights));
+				sums[1] = _mm_add_epi32(sums[1], _mm_madd_epi16(_mm_unpackhi_epi16(lowFirst, lowSecond), weights));
+				sums[2] = _mm_add_epi32(sums[2], _mm_madd_epi16(_mm_unpacklo_epi16(highFirst, highSecond), weights));
+				sums[3] = _mm_add_epi32(sums[3], _mm_madd_epi16(_mm_unpackhi_epi16(highFirst, highSecond), weights));
+			}
+
+			const __m128i low = _mm_packs_epi32(_mm_srai_epi32(sums[0], WEIGHT_BITS), _mm_srai_epi32(sums[1], WEIGHT_BITS));
+			const __m128i high = _mm_packs_epi32(_mm_srai_epi32(sums[2], WEIGHT_BITS), _mm_srai_epi32(sums[3], WEIGHT_BITS));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(ap_target + x), ClampToAlphaSSE2(_mm_packus_epi16(low, high)));
+		}
+
+		return x;
+	}
+
+	// two target pixels at once, one in each 128 bit lane
+	RESAMPLE_TARGET("avx2")
+	void ResampleRowAVX2(const unsigned char *const ap_source, const RESAMPLE_TAPS &a_taps, unsigned char *const ap_target)
+	{
+		const unsigned int tapCount = a_taps.tapCount;
+		const size_t width = a_taps.starts.size();
+		const __m256i zero = _mm256_setzero_si256();
+
+		size_t x = 0;
+		for (; x + 2 <= width; x += 2) {
+			const unsigned char *const p_firstPixels = ap_source + static_cast<size_t>(a_taps.starts[x]) * 4;
+			const unsigned char *const p_secondPixels = ap_source + static_cast<size_t>(a_taps.starts[x + 1]) * 4;
+			const short *const p_firstWeights = a_taps.weights.data() + x * tapCount;
+			const short *const p_secondWeights = p_firstWeights + tapCount;
+			__m256i sum = _mm256_set1_epi32(WEIGHT_ROUND);
+
+			for (unsigned int i = 0; i < tapCount; i += 2) {
+				// a last odd tap reads only its own pixel, the next one can be past the end of the row
+				__m128i firstPixels;
+				__m128i secondPixels;
+				short firstNext = 0;
+				short secondNext = 0;
+				if (i + 1 < tapCount) {
+					firstPixels = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p_firstPixels + i * 4));
+					secondPixels = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p_secondPixels + i * 4));
+					firstNext = p_firstWeights[i + 1];
+					secondNext = p_secondWeights[i + 1];
+				}
+				else {
+					int firstPixel;
+					int secondPixel;
+					memcpy(&firstPixel, p_firstPixels + i * 4, sizeof(firstPixel));
+					memcpy(&secondPixel, p_secondPixels + i * 4, sizeof(secondPixel));
+					firstPixels = _mm_cvtsi32_si128(firstPixel);
+					secondPixels = _mm_cvtsi32_si128(secondPixel);
+				}
+
+				__m256i pixels = _mm256_inserti128_si256(_mm256_castsi128_si256(firstPixels), secondPixels, 1);
+				pixels = _mm256_unpacklo_epi8(pixels, zero);
+				pixels = _mm256_unpacklo_epi16(pixels, _mm256_srli_si256(pixels, 8));
+				const __m256i weights = _mm256_inserti128_si256(
+					_mm256_castsi128_si256(_mm_set1_epi32(PackWeights(p_firstWeights[i], firstNext))),
+					_mm_set1_epi32(PackWeights(p_secondWeights[i], secondNext)), 1
+				);
+				sum = _mm256_add_epi32(sum, _mm256_madd_epi16(pixels, weights));
+			}
+
+			StorePixelSSE2(_mm256_castsi256_si128(sum), ap_target + x * 4);
+			StorePixelSSE2(_mm256_extracti128_si256(sum, 1), ap_target + x * 4 + 4);
+		}
+
+		if (x < width) {
+			const __m128i sum = SumPixelSSE2(
+				ap_source + static_cast<size_t>(a_taps.starts[x]) * 4, a_taps.weights.data() + x * tapCount, tapCount
+			);
+			StorePixelSSE2(sum, ap_target + x * 4);
+		}
+	}
+
+	// eight pixels at once. the unpacking and the packing work on each lane, so the pixels keep their order
+	RESAMPLE_TARGET("avx2")
+	unsigned int ResampleColumnAVX2(
+		const unsigned char *const *const ap_rows, const short *const ap_weights, const unsigned int a_tapCount,
+		const unsigned int a_byteCount, unsigned char *const ap_target
+	)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		unsigned int x = 0;
+		for (; x + 32 <= a_byteCount; x += 32) {
+			__m256i sums[4] = {
+				_mm256_set1_epi32(WEIGHT_ROUND), _mm256_set1_epi32(WEIGHT_ROUND),
+				_mm256_set1_epi32(WEIGHT_ROUND), _mm256_set1_epi32(WEIGHT_ROUND)
+			};
+
+			for (unsigned int i = 0; i < a_tapCount; i += 2) {
+				const __m256i firstRow = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ap_rows[i] + x));
+				const __m256i secondRow = i + 1 < a_tapCount ? _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ap_rows[i + 1] + x)) : zero;
+				const __m256i weights = _mm256_set1_epi32(PackWeights(ap_weights[i], i + 1 < a_tapCount ? ap_weights[i + 1] : 0));
+
+				const __m256i lowFirst = _mm256_unpacklo_epi8(firstRow, zero);
+				const __m256i lowSecond = _mm256_unpacklo_epi8(secondRow, zero);
+				const __m256i highFirst = _mm256_unpackhi_epi8(firstRow, zero);
+				const __m256i highSecond = _mm256_unpackhi_epi8(secondRow, zero);
+				sums[0] = _mm256_add_epi32(sums[0], _mm256_madd_epi16(_mm256_unpacklo_epi16(lowFirst, lowSecond), weights));
+				sums[1] = _mm256_add_epi32(sums[1], _mm256_madd_epi16(_mm256_unpackhi_epi16(lowFirst, lowSecond), weights));
+				sums[2] = _mm256_add_epi32(sums[2], _mm256_madd_epi16(_mm256_unpacklo_epi16(highFirst, highSecond), weights));
+				sums[3] = _mm256_add_epi32(sums[3], _mm256_madd_epi16(_mm256_unpackhi_epi16(highFirst, highSecond), weights));
+			}
+
+			const __m256i low = _mm256_packs_epi32(_mm256_srai_epi32(sums[0], WEIGHT_BITS), _mm256_srai_epi32(sums[1], WEIGHT_BITS));
+			const __m256i high = _mm256_packs_epi32(_mm256_srai_epi32(sums[2], WEIGHT_BITS), _mm256_srai_epi32(sums[3], WEIGHT_BITS));
+			__m256i pixels = _mm256_packus_epi16(low, high);
+
+			__m256i alpha = _mm256_srli_epi32(pixels, 24);
+			alpha = _mm256_or_si256(alpha, _mm256_slli_epi32(alpha, 8));
+			alpha = _mm256_or_si256(alpha, _mm256_slli_epi32(alpha, 16));
+			pixels = _mm256_min_epu8(pixels, alpha);
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(ap_target + x), pixels);
+		}
+
+		return x;
+	}
+#endif
+
+	RESAMPLE_KERNEL DetectKernel()
+	{
+#ifdef RESAMPLE_X86
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] >= 7) {
+			__cpuid(info, 1);
+			// the system has to save the AVX registers on a context switch
+			const bool isAVXEnabled = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && 6 == (_xgetbv(0) & 6);
+			__cpuidex(info, 7, 0);
+			if (isAVXEnabled && (info[1] & (1 << 5))) {
+				return RESAMPLE_KERNEL_AVX2;
+			}
+		}
+		// SSE2 is the minimum of the supported Windows versions
+		return RESAMPLE_KERNEL_SSE2;
+#else
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2")) {
+			return RESAMPLE_KERNEL_AVX2;
+		}
+		if (__builtin_cpu_supports("sse2")) {
+			return RESAMPLE_KERNEL_SSE2;
+		}
+#endif
+#endif
+		return RESAMPLE_KERNEL_SCALAR;
+	}
+
+	// the bands which the workers and the calling thread take one after another
+	struct BAND_STATE
+	{
+		std::atomic<unsigned int> nextBand;
+		std::atomic<unsigned int> doneCount;
+		unsigned int bandCount;
+	};
+}
+
+ImageResampler::ImageResampler(const RESAMPLE_FILTER a_filter)
+{
+	m_filter = a_filter;
+	m_kernel = GetSupportedKernel();
+}
+
+ImageResampler::~ImageResampler()
+{
+}
+
+void ImageResampler::SetFilter(const RESAMPLE_FILTER a_filter)
+{
+	m_filter = a_filter;
+}
+
+const RESAMPLE_FILTER ImageResampler::GetFilter()
+{
+	return m_filter;
+}
+
+void ImageResampler::SetKernel(const RESAMPLE_KERNEL a_kernel)
+{
+	const RESAMPLE_KERNEL supportedKernel = GetSupportedKernel();
+	m_kernel = a_kernel < supportedKernel ? a_kernel : supportedKernel;
+}
+
+const RESAMPLE_KERNEL ImageResampler::GetKernel()
+{
+	return m_kernel;
+}
+
+const RESAMPLE_KERNEL ImageResampler::GetSupportedKernel()
+{
+	static const RESAMPLE_KERNEL supportedKernel = DetectKernel();
+	return supportedKernel;
+}
+
+bool ImageResampler::Resample(
+	const IMAGE_PIXELS &a_source, const unsigned int a_width, const unsigned int a_height, IMAGE_PIXELS &a_image,
+	TaskScheduler *const ap_scheduler
+)
+{
+	if (0 == a_source.width || 0 == a_source.height || 0 == a_width || 0 == a_height ||
+		a_source.pixels.size() < static_cast<size_t>(a_source.width) * a_source.height * 4) {
+		return false;
+	}
+
+	RESAMPLE_TAPS columnTaps;
+	RESAMPLE_TAPS rowTaps;
+	ComputeTaps(a_source.width, a_width, columnTaps);
+	ComputeTaps(a_source.height, a_height, rowTaps);
+
+	a_image.width = a_width;
+	a_image.height = a_height;
+	a_image.pixels.resize(static_cast<size_t>(a_width) * a_height * 4);
+
+	const unsigned int bandRowCount = static_cast<unsigned int>(std::ceil(BAND_ROW_COUNT * GetSupport(m_filter)));
+	const unsigned int bandCount = (a_height + bandRowCount - 1) / bandRowCount;
+	const unsigned int threadCount = ap_scheduler ? ap_scheduler->GetThreadCount() : 0;
+	if (bandCount < 2 || 0 == threadCount) {
+		ResampleBand(a_source, columnTaps, rowTaps, a_image, 0, a_height);
+		return true;
+	}
+
+	// a worker which starts after all bands have been taken returns at once, so the state outlives this call
+	std::shared_ptr<BAND_STATE> p_state = std::make_shared<BAND_STATE>();
+	p_state->nextBand = 0;
+	p_state->doneCount = 0;
+	p_state->bandCount = bandCount;
+
+	auto resampleBands = [this, p_state, &a_source, &columnTaps, &rowTaps, &a_image, a_height, bandRowCount]() {
+		for (unsigned int band = p_state->nextBand++; band < p_state->bandCount; band = p_state->nextBand++) {
+			const unsigned int firstRow = band * bandRowCount;
+			const unsigned int lastRow = firstRow + bandRowCount < a_height ? firstRow + bandRowCount : a_height;
+			ResampleBand(a_source, columnTaps, rowTaps, a_image, firstRow, lastRow);
+
+			p_state->doneCount++;
+			p_state->doneCount.notify_all();
+		}
+	};
+
+	const unsigned int helperCount = threadCount < bandCount - 1 ? threadCount : bandCount - 1;
+	for (unsigned int i = 0; i < helperCount; i++) {
+		auto helper = resampleBands;
+		ap_scheduler->Post(std::move(helper));
+	}
+	// the calling thread resamples too, so it never waits for a band which no thread has taken
+	resampleBands();
+
+	for (unsigned int doneCount = p_state->doneCount; doneCount < bandCount; doneCount = p_state->doneCount) {
+		p_state->doneCount.wait(doneCount);
+	}
+
+	return true;
+}
+
+void ImageResampler::ComputeTaps(const unsigned int a_sourceSize, const unsigned int a_targetSize, RESAMPLE_TAPS &a_taps)
+{
+	// the filter is stretched over the source pixels which a target pixel covers when it shrinks the image
+	const double scale = static_cast<double>(a_sourceSize) / a_targetSize;
+	const double filterScale = scale > 1.0 ? scale : 1.0;
+	const double support = GetSupport(m_filter) * filterScale;
+
+	unsigned int tapCount = static_cast<unsigned int>(std::ceil(support)) * 2 + 1;
+	if (tapCount > a_sourceSize) {
+		tapCount = a_sourceSize;
+	}
+	a_taps.tapCount = tapCount;
+	a_taps.starts.resize(a_targetSize);
+	a_taps.weights.assign(static_cast<size_t>(a_targetSize) * tapCount, 0);
+
+	std::vector<double> values(tapCount);
+	for (unsigned int i = 0; i < a_targetSize; i++) {
+		const double center = (i + 0.5) * scale;
+		int first = static_cast<int>(std::floor(center - support + 0.5));
+		int last = static_cast<int>(std::floor(center + support + 0.5));
+		if (first < 0) {
+			first = 0;
+		}
+		if (last > static_cast<int>(a_sourceSize)) {
+			last = static_cast<int>(a_sourceSize);
+		}
+		if (last - first > static_cast<int>(tapCount)) {
+			last = first + static_cast<int>(tapCount);
+		}
+
+		// every target pixel has the same number of taps, so the taps at the end of the axis start earlier
+		const unsigned int start = first + tapCount > a_sourceSize ? a_sourceSize - tapCount : static_cast<unsigned int>(first);
+		a_taps.starts[i] = start;
+
+		double total = 0.0;
+		for (unsigned int tap = 0; tap < tapCount; tap++) {
+			const int position = static_cast<int>(start + tap);
+			values[tap] = position < first || position >= last ? 0.0 : Weigh(m_filter, (position + 0.5 - center) / filterScale);
+			total += values[tap];
+		}
+
+		// the nearest pixel is used if the filter misses every pixel
+		if (0.0 == total) {
+			unsigned int nearest = static_cast<unsigned int>(center);
+			if (nearest >= a_sourceSize) {
+				nearest = a_sourceSize - 1;
+			}
+			values[nearest - start] = 1.0;
+			total = 1.0;
+		}
+
+		// the rounding error is added to the heaviest tap so that the weights sum up to exactly one
+		short *const p_weights = a_taps.weights.data() + static_cast<size_t>(i) * tapCount;
+		int sum = 0;
+		unsigned int heaviestTap = 0;
+		for (unsigned int tap = 0; tap < tapCount; tap++) {
+			p_weights[tap] = static_cast<short>(std::lround(values[tap] / total * WEIGHT_ONE));
+			sum += p_weights[tap];
+			if (p_weights[tap] > p_weights[heaviestTap]) {
+				heaviestTap = tap;
+			}
+		}
+		p_weights[heaviestTap] = static_cast<short>(p_weights[heaviestTap] + WEIGHT_ONE - sum);
+	}
+}
+
+void ImageResampler::ResampleBand(
+	const IMAGE_PIXELS &a_source, const RESAMPLE_TAPS &a_columnTaps, const RESAMPLE_TAPS &a_rowTaps,
+	IMAGE_PIXELS &a_image, const unsigned int a_firstRow, const unsigned int a_lastRow
+)
+{
+	const unsigned int rowTapCount = a_rowTaps.tapCount;
+	const unsigned int firstSourceRow = a_rowTaps.starts[a_firstRow];
+	const unsigned int sourceRowCount = a_rowTaps.starts[a_lastRow - 1] + rowTapCount - firstSourceRow;
+	const size_t sourceStride = static_cast<size_t>(a_source.width) * 4;
+	const unsigned int byteCount = a_image.width * 4;
+
+	// the rows of the band are resampled along the row first unless they keep their width
+	std::vector<unsigned char> rowBuffer;
+	std::vector<const unsigned char *> rows(sourceRowCount);
+	if (a_source.width == a_image.width) {
+		for (unsigned int i = 0; i < sourceRowCount; i++) {
+			rows[i] = a_source.pixels.data() + (firstSourceRow + i) * sourceStride;
+		}
+	}
+	else {
+		rowBuffer.resize(static_cast<size_t>(sourceRowCount) * byteCount);
+		for (unsigned int i = 0; i < sourceRowCount; i++) {
+			const unsigned char *const p_sourceRow = a_source.pixels.data() + (firstSourceRow + i) * sourceStride;
+			unsigned char *const p_row = rowBuffer.data() + static_cast<size_t>(i) * byteCount;
+			switch (m_kernel) {
+#ifdef RESAMPLE_X86
+			case RESAMPLE_KERNEL_AVX2:
+				ResampleRowAVX2(p_sourceRow, a_columnTaps, p_row);
+				break;
+			case RESAMPLE_KERNEL_SSE2:
+				ResampleRowSSE2(p_sourceRow, a_columnTaps, p_row);
+				break;
+#endif
+			default:
+				ResampleRowScalar(p_sourceRow, a_columnTaps, p_row);
+				break;
+			}
+			rows[i] = p_row;
+		}
+	}
+
+	for (unsigned int y = a_firstRow; y < a_lastRow; y++) {
+		const unsigned char *const *const p_rows = rows.data() + (a_rowTaps.starts[y] - firstSourceRow);
+		const short *const p_weights = a_rowTaps.weights.data() + static_cast<size_t>(y) * rowTapCount;
+		unsigned char *const p_target = a_image.pixels.data() + static_cast<size_t>(y) * byteCount;
+
+		unsigned int firstByte = 0;
+		switch (m_kernel) {
+#ifdef RESAMPLE_X86
+		case RESAMPLE_KERNEL_AVX2:
+			firstByte = ResampleColumnAVX2(p_rows, p_weights, rowTapCount, byteCount, p_target);
+			break;
+		case RESAMPLE_KERNEL_SSE2:
+			firstByte = ResampleColumnSSE2(p_rows, p_weights, rowTapCount, byteCount, p_target);
+			break;
+#endif
+		default:
+			break;
+		}
+		ResampleColumnScalar(p_rows, p_weights, rowTapCount, firstByte, byteCount, p_target);
+	}
+}
\ No newline at end of file
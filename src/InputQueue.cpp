@@ -0,0 +1,97 @@
+#include "InputQueue.h"
+
+InputQueue::InputQueue()
+{
+	m_batch.rawCount = 0;
+	m_rawCount = 0;
+	m_deliveredCount = 0;
+}
+
+InputQueue::~InputQueue()
+{
+}
+
+void InputQueue::Push(const INPUT_EVENT &a_event, const INPUT_POINT *const ap_history, const unsigned int a_historyCount)
+{
+	m_batch.rawCount++;
+	m_rawCount++;
+
+	if (!m_batch.events.empty() && Coalesce(m_batch.events.back(), a_event)) {
+		if (INPUT_POINTER_MOVE == a_event.type) {
+			AddHistory(m_batch.events.back(), a_event, ap_history, a_historyCount);
+		}
+		return;
+	}
+
+	INPUT_EVENT event = a_event;
+	event.coalescedCount = 1;
+	event.historyIndex = static_cast<unsigned int>(m_batch.points.size());
+	event.historyCount = 0;
+	if (INPUT_POINTER_MOVE == event.type) {
+		AddHistory(event, a_event, ap_history, a_historyCount);
+	}
+	m_batch.events.push_back(event);
+}
+
+const bool InputQueue::IsEmpty()
+{
+	return m_batch.events.empty();
+}
+
+void InputQueue::TakeBatch(INPUT_BATCH &a_batch)
+{
+	m_deliveredCount += m_batch.events.size();
+
+	a_batch.events.swap(m_batch.events);
+	a_batch.points.swap(m_batch.points);
+	a_batch.rawCount = m_batch.rawCount;
+	m_batch.Clear();
+}
+
+void InputQueue::Clear()
+{
+	m_batch.Clear();
+}
+
+const unsigned long long InputQueue::GetRawCount()
+{
+	return m_rawCount;
+}
+
+const unsigned long long InputQueue::GetDeliveredCount()
+{
+	return m_deliveredCount;
+}
+
+bool InputQueue::Coalesce(INPUT_EVENT &a_lastEvent, const INPUT_EVENT &a_event)
+{
+	if (INPUT_OTHER == a_event.type || a_lastEvent.type != a_event.type ||
+		a_lastEvent.messageID != a_event.messageID || a_lastEvent.modifiers != a_event.modifiers) {
+		return false;
+	}
+
+	const int delta = a_lastEvent.delta + a_event.delta;
+	const unsigned int coalescedCount = a_lastEvent.coalescedCount + 1;
+	const unsigned int historyIndex = a_lastEvent.historyIndex;
+	const unsigned int historyCount = a_lastEvent.historyCount;
+
+	a_lastEvent = a_event;
+	a_lastEvent.coalescedCount = coalescedCount;
+	a_lastEvent.historyIndex = historyIndex;
+	a_lastEvent.historyCount = historyCount;
+	if (INPUT_WHEEL == a_event.type) {
+		a_lastEvent.delta = delta;
+	}
+
+	return true;
+}
+
+void InputQueue::AddHistory(INPUT_EVENT &a_event, const INPUT_EVENT &a_source, const INPUT_POINT *const ap_history, const unsigned int a_historyCount)
+{
+	// the points of the event are always the last ones of `points`, because only the last event is coalesced
+	for (unsigned int i = 0; i < a_historyCount; i++) {
+		m_batch.points.push_back(ap_history[i]);
+	}
+	m_batch.points.push_back(INPUT_POINT({ a_source.x, a_source.y, a_source.time }));
+	a_event.historyCount += a_historyCount + 1;
+}
\ No newline at end of file
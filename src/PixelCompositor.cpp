@@ -0,0 +1,562 @@
+#include "PixelCompositor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define COMPOSITE_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+// the intrinsics of any instruction set can be used without a compiler option
+#define COMPOSITE_TARGET(a_instructionSet)
+#else
+#define COMPOSITE_TARGET(a_instructionSet) __attribute__((target(a_instructionSet)))
+#endif
+#endif
+
+namespace
+{
+	// the linear colors are looked up for sRGB with 12 bits, which keeps every sRGB value after a round trip
+	const unsigned int LINEAR_BITS = 12;
+	const unsigned int LINEAR_MAX = (1 << LINEAR_BITS) - 1;
+	const float BYTE_SCALE = 1.0f / 255.0f;
+
+	// the tables have 32 bit entries, so that AVX2 can gather them
+	struct COMPOSITE_TABLES
+	{
+		int reciprocals[256];					// 255 / alpha in 16 bit fixed point, rounded up, so the colors are rounded exactly
+		float linearColors[256];
+		int srgbColors[LINEAR_MAX + 1];
+	};
+
+	const COMPOSITE_TABLES &GetTables()
+	{
+		static const COMPOSITE_TABLES tables = []() {
+			COMPOSITE_TABLES newTables;
+			newTables.reciprocals[0] = 0;
+			for (int alpha = 1; alpha < 256; alpha++) {
+				newTables.reciprocals[alpha] = (255 * 65536 + alpha - 1) / alpha;
+			}
+			for (int color = 0; color < 256; color++) {
+				const double value = color / 255.0;
+				const double linearValue = value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+				newTables.linearColors[color] = static_cast<float>(linearValue);
+			}
+			for (unsigned int color = 0; color <= LINEAR_MAX; color++) {
+				const double value = static_cast<double>(color) / LINEAR_MAX;
+				const double srgbValue = value <= 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055;
+				newTables.srgbColors[color] = static_cast<int>(std::lround(srgbValue * 255.0));
+			}
+			return newTables;
+		}();
+
+		return tables;
+	}
+
+	// rounds `a_value` / 255 exactly for a product of two bytes
+	inline unsigned int Divide255(const unsigned int a_value)
+	{
+		const unsigned int value = a_value + 128;
+		return (value + (value >> 8)) >> 8;
+	}
+
+	inline unsigned int ScalePixel(const unsigned int a_pixel, const unsigned int a_scale)
+	{
+		unsigned int pixel = 0;
+		for (unsigned int shift = 0; shift < 32; shift += 8) {
+			pixel |= Divide255(((a_pixel >> shift) & 0xFF) * a_scale) << shift;
+		}
+		return pixel;
+	}
+
+	// a color above the alpha isn't valid premultiplied, its sum is saturated
+	inline unsigned int BlendPixel(const unsigned int a_target, const unsigned int a_source)
+	{
+		const unsigned int inverseAlpha = 255 - (a_source >> 24);
+		unsigned int pixel = 0;
+		for (unsigned int shift = 0; shift < 32; shift += 8) {
+			const unsigned int value = ((a_source >> shift) & 0xFF) + Divide255(((a_target >> shift) & 0xFF) * inverseAlpha);
+			pixel |= (value < 255 ? value : 255) << shift;
+		}
+		return pixel;
+	}
+
+	// the source pixels are read from `ap_source`, or they are `a_pixel` if it is nullptr. the mask is optional.
+	// the kernels blend from `a_first` on and return the pixels which they have done, the rest is left to the scalar code
+	void BlendRowScalar(
+		unsigned int *const ap_target, const unsigned int *const ap_source, const unsigned int a_pixel,
+		const unsigned char *const ap_mask, const unsigned int a_first, const unsigned int a_count
+	)
+	{
+		for (unsigned int x = a_first; x < a_count; x++) {
+			unsigned int source = ap_source ? ap_source[x] : a_pixel;
+			if (ap_mask) {
+				source = ScalePixel(source, ap_mask[x]);
+			}
+			ap_target[x] = BlendPixel(ap_target[x], source);
+		}
+	}
+
+	// the alpha is kept if `a_isAlphaKept` is true, `ap_mask` is nullptr then and every pixel is scaled by its own alpha
+	void ScaleRowScalar(
+		unsigned int *const ap_pixels, const unsigned char *const ap_mask, const bool a_isAlphaKept,
+		const unsigned int a_first, const unsigned int a_count
+	)
+	{
+		for (unsigned int x = a_first; x < a_count; x++) {
+			const unsigned int pixel = ap_pixels[x];
+			if (a_isAlphaKept) {
+				ap_pixels[x] = (ScalePixel(pixel, pixel >> 24) & 0x00FFFFFF) | (pixel & 0xFF000000);
+			}
+			else {
+				ap_pixels[x] = ScalePixel(pixel, ap_mask[x]);
+			}
+		}
+	}
+
+	inline unsigned int UnpremultiplyColor(const unsigned int a_color, const unsigned int a_reciprocal)
+	{
+		const unsigned int value = (a_color * a_reciprocal + 0x8000) >> 16;
+		return value < 255 ? value : 255;
+	}
+
+	void UnpremultiplyRowScalar(unsigned int *const ap_pixels, const unsigned int a_first, const unsigned int a_count)
+	{
+		const int *const p_reciprocals = GetTables().reciprocals;
+		for (unsigned int x = a_first; x < a_count; x++) {
+			const unsigned int alpha = ap_pixels[x] >> 24;
+			const unsigned int reciprocal = static_cast<unsigned int>(p_reciprocals[alpha]);
+			unsigned int pixel = alpha << 24;
+			for (unsigned int shift = 0; shift < 24; shift += 8) {
+				pixel |= UnpremultiplyColor((ap_pixels[x] >> shift) & 0xFF, reciprocal) << shift;
+			}
+			ap_pixels[x] = pixel;
+		}
+	}
+
+	// the colors are unpremultiplied, decoded and premultiplied with the alpha in linear light. the blended color is
+	// divided by its alpha, encoded and premultiplied again, so the pixels stay premultiplied sRGB.
+	// the AVX2 kernel does the same float operations in the same order, so it returns the same pixels
+	void BlendRowLinearScalar(
+		unsigned int *const ap_target, const unsigned int *const ap_source, const unsigned int a_first, const unsigned int a_count
+	)
+	{
+		const COMPOSITE_TABLES &tables = GetTables();
+		for (unsigned int x = a_first; x < a_count; x++) {
+			const unsigned int source = ap_source[x];
+			const unsigned int target = ap_target[x];
+			const unsigned int sourceAlpha = source >> 24;
+			const unsigned int targetAlpha = target >> 24;
+			const unsigned int inverseAlpha = 255 - sourceAlpha;
+
+			const unsigned int alpha = std::min(sourceAlpha + Divide255(targetAlpha * inverseAlpha), 255u);
+			if (!alpha) {
+				ap_target[x] = 0;
+				continue;
+			}
+
+			const float sourceScale = static_cast<float>(sourceAlpha) * BYTE_SCALE;
+			const float targetScale = static_cast<float>(targetAlpha) * BYTE_SCALE;
+			const float inverseScale = static_cast<float>(inverseAlpha) * BYTE_SCALE;
+			const float alphaScale = static_cast<float>(alpha) * BYTE_SCALE;
+			unsigned int pixel = alpha << 24;
+			for (unsigned int shift = 0; shift < 24; shift += 8) {
+				const float sourceColor = tables.linearColors[UnpremultiplyColor((source >> shift) & 0xFF, tables.reciprocals[sourceAlpha])];
+				const float targetColor = tables.linearColors[UnpremultiplyColor((target >> shift) & 0xFF, tables.reciprocals[targetAlpha])];
+				const float color = std::min((sourceColor * sourceScale + targetColor * targetScale * inverseScale) / alphaScale, 1.0f);
+				const int srgbColor = tables.srgbColors[static_cast<int>(color * static_cast<float>(LINEAR_MAX) + 0.5f)];
+				pixel |= Divide255(static_cast<unsigned int>(srgbColor) * alpha) << shift;
+			}
+			ap_target[x] = pixel;
+		}
+	}
+
+#ifdef COMPOSITE_X86
+	// multiplies the 4 channels of each pixel with the scale of its 32 bit lane, like `ScalePixel`
+	COMPOSITE_TARGET("sse2")
+	__m128i ScalePixelsSSE2(const __m128i a_pixels, const __m128i a_scales)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i bias = _mm_set1_epi16(128);
+		// each scale into the 4 lanes of 16 bit of its pixel
+		const __m128i scales = _mm_or_si128(a_scales, _mm_slli_epi32(a_scales, 16));
+
+		__m128i low = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a_pixels, zero), _mm_unpacklo_epi32(scales, scales)), bias);
+		__m128i high = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a_pixels, zero), _mm_unpackhi_epi32(scales, scales)), bias);
+		low = _mm_srli_epi16(_mm_add_epi16(low, _mm_srli_epi16(low, 8)), 8);
+		high = _mm_srli_epi16(_mm_add_epi16(high, _mm_srli_epi16(high, 8)), 8);
+
+		return _mm_packus_epi16(low, high);
+	}
+
+	COMPOSITE_TARGET("sse2")
+	__m128i BlendPixelsSSE2(const __m128i a_targets, const __m128i a_sources)
+	{
+		const __m128i inverseAlphas = _mm_sub_epi32(_mm_set1_epi32(255), _mm_srli_epi32(a_sources, 24));
+		return _mm_adds_epu8(a_sources, ScalePixelsSSE2(a_targets, inverseAlphas));
+	}
+
+	COMPOSITE_TARGET("sse2")
+	__m128i LoadMaskSSE2(const unsigned char *const ap_mask)
+	{
+		int mask;
+		memcpy(&mask, ap_mask, sizeof(mask));
+		const __m128i zero = _mm_setzero_si128();
+		return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(mask), zero), zero);
+	}
+
+	COMPOSITE_TARGET("sse2")
+	unsigned int BlendRowSSE2(
+		unsigned int *const ap_target, const unsigned int *const ap_source, const unsigned int a_pixel,
+		const unsigned char *const ap_mask, const unsigned int a_count
+	)
+	{
+		const __m128i pixels = _mm_set1_epi32(static_cast<int>(a_pixel));
+		unsigned int x = 0;
+		for (; x + 4 <= a_count; x += 4) {
+			__m128i sources = ap_source ? _mm_loadu_si128(reinterpret_cast<const __m128i *>(ap_source + x)) : pixels;
+			if (ap_mask) {
+				sources = ScalePixelsSSE2(sources, LoadMaskSSE2(ap_mask + x));
+			}
+			__m128i *const p_targets = reinterpret_cast<__m128i *>(ap_target + x);
+			_mm_storeu_si128(p_targets, BlendPixelsSSE2(_mm_loadu_si128(p_targets), sources));
+		}
+
+		return x;
+	}
+
+	COMPOSITE_TARGET("sse2")
+	unsigned int ScaleRowSSE2(unsigned int *const ap_pixels, const unsigned char *const ap_mask, const bool a_isAlphaKept, const unsigned int a_count)
+	{
+		const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+		unsigned int x = 0;
+		for (; x + 4 <= a_count; x += 4) {
+			__m128i *const p_pixels = reinterpret_cast<__m128i *>(ap_pixels + x);
+			const __m128i pixels = _mm_loadu_si128(p_pixels);
+			if (a_isAlphaKept) {
+				const __m128i scaledPixels = ScalePixelsSSE2(pixels, _mm_srli_epi32(pixels, 24));
+				_mm_storeu_si128(p_pixels, _mm_or_si128(_mm_andnot_si128(alphaMask, scaledPixels), _mm_and_si128(alphaMask, pixels)));
+			}
+			else {
+				_mm_storeu_si128(p_pixels, ScalePixelsSSE2(pixels, LoadMaskSSE2(ap_mask + x)));
+			}
+		}
+
+		return x;
+	}
+
+	COMPOSITE_TARGET("avx2")
+	__m256i ScalePixelsAVX2(const __m256i a_pixels, const __m256i a_scales)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i bias = _mm256_set1_epi16(128);
+		const __m256i scales = _mm256_or_si256(a_scales, _mm256_slli_epi32(a_scales, 16));
+
+		// the unpacks work inside each half of 128 bits, so the pixels and the scales stay in the same order
+		__m256i low = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(a_pixels, zero), _mm256_unpacklo_epi32(scales, scales)), bias);
+		__m256i high = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(a_pixels, zero), _mm256_unpackhi_epi32(scales, scales)), bias);
+		low = _mm256_srli_epi16(_mm256_add_epi16(low, _mm256_srli_epi16(low, 8)), 8);
+		high = _mm256_srli_epi16(_mm256_add_epi16(high, _mm256_srli_epi16(high, 8)), 8);
+
+		return _mm256_packus_epi16(low, high);
+	}
+
+	COMPOSITE_TARGET("avx2")
+	__m256i BlendPixelsAVX2(const __m256i a_targets, const __m256i a_sources)
+	{
+		const __m256i inverseAlphas = _mm256_sub_epi32(_mm256_set1_epi32(255), _mm256_srli_epi32(a_sources, 24));
+		return _mm256_adds_epu8(a_sources, ScalePixelsAVX2(a_targets, inverseAlphas));
+	}
+
+	COMPOSITE_TARGET("avx2")
+	__m256i LoadMaskAVX2(const unsigned char *const ap_mask)
+	{
+		return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(ap_mask)));
+	}
+
+	// the channels of 2 pixels in lanes of 32 bit
+	COMPOSITE_TARGET("avx2")
+	__m256i LoadChannelsAVX2(const unsigned int *const ap_pixels)
+	{
+		return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(ap_pixels)));
+	}
+
+	// packs the channels of 8 pixels, the first pixels of each pair are in the lower halves
+	COMPOSITE_TARGET("avx2")
+	__m256i PackChannelsAVX2(const __m256i *const ap_channels)
+	{
+		const __m256i pixels = _mm256_packus_epi16(
+			_mm256_packus_epi32(ap_channels[0], ap_channels[1]), _mm256_packus_epi32(ap_channels[2], ap_channels[3])
+		);
+		return _mm256_permutevar8x32_epi32(pixels, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+	}
+
+	COMPOSITE_TARGET("avx2")
+	__m256i Divide255AVX2(const __m256i a_values)
+	{
+		const __m256i values = _mm256_add_epi32(a_values, _mm256_set1_epi32(128));
+		return _mm256_srli_epi32(_mm256_add_epi32(values, _mm256_srli_epi32(values, 8)), 8);
+	}
+
+	COMPOSITE_TARGET("avx2")
+	unsigned int BlendRowAVX2(
+		unsigned int *const ap_target, const unsigned int *const ap_source, const unsigned int a_pixel,
+		const unsigned char *const ap_mask, const unsigned int a_count
+	)
+	{
+		const __m256i pixels = _mm256_set1_epi32(static_cast<int>(a_pixel));
+		unsigned int x = 0;
+		for (; x + 8 <= a_count; x += 8) {
+			__m256i sources = ap_source ? _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ap_source + x)) : pixels;
+			if (ap_mask) {
+				sources = ScalePixelsAVX2(sources, LoadMaskAVX2(ap_mask + x));
+			}
+			__m256i *const p_targets = reinterpret_cast<__m256i *>(ap_target + x);
+			_mm256_storeu_si256(p_targets, BlendPixelsAVX2(_mm256_loadu_si256(p_targets), sources));
+		}
+
+		return x;
+	}
+
+	COMPOSITE_TARGET("avx2")
+	unsigned int ScaleRowAVX2(unsigned int *const ap_pixels, const unsigned char *const ap_mask, const bool a_isAlphaKept, const unsigned int a_count)
+	{
+		const __m256i alphaMask = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+		unsigned int x = 0;
+		for (; x + 8 <= a_count; x += 8) {
+			__m256i *const p_pixels = reinterpret_cast<__m256i *>(ap_pixels + x);
+			const __m256i pixels = _mm256_loadu_si256(p_pixels);
+			if (a_isAlphaKept) {
+				const __m256i scaledPixels = ScalePixelsAVX2(pixels, _mm256_srli_epi32(pixels, 24));
+				_mm256_storeu_si256(p_pixels, _mm256_blendv_epi8(scaledPixels, pixels, alphaMask));
+			}
+			else {
+				_mm256_storeu_si256(p_pixels, ScalePixelsAVX2(pixels, LoadMaskAVX2(ap_mask + x)));
+			}
+		}
+
+		return x;
+	}
+
+	// unpremultiplies the colors of 2 pixels in lanes of 32 bit and keeps their alpha
+	COMPOSITE_TARGET("avx2")
+	__m256i UnpremultiplyChannelsAVX2(const __m256i a_channels, const int *const ap_reciprocals)
+	{
+		const __m256i alphas = _mm256_shuffle_epi32(a_channels, _MM_SHUFFLE(3, 3, 3, 3));
+		const __m256i reciprocals = _mm256_i32gather_epi32(ap_reciprocals, alphas, 4);
+		const __m256i colors = _mm256_srli_epi32(_mm256_add_epi32(_mm256_mullo_epi32(a_channels, reciprocals), _mm256_set1_epi32(0x8000)), 16);
+		// the alpha is the fourth lane of each pixel
+		return _mm256_blend_epi32(_mm256_min_epu32(colors, _mm256_set1_epi32(255)), a_channels, 0x88);
+	}
+
+	COMPOSITE_TARGET("avx2")
+	unsigned int UnpremultiplyRowAVX2(unsigned int *const ap_pixels, const unsigned int a_count)
+	{
+		const int *const p_reciprocals = GetTables().reciprocals;
+		unsigned int x = 0;
+		for (; x + 8 <= a_count; x += 8) {
+			__m256i channels[4];
+			for (unsigned int i = 0; i < 4; i++) {
+				channels[i] = UnpremultiplyChannelsAVX2(LoadChannelsAVX2(ap_pixels + x + i * 2), p_reciprocals);
+			}
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(ap_pixels + x), PackChannelsAVX2(channels));
+		}
+
+		return x;
+	}
+
+	COMPOSITE_TARGET("avx2")
+	unsigned int BlendRowLinearAVX2(unsigned int *const ap_target, const unsigned int *const ap_source, const unsigned int a_count)
+	{
+		const COMPOSITE_TABLES &tables = GetTables();
+		const __m256i maxValue = _mm256_set1_epi32(255);
+		const __m256 byteScale = _mm256_set1_ps(BYTE_SCALE);
+		unsigned int x = 0;
+		for (; x + 8 <= a_count; x += 8) {
+			__m256i channels[4];
+			for (unsigned int i = 0; i < 4; i++) {
+				const __m256i sources = LoadChannelsAVX2(ap_source + x + i * 2);
+				const __m256i targets = LoadChannelsAVX2(ap_target + x + i * 2);
+				const __m256i sourceAlphas = _mm256_shuffle_epi32(sources, _MM_SHUFFLE(3, 3, 3, 3));
+				const __m256i targetAlphas = _mm256_shuffle_epi32(targets, _MM_SHUFFLE(3, 3, 3, 3));
+				const __m256i inverseAlphas = _mm256_sub_epi32(maxValue, sourceAlphas);
+				const __m256i alphas = _mm256_min_epu32(_mm256_add_epi32(sourceAlphas, Divide255AVX2(_mm256_mullo_epi32(targetAlphas, inverseAlphas))), maxValue);
+
+				const __m256 sourceColors = _mm256_i32gather_ps(tables.linearColors, UnpremultiplyChannelsAVX2(sources, tables.reciprocals), 4);
+				const __m256 targetColors = _mm256_i32gather_ps(tables.linearColors, UnpremultiplyChannelsAVX2(targets, tables.reciprocals), 4);
+				const __m256 sourceScales = _mm256_mul_ps(_mm256_cvtepi32_ps(sourceAlphas), byteScale);
+				const __m256 targetScales = _mm256_mul_ps(_mm256_cvtepi32_ps(targetAlphas), byteScale);
+				const __m256 inverseScales = _mm256_mul_ps(_mm256_cvtepi32_ps(inverseAlphas), byteScale);
+				const __m256 alphaScales = _mm256_mul_ps(_mm256_cvtepi32_ps(alphas), byteScale);
+
+				__m256 colors = _mm256_add_ps(
+					_mm256_mul_ps(sourceColors, sourceScales), _mm256_mul_ps(_mm256_mul_ps(targetColors, targetScales), inverseScales)
+				);
+				// a transparent result is cleared below, its division isn't used
+				colors = _mm256_min_ps(_mm256_div_ps(colors, alphaScales), _mm256_set1_ps(1.0f));
+				const __m256i indices = _mm256_cvttps_epi32(
+					_mm256_add_ps(_mm256_mul_ps(colors, _mm256_set1_ps(static_cast<float>(LINEAR_MAX))), _mm256_set1_ps(0.5f))
+				);
+				const __m256i srgbColors = _mm256_i32gather_epi32(tables.srgbColors, indices, 4);
+
+				__m256i pixels = _mm256_blend_epi32(Divide255AVX2(_mm256_mullo_epi32(srgbColors, alphas)), alphas, 0x88);
+				channels[i] = _mm256_andnot_si256(_mm256_cmpeq_epi32(alphas, _mm256_setzero_si256()), pixels);
+			}
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(ap_target + x), PackChannelsAVX2(channels));
+		}
+
+		return x;
+	}
+#endif
+
+	COMPOSITE_KERNEL DetectKernel()
+	{
+#ifdef COMPOSITE_X86
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] >= 7) {
+			__cpuid(info, 1);
+			// the system has to save the AVX registers on a context switch
+			const bool isAVXEnabled = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && 6 == (_xgetbv(0) & 6);
+			__cpuidex(info, 7, 0);
+			if (isAVXEnabled && (info[1] & (1 << 5))) {
+				return COMPOSITE_KERNEL_AVX2;
+			}
+		}
+		// SSE2 is the minimum of the supported Windows versions
+		return COMPOSITE_KERNEL_SSE2;
+#else
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2")) {
+			return COMPOSITE_KERNEL_AVX2;
+		}
+		if (__builtin_cpu_supports("sse2")) {
+			return COMPOSITE_KERNEL_SSE2;
+		}
+#endif
+#endif
+		return COMPOSITE_KERNEL_SCALAR;
+	}
+
+	unsigned int BlendRow(
+		const COMPOSITE_KERNEL a_kernel, unsigned int *const ap_target, const unsigned int *const ap_source,
+		const unsigned int a_pixel, const unsigned char *const ap_mask, const unsigned int a_count
+	)
+	{
+		switch (a_kernel) {
+#ifdef COMPOSITE_X86
+		case COMPOSITE_KERNEL_AVX2:
+			return BlendRowAVX2(ap_target, ap_source, a_pixel, ap_mask, a_count);
+		case COMPOSITE_KERNEL_SSE2:
+			return BlendRowSSE2(ap_target, ap_source, a_pixel, ap_mask, a_count);
+#endif
+		default:
+			return 0;
+		}
+	}
+
+	unsigned int ScaleRow(
+		const COMPOSITE_KERNEL a_kernel, unsigned int *const ap_pixels, const unsigned char *const ap_mask,
+		const bool a_isAlphaKept, const unsigned int a_count
+	)
+	{
+		switch (a_kernel) {
+#ifdef COMPOSITE_X86
+		case COMPOSITE_KERNEL_AVX2:
+			return ScaleRowAVX2(ap_pixels, ap_mask, a_isAlphaKept, a_count);
+		case COMPOSITE_KERNEL_SSE2:
+			return ScaleRowSSE2(ap_pixels, ap_mask, a_isAlphaKept, a_count);
+#endif
+		default:
+			return 0;
+		}
+	}
+}
+
+PixelCompositor::PixelCompositor()
+{
+	m_kernel = GetSupportedKernel();
+}
+
+PixelCompositor::~PixelCompositor()
+{
+}
+
+void PixelCompositor::SetKernel(const COMPOSITE_KERNEL a_kernel)
+{
+	const COMPOSITE_KERNEL supportedKernel = GetSupportedKernel();
+	m_kernel = a_kernel < supportedKernel ? a_kernel : supportedKernel;
+}
+
+const COMPOSITE_KERNEL PixelCompositor::GetKernel()
+{
+	return m_kernel;
+}
+
+const COMPOSITE_KERNEL PixelCompositor::GetSupportedKernel()
+{
+	static const COMPOSITE_KERNEL supportedKernel = DetectKernel();
+	return supportedKernel;
+}
+
+void PixelCompositor::BlendOver(unsigned int *const ap_target, const unsigned int *const ap_source, const unsigned int a_count)
+{
+	BlendRowScalar(ap_target, ap_source, 0, nullptr, BlendRow(m_kernel, ap_target, ap_source, 0, nullptr, a_count), a_count);
+}
+
+void PixelCompositor::BlendOver(
+	unsigned int *const ap_target, const unsigned int *const ap_source, const unsigned char *const ap_mask, const unsigned int a_count
+)
+{
+	BlendRowScalar(ap_target, ap_source, 0, ap_mask, BlendRow(m_kernel, ap_target, ap_source, 0, ap_mask, a_count), a_count);
+}
+
+void PixelCompositor::FillSpan(unsigned int *const ap_target, const unsigned int a_pixel, const unsigned int a_count)
+{
+	const unsigned int alpha = a_pixel >> 24;
+	if (255 == alpha) {
+		std::fill(ap_target, ap_target + a_count, a_pixel);
+	}
+	else if (alpha || a_pixel) {
+		BlendRowScalar(ap_target, nullptr, a_pixel, nullptr, BlendRow(m_kernel, ap_target, nullptr, a_pixel, nullptr, a_count), a_count);
+	}
+}
+
+void PixelCompositor::FillSpan(unsigned int *const ap_target, const unsigned int a_pixel, const unsigned char *const ap_mask, const unsigned int a_count)
+{
+	BlendRowScalar(ap_target, nullptr, a_pixel, ap_mask, BlendRow(m_kernel, ap_target, nullptr, a_pixel, ap_mask, a_count), a_count);
+}
+
+void PixelCompositor::ApplyMask(unsigned int *const ap_pixels, const unsigned char *const ap_mask, const unsigned int a_count)
+{
+	ScaleRowScalar(ap_pixels, ap_mask, false, ScaleRow(m_kernel, ap_pixels, ap_mask, false, a_count), a_count);
+}
+
+void PixelCompositor::Premultiply(unsigned int *const ap_pixels, const unsigned int a_count)
+{
+	ScaleRowScalar(ap_pixels, nullptr, true, ScaleRow(m_kernel, ap_pixels, nullptr, true, a_count), a_count);
+}
+
+void PixelCompositor::Unpremultiply(unsigned int *const ap_pixels, const unsigned int a_count)
+{
+	unsigned int x = 0;
+#ifdef COMPOSITE_X86
+	if (COMPOSITE_KERNEL_AVX2 == m_kernel) {
+		x = UnpremultiplyRowAVX2(ap_pixels, a_count);
+	}
+#endif
+	UnpremultiplyRowScalar(ap_pixels, x, a_count);
+}
+
+void PixelCompositor::BlendOverLinear(unsigned int *const ap_target, const unsigned int *const ap_source, const unsigned int a_count)
+{
+	unsigned int x = 0;
+#ifdef COMPOSITE_X86
+	if (COMPOSITE_KERNEL_AVX2 == m_kernel) {
+		x = BlendRowLinearAVX2(ap_target, ap_source, a_count);
+	}
+#endif
+	BlendRowLinearScalar(ap_target, ap_source, x, a_count);
+}
\ No newline at end of file
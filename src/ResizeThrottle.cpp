@@ -0,0 +1,111 @@
+#include "ResizeThrottle.h"
+
+ResizeThrottle::ResizeThrottle(const unsigned long long a_interval)
+{
+	m_interval = a_interval;
+	m_isLiveResize = false;
+	m_isPending = false;
+	m_pendingWidth = 0;
+	m_pendingHeight = 0;
+	m_width = 0;
+	m_height = 0;
+	m_applyTime = 0;
+	ResetStatistics();
+}
+
+ResizeThrottle::~ResizeThrottle()
+{
+}
+
+void ResizeThrottle::SetInterval(const unsigned long long a_interval)
+{
+	m_interval = a_interval;
+}
+
+void ResizeThrottle::BeginLiveResize()
+{
+	m_isLiveResize = true;
+}
+
+bool ResizeThrottle::EndLiveResize(const unsigned long long a_time)
+{
+	m_isLiveResize = false;
+	if (!m_isPending) {
+		return false;
+	}
+
+	Apply(m_pendingWidth, m_pendingHeight, a_time);
+	return true;
+}
+
+bool ResizeThrottle::Request(const unsigned int a_width, const unsigned int a_height, const unsigned long long a_time)
+{
+	m_statistics.requestCount++;
+
+	if (!m_isLiveResize || a_time - m_applyTime >= m_interval) {
+		// the waiting size is replaced by this one
+		if (m_isPending) {
+			m_statistics.droppedCount++;
+		}
+		Apply(a_width, a_height, a_time);
+		return true;
+	}
+
+	if (m_isPending) {
+		m_statistics.droppedCount++;
+	}
+	m_isPending = true;
+	m_pendingWidth = a_width;
+	m_pendingHeight = a_height;
+
+	return false;
+}
+
+bool ResizeThrottle::Poll(const unsigned long long a_time)
+{
+	if (!m_isPending || a_time - m_applyTime < m_interval) {
+		return false;
+	}
+
+	Apply(m_pendingWidth, m_pendingHeight, a_time);
+	return true;
+}
+
+const unsigned int ResizeThrottle::GetWidth()
+{
+	return m_width;
+}
+
+const unsigned int ResizeThrottle::GetHeight()
+{
+	return m_height;
+}
+
+const bool ResizeThrottle::IsLiveResize()
+{
+	return m_isLiveResize;
+}
+
+const unsigned long long ResizeThrottle::GetInterval()
+{
+	return m_interval;
+}
+
+const RESIZE_STATISTICS &ResizeThrottle::GetStatistics()
+{
+	return m_statistics;
+}
+
+void ResizeThrottle::ResetStatistics()
+{
+	m_statistics = { 0, 0, 0 };
+}
+
+void ResizeThrottle::Apply(const unsigned int a_width, const unsigned int a_height, const unsigned long long a_time)
+{
+	m_isPending = false;
+	m_width = a_width;
+	m_height = a_height;
+	m_applyTime = a_time;
+	m_statistics.appliedCount++;
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include "SkylinePacker.h"
+
+SkylinePacker::SkylinePacker(const int a_width, const int a_height)
+{
+	Reset(a_width, a_height);
+}
+
+SkylinePacker::~SkylinePacker()
+{
+}
+
+bool SkylinePacker::Insert(const int a_width, const int a_height, int &a_x, int &a_y)
+{
+	if (a_width <= 0 || a_height <= 0) {
+		return false;
+	}
+
+	// the lowest top wins, a narrower node breaks the tie to leave the wider gaps open
+	size_t bestIndex = m_skyline.size();
+	int bestTop = m_height + 1;
+	int bestWidth = 0;
+
+	for (size_t i = 0; i < m_skyline.size(); i++) {
+		const int y = GetFitPosition(i, a_width, a_height);
+		if (y < 0) {
+			continue;
+		}
+
+		const int top = y + a_height;
+		if (top < bestTop || (top == bestTop && m_skyline[i].width < bestWidth)) {
+			bestIndex = i;
+			bestTop = top;
+			bestWidth = m_skyline[i].width;
+		}
+	}
+
+	if (bestIndex == m_skyline.size()) {
+		return false;
+	}
+
+	a_x = m_skyline[bestIndex].x;
+	a_y = bestTop - a_height;
+	AddNode(bestIndex, a_x, a_y, a_width, a_height);
+
+	m_usedArea += static_cast<unsigned long long>(a_width) * a_height;
+	m_rectCount++;
+
+	return true;
+}
+
+void SkylinePacker::Reset()
+{
+	m_skyline.clear();
+	m_skyline.push_back(SKYLINE_NODE({ 0, 0, m_width }));
+	m_usedArea = 0;
+	m_rectCount = 0;
+}
+
+void SkylinePacker::Reset(const int a_width, const int a_height)
+{
+	m_width = a_width > 0 ? a_width : 1;
+	m_height = a_height > 0 ? a_height : 1;
+	Reset();
+}
+
+const int SkylinePacker::GetWidth()
+{
+	return m_width;
+}
+
+const int SkylinePacker::GetHeight()
+{
+	return m_height;
+}
+
+const unsigned int SkylinePacker::GetRectCount()
+{
+	return m_rectCount;
+}
+
+const unsigned long long SkylinePacker::GetUsedArea()
+{
+	return m_usedArea;
+}
+
+const float SkylinePacker::GetOccupancy()
+{
+	return static_cast<float>(static_cast<double>(m_usedArea) / (static_cast<double>(m_width) * m_height));
+}
+
+int SkylinePacker::GetFitPosition(const size_t a_index, const int a_width, const int a_height)
+{
+	if (m_skyline[a_index].x + a_width > m_width) {
+		return -1;
+	}
+
+	// the rectangle lies on the highest node under its width
+	int y = 0;
+	int remainWidth = a_width;
+	for (size_t i = a_index; remainWidth > 0; i++) {
+		if (m_skyline[i].y > y) {
+			y = m_skyline[i].y;
+		}
+		if (y + a_height > m_height) {
+			return -1;
+		}
+		remainWidth -= m_skyline[i].width;
+	}
+
+	return y;
+}
+
+void SkylinePacker::AddNode(const size_t a_index, const int a_x, const int a_y, const int a_width, const int a_height)
+{
+	m_skyline.insert(m_skyline.begin() + a_index, SKYLINE_NODE({ a_x, a_y + a_height, a_width }));
+
+	// the nodes under the new one are shrunk or removed
+	const int right = a_x + a_width;
+	size_t i = a_index + 1;
+	while (i < m_skyline.size() && m_skyline[i].x < right) {
+		const int nodeRight = m_skyline[i].x + m_skyline[i].width;
+		if (nodeRight <= right) {
+			m_skyline.erase(m_skyline.begin() + i);
+			continue;
+		}
+
+		m_skyline[i].width = nodeRight - right;
+		m_skyline[i].x = right;
+		break;
+	}
+
+	// the neighbours of the same height become one node
+	for (size_t j = 0; j + 1 < m_skyline.size();) {
+		if (m_skyline[j].y == m_skyline[j + 1].y) {
+			m_skyline[j].width += m_skyline[j + 1].width;
+			m_skyline.erase(m_skyline.begin() + j + 1);
+		} else {
+			j++;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,661 @@
+#include "SoftwareRasterizer.h"
+#include <algorithm>
+#include <cmath>
+
+#define PI_F				3.14159265358979f
+// coverage below this value doesn't change an 8-bit pixel
+#define MIN_COVERAGE		(1.0f / 512.0f)
+#define MAX_ARC_SEGMENTS	256
+
+namespace
+{
+	// multiplies all 4 channels of a premultiplied pixel with `a_scale` / 255
+	inline unsigned int ScalePixel(const unsigned int a_pixel, const unsigned int a_scale)
+	{
+		unsigned int redBlue = (a_pixel & 0x00FF00FF) * a_scale + 0x00800080;
+		unsigned int alphaGreen = ((a_pixel >> 8) & 0x00FF00FF) * a_scale + 0x00800080;
+		redBlue = ((redBlue + ((redBlue >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+		alphaGreen = (alphaGreen + ((alphaGreen >> 8) & 0x00FF00FF)) & 0xFF00FF00;
+
+		return redBlue | alphaGreen;
+	}
+
+	inline unsigned int ToPremultipliedPixel(const RColor &a_color, const float a_coverage)
+	{
+		const float alpha = std::min(1.0f, std::max(0.0f, a_color.a * a_coverage));
+		auto ToByte = [alpha](const float a_channel) {
+			return static_cast<unsigned int>(std::min(1.0f, std::max(0.0f, a_channel)) * alpha * 255.0f + 0.5f);
+		};
+
+		return (static_cast<unsigned int>(alpha * 255.0f + 0.5f) << 24) |
+			(ToByte(a_color.r) << 16) | (ToByte(a_color.g) << 8) | ToByte(a_color.b);
+	}
+}
+
+SoftwareRasterizer::SoftwareRasterizer(const int a_width, const int a_height)
+{
+	m_width = std::max(a_width, 0);
+	m_height = std::max(a_height, 0);
+	m_stride = m_width;
+	mp_pixels = new unsigned int[static_cast<size_t>(m_stride) * m_height]();
+	m_isOwnBuffer = true;
+
+	SetLimitRect(0, 0, m_width, m_height);
+	SetColor(RColor({ 1.0f, 1.0f, 1.0f, 1.0f }));
+	m_strokeWidth = 1.0f;
+	m_transform = IdentityMatrix();
+	m_tolerance = 0.25f;
+}
+
+SoftwareRasterizer::SoftwareRasterizer(unsigned int *const ap_pixels, const int a_width, const int a_height, const int a_stride)
+{
+	mp_pixels = ap_pixels;
+	m_width = a_width;
+	m_height = a_height;
+	m_stride = a_stride;
+	m_isOwnBuffer = false;
+
+	SetLimitRect(0, 0, m_width, m_height);
+	SetColor(RColor({ 1.0f, 1.0f, 1.0f, 1.0f }));
+	m_strokeWidth = 1.0f;
+	m_transform = IdentityMatrix();
+	m_tolerance = 0.25f;
+}
+
+SoftwareRasterizer::~SoftwareRasterizer()
+{
+	if (m_isOwnBuffer) {
+		delete[] mp_pixels;
+	}
+}
+
+unsigned int *const SoftwareRasterizer::GetPixels()
+{
+	return mp_pixels;
+}
+
+const int SoftwareRasterizer::GetWidth()
+{
+	return m_width;
+}
+
+const int SoftwareRasterizer::GetHeight()
+{
+	return m_height;
+}
+
+const int SoftwareRasterizer::GetStride()
+{
+	return m_stride;
+}
+
+void SoftwareRasterizer::SetClipRect(const int a_left, const int a_top, const int a_right, const int a_bottom)
+{
+	m_clipLeft = std::max(a_left, m_limitLeft);
+	m_clipTop = std::max(a_top, m_limitTop);
+	m_clipRight = std::max(m_clipLeft, std::min(a_right, m_limitRight));
+	m_clipBottom = std::max(m_clipTop, std::min(a_bottom, m_limitBottom));
+}
+
+void SoftwareRasterizer::SetLimitRect(const int a_left, const int a_top, const int a_right, const int a_bottom)
+{
+	m_limitLeft = std::max(a_left, 0);
+	m_limitTop = std::max(a_top, 0);
+	m_limitRight = std::max(m_limitLeft, std::min(a_right, m_width));
+	m_limitBottom = std::max(m_limitTop, std::min(a_bottom, m_height));
+
+	ResetClipRect();
+}
+
+void SoftwareRasterizer::SetClipRect(const RRect &a_rect)
+{
+	// the clips which don't overlap are intersected into an empty rectangle, which must not keep a column of pixels
+	if (!(a_rect.left < a_rect.right && a_rect.top < a_rect.bottom)) {
+		SetClipRect(m_limitLeft, m_limitTop, m_limitLeft, m_limitTop);
+		return;
+	}
+
+	SetClipRect(
+		static_cast<int>(std::floor(a_rect.left)), static_cast<int>(std::floor(a_rect.top)),
+		static_cast<int>(std::ceil(a_rect.right)), static_cast<int>(std::ceil(a_rect.bottom))
+	);
+}
+
+void SoftwareRasterizer::ResetClipRect()
+{
+	m_clipLeft = m_limitLeft;
+	m_clipTop = m_limitTop;
+	m_clipRight = m_limitRight;
+	m_clipBottom = m_limitBottom;
+}
+
+void SoftwareRasterizer::SetTolerance(const float a_tolerance)
+{
+	m_tolerance = std::max(a_tolerance, 0.01f);
+}
+
+void SoftwareRasterizer::BeginDraw()
+{
+
+}
+
+void SoftwareRasterizer::EndDraw()
+{
+
+}
+
+void SoftwareRasterizer::Clear(const RColor &a_color)
+{
+	const unsigned int pixel = ToPremultipliedPixel(a_color, 1.0f);
+	for (int y = m_clipTop; y < m_clipBottom; y++) {
+		unsigned int *p_row = mp_pixels + static_cast<size_t>(y) * m_stride;
+		std::fill(p_row + m_clipLeft, p_row + m_clipRight, pixel);
+	}
+}
+
+void SoftwareRasterizer::SetColor(const RColor &a_color)
+{
+	m_color = a_color;
+	m_solidPixel = ToPremultipliedPixel(a_color, 1.0f);
+}
+
+void SoftwareRasterizer::SetStrokeWidth(const float a_strokeWidth)
+{
+	m_strokeWidth = a_strokeWidth;
+}
+
+void SoftwareRasterizer::SetTransform(const RMatrix &a_transform)
+{
+	m_transform = a_transform;
+}
+
+////////////////////////////////////
+// drawing methode
+////////////////////////////////////
+
+void SoftwareRasterizer::DrawLine(const RPoint &a_startPoint, const RPoint &a_endPoint)
+{
+	AddCapsule(a_startPoint, a_endPoint, m_strokeWidth * 0.5f);
+	FillPath();
+}
+
+void SoftwareRasterizer::DrawRectangle(const RRect &a_rect)
+{
+	const float halfWidth = m_strokeWidth * 0.5f;
+	// the outer border has the round joins of the default stroke style
+	AddRoundedRectangle(
+		RRect({ a_rect.left - halfWidth, a_rect.top - halfWidth, a_rect.right + halfWidth, a_rect.bottom + halfWidth }),
+		halfWidth, halfWidth, false
+	);
+	const RRect innerRect = { a_rect.left + halfWidth, a_rect.top + halfWidth, a_rect.right - halfWidth, a_rect.bottom - halfWidth };
+	if (innerRect.left < innerRect.right && innerRect.top < innerRect.bottom) {
+		AddRoundedRectangle(innerRect, 0.0f, 0.0f, true);
+	}
+	FillPath();
+}
+
+void SoftwareRasterizer::DrawRoundedRectangle(const RRect &a_rect, const float a_radius)
+{
+	const float halfWidth = m_strokeWidth * 0.5f;
+	AddRoundedRectangle(
+		RRect({ a_rect.left - halfWidth, a_rect.top - halfWidth, a_rect.right + halfWidth, a_rect.bottom + halfWidth }),
+		a_radius + halfWidth, a_radius + halfWidth, false
+	);
+	const RRect innerRect = { a_rect.left + halfWidth, a_rect.top + halfWidth, a_rect.right - halfWidth, a_rect.bottom - halfWidth };
+	if (innerRect.left < innerRect.right && innerRect.top < innerRect.bottom) {
+		const float innerRadius = std::max(a_radius - halfWidth, 0.0f);
+		AddRoundedRectangle(innerRect, innerRadius, innerRadius, true);
+	}
+	FillPath();
+}
+
+void SoftwareRasterizer::DrawEllipse(const RRect &a_rect)
+{
+	const float halfWidth = m_strokeWidth * 0.5f;
+	AddEllipse(RRect({ a_rect.left - halfWidth, a_rect.top - halfWidth, a_rect.right + halfWidth, a_rect.bottom + halfWidth }), false);
+	const RRect innerRect = { a_rect.left + halfWidth, a_rect.top + halfWidth, a_rect.right - halfWidth, a_rect.bottom - halfWidth };
+	if (innerRect.left < innerRect.right && innerRect.top < innerRect.bottom) {
+		AddEllipse(innerRect, true);
+	}
+	FillPath();
+}
+
+void SoftwareRasterizer::DrawPolyline(const RPoint *const ap_points, const unsigned int *const ap_contourSizes, const unsigned int a_contourCount)
+{
+	const float halfWidth = m_strokeWidth * 0.5f;
+	const RPoint *p_point = ap_points;
+
+	for (unsigned int contour = 0; contour < a_contourCount; contour++) {
+		const unsigned int size = ap_contourSizes[contour];
+		if (1 == size) {
+			AddCapsule(p_point[0], p_point[0], halfWidth);
+		}
+		for (unsigned int i = 1; i < size; i++) {
+			AddCapsule(p_point[i - 1], p_point[i], halfWidth);
+		}
+		p_point += size;
+	}
+	FillPath();
+}
+
+void SoftwareRasterizer::FillRectangle(const RRect &a_rect)
+{
+	if (IsAxisAligned()) {
+		const RPoint leftTop = TransformPoint(m_transform, RPoint({ a_rect.left, a_rect.top }));
+		const RPoint rightBottom = TransformPoint(m_transform, RPoint({ a_rect.right, a_rect.bottom }));
+
+		FillPixelRect(
+			std::min(leftTop.x, rightBottom.x), std::min(leftTop.y, rightBottom.y),
+			std::max(leftTop.x, rightBottom.x), std::max(leftTop.y, rightBottom.y)
+		);
+		return;
+	}
+
+	AddRoundedRectangle(a_rect, 0.0f, 0.0f, false);
+	FillPath();
+}
+
+void SoftwareRasterizer::FillRoundedRectangle(const RRect &a_rect, const float a_radius)
+{
+	AddRoundedRectangle(a_rect, a_radius, a_radius, false);
+	FillPath();
+}
+
+void SoftwareRasterizer::FillEllipse(const RRect &a_rect)
+{
+	AddEllipse(a_rect, false);
+	FillPath();
+}
+
+void SoftwareRasterizer::FillPolygon(const RPoint *const ap_points, const unsigned int *const ap_contourSizes, const unsigned int a_contourCount)
+{
+	const RPoint *p_point = ap_points;
+
+	for (unsigned int contour = 0; contour < a_contourCount; contour++) {
+		const unsigned int startIndex = static_cast<unsigned int>(m_points.size());
+		for (unsigned int i = 0; i < ap_contourSizes[contour]; i++) {
+			AddPoint(p_point[i].x, p_point[i].y);
+		}
+		CloseContour(startIndex);
+		p_point += ap_contourSizes[contour];
+	}
+	FillPath();
+}
+
+////////////////////////////////////
+// path building
+////////////////////////////////////
+
+void SoftwareRasterizer::AddPoint(const float a_x, const float a_y)
+{
+	m_points.push_back(TransformPoint(m_transform, RPoint({ a_x, a_y })));
+}
+
+void SoftwareRasterizer::CloseContour(const unsigned int a_startIndex)
+{
+	const unsigned int size = static_cast<unsigned int>(m_points.size()) - a_startIndex;
+	if (size) {
+		m_contourSizes.push_back(size);
+	}
+}
+
+int SoftwareRasterizer::GetArcSegmentCount(const float a_radius, const float a_sweepAngle)
+{
+	// the scale of the transform decides how large the radius is in pixels
+	const float scale = std::sqrt(std::max(
+		m_transform._11 * m_transform._11 + m_transform._12 * m_transform._12,
+		m_transform._21 * m_transform._21 + m_transform._22 * m_transform._22
+	));
+	const float radius = a_radius * scale;
+	if (radius <= m_tolerance) {
+		return 1;
+	}
+
+	const float stepAngle = 2.0f * std::acos(1.0f - m_tolerance / radius);
+	const int count = static_cast<int>(std::ceil(std::fabs(a_sweepAngle) / stepAngle));
+
+	return std::min(std::max(count, 1), MAX_ARC_SEGMENTS);
+}
+
+void SoftwareRasterizer::AddArc(
+	const float a_centerX, const float a_centerY, const float a_radiusX, const float a_radiusY,
+	const float a_startAngle, const float a_sweepAngle
+)
+{
+	const int count = GetArcSegmentCount(std::max(a_radiusX, a_radiusY), a_sweepAngle);
+	const float step = a_sweepAngle / count;
+
+	for (int i = 0; i <= count; i++) {
+		const float angle = a_startAngle + step * i;
+		AddPoint(a_centerX + a_radiusX * std::cos(angle), a_centerY + a_radiusY * std::sin(angle));
+	}
+}
+
+void SoftwareRasterizer::AddRoundedRectangle(const RRect &a_rect, const float a_radiusX, const float a_radiusY, const bool a_isReversed)
+{
+	const unsigned int startIndex = static_cast<unsigned int>(m_points.size());
+	const float radiusX = std::min(std::max(a_radiusX, 0.0f), (a_rect.right - a_rect.left) * 0.5f);
+	const float radiusY = std::min(std::max(a_radiusY, 0.0f), (a_rect.bottom - a_rect.top) * 0.5f);
+
+	if (radiusX <= 0.0f || radiusY <= 0.0f) {
+		AddPoint(a_rect.left, a_rect.top);
+		AddPoint(a_rect.right, a_rect.top);
+		AddPoint(a_rect.right, a_rect.bottom);
+		AddPoint(a_rect.left, a_rect.bottom);
+	}
+	else {
+		AddArc(a_rect.right - radiusX, a_rect.top + radiusY, radiusX, radiusY, -PI_F * 0.5f, PI_F * 0.5f);
+		AddArc(a_rect.right - radiusX, a_rect.bottom - radiusY, radiusX, radiusY, 0.0f, PI_F * 0.5f);
+		AddArc(a_rect.left + radiusX, a_rect.bottom - radiusY, radiusX, radiusY, PI_F * 0.5f, PI_F * 0.5f);
+		AddArc(a_rect.left + radiusX, a_rect.top + radiusY, radiusX, radiusY, PI_F, PI_F * 0.5f);
+	}
+
+	if (a_isReversed) {
+		std::reverse(m_points.begin() + startIndex, m_points.end());
+	}
+	CloseContour(startIndex);
+}
+
+void SoftwareRasterizer::AddEllipse(const RRect &a_rect, const bool a_isReversed)
+{
+	const unsigned int startIndex = static_cast<unsigned int>(m_points.size());
+	const float radiusX = (a_rect.right - a_rect.left) * 0.5f;
+	const float radiusY = (a_rect.bottom - a_rect.top) * 0.5f;
+
+	AddArc(a_rect.left + radiusX, a_rect.top + radiusY, radiusX, radiusY, 0.0f, a_isReversed ? -2.0f * PI_F : 2.0f * PI_F);
+	CloseContour(startIndex);
+}
+
+void SoftwareRasterizer::AddCapsule(const RPoint &a_startPoint, const RPoint &a_endPoint, const float a_halfWidth)
+{
+	const unsigned int startIndex = static_cast<unsigned int>(m_points.size());
+	const float dx = a_endPoint.x - a_startPoint.x;
+	const float dy = a_endPoint.y - a_startPoint.y;
+	const float angle = (0.0f == dx && 0.0f == dy) ? 0.0f : std::atan2(dy, dx);
+
+	// all capsules have the same orientation so that overlapping joins don't cancel each other
+	AddArc(a_endPoint.x, a_endPoint.y, a_halfWidth, a_halfWidth, angle - PI_F * 0.5f, PI_F);
+	AddArc(a_startPoint.x, a_startPoint.y, a_halfWidth, a_halfWidth, angle + PI_F * 0.5f, PI_F);
+	CloseContour(startIndex);
+}
+
+const bool SoftwareRasterizer::IsAxisAligned()
+{
+	return 0.0f == m_transform._12 && 0.0f == m_transform._21;
+}
+
+////////////////////////////////////
+// rasterization
+////////////////////////////////////
+
+void SoftwareRasterizer::FillPath()
+{
+	const RPoint *p_point = m_points.data();
+	for (const unsigned int size : m_contourSizes) {
+		for (unsigned int i = 0; i < size; i++) {
+			const RPoint &from = p_point[i];
+			const RPoint &to = p_point[(i + 1) % size];
+			AddEdge(from.x, from.y, to.x, to.y);
+		}
+		p_point += size;
+	}
+
+	SweepCells();
+
+	m_points.clear();
+	m_contourSizes.clear();
+	m_cells.clear();
+}
+
+void SoftwareRasterizer::AddEdge(float a_x0, float a_y0, float a_x1, float a_y1)
+{
+	if (a_y0 == a_y1 || !std::isfinite(a_x0 + a_y0 + a_x1 + a_y1)) {
+		return;
+	}
+
+	// the rows outside of the clip rectangle are independent of the visible rows
+	const float top = static_cast<float>(m_clipTop);
+	const float bottom = static_cast<float>(m_clipBottom);
+	if (std::max(a_y0, a_y1) <= top || std::min(a_y0, a_y1) >= bottom) {
+		return;
+	}
+
+	const float dxdy = (a_x1 - a_x0) / (a_y1 - a_y0);
+	auto ClampY = [&](float &a_x, float &a_y, const float a_limit) {
+		a_x += (a_limit - a_y) * dxdy;
+		a_y = a_limit;
+	};
+	if (a_y0 < top) ClampY(a_x0, a_y0, top);
+	else if (a_y0 > bottom) ClampY(a_x0, a_y0, bottom);
+	if (a_y1 < top) ClampY(a_x1, a_y1, top);
+	else if (a_y1 > bottom) ClampY(a_x1, a_y1, bottom);
+
+	AddClippedEdge(a_x0, a_y0, a_x1, a_y1);
+}
+
+void SoftwareRasterizer::AddClippedEdge(float a_x0, float a_y0, float a_x1, float a_y1)
+{
+	// the parts on the left of the clip rectangle still cover the visible pixels on their right,
+	// so they are moved onto the left border. the parts on the right don't cover visible pixels
+	const float left = static_cast<float>(m_clipLeft);
+	const float right = static_cast<float>(m_clipRight);
+	float splits[4] = { 0.0f, 1.0f, 1.0f, 1.0f };
+	int splitCount = 1;
+
+	const float dx = a_x1 - a_x0;
+	if (0.0f != dx) {
+		for (const float border : { left, right }) {
+			const float t = (border - a_x0) / dx;
+			if (t > 0.0f && t < 1.0f) {
+				splits[splitCount++] = t;
+			}
+		}
+	}
+	splits[splitCount] = 1.0f;
+	if (3 == splitCount && splits[1] > splits[2]) {
+		std::swap(splits[1], splits[2]);
+	}
+
+	const float dy = a_y1 - a_y0;
+	for (int i = 0; i < splitCount; i++) {
+		float x0 = a_x0 + dx * splits[i];
+		float x1 = a_x0 + dx * splits[i + 1];
+		const float y0 = a_y0 + dy * splits[i];
+		const float y1 = (i + 1 == splitCount) ? a_y1 : a_y0 + dy * splits[i + 1];
+
+		const float middleX = (x0 + x1) * 0.5f;
+		if (middleX <= left) {
+			x0 = x1 = left;
+		}
+		else if (middleX >= right) {
+			x0 = x1 = right;
+		}
+		else {
+			x0 = std::min(std::max(x0, left), right);
+			x1 = std::min(std::max(x1, left), right);
+		}
+
+		// split the part into rows
+		const float sign = y1 > y0 ? 1.0f : -1.0f;
+		const float fromY = std::min(y0, y1);
+		const float toY = std::max(y0, y1);
+		const float fromX = y1 > y0 ? x0 : x1;
+		const float partDxdy = (toY > fromY) ? ((y1 > y0 ? x1 - x0 : x0 - x1) / (toY - fromY)) : 0.0f;
+
+		float y = fromY;
+		float x = fromX;
+		int row = static_cast<int>(std::floor(fromY));
+		while (y < toY) {
+			const float nextY = std::min(static_cast<float>(row + 1), toY);
+			const float nextX = fromX + (nextY - fromY) * partDxdy;
+			if (sign > 0.0f) {
+				AddCellEdge(row, x, y - row, nextX, nextY - row);
+			}
+			else {
+				AddCellEdge(row, nextX, nextY - row, x, y - row);
+			}
+			y = nextY;
+			x = nextX;
+			row++;
+		}
+	}
+}
+
+// adds a part of an edge in a row. the y values are relative to the row
+void SoftwareRasterizer::AddCellEdge(const int a_row, float a_x0, float a_y0, float a_x1, float a_y1)
+{
+	auto AddCell = [this, a_row](const int a_x, const float a_cover, const float a_area) {
+		if (!m_cells.empty()) {
+			RASTER_CELL &lastCell = m_cells.back();
+			if (lastCell.x == a_x && lastCell.y == a_row) {
+				lastCell.cover += a_cover;
+				lastCell.area += a_area;
+				return;
+			}
+		}
+		m_cells.push_back(RASTER_CELL({ a_x, a_row, a_cover, a_area }));
+	};
+	auto AddPart = [&AddCell](const float a_fromX, const float a_fromY, const float a_toX, const float a_toY) {
+		const float dy = a_toY - a_fromY;
+		if (0.0f == dy) {
+			return;
+		}
+		const int cellX = static_cast<int>(std::floor((a_fromX + a_toX) * 0.5f));
+		AddCell(cellX, dy, dy * ((a_fromX - cellX) + (a_toX - cellX)));
+	};
+
+	const int fromCell = static_cast<int>(std::floor(a_x0));
+	const int toCell = static_cast<int>(std::floor(a_x1));
+	if (fromCell == toCell || a_x0 == a_x1) {
+		AddPart(a_x0, a_y0, a_x1, a_y1);
+		return;
+	}
+
+	// split the edge at the vertical borders of the cells
+	const float dydx = (a_y1 - a_y0) / (a_x1 - a_x0);
+	const int step = toCell > fromCell ? 1 : -1;
+	float x = a_x0;
+	float y = a_y0;
+	for (int cell = fromCell; cell != toCell; cell += step) {
+		const float borderX = static_cast<float>(step > 0 ? cell + 1 : cell);
+		const float borderY = a_y0 + (borderX - a_x0) * dydx;
+		AddPart(x, y, borderX, borderY);
+		x = borderX;
+		y = borderY;
+	}
+	AddPart(x, y, a_x1, a_y1);
+}
+
+void SoftwareRasterizer::SweepCells()
+{
+	if (m_cells.empty()) {
+		return;
+	}
+
+	// the cells are sorted into their rows with a counting sort and by x in every row afterwards
+	int minY = m_cells.front().y;
+	int maxY = minY;
+	for (const RASTER_CELL &cell : m_cells) {
+		minY = std::min(minY, cell.y);
+		maxY = std::max(maxY, cell.y);
+	}
+	m_rowOffsets.assign(static_cast<size_t>(maxY - minY) + 2, 0);
+	for (const RASTER_CELL &cell : m_cells) {
+		m_rowOffsets[cell.y - minY + 1]++;
+	}
+	for (size_t i = 1; i < m_rowOffsets.size(); i++) {
+		m_rowOffsets[i] += m_rowOffsets[i - 1];
+	}
+	m_sortedCells.resize(m_cells.size());
+	for (const RASTER_CELL &cell : m_cells) {
+		m_sortedCells[m_rowOffsets[cell.y - minY]++] = cell;
+	}
+
+	auto IsLeft = [](const RASTER_CELL &a_left, const RASTER_CELL &a_right) {
+		return a_left.x < a_right.x;
+	};
+
+	size_t rowStart = 0;
+	for (int y = minY; y <= maxY; y++) {
+		const size_t rowEnd = m_rowOffsets[y - minY];
+		RASTER_CELL *const p_row = m_sortedCells.data();
+		std::sort(p_row + rowStart, p_row + rowEnd, IsLeft);
+
+		float accumulation = 0.0f;
+		size_t index = rowStart;
+		while (index < rowEnd) {
+			const int x = p_row[index].x;
+			float cover = 0.0f;
+			float area = 0.0f;
+			for (; index < rowEnd && p_row[index].x == x; index++) {
+				cover += p_row[index].cover;
+				area += p_row[index].area;
+			}
+
+			// the pixel of the cell is covered partially by its own edges
+			const float cellCoverage = std::min(std::fabs(accumulation + cover - area * 0.5f), 1.0f);
+			if (cellCoverage >= MIN_COVERAGE) {
+				BlendSpan(y, x, 1, cellCoverage);
+			}
+			accumulation += cover;
+
+			// the pixels up to the next cell have the same coverage
+			const int nextX = index < rowEnd ? p_row[index].x : m_clipRight;
+			const float spanCoverage = std::min(std::fabs(accumulation), 1.0f);
+			if (nextX > x + 1 && spanCoverage >= MIN_COVERAGE) {
+				BlendSpan(y, x + 1, nextX - x - 1, spanCoverage);
+			}
+		}
+		rowStart = rowEnd;
+	}
+}
+
+void SoftwareRasterizer::BlendSpan(const int a_y, const int a_x, const int a_length, const float a_coverage)
+{
+	if (a_y < m_clipTop || a_y >= m_clipBottom) {
+		return;
+	}
+
+	const int fromX = std::max(a_x, m_clipLeft);
+	const int toX = std::min(a_x + a_length, m_clipRight);
+	if (fromX >= toX) {
+		return;
+	}
+
+	const unsigned int source = a_coverage >= 1.0f
+		? m_solidPixel
+		: ScalePixel(m_solidPixel, static_cast<unsigned int>(a_coverage * 255.0f + 0.5f));
+	m_compositor.FillSpan(mp_pixels + static_cast<size_t>(a_y) * m_stride + fromX, source, toX - fromX);
+}
+
+void SoftwareRasterizer::FillPixelRect(float a_left, float a_top, float a_right, float a_bottom)
+{
+	a_left = std::max(a_left, static_cast<float>(m_clipLeft));
+	a_top = std::max(a_top, static_cast<float>(m_clipTop));
+	a_right = std::min(a_right, static_cast<float>(m_clipRight));
+	a_bottom = std::min(a_bottom, static_cast<float>(m_clipBottom));
+	if (a_left >= a_right || a_top >= a_bottom) {
+		return;
+	}
+
+	const int fromX = static_cast<int>(std::floor(a_left));
+	const int toX = static_cast<int>(std::ceil(a_right)) - 1;
+	const int fromY = static_cast<int>(std::floor(a_top));
+	const int toY = static_cast<int>(std::ceil(a_bottom)) - 1;
+
+	for (int y = fromY; y <= toY; y++) {
+		const float rowCoverage = std::min(a_bottom, y + 1.0f) - std::max(a_top, static_cast<float>(y));
+
+		if (fromX == toX) {
+			BlendSpan(y, fromX, 1, rowCoverage * (a_right - a_left));
+			continue;
+		}
+
+		// the partial columns on both sides and the full span between them
+		BlendSpan(y, fromX, 1, rowCoverage * (fromX + 1.0f - a_left));
+		if (toX > fromX + 1) {
+			BlendSpan(y, fromX + 1, toX - fromX - 1, rowCoverage);
+		}
+		BlendSpan(y, toX, 1, rowCoverage * (a_right - toX));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "StartupTimeline.h"
+
+StartupTimeline::StartupTimeline() :
+	m_originTime(std::chrono::steady_clock::now()),
+	m_mainThreadID(std::this_thread::get_id())
+{
+	m_finishTime = 0;
+}
+
+StartupTimeline::~StartupTimeline()
+{
+}
+
+const unsigned long long StartupTimeline::GetTime()
+{
+	return static_cast<unsigned long long>(
+		std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_originTime).count()
+	);
+}
+
+void StartupTimeline::AddPhase(const wchar_t *const ap_name, const unsigned long long a_startTime)
+{
+	const unsigned long long endTime = GetTime();
+	const bool isBackground = std::this_thread::get_id() != m_mainThreadID;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_phases.push_back(STARTUP_PHASE({ ap_name, a_startTime, endTime - a_startTime, isBackground }));
+}
+
+void StartupTimeline::AddMark(const wchar_t *const ap_name)
+{
+	AddPhase(ap_name, GetTime());
+}
+
+void StartupTimeline::Finish(const wchar_t *const ap_name)
+{
+	const unsigned long long time = GetTime();
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_finishTime) {
+			return;
+		}
+		// the time is at least 1, so a finished timeline is never 0
+		m_finishTime = time ? time : 1;
+	}
+
+	AddPhase(ap_name, time);
+}
+
+const bool StartupTimeline::IsFinished()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return 0 != m_finishTime;
+}
+
+const unsigned long long StartupTimeline::GetFinishTime()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_finishTime;
+}
+
+std::vector<STARTUP_PHASE> StartupTimeline::GetPhases()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_phases;
+}
\ No newline at end of file
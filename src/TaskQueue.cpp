@@ -0,0 +1,99 @@
+#include "TaskQueue.h"
+#include <chrono>
+
+TaskQueue::TaskQueue() :
+	mp_head(&m_stub),
+	m_pendingCount(0)
+{
+	mp_tail = &m_stub;
+	m_runCount = 0;
+}
+
+TaskQueue::~TaskQueue()
+{
+	// the remaining tasks are released without running
+	for (TaskNode *p_node = Pop(); p_node; p_node = Pop()) {
+		delete p_node;
+	}
+}
+
+unsigned int TaskQueue::Drain(const unsigned int a_budget)
+{
+	const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	unsigned int count = 0;
+
+	for (TaskNode *p_node = Pop(); p_node; p_node = Pop()) {
+		p_node->Run();
+		delete p_node;
+		count++;
+		m_pendingCount.fetch_sub(1, std::memory_order_release);
+
+		if (a_budget && std::chrono::steady_clock::now() - startTime >= std::chrono::microseconds(a_budget)) {
+			break;
+		}
+	}
+	m_runCount += count;
+
+	return count;
+}
+
+const bool TaskQueue::HasPendingTask()
+{
+	return 0 != m_pendingCount.load(std::memory_order_acquire);
+}
+
+const unsigned long long TaskQueue::GetRunCount()
+{
+	return m_runCount;
+}
+
+bool TaskQueue::Push(TaskNode *const ap_node)
+{
+	// the count is raised before the node is visible, so the consumer doesn't sleep with a pending task
+	const bool isEmpty = 0 == m_pendingCount.fetch_add(1, std::memory_order_acq_rel);
+	PushNode(ap_node);
+
+	return isEmpty;
+}
+
+TaskNode *TaskQueue::Pop()
+{
+	TaskNode *p_tail = mp_tail;
+	TaskNode *p_next = p_tail->mp_next.load(std::memory_order_acquire);
+
+	if (&m_stub == p_tail) {
+		if (nullptr == p_next) {
+			return nullptr;
+		}
+
+		mp_tail = p_next;
+		p_tail = p_next;
+		p_next = p_next->mp_next.load(std::memory_order_acquire);
+	}
+
+	if (p_next) {
+		mp_tail = p_next;
+		return p_tail;
+	}
+
+	if (p_tail != mp_head.load(std::memory_order_acquire)) {
+		return nullptr;
+	}
+
+	// the last node can only be taken with the stub behind it
+	PushNode(&m_stub);
+	p_next = p_tail->mp_next.load(std::memory_order_acquire);
+	if (p_next) {
+		mp_tail = p_next;
+		return p_tail;
+	}
+
+	return nullptr;
+}
+
+void TaskQueue::PushNode(TaskNode *const ap_node)
+{
+	ap_node->mp_next.store(nullptr, std::memory_order_relaxed);
+	TaskNode *const p_prevHead = mp_head.exchange(ap_node, std::memory_order_acq_rel);
+	p_prevHead->mp_next.store(ap_node, std::memory_order_release);
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "TaskScheduler.h"
+
+ResumeTask::ResumeTask(const std::coroutine_handle<> a_handle, const std::shared_ptr<ResumeContext> &ap_context) :
+	m_handle(a_handle),
+	mp_context(ap_context)
+{
+}
+
+ResumeTask::ResumeTask(ResumeTask &&a_task) :
+	m_handle(a_task.m_handle),
+	mp_context(std::move(a_task.mp_context))
+{
+	a_task.m_handle = nullptr;
+}
+
+ResumeTask::~ResumeTask()
+{
+	if (m_handle) {
+		m_handle.destroy();
+	}
+}
+
+void ResumeTask::operator()()
+{
+	const std::coroutine_handle<> handle = m_handle;
+	m_handle = nullptr;
+
+	if (mp_context && mp_context->IsClosed()) {
+		handle.destroy();
+		return;
+	}
+	handle.resume();
+}
+
+TaskScheduler::TaskScheduler(const unsigned int a_threadCount)
+{
+	m_isStopped = false;
+
+	unsigned int threadCount = a_threadCount;
+	if (0 == threadCount) {
+		const unsigned int processorCount = std::thread::hardware_concurrency();
+		threadCount = processorCount > 2 ? processorCount - 1 : 1;
+	}
+
+	for (unsigned int i = 0; i < threadCount; i++) {
+		m_threads.push_back(std::thread(&TaskScheduler::WorkerProcedure, this));
+	}
+}
+
+TaskScheduler::~TaskScheduler()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isStopped = true;
+	}
+	m_condition.notify_all();
+
+	for (std::thread &thread : m_threads) {
+		thread.join();
+	}
+
+	// the remaining tasks are released without running
+	for (TaskNode *p_node : m_tasks) {
+		delete p_node;
+	}
+}
+
+const unsigned int TaskScheduler::GetThreadCount()
+{
+	return static_cast<unsigned int>(m_threads.size());
+}
+
+void TaskScheduler::Push(TaskNode *const ap_node)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_tasks.push_back(ap_node);
+	}
+	m_condition.notify_one();
+}
+
+void TaskScheduler::WorkerProcedure()
+{
+	while (true) {
+		TaskNode *p_node = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return m_isStopped || !m_tasks.empty(); });
+			if (m_isStopped) {
+				return;
+			}
+
+			p_node = m_tasks.front();
+			m_tasks.pop_front();
+		}
+
+		p_node->Run();
+		delete p_node;
+	}
+}
+
+ResumeContext::ResumeContext(TaskQueue *const ap_queue, void (*ap_wake)(void *), void *const ap_wakeData) :
+	m_isClosed(false)
+{
+	mp_queue = ap_queue;
+	mp_wake = ap_wake;
+	mp_wakeData = ap_wakeData;
+}
+
+ResumeContext::~ResumeContext()
+{
+}
+
+void ResumeContext::Resume(const std::coroutine_handle<> a_handle)
+{
+	// the lock keeps `Close` from finishing while the queue is used
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_isClosed.load(std::memory_order_acquire)) {
+		a_handle.destroy();
+		return;
+	}
+
+	if (mp_queue->Post(ResumeTask(a_handle, shared_from_this())) && mp_wake) {
+		mp_wake(mp_wakeData);
+	}
+}
+
+void ResumeContext::Close()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_isClosed.store(true, std::memory_order_release);
+}
+
+const bool ResumeContext::IsClosed()
+{
+	return m_isClosed.load(std::memory_order_acquire);
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "TessellationCache.h"
+#include <cmath>
+
+namespace
+{
+	const int SCALE_BUCKETS_PER_OCTAVE = 4;
+	const int MAX_SCALE_BUCKET = 127;
+}
+
+TessellationCache::TessellationCache(const unsigned int a_capacity, const float a_tolerance)
+{
+	m_nextID = 1;
+	m_tolerance = a_tolerance > 0.01f ? a_tolerance : 0.01f;
+	m_capacity = a_capacity ? a_capacity : 1;
+
+	m_hitCount = 0;
+	m_missCount = 0;
+}
+
+TessellationCache::~TessellationCache()
+{
+}
+
+unsigned long long TessellationCache::AddPath(const VECTOR_PATH &a_path)
+{
+	const unsigned long long pathID = m_nextID++;
+	m_paths[pathID] = { a_path, GetPathBounds(a_path) };
+
+	return pathID;
+}
+
+void TessellationCache::RemovePath(const unsigned long long a_pathID)
+{
+	if (!m_paths.erase(a_pathID)) {
+		return;
+	}
+
+	for (auto entry = m_entries.begin(); entry != m_entries.end();) {
+		if (a_pathID == entry->pathID) {
+			RemoveEntry(entry++);
+		}
+		else {
+			entry++;
+		}
+	}
+}
+
+const VECTOR_PATH *const TessellationCache::GetPath(const unsigned long long a_pathID)
+{
+	const auto pathIterator = m_paths.find(a_pathID);
+
+	return m_paths.end() != pathIterator ? &pathIterator->second.path : nullptr;
+}
+
+const bool TessellationCache::GetBounds(const unsigned long long a_pathID, RRect &a_bounds)
+{
+	const auto pathIterator = m_paths.find(a_pathID);
+	if (m_paths.end() == pathIterator) {
+		return false;
+	}
+
+	a_bounds = pathIterator->second.bounds;
+	return true;
+}
+
+const PATH_TESSELLATION *const TessellationCache::Get(const unsigned long long a_pathID, const float a_scale, const bool a_needsTriangles)
+{
+	const auto pathIterator = m_paths.find(a_pathID);
+	if (m_paths.end() == pathIterator) {
+		return nullptr;
+	}
+
+	const int scaleBucket = GetScaleBucket(a_scale);
+	const auto tableEntry = m_entryTable.find(GetKey(a_pathID, scaleBucket));
+	if (m_entryTable.end() != tableEntry) {
+		m_hitCount++;
+		m_entries.splice(m_entries.begin(), m_entries, tableEntry->second);
+	}
+	else {
+		m_missCount++;
+		while (m_entries.size() >= m_capacity) {
+			RemoveEntry(std::prev(m_entries.end()));
+		}
+
+		PATH_TESSELLATION entry = {};
+		entry.pathID = a_pathID;
+		entry.scaleBucket = scaleBucket;
+		// the largest scale of the bucket needs the finest polyline
+		const float maxScale = std::exp2(static_cast<float>(scaleBucket * 2 + 1) / (SCALE_BUCKETS_PER_OCTAVE * 2));
+		entry.tolerance = m_tolerance / maxScale;
+		FlattenPath(pathIterator->second.path, entry.tolerance, entry.points, entry.contourSizes, entry.filledContourCount);
+		entry.filledPointCount = 0;
+		for (unsigned int i = 0; i < entry.filledContourCount; i++) {
+			entry.filledPointCount += entry.contourSizes[i];
+		}
+		entry.isTriangulated = false;
+
+		m_entries.push_front(std::move(entry));
+		m_entryTable.emplace(GetKey(a_pathID, scaleBucket), m_entries.begin());
+	}
+
+	PATH_TESSELLATION &entry = m_entries.front();
+	if (a_needsTriangles && !entry.isTriangulated) {
+		TessellatePolygon(entry.points.data(), entry.contourSizes.data(), entry.filledContourCount, entry.triangles);
+		entry.isTriangulated = true;
+	}
+
+	return &entry;
+}
+
+void TessellationCache::Clear()
+{
+	m_entries.clear();
+	m_entryTable.clear();
+}
+
+void TessellationCache::SetCapacity(const unsigned int a_capacity)
+{
+	m_capacity = a_capacity ? a_capacity : 1;
+	while (m_entries.size() > m_capacity) {
+		RemoveEntry(std::prev(m_entries.end()));
+	}
+}
+
+const unsigned int TessellationCache::GetCount()
+{
+	return static_cast<unsigned int>(m_entries.size());
+}
+
+const unsigned int TessellationCache::GetHitCount()
+{
+	return m_hitCount;
+}
+
+const unsigned int TessellationCache::GetMissCount()
+{
+	return m_missCount;
+}
+
+int TessellationCache::GetScaleBucket(const float a_scale)
+{
+	if (!(a_scale > 0.0f)) {
+		return 0;
+	}
+
+	const float bucket = std::round(std::log2(a_scale) * SCALE_BUCKETS_PER_OCTAVE);
+	return bucket < -MAX_SCALE_BUCKET ? -MAX_SCALE_BUCKET : (bucket > MAX_SCALE_BUCKET ? MAX_SCALE_BUCKET : static_cast<int>(bucket));
+}
+
+unsigned long long TessellationCache::GetKey(const unsigned long long a_pathID, const int a_scaleBucket)
+{
+	return a_pathID << 8 | static_cast<unsigned long long>(a_scaleBucket + MAX_SCALE_BUCKET + 1);
+}
+
+void TessellationCache::RemoveEntry(const std::list<PATH_TESSELLATION>::iterator &a_entry)
+{
+	m_entryTable.erase(GetKey(a_entry->pathID, a_entry->scaleBucket));
+	m_entries.erase(a_entry);
+}
\ No newline at end of file
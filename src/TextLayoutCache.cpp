@@ -0,0 +1,135 @@
+#include "TextLayoutCache.h"
+#include <cstring>
+
+namespace
+{
+	// FNV-1a
+	unsigned long long HashBytes(const void *const ap_data, const size_t a_size, unsigned long long a_hash)
+	{
+		const unsigned char *const p_bytes = static_cast<const unsigned char *>(ap_data);
+		for (size_t i = 0; i < a_size; i++) {
+			a_hash = (a_hash ^ p_bytes[i]) * 1099511628211ULL;
+		}
+		return a_hash;
+	}
+}
+
+TextLayoutCache::TextLayoutCache(TextMeasurer *const ap_measurer, const unsigned int a_capacity)
+{
+	mp_measurer = ap_measurer;
+	m_capacity = a_capacity ? a_capacity : 1;
+
+	m_hitCount = 0;
+	m_missCount = 0;
+}
+
+TextLayoutCache::~TextLayoutCache()
+{
+	Clear();
+}
+
+const TEXT_LAYOUT_ENTRY *const TextLayoutCache::Get(
+	const wchar_t *const ap_text, const unsigned int a_length, const DISPLAY_FONT &a_font,
+	const float a_maxWidth, const float a_maxHeight
+)
+{
+	const unsigned long long hash = GetHash(ap_text, a_length, a_font, a_maxWidth, a_maxHeight);
+
+	auto range = m_entryTable.equal_range(hash);
+	for (auto tableEntry = range.first; tableEntry != range.second; tableEntry++) {
+		const TEXT_LAYOUT_ENTRY &entry = *tableEntry->second;
+		if (entry.maxWidth == a_maxWidth && entry.maxHeight == a_maxHeight && entry.text.size() == a_length &&
+			0 == memcmp(entry.text.c_str(), ap_text, sizeof(wchar_t) * a_length) && entry.font == a_font) {
+			m_hitCount++;
+			// the entry becomes the most recently used one without moving its memory
+			m_entries.splice(m_entries.begin(), m_entries, tableEntry->second);
+
+			return &m_entries.front();
+		}
+	}
+	m_missCount++;
+
+	TEXT_METRICS metrics = { 0.0f, 0.0f };
+	void *const p_layout = mp_measurer->CreateLayout(ap_text, a_length, a_font, a_maxWidth, a_maxHeight, metrics);
+	if (!p_layout) {
+		return nullptr;
+	}
+
+	while (m_entries.size() >= m_capacity) {
+		RemoveLastEntry();
+	}
+
+	m_entries.push_front(TEXT_LAYOUT_ENTRY({
+		std::wstring(ap_text, a_length), a_font, a_maxWidth, a_maxHeight, metrics, p_layout
+	}));
+	m_entryTable.emplace(hash, m_entries.begin());
+
+	return &m_entries.front();
+}
+
+void TextLayoutCache::Clear()
+{
+	for (TEXT_LAYOUT_ENTRY &entry : m_entries) {
+		mp_measurer->ReleaseLayout(entry.p_layout);
+	}
+	m_entries.clear();
+	m_entryTable.clear();
+}
+
+void TextLayoutCache::SetCapacity(const unsigned int a_capacity)
+{
+	m_capacity = a_capacity ? a_capacity : 1;
+	while (m_entries.size() > m_capacity) {
+		RemoveLastEntry();
+	}
+}
+
+const unsigned int TextLayoutCache::GetCount()
+{
+	return static_cast<unsigned int>(m_entries.size());
+}
+
+const unsigned int TextLayoutCache::GetHitCount()
+{
+	return m_hitCount;
+}
+
+const unsigned int TextLayoutCache::GetMissCount()
+{
+	return m_missCount;
+}
+
+unsigned long long TextLayoutCache::GetHash(
+	const wchar_t *const ap_text, const unsigned int a_length, const DISPLAY_FONT &a_font,
+	const float a_maxWidth, const float a_maxHeight
+)
+{
+	unsigned long long hash = HashBytes(ap_text, sizeof(wchar_t) * a_length, 14695981039346656037ULL);
+	hash = HashBytes(a_font.name.c_str(), sizeof(wchar_t) * a_font.name.size(), hash);
+	hash = HashBytes(a_font.locale.c_str(), sizeof(wchar_t) * a_font.locale.size(), hash);
+
+	const float values[3] = { a_font.size, a_maxWidth, a_maxHeight };
+	const int styles[5] = { a_font.weight, a_font.style, a_font.textAlignment, a_font.paragraphAlignment, a_font.stretch };
+	hash = HashBytes(values, sizeof(values), hash);
+
+	return HashBytes(styles, sizeof(styles), hash);
+}
+
+void TextLayoutCache::RemoveLastEntry()
+{
+	TEXT_LAYOUT_ENTRY &entry = m_entries.back();
+	const unsigned long long hash = GetHash(
+		entry.text.c_str(), static_cast<unsigned int>(entry.text.size()), entry.font, entry.maxWidth, entry.maxHeight
+	);
+
+	auto range = m_entryTable.equal_range(hash);
+	for (auto tableEntry = range.first; tableEntry != range.second; tableEntry++) {
+		if (&*tableEntry->second == &entry) {
+			m_entryTable.erase(tableEntry);
+			break;
+		}
+	}
+
+	mp_measurer->ReleaseLayout(entry.p_layout);
+	m_entries.pop_back();
+}
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include "TileRenderer.h"
+#include "SoftwareRasterizer.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+
+namespace
+{
+	const int MIN_TILE_SIZE = 8;
+	// the flattened curves can lie slightly outside of the bounds of a command
+	const float BIN_MARGIN = 1.0f;
+
+	// the tiles which the workers and the calling thread take one after another
+	struct TILE_STATE
+	{
+		std::atomic<unsigned int> nextTile;
+		std::atomic<unsigned int> doneCount;
+		unsigned int tileCount;
+	};
+}
+
+TileRenderer::TileRenderer(const int a_tileSize)
+{
+	m_tileSize = a_tileSize > MIN_TILE_SIZE ? a_tileSize : MIN_TILE_SIZE;
+	m_columnCount = 0;
+	m_rowCount = 0;
+	m_binnedCount = 0;
+}
+
+TileRenderer::~TileRenderer()
+{
+}
+
+void TileRenderer::Render(
+	const DisplayList &a_list, unsigned int *const ap_pixels, const int a_width, const int a_height, const int a_stride,
+	TaskScheduler *const ap_scheduler
+)
+{
+	m_columnCount = a_width > 0 ? (a_width + m_tileSize - 1) / m_tileSize : 0;
+	m_rowCount = a_height > 0 ? (a_height + m_tileSize - 1) / m_tileSize : 0;
+	BinCommands(a_list);
+
+	const unsigned int tileCount = static_cast<unsigned int>(m_tileOrder.size());
+	if (0 == tileCount) {
+		return;
+	}
+
+	// every thread which takes part draws with its own rasterizer, the scratch buffers are shared by its tiles
+	auto drawTile = [this, &a_list](SoftwareRasterizer &a_rasterizer, const unsigned int a_tile) {
+		const std::vector<unsigned int> &commands = m_tileCommands[a_tile];
+		const int left = static_cast<int>(a_tile % m_columnCount) * m_tileSize;
+		const int top = static_cast<int>(a_tile / m_columnCount) * m_tileSize;
+		a_rasterizer.SetLimitRect(left, top, left + m_tileSize, top + m_tileSize);
+		a_list.Replay(&a_rasterizer, commands.data(), static_cast<unsigned int>(commands.size()));
+	};
+
+	const unsigned int threadCount = ap_scheduler ? ap_scheduler->GetThreadCount() : 0;
+	if (tileCount < 2 || 0 == threadCount) {
+		SoftwareRasterizer rasterizer(ap_pixels, a_width, a_height, a_stride);
+		for (const unsigned int tile : m_tileOrder) {
+			drawTile(rasterizer, tile);
+		}
+		return;
+	}
+
+	// a worker which starts after all tiles have been taken returns at once, so the state outlives this call
+	std::shared_ptr<TILE_STATE> p_state = std::make_shared<TILE_STATE>();
+	p_state->nextTile = 0;
+	p_state->doneCount = 0;
+	p_state->tileCount = tileCount;
+
+	// the tiles are taken one by one from a shared counter, so a thread which has drawn cheap tiles takes
+	// the remaining ones of the others. the bins aren't changed until every tile is done
+	auto drawTiles = [this, p_state, drawTile, ap_pixels, a_width, a_height, a_stride]() {
+		unsigned int index = p_state->nextTile++;
+		if (index >= p_state->tileCount) {
+			return;
+		}
+
+		SoftwareRasterizer rasterizer(ap_pixels, a_width, a_height, a_stride);
+		for (; index < p_state->tileCount; index = p_state->nextTile++) {
+			drawTile(rasterizer, m_tileOrder[index]);
+
+			p_state->doneCount++;
+			p_state->doneCount.notify_all();
+		}
+	};
+
+	const unsigned int helperCount = threadCount < tileCount - 1 ? threadCount : tileCount - 1;
+	for (unsigned int i = 0; i < helperCount; i++) {
+		auto helper = drawTiles;
+		ap_scheduler->Post(std::move(helper));
+	}
+	// the calling thread draws too, so it never waits for a tile which no thread has taken
+	drawTiles();
+
+	for (unsigned int doneCount = p_state->doneCount; doneCount < tileCount; doneCount = p_state->doneCount) {
+		p_state->doneCount.wait(doneCount);
+	}
+}
+
+const int TileRenderer::GetTileSize()
+{
+	return m_tileSize;
+}
+
+const unsigned int TileRenderer::GetTileCount()
+{
+	return static_cast<unsigned int>(m_tileOrder.size());
+}
+
+const unsigned int TileRenderer::GetBinnedCount()
+{
+	return m_binnedCount;
+}
+
+void TileRenderer::BinCommands(const DisplayList &a_list)
+{
+	const size_t tileCount = static_cast<size_t>(m_columnCount) * m_rowCount;
+	if (m_tileCommands.size() < tileCount) {
+		m_tileCommands.resize(tileCount);
+	}
+	for (size_t i = 0; i < tileCount; i++) {
+		m_tileCommands[i].clear();
+	}
+	m_clipRects.clear();
+	m_clipRanges.clear();
+	m_binnedCount = 0;
+
+	const TILE_RANGE allTiles = { 0, 0, m_columnCount, m_rowCount };
+	const DISPLAY_COMMAND *const p_commands = a_list.GetCommands();
+	const unsigned int commandCount = a_list.GetCommandCount();
+	for (unsigned int i = 0; i < commandCount; i++) {
+		const DISPLAY_COMMAND &command = p_commands[i];
+		const TILE_RANGE &clipRange = m_clipRanges.empty() ? allTiles : m_clipRanges.back();
+
+		switch (command.opcode) {
+		case DISPLAY_DRAW_TEXT:
+			// a backend has no text output
+			break;
+		case DISPLAY_CLEAR:
+			AddToTiles(i, clipRange);
+			break;
+		case DISPLAY_PUSH_CLIP:
+			// the tiles outside of a clip draw nothing until it is popped, so they don't need to push it
+			m_clipRects.push_back(TransformBounds(a_list.GetTransform(command), command.rect));
+			if (1 < m_clipRects.size()) {
+				m_clipRects.back() = IntersectBounds(m_clipRects.back(), m_clipRects[m_clipRects.size() - 2]);
+			}
+			m_clipRanges.push_back(GetTileRange(m_clipRects.back()));
+			AddToTiles(i, m_clipRanges.back());
+			break;
+		case DISPLAY_POP_CLIP:
+			if (!m_clipRanges.empty()) {
+				AddToTiles(i, m_clipRanges.back());
+				m_clipRects.pop_back();
+				m_clipRanges.pop_back();
+			}
+			break;
+		default:
+		{
+			const RRect bounds = a_list.GetBounds(command);
+			const TILE_RANGE range = GetTileRange(
+				{ bounds.left - BIN_MARGIN, bounds.top - BIN_MARGIN, bounds.right + BIN_MARGIN, bounds.bottom + BIN_MARGIN }
+			);
+			// the pixels are intersected rather than the bounds, because the clip of the rasterizer is rounded out too
+			AddToTiles(i, {
+				std::max(range.left, clipRange.left), std::max(range.top, clipRange.top),
+				std::min(range.right, clipRange.right), std::min(range.bottom, clipRange.bottom)
+			});
+			break;
+		}
+		}
+	}
+
+	// the expensive tiles are started first, so no thread is left with a long tile at the end
+	m_tileOrder.clear();
+	for (unsigned int i = 0; i < tileCount; i++) {
+		if (!m_tileCommands[i].empty()) {
+			m_tileOrder.push_back(i);
+		}
+	}
+	std::stable_sort(m_tileOrder.begin(), m_tileOrder.end(), [this](const unsigned int a_tile, const unsigned int a_otherTile) {
+		return m_tileCommands[a_tile].size() > m_tileCommands[a_otherTile].size();
+	});
+}
+
+const TileRenderer::TILE_RANGE TileRenderer::GetTileRange(const RRect &a_bounds)
+{
+	// an empty clip draws nothing. otherwise the partially covered pixels are included like the clip of the rasterizer does
+	if (!(a_bounds.left < a_bounds.right && a_bounds.top < a_bounds.bottom)) {
+		return { 0, 0, 0, 0 };
+	}
+
+	const float left = std::max(std::floor(a_bounds.left), 0.0f);
+	const float top = std::max(std::floor(a_bounds.top), 0.0f);
+	const float right = std::min(std::ceil(a_bounds.right), static_cast<float>(m_columnCount * m_tileSize));
+	const float bottom = std::min(std::ceil(a_bounds.bottom), static_cast<float>(m_rowCount * m_tileSize));
+	if (!(left < right && top < bottom)) {
+		return { 0, 0, 0, 0 };
+	}
+
+	return {
+		static_cast<int>(left) / m_tileSize, static_cast<int>(top) / m_tileSize,
+		(static_cast<int>(right) - 1) / m_tileSize + 1, (static_cast<int>(bottom) - 1) / m_tileSize + 1
+	};
+}
+
+void TileRenderer::AddToTiles(const unsigned int a_commandIndex, const TILE_RANGE &a_range)
+{
+	for (int row = a_range.top; row < a_range.bottom; row++) {
+		for (int column = a_range.left; column < a_range.right; column++) {
+			m_tileCommands[static_cast<size_t>(row) * m_columnCount + column].push_back(a_commandIndex);
+			m_binnedCount++;
+		}
+	}
+}
\ No newline at end of file
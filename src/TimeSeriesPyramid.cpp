@@ -0,0 +1,189 @@
+#include "TimeSeriesPyramid.h"
+#include <algorithm>
+#include <cmath>
+
+TimeSeriesPyramid::TimeSeriesPyramid()
+{
+	m_firstX = 0.0;
+	m_stepX = 1.0;
+}
+
+TimeSeriesPyramid::~TimeSeriesPyramid()
+{
+}
+
+void TimeSeriesPyramid::SetSamples(const double *const ap_xValues, const float *const ap_yValues, const unsigned int a_count)
+{
+	m_xValues.assign(ap_xValues, ap_xValues + a_count);
+	m_yValues.assign(ap_yValues, ap_yValues + a_count);
+	BuildLevels();
+}
+
+void TimeSeriesPyramid::SetUniformSamples(const double a_firstX, const double a_stepX, const float *const ap_yValues, const unsigned int a_count)
+{
+	m_xValues.clear();
+	m_firstX = a_firstX;
+	m_stepX = a_stepX;
+	m_yValues.assign(ap_yValues, ap_yValues + a_count);
+	BuildLevels();
+}
+
+const unsigned int TimeSeriesPyramid::GetCount()
+{
+	return static_cast<unsigned int>(m_yValues.size());
+}
+
+const double TimeSeriesPyramid::GetX(const unsigned int a_index)
+{
+	return m_xValues.empty() ? m_firstX + a_index * m_stepX : m_xValues[a_index];
+}
+
+const float TimeSeriesPyramid::GetY(const unsigned int a_index)
+{
+	return m_yValues[a_index];
+}
+
+const unsigned int TimeSeriesPyramid::FindIndex(const double a_x)
+{
+	const unsigned int count = GetCount();
+	if (!m_xValues.empty()) {
+		return static_cast<unsigned int>(std::lower_bound(m_xValues.begin(), m_xValues.end(), a_x) - m_xValues.begin());
+	}
+
+	if (a_x <= m_firstX) {
+		return 0;
+	}
+	const double index = std::ceil((a_x - m_firstX) / m_stepX);
+	return index < count ? static_cast<unsigned int>(index) : count;
+}
+
+void TimeSeriesPyramid::FindRange(unsigned int a_first, const unsigned int a_last, unsigned int &a_minIndex, unsigned int &a_maxIndex)
+{
+	a_minIndex = a_first;
+	a_maxIndex = a_first;
+	const size_t levelCount = m_minIndices.size();
+
+	while (a_first < a_last) {
+		// the largest block which starts at the first sample and ends within the range
+		size_t level = 0;
+		while (level < levelCount) {
+			const unsigned int blockSize = 2u << level;
+			if (0 != (a_first & (blockSize - 1)) || a_last - a_first < blockSize) {
+				break;
+			}
+			level++;
+		}
+
+		unsigned int minIndex = a_first;
+		unsigned int maxIndex = a_first;
+		if (level) {
+			const unsigned int block = a_first >> level;
+			minIndex = m_minIndices[level - 1][block];
+			maxIndex = m_maxIndices[level - 1][block];
+		}
+		a_first += 1u << level;
+
+		if (m_yValues[minIndex] < m_yValues[a_minIndex]) {
+			a_minIndex = minIndex;
+		}
+		if (m_yValues[maxIndex] > m_yValues[a_maxIndex]) {
+			a_maxIndex = maxIndex;
+		}
+	}
+}
+
+void TimeSeriesPyramid::Reduce(const TIME_SERIES_VIEW &a_view, std::vector<RPoint> &a_points)
+{
+	a_points.clear();
+
+	const unsigned int count = GetCount();
+	if (0 == count || 0 == a_view.columnCount || !(a_view.lastX > a_view.firstX)) {
+		return;
+	}
+
+	const unsigned int first = FindIndex(a_view.firstX);
+	const unsigned int last = FindIndex(a_view.lastX);
+	if (first) {
+		a_points.push_back(ToViewPoint(a_view, first - 1));
+	}
+
+	// a column of up to 4 samples keeps all of them anyway
+	if (last - first <= a_view.columnCount * 4) {
+		for (unsigned int i = first; i < last; i++) {
+			a_points.push_back(ToViewPoint(a_view, i));
+		}
+	}
+	else {
+		const double columnWidth = (a_view.lastX - a_view.firstX) / a_view.columnCount;
+		unsigned int columnFirst = first;
+		for (unsigned int column = 0; column < a_view.columnCount; column++) {
+			unsigned int columnLast = column + 1 == a_view.columnCount ? last : FindIndex(a_view.firstX + columnWidth * (column + 1));
+			if (columnLast <= columnFirst) {
+				continue;
+			}
+
+			unsigned int minIndex;
+			unsigned int maxIndex;
+			FindRange(columnFirst, columnLast, minIndex, maxIndex);
+
+			// the first, the minimum, the maximum and the last sample in the order of the samples
+			unsigned int indices[4] = { columnFirst, std::min(minIndex, maxIndex), std::max(minIndex, maxIndex), columnLast - 1 };
+			a_points.push_back(ToViewPoint(a_view, indices[0]));
+			for (unsigned int i = 1; i < 4; i++) {
+				if (indices[i] != indices[i - 1]) {
+					a_points.push_back(ToViewPoint(a_view, indices[i]));
+				}
+			}
+			columnFirst = columnLast;
+		}
+	}
+
+	if (last < count) {
+		a_points.push_back(ToViewPoint(a_view, last));
+	}
+}
+
+void TimeSeriesPyramid::BuildLevels()
+{
+	m_minIndices.clear();
+	m_maxIndices.clear();
+
+	// the first level compares pairs of samples, every other level pairs of blocks of the level below
+	const size_t count = m_yValues.size();
+	for (size_t blockSize = 2; blockSize <= count; blockSize *= 2) {
+		const size_t blockCount = count / blockSize;
+		std::vector<unsigned int> minIndices(blockCount);
+		std::vector<unsigned int> maxIndices(blockCount);
+
+		for (size_t i = 0; i < blockCount; i++) {
+			unsigned int firstMin = static_cast<unsigned int>(i * 2);
+			unsigned int secondMin = firstMin + 1;
+			unsigned int firstMax = firstMin;
+			unsigned int secondMax = secondMin;
+			if (!m_minIndices.empty()) {
+				firstMin = m_minIndices.back()[i * 2];
+				secondMin = m_minIndices.back()[i * 2 + 1];
+				firstMax = m_maxIndices.back()[i * 2];
+				secondMax = m_maxIndices.back()[i * 2 + 1];
+			}
+
+			minIndices[i] = m_yValues[secondMin] < m_yValues[firstMin] ? secondMin : firstMin;
+			maxIndices[i] = m_yValues[secondMax] > m_yValues[firstMax] ? secondMax : firstMax;
+		}
+
+		m_minIndices.push_back(std::move(minIndices));
+		m_maxIndices.push_back(std::move(maxIndices));
+	}
+}
+
+const RPoint TimeSeriesPyramid::ToViewPoint(const TIME_SERIES_VIEW &a_view, const unsigned int a_index)
+{
+	const RRect &rect = a_view.rect;
+	const double x = rect.left + (GetX(a_index) - a_view.firstX) * (rect.right - rect.left) / (a_view.lastX - a_view.firstX);
+	const float range = a_view.maxY - a_view.minY;
+	const float y = 0.0f == range ?
+		(rect.top + rect.bottom) * 0.5f :
+		rect.bottom - (m_yValues[a_index] - a_view.minY) * (rect.bottom - rect.top) / range;
+
+	return RPoint({ static_cast<float>(x), y });
+}
\ No newline at end of file
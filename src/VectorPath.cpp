@@ -0,0 +1,463 @@
+#include "VectorPath.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	const int MAX_CURVE_SEGMENTS = 256;
+
+	// a non-horizontal edge of a polygon from its top to its bottom
+	struct POLYGON_EDGE
+	{
+		double topX;
+		double topY;
+		double bottomX;
+		double bottomY;
+		int winding;			// +1 if the contour goes down along the edge, otherwise -1
+
+		double GetX(const double a_y) const
+		{
+			return topX + (bottomX - topX) * (a_y - topY) / (bottomY - topY);
+		}
+	};
+
+	// the closing edge of every contour is added even if the contour doesn't repeat its first point
+	void BuildEdges(
+		const RPoint *const ap_points, const unsigned int *const ap_contourSizes, const unsigned int a_contourCount,
+		std::vector<POLYGON_EDGE> &a_edges
+	)
+	{
+		const RPoint *p_point = ap_points;
+		for (unsigned int contour = 0; contour < a_contourCount; contour++) {
+			const unsigned int size = ap_contourSizes[contour];
+			for (unsigned int i = 0; i < size; i++) {
+				const RPoint &startPoint = p_point[i];
+				const RPoint &endPoint = p_point[i + 1 < size ? i + 1 : 0];
+				if (startPoint.y == endPoint.y) {
+					continue;
+				}
+
+				if (startPoint.y < endPoint.y) {
+					a_edges.push_back({ startPoint.x, startPoint.y, endPoint.x, endPoint.y, 1 });
+				}
+				else {
+					a_edges.push_back({ endPoint.x, endPoint.y, startPoint.x, startPoint.y, -1 });
+				}
+			}
+			p_point += size;
+		}
+
+		std::sort(a_edges.begin(), a_edges.end(), [](const POLYGON_EDGE &a_edge, const POLYGON_EDGE &a_otherEdge) {
+			return a_edge.topY < a_otherEdge.topY;
+		});
+	}
+
+	// the number of segments which keep a curve within the tolerance by the bound of its second derivative (Wang's formula)
+	int GetCurveSegmentCount(const float a_secondDifference, const float a_factor, const float a_tolerance)
+	{
+		const float count = std::ceil(std::sqrt(a_secondDifference * a_factor / a_tolerance));
+
+		return count < 1.0f ? 1 : (count > MAX_CURVE_SEGMENTS ? MAX_CURVE_SEGMENTS : static_cast<int>(count));
+	}
+
+	float GetLength(const float a_x, const float a_y)
+	{
+		return std::sqrt(a_x * a_x + a_y * a_y);
+	}
+
+	// the start point is copied because it can be the last point of the vector which grows
+	void AddQuadratic(const RPoint a_start, const RPoint *const ap_points, const float a_tolerance, std::vector<RPoint> &a_points)
+	{
+		const RPoint &control = ap_points[0];
+		const RPoint &end = ap_points[1];
+		const float difference = GetLength(a_start.x - 2.0f * control.x + end.x, a_start.y - 2.0f * control.y + end.y);
+		const int count = GetCurveSegmentCount(difference, 0.25f, a_tolerance);
+
+		for (int i = 1; i < count; i++) {
+			const float t = static_cast<float>(i) / count;
+			const float u = 1.0f - t;
+			a_points.push_back(RPoint({
+				u * u * a_start.x + 2.0f * u * t * control.x + t * t * end.x,
+				u * u * a_start.y + 2.0f * u * t * control.y + t * t * end.y
+			}));
+		}
+		a_points.push_back(end);
+	}
+
+	void AddBezier(const RPoint a_start, const RPoint *const ap_points, const float a_tolerance, std::vector<RPoint> &a_points)
+	{
+		const RPoint &control1 = ap_points[0];
+		const RPoint &control2 = ap_points[1];
+		const RPoint &end = ap_points[2];
+		const float difference = std::max(
+			GetLength(a_start.x - 2.0f * control1.x + control2.x, a_start.y - 2.0f * control1.y + control2.y),
+			GetLength(control1.x - 2.0f * control2.x + end.x, control1.y - 2.0f * control2.y + end.y)
+		);
+		const int count = GetCurveSegmentCount(difference, 0.75f, a_tolerance);
+
+		for (int i = 1; i < count; i++) {
+			const float t = static_cast<float>(i) / count;
+			const float u = 1.0f - t;
+			const float a = u * u * u;
+			const float b = 3.0f * u * u * t;
+			const float c = 3.0f * u * t * t;
+			const float d = t * t * t;
+			a_points.push_back(RPoint({
+				a * a_start.x + b * control1.x + c * control2.x + d * end.x,
+				a * a_start.y + b * control1.y + c * control2.y + d * end.y
+			}));
+		}
+		a_points.push_back(end);
+	}
+
+	void AddToBounds(RRect &a_bounds, const float a_x, const float a_y)
+	{
+		a_bounds.left = a_x < a_bounds.left ? a_x : a_bounds.left;
+		a_bounds.top = a_y < a_bounds.top ? a_y : a_bounds.top;
+		a_bounds.right = a_x > a_bounds.right ? a_x : a_bounds.right;
+		a_bounds.bottom = a_y > a_bounds.bottom ? a_y : a_bounds.bottom;
+	}
+
+	// the parameters in (0, 1) where the derivative `a * t^2 + b * t + c` of one coordinate is zero
+	int FindExtrema(const float a_a, const float a_b, const float a_c, float *const ap_parameters)
+	{
+		int count = 0;
+		auto AddParameter = [ap_parameters, &count](const float a_t) {
+			if (a_t > 0.0f && a_t < 1.0f) {
+				ap_parameters[count++] = a_t;
+			}
+		};
+
+		if (std::fabs(a_a) < 1e-12f) {
+			if (std::fabs(a_b) >= 1e-12f) {
+				AddParameter(-a_c / a_b);
+			}
+			return count;
+		}
+
+		const float discriminant = a_b * a_b - 4.0f * a_a * a_c;
+		if (discriminant >= 0.0f) {
+			const float root = std::sqrt(discriminant);
+			AddParameter((-a_b + root) / (2.0f * a_a));
+			AddParameter((-a_b - root) / (2.0f * a_a));
+		}
+		return count;
+	}
+
+	// adds the trapezoids between two rows where the order of the edges doesn't change
+	void AddTrapezoids(
+		const std::vector<const POLYGON_EDGE *> &a_edges, const double a_top, const double a_bottom, std::vector<RPoint> &a_triangles
+	)
+	{
+		int winding = 0;
+		const POLYGON_EDGE *p_leftEdge = nullptr;
+		for (const POLYGON_EDGE *const p_edge : a_edges) {
+			const int previousWinding = winding;
+			winding += p_edge->winding;
+			if (0 == previousWinding) {
+				p_leftEdge = p_edge;
+				continue;
+			}
+			if (0 != winding) {
+				continue;
+			}
+
+			const RPoint topLeft = { static_cast<float>(p_leftEdge->GetX(a_top)), static_cast<float>(a_top) };
+			const RPoint topRight = { static_cast<float>(p_edge->GetX(a_top)), static_cast<float>(a_top) };
+			const RPoint bottomLeft = { static_cast<float>(p_leftEdge->GetX(a_bottom)), static_cast<float>(a_bottom) };
+			const RPoint bottomRight = { static_cast<float>(p_edge->GetX(a_bottom)), static_cast<float>(a_bottom) };
+			// a trapezoid which ends in a point is a single triangle
+			if (topLeft.x < topRight.x) {
+				a_triangles.insert(a_triangles.end(), { topLeft, topRight, bottomRight });
+			}
+			if (bottomLeft.x < bottomRight.x) {
+				a_triangles.insert(a_triangles.end(), { topLeft, bottomRight, bottomLeft });
+			}
+		}
+	}
+}
+
+float GetMatrixScale(const RMatrix &a_matrix)
+{
+	// the square root of the larger eigenvalue of the linear part multiplied by its transpose
+	const float a = a_matrix._11 * a_matrix._11 + a_matrix._12 * a_matrix._12;
+	const float b = a_matrix._11 * a_matrix._21 + a_matrix._12 * a_matrix._22;
+	const float c = a_matrix._21 * a_matrix._21 + a_matrix._22 * a_matrix._22;
+	const float halfTrace = (a + c) * 0.5f;
+	const float halfDifference = (a - c) * 0.5f;
+
+	return std::sqrt(halfTrace + std::sqrt(halfDifference * halfDifference + b * b));
+}
+
+RRect GetPathBounds(const VECTOR_PATH &a_path)
+{
+	if (a_path.points.empty()) {
+		return RRect({ 0.0f, 0.0f, 0.0f, 0.0f });
+	}
+
+	RRect bounds = { a_path.points[0].x, a_path.points[0].y, a_path.points[0].x, a_path.points[0].y };
+	const RPoint *p_point = a_path.points.data();
+	RPoint lastPoint = *p_point;
+	for (const unsigned char command : a_path.commands) {
+		float parameters[4];
+		int count = 0;
+
+		switch (command) {
+		case PATH_BEGIN_FILLED:
+		case PATH_BEGIN_HOLLOW:
+		case PATH_LINE:
+			lastPoint = *p_point++;
+			AddToBounds(bounds, lastPoint.x, lastPoint.y);
+			break;
+		case PATH_QUADRATIC:
+			// the derivative is linear, so each coordinate has at most one extremum
+			count = FindExtrema(0.0f, 2.0f * (lastPoint.x - 2.0f * p_point[0].x + p_point[1].x), 2.0f * (p_point[0].x - lastPoint.x), parameters);
+			count += FindExtrema(0.0f, 2.0f * (lastPoint.y - 2.0f * p_point[0].y + p_point[1].y), 2.0f * (p_point[0].y - lastPoint.y), parameters + count);
+			for (int i = 0; i < count; i++) {
+				const float t = parameters[i];
+				const float u = 1.0f - t;
+				AddToBounds(
+					bounds,
+					u * u * lastPoint.x + 2.0f * u * t * p_point[0].x + t * t * p_point[1].x,
+					u * u * lastPoint.y + 2.0f * u * t * p_point[0].y + t * t * p_point[1].y
+				);
+			}
+			lastPoint = p_point[1];
+			AddToBounds(bounds, lastPoint.x, lastPoint.y);
+			p_point += 2;
+			break;
+		case PATH_BEZIER:
+			count = FindExtrema(
+				3.0f * (-lastPoint.x + 3.0f * p_point[0].x - 3.0f * p_point[1].x + p_point[2].x),
+				6.0f * (lastPoint.x - 2.0f * p_point[0].x + p_point[1].x), 3.0f * (p_point[0].x - lastPoint.x), parameters
+			);
+			count += FindExtrema(
+				3.0f * (-lastPoint.y + 3.0f * p_point[0].y - 3.0f * p_point[1].y + p_point[2].y),
+				6.0f * (lastPoint.y - 2.0f * p_point[0].y + p_point[1].y), 3.0f * (p_point[0].y - lastPoint.y), parameters + count
+			);
+			for (int i = 0; i < count; i++) {
+				const float t = parameters[i];
+				const float u = 1.0f - t;
+				AddToBounds(
+					bounds,
+					u * u * u * lastPoint.x + 3.0f * u * u * t * p_point[0].x + 3.0f * u * t * t * p_point[1].x + t * t * t * p_point[2].x,
+					u * u * u * lastPoint.y + 3.0f * u * u * t * p_point[0].y + 3.0f * u * t * t * p_point[1].y + t * t * t * p_point[2].y
+				);
+			}
+			lastPoint = p_point[2];
+			AddToBounds(bounds, lastPoint.x, lastPoint.y);
+			p_point += 3;
+			break;
+		}
+	}
+
+	return bounds;
+}
+
+void FlattenPath(
+	const VECTOR_PATH &a_path, const float a_tolerance,
+	std::vector<RPoint> &a_points, std::vector<unsigned int> &a_contourSizes, unsigned int &a_filledContourCount
+)
+{
+	a_points.clear();
+	a_contourSizes.clear();
+	a_filledContourCount = 0;
+
+	const float tolerance = a_tolerance > 1e-6f ? a_tolerance : 1e-6f;
+	// the hollow figures are moved behind the filled ones at the end
+	std::vector<RPoint> hollowPoints;
+	std::vector<unsigned int> hollowContourSizes;
+	std::vector<RPoint> *p_points = &a_points;
+	size_t figureStart = 0;
+	bool isInFigure = false;
+
+	auto EndFigure = [&](const bool a_isClosed) {
+		if (!isInFigure) {
+			return;
+		}
+		isInFigure = false;
+
+		if (a_isClosed) {
+			const RPoint startPoint = (*p_points)[figureStart];
+			p_points->push_back(startPoint);
+		}
+		const unsigned int size = static_cast<unsigned int>(p_points->size() - figureStart);
+		if (p_points == &a_points) {
+			a_contourSizes.push_back(size);
+			a_filledContourCount++;
+		}
+		else {
+			hollowContourSizes.push_back(size);
+		}
+	};
+
+	const RPoint *p_point = a_path.points.data();
+	for (const unsigned char command : a_path.commands) {
+		switch (command) {
+		case PATH_BEGIN_FILLED:
+		case PATH_BEGIN_HOLLOW:
+			EndFigure(false);
+			p_points = PATH_BEGIN_HOLLOW == command ? &hollowPoints : &a_points;
+			figureStart = p_points->size();
+			isInFigure = true;
+			p_points->push_back(*p_point++);
+			break;
+		case PATH_LINE:
+			p_points->push_back(*p_point++);
+			break;
+		case PATH_QUADRATIC:
+			AddQuadratic(p_points->back(), p_point, tolerance, *p_points);
+			p_point += 2;
+			break;
+		case PATH_BEZIER:
+			AddBezier(p_points->back(), p_point, tolerance, *p_points);
+			p_point += 3;
+			break;
+		case PATH_END_OPEN:
+		case PATH_END_CLOSED:
+			EndFigure(PATH_END_CLOSED == command);
+			break;
+		}
+	}
+	EndFigure(false);
+
+	a_points.insert(a_points.end(), hollowPoints.begin(), hollowPoints.end());
+	a_contourSizes.insert(a_contourSizes.end(), hollowContourSizes.begin(), hollowContourSizes.end());
+}
+
+void TessellatePolygon(
+	const RPoint *const ap_points, const unsigned int *const ap_contourSizes, const unsigned int a_contourCount,
+	std::vector<RPoint> &a_triangles
+)
+{
+	a_triangles.clear();
+
+	std::vector<POLYGON_EDGE> edges;
+	BuildEdges(ap_points, ap_contourSizes, a_contourCount, edges);
+	if (edges.empty()) {
+		return;
+	}
+
+	// the rows where an edge begins or ends
+	std::vector<double> rows;
+	for (const POLYGON_EDGE &edge : edges) {
+		rows.push_back(edge.topY);
+		rows.push_back(edge.bottomY);
+	}
+	std::sort(rows.begin(), rows.end());
+	rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+	std::vector<const POLYGON_EDGE *> activeEdges;
+	size_t nextEdge = 0;
+	for (size_t row = 0; row + 1 < rows.size(); row++) {
+		double top = rows[row];
+		const double bottom = rows[row + 1];
+
+		activeEdges.erase(
+			std::remove_if(activeEdges.begin(), activeEdges.end(), [top](const POLYGON_EDGE *const ap_edge) { return ap_edge->bottomY <= top; }),
+			activeEdges.end()
+		);
+		while (nextEdge < edges.size() && edges[nextEdge].topY <= top) {
+			activeEdges.push_back(&edges[nextEdge++]);
+		}
+
+		// the band is split where two edges cross, so the edges keep their order within each part.
+		// the order is taken in the middle of a part because edges which cross at its top or bottom have the same x there
+		while (top < bottom) {
+			double partBottom = bottom;
+			const double margin = (std::fabs(top) + 1.0) * 1e-9;
+			while (true) {
+				const double middle = top + (partBottom - top) * 0.5;
+				std::sort(activeEdges.begin(), activeEdges.end(), [middle](const POLYGON_EDGE *const ap_edge, const POLYGON_EDGE *const ap_otherEdge) {
+					return ap_edge->GetX(middle) < ap_otherEdge->GetX(middle);
+				});
+
+				// if no neighbours change their order toward the top or the bottom, no edges cross within the part
+				double crossing = partBottom;
+				for (size_t i = 0; i + 1 < activeEdges.size(); i++) {
+					const double middleDistance = activeEdges[i + 1]->GetX(middle) - activeEdges[i]->GetX(middle);
+					for (const double y : { top, partBottom }) {
+						const double distance = activeEdges[i + 1]->GetX(y) - activeEdges[i]->GetX(y);
+						if (distance < 0.0) {
+							const double crossingY = middle + (y - middle) * middleDistance / (middleDistance - distance);
+							crossing = crossingY > top + margin && crossingY < crossing ? crossingY : crossing;
+						}
+					}
+				}
+
+				if (crossing >= partBottom - margin) {
+					break;
+				}
+				partBottom = crossing;
+			}
+
+			AddTrapezoids(activeEdges, top, partBottom, a_triangles);
+			top = partBottom;
+		}
+	}
+}
+
+void TessellateSpans(
+	const RPoint *const ap_points, const unsigned int *const ap_contourSizes, const unsigned int a_contourCount,
+	const float a_rowHeight, std::vector<PATH_SPAN> &a_spans
+)
+{
+	a_spans.clear();
+
+	std::vector<POLYGON_EDGE> edges;
+	BuildEdges(ap_points, ap_contourSizes, a_contourCount, edges);
+	if (edges.empty() || !(a_rowHeight > 0.0f)) {
+		return;
+	}
+
+	double top = edges[0].topY;
+	double bottom = top;
+	for (const POLYGON_EDGE &edge : edges) {
+		bottom = std::max(bottom, edge.bottomY);
+	}
+
+	struct CROSSING
+	{
+		double x;
+		int winding;
+	};
+	std::vector<CROSSING> crossings;
+	std::vector<const POLYGON_EDGE *> activeEdges;
+	size_t nextEdge = 0;
+	// the first row center which isn't above the polygon
+	for (double row = std::ceil(top / a_rowHeight - 0.5); (row + 0.5) * a_rowHeight < bottom; row++) {
+		const double y = (row + 0.5) * a_rowHeight;
+
+		activeEdges.erase(
+			std::remove_if(activeEdges.begin(), activeEdges.end(), [y](const POLYGON_EDGE *const ap_edge) { return ap_edge->bottomY <= y; }),
+			activeEdges.end()
+		);
+		while (nextEdge < edges.size() && edges[nextEdge].topY <= y) {
+			if (edges[nextEdge].bottomY > y) {
+				activeEdges.push_back(&edges[nextEdge]);
+			}
+			nextEdge++;
+		}
+
+		crossings.clear();
+		for (const POLYGON_EDGE *const p_edge : activeEdges) {
+			crossings.push_back({ p_edge->GetX(y), p_edge->winding });
+		}
+		std::sort(crossings.begin(), crossings.end(), [](const CROSSING &a_crossing, const CROSSING &a_otherCrossing) {
+			return a_crossing.x < a_otherCrossing.x;
+		});
+
+		int winding = 0;
+		double left = 0.0;
+		for (const CROSSING &crossing : crossings) {
+			const int previousWinding = winding;
+			winding += crossing.winding;
+			if (0 == previousWinding) {
+				left = crossing.x;
+			}
+			else if (0 == winding && crossing.x > left) {
+				a_spans.push_back({ static_cast<float>(y), static_cast<float>(left), static_cast<float>(crossing.x) });
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -1,15 +1,49 @@
 #include "Resource.h"
 #include "WindowDialog.h"
+#include "StartupTimeline.h"
 #include <typeinfo>
 #include <dwmapi.h>
+#include <timeapi.h>
 
 #pragma comment (lib, "Dwmapi")
+#pragma comment (lib, "Winmm")
 
 #define MENU_DARK_MODE      20000
 #define MENU_LIGHT_MODE     20001
+#define RESIZE_TIMER_ID     20002
 
 extern ApplicationCore *gp_appCore;
 
+namespace
+{
+    // microseconds of the performance counter
+    unsigned long long GetTimestamp()
+    {
+        static LARGE_INTEGER frequency = {};
+        if (0 == frequency.QuadPart) {
+            ::QueryPerformanceFrequency(&frequency);
+        }
+
+        LARGE_INTEGER counter;
+        ::QueryPerformanceCounter(&counter);
+
+        return static_cast<unsigned long long>(counter.QuadPart / frequency.QuadPart * 1000000 +
+            counter.QuadPart % frequency.QuadPart * 1000000 / frequency.QuadPart);
+    }
+
+    // microseconds between two refreshes of the display, or 60Hz if the compositor doesn't tell it
+    unsigned long long GetDisplayInterval()
+    {
+        DWM_TIMING_INFO timingInfo = {};
+        timingInfo.cbSize = sizeof(DWM_TIMING_INFO);
+        if (S_OK == ::DwmGetCompositionTimingInfo(nullptr, &timingInfo) && timingInfo.rateRefresh.uiNumerator) {
+            return 1000000ull * timingInfo.rateRefresh.uiDenominator / timingInfo.rateRefresh.uiNumerator;
+        }
+
+        return 16667;
+    }
+}
+
 LRESULT CALLBACK WindowDialog::WindowProcedure(HWND ah_window, UINT a_messageID, WPARAM a_wordParam, LPARAM a_longParam)
 {
     if (a_messageID == WM_NCCREATE) {
@@ -29,9 +63,22 @@ LRESULT CALLBACK WindowDialog::WindowProcedure(HWND ah_window, UINT a_messageID,
     // recover the "this" pointer from where our WM_NCCREATE handler stashed it.
     WindowDialog *p_dialog = reinterpret_cast<WindowDialog *>(GetWindowLongPtr(ah_window, GWLP_USERDATA));
     if (p_dialog) {
+        // the render target follows the size of the window even if the size message is queued or handled by the developer
+        if (WM_SIZE == a_messageID || WM_ENTERSIZEMOVE == a_messageID || WM_EXITSIZEMOVE == a_messageID) {
+            p_dialog->TrackResize(a_messageID, a_wordParam, a_longParam);
+        }
+
         // find message handler of the message ID
         auto handler = p_dialog->GetMessageHandler(a_messageID);
         if (handler) {
+            if (p_dialog->m_isInputBatched) {
+                if (p_dialog->QueueInput(a_messageID, a_wordParam, a_longParam)) {
+                    return 0;
+                }
+                // the queued moves and wheels come first, so every other handler sees the input in order
+                // and reads the capture, the key states and the message position at its own time
+                p_dialog->DeliverInput();
+            }
             (p_dialog->*handler)(a_wordParam, a_longParam);
 
             return 1;
@@ -42,7 +89,8 @@ LRESULT CALLBACK WindowDialog::WindowProcedure(HWND ah_window, UINT a_messageID,
     return DefWindowProc(ah_window, a_messageID, a_wordParam, a_longParam);
 }
 
-WindowDialog::WindowDialog(const wchar_t *const ap_windowClass, const wchar_t *const ap_title)
+WindowDialog::WindowDialog(const wchar_t *const ap_windowClass, const wchar_t *const ap_title) :
+    m_frameLoop(this, this, this)
 {
     size_t length = wcslen(ap_windowClass) + 1;
     mp_windowClass = new wchar_t[length];
@@ -61,9 +109,9 @@ WindowDialog::WindowDialog(const wchar_t *const ap_windowClass, const wchar_t *c
     m_showType = SW_SHOWNORMAL;
 
     mh_window = nullptr;
-    m_messageMap[WM_DESTROY] = &WindowDialog::DestroyHandler;
-    m_messageMap[WM_PAINT] = &WindowDialog::PaintHandler;
-    m_messageMap[WM_SYSCOMMAND] = &WindowDialog::SysCommandHandler;
+    m_messageMap.Set(WM_DESTROY, &WindowDialog::DestroyHandler);
+    m_messageMap.Set(WM_PAINT, &WindowDialog::PaintHandler);
+    m_messageMap.Set(WM_SYSCOMMAND, &WindowDialog::SysCommandHandler);
 
     mp_direct2d = nullptr;
     m_themeMode = THEME_MODE::DARK_MODE;
@@ -71,16 +119,44 @@ WindowDialog::WindowDialog(const wchar_t *const ap_windowClass, const wchar_t *c
     m_height = 0;
     m_style = DS_SETFONT | DS_MODALFRAME | DS_FIXEDSYS | WS_POPUP | WS_VISIBLE | WS_CAPTION | WS_SYSMENU;
     m_extendStyle = 0;
+
+    m_isRetainedPaint = false;
+    m_prevFrameGeneration = 0;
+    m_isThreadedRendering = false;
+    m_renderSize = 0;
+
+    m_isInputBatched = false;
+    m_isPointerHistory = false;
+    m_isDeliveringInput = false;
+    m_inputBatch.rawCount = 0;
+    m_lastMoveTime = 0;
+
+    // an auto-reset event which wakes `Run` when a task is posted to the empty queue
+    mh_taskEvent = ::CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    m_taskBudget = 4000;
+    mp_resumeContext = std::make_shared<ResumeContext>(&m_taskQueue, &WindowDialog::WakeProcedure, mh_taskEvent);
+
+    m_frameRate = 0;
+    m_isTimerPeriodRaised = false;
+    m_exitCode = 0;
 }
 
 WindowDialog::~WindowDialog()
 {
+    StopRenderThread();
+
     delete[] mp_windowClass;
     delete[] mp_title;
 
     if (mp_direct2d) {
         delete mp_direct2d;
     }
+
+    // a coroutine on a worker thread can't post to the queue or signal the event anymore
+    mp_resumeContext->Close();
+    if (mh_taskEvent) {
+        ::CloseHandle(mh_taskEvent);
+    }
 }
 
 // window class registration
@@ -89,7 +165,8 @@ void WindowDialog::RegistWindowClass()
     WNDCLASSEXW wcex;
 
     wcex.cbSize = sizeof(WNDCLASSEX);
-    wcex.style = CS_HREDRAW | CS_VREDRAW;
+    // a resize invalidates only the uncovered area, `Direct2D` redraws the invalidated region
+    wcex.style = 0;
     wcex.lpfnWndProc = WindowProcedure;
     wcex.cbClsExtra = 0;
     wcex.cbWndExtra = 0;
@@ -107,15 +184,19 @@ void WindowDialog::RegistWindowClass()
 // Functions that handle messages issued to the application
 int WindowDialog::Run()
 {
-    MSG message;
-    while (GetMessage(&message, nullptr, 0, 0)) { // until occuring the WM_QUIT message
-        TranslateMessage(&message); // check whether additional messages are generated when keyboard messages occur
-        DispatchMessage(&message);  // handle the occured message
+    if (0 == m_frameRate) {
+        m_frameLoop.SetInterval(GetDisplayInterval());
+    }
+    // the loop blocks like `GetMessage` while no animation is active, and paces the frames otherwise
+    m_frameLoop.Run();
+
+    if (m_isTimerPeriodRaised) {
+        ::timeEndPeriod(1);
+        m_isTimerPeriodRaised = false;
     }
-    // when exiting the while statement, the WM_QUIT message is included in msg.
-    // therefore, the wParam value of the WM_QUIT message is returned. 
+    // the wParam value of the WM_QUIT message is returned. 
     // The wParam value is the argument value (0) used by the PostQuitMessage function.
-    return static_cast<int>(message.wParam);
+    return m_exitCode;
 }
 
 int WindowDialog::Create(int a_x, int a_y)
@@ -170,6 +251,87 @@ void WindowDialog::InheritDirect2D(Direct2DEx *const ap_direct2d)
     mp_direct2d = ap_direct2d;
 }
 
+void WindowDialog::EnableRetainedPaint(const bool a_isEnabled)
+{
+    m_isRetainedPaint = a_isEnabled;
+    m_frameList.Reset();
+    m_prevFrameList.Reset();
+    m_prevFrameGeneration = 0;
+}
+
+void WindowDialog::EnableThreadedRendering(const bool a_isEnabled, const bool a_isTripleBuffered)
+{
+    m_isThreadedRendering = a_isEnabled;
+    m_frameExchange.SetTripleBuffered(a_isTripleBuffered);
+}
+
+void WindowDialog::EnableInputBatching(const bool a_isEnabled, const bool a_isPointerHistory)
+{
+    if (!a_isEnabled) {
+        DeliverInput();
+    }
+
+    m_isInputBatched = a_isEnabled;
+    m_isPointerHistory = a_isPointerHistory;
+    m_lastMoveTime = 0;
+}
+
+void WindowDialog::SetTaskBudget(const unsigned int a_budget)
+{
+    m_taskBudget = a_budget;
+}
+
+WORKER_AWAITER WindowDialog::SwitchToWorker()
+{
+    return WORKER_AWAITER({ gp_appCore->GetTaskScheduler() });
+}
+
+CONTEXT_AWAITER WindowDialog::SwitchToWindow()
+{
+    return CONTEXT_AWAITER({ mp_resumeContext });
+}
+
+const bool WindowDialog::IsTaskCanceled()
+{
+    return mp_resumeContext->IsClosed();
+}
+
+void WindowDialog::SetFrameRate(const unsigned int a_frameRate)
+{
+    m_frameRate = a_frameRate;
+    m_frameLoop.SetInterval(a_frameRate ? 1000000 / a_frameRate : GetDisplayInterval());
+}
+
+void WindowDialog::SetFrameStep(const FRAME_STEP_MODE a_mode, const unsigned long long a_fixedStep)
+{
+    m_frameLoop.SetStepMode(a_mode, a_fixedStep);
+}
+
+void WindowDialog::BeginAnimation()
+{
+    m_frameLoop.BeginAnimation();
+}
+
+void WindowDialog::EndAnimation()
+{
+    m_frameLoop.EndAnimation();
+}
+
+const FRAME_STATISTICS &WindowDialog::GetFrameStatistics()
+{
+    return m_frameLoop.GetStatistics();
+}
+
+void WindowDialog::SetResizeInterval(const unsigned long long a_interval)
+{
+    m_resizeThrottle.SetInterval(a_interval);
+}
+
+const RESIZE_STATISTICS &WindowDialog::GetResizeStatistics()
+{
+    return m_resizeThrottle.GetStatistics();
+}
+
 const WindowDialog::THEME_MODE WindowDialog::GetThemeMode()
 {
     return m_themeMode;
@@ -208,22 +370,211 @@ void WindowDialog::DisableMaximize()
 // find the message handler for a given message ID.
 MessageHandler WindowDialog::GetMessageHandler(unsigned int a_messageID)
 {
-    auto messageEntry = m_messageMap.find(a_messageID);
-    if (messageEntry == m_messageMap.end()) {
-        return nullptr;
-    }
-
-    return messageEntry->second;
+    return m_messageMap.Get(a_messageID);
 }
 
 void WindowDialog::AddMessageHandler(unsigned int a_messageID, MessageHandler a_handler)
 {
-    m_messageMap[a_messageID] = a_handler;
+    m_messageMap.Set(a_messageID, a_handler);
 }
 
 void WindowDialog::RemoveMessageHandler(unsigned int a_messageID)
 {
-    m_messageMap.erase(a_messageID);
+    m_messageMap.Remove(a_messageID);
+}
+
+bool WindowDialog::QueueInput(const UINT a_messageID, const WPARAM a_wordParam, const LPARAM a_longParam)
+{
+    INPUT_EVENT event = {};
+    event.messageID = a_messageID;
+    event.wordParam = a_wordParam;
+    event.longParam = a_longParam;
+    event.time = GetTimestamp();
+    event.x = static_cast<float>(GET_X_LPARAM(a_longParam));
+    event.y = static_cast<float>(GET_Y_LPARAM(a_longParam));
+
+    switch (a_messageID) {
+    case WM_MOUSEMOVE:
+        event.type = INPUT_POINTER_MOVE;
+        event.modifiers = static_cast<unsigned int>(a_wordParam);
+        break;
+    case WM_MOUSEWHEEL:
+    case WM_MOUSEHWHEEL:
+        event.type = INPUT_WHEEL;
+        event.delta = GET_WHEEL_DELTA_WPARAM(a_wordParam);
+        event.modifiers = GET_KEYSTATE_WPARAM(a_wordParam);
+        break;
+    default:
+        // the buttons and the keys change the capture and the key states, so they are handled at once
+        return false;
+    }
+
+    if (INPUT_POINTER_MOVE != event.type || !m_isPointerHistory) {
+        m_inputQueue.Push(event);
+        return true;
+    }
+
+    // the points which the system has merged into this move, oldest first
+    POINT point = { GET_X_LPARAM(a_longParam), GET_Y_LPARAM(a_longParam) };
+    ::ClientToScreen(mh_window, &point);
+    MOUSEMOVEPOINT current = { static_cast<int>(point.x), static_cast<int>(point.y), static_cast<DWORD>(::GetMessageTime()), 0 };
+    MOUSEMOVEPOINT points[64];
+    const int count = ::GetMouseMovePointsEx(sizeof(MOUSEMOVEPOINT), &current, points, 64, GMMP_USE_DISPLAY_POINTS);
+
+    m_pointerHistory.clear();
+    for (int i = count - 1; i > 0 && m_lastMoveTime; i--) {
+        if (static_cast<int>(points[i].time - m_lastMoveTime) <= 0 || static_cast<int>(current.time - points[i].time) < 0) {
+            continue;
+        }
+
+        // the display points of a monitor left or above of the primary one are wrapped
+        POINT rawPoint = { points[i].x > 32767 ? points[i].x - 65536 : points[i].x, points[i].y > 32767 ? points[i].y - 65536 : points[i].y };
+        ::ScreenToClient(mh_window, &rawPoint);
+        m_pointerHistory.push_back(INPUT_POINT({
+            static_cast<float>(rawPoint.x), static_cast<float>(rawPoint.y),
+            event.time - static_cast<unsigned long long>(current.time - points[i].time) * 1000
+        }));
+    }
+    m_lastMoveTime = current.time;
+
+    m_inputQueue.Push(event, m_pointerHistory.data(), static_cast<unsigned int>(m_pointerHistory.size()));
+    return true;
+}
+
+void WindowDialog::DeliverInput()
+{
+    // a handler which runs a message loop doesn't deliver the batch again
+    if (m_isDeliveringInput || m_inputQueue.IsEmpty()) {
+        return;
+    }
+
+    m_isDeliveringInput = true;
+    m_inputQueue.TakeBatch(m_inputBatch);
+    OnInputBatch(m_inputBatch);
+    m_isDeliveringInput = false;
+}
+
+void WindowDialog::DrawFrame(Direct2DEx *const ap_direct2d, DisplayList &a_frameList, DisplayList &a_prevFrameList, unsigned int &a_prevGeneration)
+{
+    if (a_prevGeneration == ap_direct2d->GetDeviceGeneration()) {
+        // the render target still shows the same frame
+        if (a_frameList.IsEqual(a_prevFrameList)) {
+            // the update region belongs to the window thread, which has validated it already
+            if (ap_direct2d == mp_direct2d) {
+                ::ValidateRect(mh_window, nullptr);
+            }
+
+            return;
+        }
+
+        // only the area of the changed commands is drawn again
+        DirtyRegion region;
+        a_frameList.AddDifference(a_prevFrameList, region);
+        if (region.IsFull()) {
+            ap_direct2d->InvalidateAll();
+        }
+        else {
+            for (unsigned int i = 0; i < region.GetRectCount(); i++) {
+                ap_direct2d->Invalidate(ToDirect2DRect(region.GetRects()[i]));
+            }
+        }
+    }
+    else {
+        ap_direct2d->InvalidateAll();
+    }
+
+    ap_direct2d->BeginDraw();
+    ap_direct2d->DrawDisplayList(a_frameList);
+    ap_direct2d->EndDraw();
+
+    a_frameList.Swap(a_prevFrameList);
+    a_prevGeneration = ap_direct2d->GetDeviceGeneration();
+}
+
+void WindowDialog::RenderProcedure()
+{
+    // the render target and its resources are created and released on this thread only
+    ::CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    Direct2DEx *const p_direct2d = new Direct2DEx(mh_window);
+    // the window thread takes the update region of the window, this instance only draws the region of its frames
+    p_direct2d->SetWindowRegionOwner(false);
+
+    if (S_OK == p_direct2d->Create()) {
+        DisplayList prevFrameList;
+        unsigned int prevGeneration = 0;
+        unsigned long long renderSize = m_renderSize.load(std::memory_order_acquire);
+        // the front frame belongs to this thread until the next frame is taken, so it can be swapped
+        while (m_frameExchange.WaitFrame()) {
+            // the window thread has applied a new size since the last frame
+            const unsigned long long size = m_renderSize.load(std::memory_order_acquire);
+            if (size != renderSize) {
+                renderSize = size;
+                p_direct2d->Resize(static_cast<unsigned int>(size >> 32), static_cast<unsigned int>(size & 0xFFFFFFFF));
+            }
+            DrawFrame(p_direct2d, m_frameExchange.GetFrontFrame(), prevFrameList, prevGeneration);
+        }
+    }
+
+    delete p_direct2d;
+    ::CoUninitialize();
+}
+
+void WindowDialog::StopRenderThread()
+{
+    if (m_renderThread.joinable()) {
+        m_frameExchange.Close();
+        m_renderThread.join();
+    }
+}
+
+void WindowDialog::TrackResize(const UINT a_messageID, const WPARAM a_wordParam, const LPARAM a_longParam)
+{
+    const unsigned long long time = GetTimestamp();
+
+    switch (a_messageID) {
+    case WM_ENTERSIZEMOVE:
+        m_resizeThrottle.BeginLiveResize();
+        // the sizing loop of the system still dispatches the timer, so a waiting size is applied without a new WM_SIZE
+        ::SetTimer(
+            mh_window, RESIZE_TIMER_ID, static_cast<UINT>(m_resizeThrottle.GetInterval() / 1000),
+            &WindowDialog::ResizeTimerProcedure
+        );
+        break;
+    case WM_EXITSIZEMOVE:
+        ::KillTimer(mh_window, RESIZE_TIMER_ID);
+        if (m_resizeThrottle.EndLiveResize(time)) {
+            ApplySize();
+        }
+        break;
+    case WM_SIZE:
+        // a minimized window keeps its render target
+        if (SIZE_MINIMIZED != a_wordParam && m_resizeThrottle.Request(LOWORD(a_longParam), HIWORD(a_longParam), time)) {
+            ApplySize();
+        }
+        break;
+    }
+}
+
+void WindowDialog::ApplySize()
+{
+    const unsigned int width = m_resizeThrottle.GetWidth();
+    const unsigned int height = m_resizeThrottle.GetHeight();
+
+    if (m_renderThread.joinable()) {
+        m_renderSize.store(static_cast<unsigned long long>(width) << 32 | height, std::memory_order_release);
+    }
+    // the first WM_SIZE arrives before `Direct2D` is created, it takes the size of the window then
+    if (mp_direct2d) {
+        mp_direct2d->Resize(width, height);
+    }
+}
+
+void CALLBACK WindowDialog::ResizeTimerProcedure(HWND ah_window, UINT a_messageID, UINT_PTR a_timerID, DWORD a_time)
+{
+    WindowDialog *const p_dialog = reinterpret_cast<WindowDialog *>(GetWindowLongPtr(ah_window, GWLP_USERDATA));
+    if (p_dialog && p_dialog->m_resizeThrottle.Poll(GetTimestamp())) {
+        p_dialog->ApplySize();
+    }
 }
 
 // create and initialize a main window
@@ -257,12 +608,20 @@ bool WindowDialog::InitInstance(int a_width, int a_height, int a_x, int a_y)
 
         if (S_OK == SetThemeMode(m_themeMode)) {
             mp_direct2d = new Direct2DEx(mh_window);
+            // the render thread owns the only render target of the window, this instance records the frames
+            const bool isThreaded = m_isThreadedRendering && gp_appCore->IsMultiThreaded();
+            mp_direct2d->SetRecorder(isThreaded);
 
             if (S_OK == mp_direct2d->Create()) {
+                if (isThreaded) {
+                    m_renderThread = std::thread(&WindowDialog::RenderProcedure, this);
+                }
                 OnInitDialog();
 
                 ::ShowWindow(h_window, m_showType);
                 ::UpdateWindow(h_window);
+                // `UpdateWindow` has painted the window, so the startup of the application ends with its first window
+                gp_appCore->GetStartupTimeline()->Finish(L"first paint");
 
                 return true;
             }
@@ -277,6 +636,10 @@ bool WindowDialog::InitInstance(int a_width, int a_height, int a_x, int a_y)
 // to handle the WM_DESTROY message that occurs when a window is destroyed
 msg_handler int WindowDialog::DestroyHandler(WPARAM a_wordParam, LPARAM a_longParam)
 {
+    // the pending coroutines of the window are destroyed instead of resumed from now on
+    mp_resumeContext->Close();
+    // the render target is released while the window still exists
+    StopRenderThread();
     OnDestroy();
     PostQuitMessage(0);
 
@@ -286,6 +649,31 @@ msg_handler int WindowDialog::DestroyHandler(WPARAM a_wordParam, LPARAM a_longPa
 // to handle the WM_PAINT message that occurs when a window is created
 msg_handler int WindowDialog::PaintHandler(WPARAM a_wordParam, LPARAM a_longParam)
 {
+    if (m_renderThread.joinable()) {
+        // the back frame still holds an older frame, its memory is reused
+        DisplayList &frameList = m_frameExchange.GetBackFrame();
+        frameList.Reset();
+        mp_direct2d->BeginRecord(&frameList);
+        OnPaint();
+        mp_direct2d->EndRecord();
+
+        ::ValidateRect(mh_window, nullptr);
+        m_frameExchange.Publish();
+
+        return S_OK;
+    }
+
+    if (m_isRetainedPaint) {
+        m_frameList.Reset();
+        mp_direct2d->BeginRecord(&m_frameList);
+        OnPaint();
+        mp_direct2d->EndRecord();
+
+        DrawFrame(mp_direct2d, m_frameList, m_prevFrameList, m_prevFrameGeneration);
+
+        return S_OK;
+    }
+
     mp_direct2d->BeginDraw();
     OnPaint();
     mp_direct2d->EndDraw();
@@ -341,4 +729,103 @@ void WindowDialog::OnPaint()
 void WindowDialog::OnSetThemeMode()
 {
 
+}
+
+void WindowDialog::OnInputBatch(const INPUT_BATCH &a_batch)
+{
+    for (const INPUT_EVENT &event : a_batch.events) {
+        WPARAM wordParam = static_cast<WPARAM>(event.wordParam);
+        if (INPUT_WHEEL == event.type) {
+            // the summed up delta of the coalesced wheel messages
+            const int delta = event.delta > 32767 ? 32767 : (event.delta < -32768 ? -32768 : event.delta);
+            wordParam = MAKEWPARAM(event.modifiers, delta);
+        }
+
+        // a handler which has been removed after the event was queued leaves it to the system, like `WindowProcedure`
+        MessageHandler handler = m_messageMap.Get(event.messageID);
+        if (handler) {
+            (this->*handler)(wordParam, static_cast<LPARAM>(event.longParam));
+        }
+        else if (mh_window) {
+            ::DefWindowProc(mh_window, event.messageID, wordParam, static_cast<LPARAM>(event.longParam));
+        }
+    }
+}
+
+void WindowDialog::OnFrameUpdate(const double a_step)
+{
+
+}
+
+void WindowDialog::OnFrameRender(const double a_alpha)
+{
+    if (!mh_window) {
+        return;
+    }
+
+    // a recorded frame is compared with the previous one, so only the changed commands are drawn without invalidating the window
+    if (m_isRetainedPaint || m_renderThread.joinable()) {
+        PaintHandler(0, 0);
+        return;
+    }
+
+    // the area which the animation has invalidated through `Direct2D::Invalidate` is painted, the whole window only if it hasn't
+    if (!::GetUpdateRect(mh_window, nullptr, FALSE)) {
+        ::InvalidateRect(mh_window, nullptr, FALSE);
+    }
+    ::UpdateWindow(mh_window);
+}
+
+const unsigned long long WindowDialog::GetTime()
+{
+    return GetTimestamp();
+}
+
+bool WindowDialog::PumpMessages()
+{
+    MSG message;
+    while (PeekMessage(&message, nullptr, 0, 0, PM_REMOVE)) {
+        if (WM_QUIT == message.message) { // until occuring the WM_QUIT message
+            m_exitCode = static_cast<int>(message.wParam);
+            return false;
+        }
+
+        TranslateMessage(&message); // check whether additional messages are generated when keyboard messages occur
+        DispatchMessage(&message);  // handle the occured message
+    }
+
+    // the message queue is drained, so the queued input of this frame is delivered
+    DeliverInput();
+    // the posted tasks run within a budget, so the messages of the next frame aren't delayed
+    m_taskQueue.Drain(m_taskBudget);
+
+    return true;
+}
+
+void WindowDialog::WaitMessage(const unsigned long long a_timeout, const bool a_isInfinite)
+{
+    if (m_taskQueue.HasPendingTask()) {
+        return;
+    }
+
+    // the default timer period of about 15ms is too coarse to pace the frames, so it's raised only while they are paced
+    if (a_isInfinite && m_isTimerPeriodRaised) {
+        ::timeEndPeriod(1);
+        m_isTimerPeriodRaised = false;
+    }
+    else if (!a_isInfinite && !m_isTimerPeriodRaised) {
+        ::timeBeginPeriod(1);
+        m_isTimerPeriodRaised = true;
+    }
+
+    // sleep until a message arrives, a task is posted to the empty queue or the next frame is due.
+    // the last partial millisecond is waited by polling
+    const DWORD timeout = a_isInfinite ? INFINITE : static_cast<DWORD>(a_timeout / 1000);
+    ::MsgWaitForMultipleObjectsEx(1, &mh_taskEvent, timeout, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+}
+
+void WindowDialog::WakeProcedure(void *ap_event)
+{
+    // called by `ResumeContext` when a coroutine is posted to the empty queue
+    ::SetEvent(static_cast<HANDLE>(ap_event));
 }
\ No newline at end of file
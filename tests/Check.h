@@ -0,0 +1,28 @@
+#ifndef _CHECK_H_
+#define _CHECK_H_
+
+#include <cstdio>
+
+// the number of failed checks of the test program
+inline unsigned int g_failedCount = 0;
+
+// prints a failed condition with its location. the test goes on, so a run reports every failure
+#define CHECK(a_condition) \
+	do { \
+		if (!(a_condition)) { \
+			printf("%s(%d): check failed: %s\n", __FILE__, __LINE__, #a_condition); \
+			g_failedCount++; \
+		} \
+	} while (false)
+
+// the exit code of the test program
+inline int GetCheckResult()
+{
+	if (g_failedCount) {
+		printf("%u checks failed\n", g_failedCount);
+		return 1;
+	}
+	return 0;
+}
+
+#endif //_CHECK_H_
\ No newline at end of file
@@ -0,0 +1,217 @@
+#include "Check.h"
+#include "DirtyRegion.h"
+#include <random>
+#include <vector>
+
+namespace
+{
+	bool IsSameRect(const RRect &a_rect, const RRect &a_otherRect)
+	{
+		return a_rect.left == a_otherRect.left && a_rect.top == a_otherRect.top &&
+			a_rect.right == a_otherRect.right && a_rect.bottom == a_otherRect.bottom;
+	}
+
+	bool HasRect(const DirtyRegion &a_region, const RRect &a_rect)
+	{
+		for (unsigned int i = 0; i < a_region.GetRectCount(); i++) {
+			if (IsSameRect(a_region.GetRects()[i], a_rect)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// overlapping and adjoining rectangles are merged into their union, contained ones are dropped, and the others
+	// are kept apart. the rectangles are expanded to whole pixels
+	void TestMerging()
+	{
+		DirtyRegion region;
+		CHECK(region.IsEmpty());
+		region.Add({ 10.2f, 10.7f, 19.5f, 20.0f });
+		CHECK(1 == region.GetRectCount() && HasRect(region, { 10.0f, 10.0f, 20.0f, 20.0f }));
+		// the corners can be swapped, and an empty rectangle is ignored
+		region.Add({ 60.0f, 20.0f, 50.0f, 10.0f });
+		region.Add({ 30.0f, 30.0f, 30.0f, 40.0f });
+		CHECK(2 == region.GetRectCount() && HasRect(region, { 50.0f, 10.0f, 60.0f, 20.0f }));
+
+		region.Add({ 12.0f, 12.0f, 18.0f, 18.0f });
+		CHECK(2 == region.GetRectCount() && HasRect(region, { 10.0f, 10.0f, 20.0f, 20.0f }));
+		region.Add({ 15.0f, 15.0f, 25.0f, 25.0f });
+		CHECK(2 == region.GetRectCount() && HasRect(region, { 10.0f, 10.0f, 25.0f, 25.0f }));
+		// a neighbour which shares a whole side is merged, one which only touches a corner isn't
+		region.Add({ 60.0f, 10.0f, 70.0f, 20.0f });
+		CHECK(2 == region.GetRectCount() && HasRect(region, { 50.0f, 10.0f, 70.0f, 20.0f }));
+		region.Add({ 70.0f, 20.0f, 80.0f, 30.0f });
+		region.Add({ 60.0f, 22.0f, 66.0f, 28.0f });
+		CHECK(4 == region.GetRectCount());
+
+		// a rectangle which overlaps two of them merges them, and their union merges the one which it overlaps
+		region.Add({ 20.0f, 15.0f, 55.0f, 18.0f });
+		CHECK(2 == region.GetRectCount());
+		CHECK(HasRect(region, { 10.0f, 10.0f, 70.0f, 28.0f }) && HasRect(region, { 70.0f, 20.0f, 80.0f, 30.0f }));
+		CHECK(IsSameRect(region.GetExtent(), { 10.0f, 10.0f, 80.0f, 30.0f }));
+		CHECK(1180.0f == region.GetArea());
+		CHECK(region.Intersects({ 79.5f, 29.5f, 90.0f, 40.0f }));
+		CHECK(!region.Intersects({ 80.0f, 0.0f, 90.0f, 40.0f }));
+
+		region.Reset();
+		CHECK(region.IsEmpty() && 0 == region.GetRectCount());
+	}
+
+	// above the limit the pair with the least wasted area is merged
+	void TestReduce()
+	{
+		DirtyRegion region(3);
+		region.Add({ 0.0f, 0.0f, 10.0f, 10.0f });
+		region.Add({ 100.0f, 0.0f, 110.0f, 10.0f });
+		region.Add({ 0.0f, 100.0f, 10.0f, 110.0f });
+		CHECK(3 == region.GetRectCount());
+		region.Add({ 112.0f, 0.0f, 120.0f, 10.0f });
+		CHECK(3 == region.GetRectCount());
+		CHECK(HasRect(region, { 100.0f, 0.0f, 120.0f, 10.0f }));
+		CHECK(HasRect(region, { 0.0f, 0.0f, 10.0f, 10.0f }));
+		CHECK(HasRect(region, { 0.0f, 100.0f, 10.0f, 110.0f }));
+
+		// the merged union can overlap another rectangle, which is merged too
+		DirtyRegion chainRegion(2);
+		chainRegion.Add({ 0.0f, 0.0f, 10.0f, 10.0f });
+		chainRegion.Add({ 10.0f, 10.0f, 12.0f, 12.0f });
+		chainRegion.Add({ 11.0f, 0.0f, 30.0f, 1.0f });
+		CHECK(1 == chainRegion.GetRectCount());
+		CHECK(HasRect(chainRegion, { 0.0f, 0.0f, 30.0f, 12.0f }));
+	}
+
+	// a region which is merged into a rectangle that covers the bounds becomes full
+	void TestFullFallback()
+	{
+		DirtyRegion region(1);
+		region.SetBounds({ 0.0f, 0.0f, 100.0f, 100.0f });
+		region.Add({ 0.0f, 0.0f, 10.0f, 10.0f });
+		CHECK(!region.IsFull());
+		region.Add({ 95.0f, 40.0f, 100.0f, 60.0f });
+		CHECK(!region.IsFull());
+		CHECK(HasRect(region, { 0.0f, 0.0f, 100.0f, 60.0f }));
+		region.Add({ 50.0f, 90.0f, 60.0f, 100.0f });
+		CHECK(region.IsFull());
+		CHECK(1 == region.GetRectCount() && HasRect(region, region.GetBounds()));
+
+		// a larger limit keeps the rectangles apart until a single one covers the bounds
+		DirtyRegion largeRegion(4);
+		largeRegion.SetBounds({ 0.0f, 0.0f, 100.0f, 100.0f });
+		largeRegion.Add({ 0.0f, 0.0f, 10.0f, 10.0f });
+		largeRegion.Add({ 90.0f, 90.0f, 100.0f, 100.0f });
+		CHECK(!largeRegion.IsFull() && 2 == largeRegion.GetRectCount());
+		largeRegion.Add({ -10.0f, -10.0f, 110.0f, 110.0f });
+		CHECK(largeRegion.IsFull());
+	}
+
+	// a full region has the bounds as its only rectangle, ignores the next rectangles and intersects everything
+	void TestAddAll()
+	{
+		DirtyRegion region;
+		region.SetBounds({ 0.0f, 0.0f, 200.0f, 100.0f });
+		region.Add({ 10.0f, 10.0f, 20.0f, 20.0f });
+		region.AddAll();
+		CHECK(region.IsFull() && !region.IsEmpty());
+		CHECK(1 == region.GetRectCount() && HasRect(region, { 0.0f, 0.0f, 200.0f, 100.0f }));
+		region.Add({ 300.0f, 300.0f, 400.0f, 400.0f });
+		CHECK(1 == region.GetRectCount());
+		CHECK(region.Intersects({ 500.0f, 500.0f, 600.0f, 600.0f }));
+		CHECK(20000.0f == region.GetArea());
+
+		// the full rectangle follows the bounds
+		region.SetBounds({ 0.0f, 0.0f, 300.0f, 150.0f });
+		CHECK(HasRect(region, { 0.0f, 0.0f, 300.0f, 150.0f }));
+
+		DirtyRegion otherRegion;
+		otherRegion.SetBounds({ 0.0f, 0.0f, 300.0f, 150.0f });
+		otherRegion.Add({ 10.0f, 10.0f, 20.0f, 20.0f });
+		otherRegion.Add(region);
+		CHECK(otherRegion.IsFull());
+
+		region.Reset();
+		CHECK(region.IsEmpty() && !region.IsFull());
+		region.Add({ 10.0f, 10.0f, 20.0f, 20.0f });
+		CHECK(1 == region.GetRectCount() && HasRect(region, { 10.0f, 10.0f, 20.0f, 20.0f }));
+	}
+
+	// the rectangles are clipped to the bounds. a region without bounds doesn't clip
+	void TestClamping()
+	{
+		DirtyRegion region;
+		region.SetBounds({ 0.0f, 0.0f, 100.0f, 80.0f });
+		region.Add({ -20.0f, -5.5f, 10.0f, 10.0f });
+		region.Add({ 90.0f, 70.0f, 130.0f, 95.0f });
+		region.Add({ 100.0f, 10.0f, 120.0f, 20.0f });
+		region.Add({ -30.0f, 30.0f, -1.0f, 40.0f });
+		CHECK(2 == region.GetRectCount());
+		CHECK(HasRect(region, { 0.0f, 0.0f, 10.0f, 10.0f }));
+		CHECK(HasRect(region, { 90.0f, 70.0f, 100.0f, 80.0f }));
+		CHECK(!region.IsFull());
+
+		DirtyRegion unboundedRegion;
+		unboundedRegion.Add({ -20.0f, -5.5f, 10.0f, 10.0f });
+		CHECK(HasRect(unboundedRegion, { -20.0f, -6.0f, 10.0f, 10.0f }));
+		CHECK(!unboundedRegion.IsFull());
+	}
+
+	// random rectangles stay covered by the region, which keeps its limit and never overlaps itself
+	void TestCoverage()
+	{
+		const int VIEW_SIZE = 64;
+		std::mt19937 random(3);
+		std::uniform_real_distribution<float> position(-8.0f, VIEW_SIZE + 8.0f);
+		std::uniform_real_distribution<float> size(0.0f, 16.0f);
+		bool isCovered = true;
+		bool isDisjoint = true;
+		bool isLimited = true;
+
+		for (unsigned int round = 0; round < 200; round++) {
+			DirtyRegion region(6);
+			region.SetBounds({ 0.0f, 0.0f, static_cast<float>(VIEW_SIZE), static_cast<float>(VIEW_SIZE) });
+			std::vector<bool> dirtyPixels(VIEW_SIZE * VIEW_SIZE, false);
+			for (unsigned int i = 0; i < 12; i++) {
+				const float left = position(random);
+				const float top = position(random);
+				const RRect rect = { left, top, left + size(random), top + size(random) };
+				region.Add(rect);
+				for (int y = 0; y < VIEW_SIZE; y++) {
+					for (int x = 0; x < VIEW_SIZE; x++) {
+						if (x + 1 > rect.left && x < rect.right && y + 1 > rect.top && y < rect.bottom) {
+							dirtyPixels[y * VIEW_SIZE + x] = true;
+						}
+					}
+				}
+			}
+
+			isLimited = isLimited && region.GetRectCount() <= 6;
+			const RRect *const p_rects = region.GetRects();
+			for (unsigned int i = 0; i < region.GetRectCount(); i++) {
+				for (unsigned int j = i + 1; j < region.GetRectCount(); j++) {
+					isDisjoint = isDisjoint && !(p_rects[i].left < p_rects[j].right && p_rects[j].left < p_rects[i].right &&
+						p_rects[i].top < p_rects[j].bottom && p_rects[j].top < p_rects[i].bottom);
+				}
+			}
+			for (int y = 0; y < VIEW_SIZE; y++) {
+				for (int x = 0; x < VIEW_SIZE; x++) {
+					const RRect pixel = { x + 0.25f, y + 0.25f, x + 0.75f, y + 0.75f };
+					isCovered = isCovered && (!dirtyPixels[y * VIEW_SIZE + x] || region.Intersects(pixel));
+				}
+			}
+		}
+		CHECK(isCovered);
+		CHECK(isDisjoint);
+		CHECK(isLimited);
+	}
+}
+
+int main()
+{
+	TestMerging();
+	TestReduce();
+	TestFullFallback();
+	TestAddAll();
+	TestClamping();
+	TestCoverage();
+	return GetCheckResult();
+}
\ No newline at end of file
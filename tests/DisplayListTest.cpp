@@ -0,0 +1,287 @@
+#include "Check.h"
+#include "DisplayList.h"
+#include "SoftwareRasterizer.h"
+#include <string>
+#include <vector>
+
+namespace
+{
+	const int VIEW_WIDTH = 128;
+	const int VIEW_HEIGHT = 128;
+	const RColor BLACK = { 0.0f, 0.0f, 0.0f, 1.0f };
+	const RColor WHITE = { 1.0f, 1.0f, 1.0f, 1.0f };
+	const RColor RED = { 1.0f, 0.0f, 0.0f, 1.0f };
+	const RColor GREEN = { 0.0f, 1.0f, 0.0f, 1.0f };
+	const RColor BLUE = { 0.0f, 0.0f, 1.0f, 1.0f };
+
+	// the parts of a frame which the tests change between two recordings
+	struct SCENE
+	{
+		RColor clearColor;
+		RRect strokeRect;
+		RColor ellipseColor;
+		RMatrix ellipseTransform;
+		float triangleRight;
+		std::wstring text;
+		float textSize;
+		unsigned long long imageID;
+		float fillRadius;
+		bool hasExtraRect;
+	};
+
+	SCENE MakeScene()
+	{
+		SCENE scene;
+		scene.clearColor = BLACK;
+		scene.strokeRect = { 100.0f, 100.0f, 120.0f, 120.0f };
+		scene.ellipseColor = RED;
+		scene.ellipseTransform = IdentityMatrix();
+		scene.ellipseTransform._31 = 50.0f;
+		scene.ellipseTransform._32 = 10.0f;
+		scene.triangleRight = 180.0f;
+		scene.text = L"chart";
+		scene.textSize = 12.0f;
+		scene.imageID = 0;
+		scene.fillRadius = 0.0f;
+		scene.hasExtraRect = false;
+		return scene;
+	}
+
+	// the commands of the frame in their order
+	enum SCENE_COMMAND : unsigned int
+	{
+		SCENE_CLEAR = 0,
+		SCENE_FILL,
+		SCENE_STROKE,
+		SCENE_ELLIPSE,
+		SCENE_TRIANGLE,
+		SCENE_TEXT,
+		SCENE_BITMAP,
+		SCENE_COMMAND_COUNT
+	};
+
+	void Record(DisplayList &a_list, const SCENE &a_scene)
+	{
+		a_list.Reset();
+		a_list.AddClear(a_scene.clearColor);
+		a_list.AddShape(DISPLAY_FILL_ROUNDED_RECTANGLE, { 10.0f, 150.0f, 40.0f, 180.0f }, a_scene.fillRadius, WHITE, 1.0f, IdentityMatrix());
+		a_list.AddShape(DISPLAY_DRAW_RECTANGLE, a_scene.strokeRect, 0.0f, WHITE, 4.0f, IdentityMatrix());
+		a_list.AddShape(DISPLAY_FILL_ELLIPSE, { 10.0f, 10.0f, 30.0f, 30.0f }, 0.0f, a_scene.ellipseColor, 1.0f, a_scene.ellipseTransform);
+		const RPoint points[] = { { 150.0f, 150.0f }, { a_scene.triangleRight, 150.0f }, { 165.0f, 180.0f } };
+		const unsigned int contourSize = 3;
+		a_list.AddPolygon(DISPLAY_FILL_POLYGON, points, &contourSize, 1, BLUE, 1.0f, IdentityMatrix());
+
+		DISPLAY_FONT font = { L"Segoe UI", a_scene.textSize, 400, 0, 0, 0, 5, L"en-us" };
+		a_list.AddText(a_scene.text.c_str(), static_cast<unsigned int>(a_scene.text.size()), { 10.0f, 60.0f, 90.0f, 80.0f }, font, WHITE, IdentityMatrix());
+		const std::wstring path = L"images/logo.png";
+		a_list.AddBitmap(path.c_str(), static_cast<unsigned int>(path.size()), { 10.0f, 100.0f, 42.0f, 132.0f }, 1.0f, a_scene.imageID, GREEN, IdentityMatrix());
+		if (a_scene.hasExtraRect) {
+			a_list.AddShape(DISPLAY_FILL_RECTANGLE, { 170.0f, 10.0f, 190.0f, 30.0f }, 0.0f, GREEN, 1.0f, IdentityMatrix());
+		}
+	}
+
+	bool HasRect(const DirtyRegion &a_region, const RRect &a_rect)
+	{
+		for (unsigned int i = 0; i < a_region.GetRectCount(); i++) {
+			const RRect &rect = a_region.GetRects()[i];
+			if (rect.left == a_rect.left && rect.top == a_rect.top && rect.right == a_rect.right && rect.bottom == a_rect.bottom) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// records the scene with one change and compares it with the original. the first difference is the changed command
+	void CheckChange(const DisplayList &a_list, const SCENE &a_scene, const unsigned int a_command)
+	{
+		DisplayList changedList;
+		Record(changedList, a_scene);
+		CHECK(!a_list.IsEqual(changedList));
+		CHECK(!changedList.IsEqual(a_list));
+		CHECK(a_command == a_list.FindFirstDifference(changedList));
+	}
+
+	// the frames which are recorded by the same calls are equal, and every changed part of a command makes them differ
+	void TestIsEqual()
+	{
+		const SCENE scene = MakeScene();
+		DisplayList list;
+		DisplayList sameList;
+		Record(list, scene);
+		Record(sameList, scene);
+		CHECK(SCENE_COMMAND_COUNT == list.GetCommandCount());
+		CHECK(list.IsEqual(sameList));
+		CHECK(SCENE_COMMAND_COUNT == list.FindFirstDifference(sameList));
+
+		SCENE changedScene = scene;
+		changedScene.clearColor.b = 0.5f;
+		CheckChange(list, changedScene, SCENE_CLEAR);
+		changedScene = scene;
+		changedScene.fillRadius = -0.0f;
+		CheckChange(list, changedScene, SCENE_FILL);
+		changedScene = scene;
+		changedScene.strokeRect.right = 121.0f;
+		CheckChange(list, changedScene, SCENE_STROKE);
+		changedScene = scene;
+		changedScene.ellipseColor.a = 0.5f;
+		CheckChange(list, changedScene, SCENE_ELLIPSE);
+		changedScene = scene;
+		changedScene.ellipseTransform._32 = 11.0f;
+		CheckChange(list, changedScene, SCENE_ELLIPSE);
+		changedScene = scene;
+		changedScene.triangleRight = 190.0f;
+		CheckChange(list, changedScene, SCENE_TRIANGLE);
+		changedScene = scene;
+		changedScene.text = L"chary";
+		CheckChange(list, changedScene, SCENE_TEXT);
+		changedScene = scene;
+		changedScene.textSize = 14.0f;
+		CheckChange(list, changedScene, SCENE_TEXT);
+		// the decoded image replaces the placeholder
+		changedScene = scene;
+		changedScene.imageID = 7;
+		CheckChange(list, changedScene, SCENE_BITMAP);
+		changedScene = scene;
+		changedScene.hasExtraRect = true;
+		CheckChange(list, changedScene, SCENE_COMMAND_COUNT);
+
+		// a list which is reset and recorded again is equal, and the swapped lists keep their frames
+		DisplayList changedList;
+		Record(changedList, changedScene);
+		sameList.Swap(changedList);
+		CHECK(!list.IsEqual(sameList));
+		CHECK(list.IsEqual(changedList));
+		Record(sameList, scene);
+		CHECK(list.IsEqual(sameList));
+	}
+
+	// the region gets the bounds of the changed commands in both frames and of the commands which only one frame has.
+	// the strokes are expanded by their half width, and the transforms are applied
+	void TestAddDifference()
+	{
+		const SCENE scene = MakeScene();
+		DisplayList list;
+		Record(list, scene);
+		DirtyRegion region;
+		region.SetBounds({ 0.0f, 0.0f, 200.0f, 200.0f });
+
+		DisplayList sameList;
+		Record(sameList, scene);
+		list.AddDifference(sameList, region);
+		CHECK(region.IsEmpty());
+
+		SCENE changedScene = scene;
+		changedScene.strokeRect = { 140.0f, 100.0f, 160.0f, 120.0f };
+		changedScene.ellipseColor = GREEN;
+		changedScene.triangleRight = 190.0f;
+		changedScene.hasExtraRect = true;
+		DisplayList changedList;
+		Record(changedList, changedScene);
+		list.AddDifference(changedList, region);
+
+		CHECK(5 == region.GetRectCount());
+		CHECK(HasRect(region, { 98.0f, 98.0f, 122.0f, 122.0f }));
+		CHECK(HasRect(region, { 138.0f, 98.0f, 162.0f, 122.0f }));
+		CHECK(HasRect(region, { 60.0f, 20.0f, 80.0f, 40.0f }));
+		CHECK(HasRect(region, { 150.0f, 150.0f, 190.0f, 180.0f }));
+		CHECK(HasRect(region, { 170.0f, 10.0f, 190.0f, 30.0f }));
+		// the unchanged commands stay clean
+		CHECK(!region.Intersects({ 10.0f, 150.0f, 40.0f, 180.0f }));
+		CHECK(!region.Intersects({ 10.0f, 60.0f, 90.0f, 80.0f }));
+		CHECK(!region.Intersects({ 10.0f, 100.0f, 42.0f, 132.0f }));
+
+		// the comparison is the same in both directions
+		DirtyRegion reverseRegion;
+		reverseRegion.SetBounds(region.GetBounds());
+		changedList.AddDifference(list, reverseRegion);
+		CHECK(region.GetRectCount() == reverseRegion.GetRectCount() && region.GetArea() == reverseRegion.GetArea());
+
+		// a changed clear invalidates everything
+		changedScene = scene;
+		changedScene.clearColor = WHITE;
+		Record(changedList, changedScene);
+		region.Reset();
+		list.AddDifference(changedList, region);
+		CHECK(region.IsFull());
+		CHECK(1 == region.GetRectCount() && HasRect(region, region.GetBounds()));
+	}
+
+	unsigned int GetPixel(SoftwareRasterizer &a_rasterizer, const int a_x, const int a_y)
+	{
+		return a_rasterizer.GetPixels()[a_y * a_rasterizer.GetStride() + a_x];
+	}
+
+	bool IsInside(const int a_x, const int a_y, const int a_left, const int a_top, const int a_right, const int a_bottom)
+	{
+		return a_x >= a_left && a_x < a_right && a_y >= a_top && a_y < a_bottom;
+	}
+
+	// a nested clip is intersected with the outer one after its transform, a pop restores the outer clip, and the
+	// replay leaves no clip behind
+	void TestClipReplay()
+	{
+		DisplayList list;
+		RMatrix translation = IdentityMatrix();
+		translation._31 = 5.0f;
+		list.AddClear({ 0.0f, 0.0f, 0.0f, 0.0f });
+		list.AddShape(DISPLAY_PUSH_CLIP, { 20.0f, 20.0f, 60.0f, 60.0f }, 0.0f, WHITE, 1.0f, IdentityMatrix());
+		list.AddShape(DISPLAY_FILL_RECTANGLE, { 0.0f, 0.0f, 128.0f, 128.0f }, 0.0f, WHITE, 1.0f, IdentityMatrix());
+		list.AddShape(DISPLAY_PUSH_CLIP, { 40.0f, 10.0f, 100.0f, 50.0f }, 0.0f, WHITE, 1.0f, translation);
+		list.AddShape(DISPLAY_FILL_RECTANGLE, { -5.0f, 0.0f, 123.0f, 128.0f }, 0.0f, RED, 1.0f, translation);
+		list.AddShape(DISPLAY_POP_CLIP, {}, 0.0f, RED, 1.0f, IdentityMatrix());
+		list.AddShape(DISPLAY_FILL_RECTANGLE, { 0.0f, 55.0f, 128.0f, 128.0f }, 0.0f, BLUE, 1.0f, IdentityMatrix());
+		list.AddShape(DISPLAY_POP_CLIP, {}, 0.0f, BLUE, 1.0f, IdentityMatrix());
+		list.AddShape(DISPLAY_FILL_RECTANGLE, { 0.0f, 120.0f, 128.0f, 128.0f }, 0.0f, GREEN, 1.0f, IdentityMatrix());
+
+		SoftwareRasterizer rasterizer(VIEW_WIDTH, VIEW_HEIGHT);
+		list.Replay(&rasterizer);
+		for (int y = 0; y < VIEW_HEIGHT; y++) {
+			for (int x = 0; x < VIEW_WIDTH; x++) {
+				unsigned int pixel = 0;
+				if (y >= 120) {
+					pixel = 0xFF00FF00;
+				}
+				else if (IsInside(x, y, 45, 20, 60, 50)) {
+					pixel = 0xFFFF0000;
+				}
+				else if (IsInside(x, y, 20, 55, 60, 60)) {
+					pixel = 0xFF0000FF;
+				}
+				else if (IsInside(x, y, 20, 20, 60, 60)) {
+					pixel = 0xFFFFFFFF;
+				}
+				CHECK(pixel == GetPixel(rasterizer, x, y));
+			}
+		}
+
+		// the commands without the nested clip. the replay which ends inside a clip resets it
+		const unsigned int INDICES[] = { 0, 1, 2, 6 };
+		list.Replay(&rasterizer, INDICES, 4);
+		rasterizer.SetTransform(IdentityMatrix());
+		rasterizer.SetColor(GREEN);
+		rasterizer.FillRectangle({ 0.0f, 0.0f, 10.0f, 10.0f });
+		for (int y = 0; y < VIEW_HEIGHT; y++) {
+			for (int x = 0; x < VIEW_WIDTH; x++) {
+				unsigned int pixel = 0;
+				if (IsInside(x, y, 0, 0, 10, 10)) {
+					pixel = 0xFF00FF00;
+				}
+				else if (IsInside(x, y, 20, 55, 60, 60)) {
+					pixel = 0xFF0000FF;
+				}
+				else if (IsInside(x, y, 20, 20, 60, 60)) {
+					pixel = 0xFFFFFFFF;
+				}
+				CHECK(pixel == GetPixel(rasterizer, x, y));
+			}
+		}
+	}
+}
+
+int main()
+{
+	TestIsEqual();
+	TestAddDifference();
+	TestClipReplay();
+	return GetCheckResult();
+}
\ No newline at end of file
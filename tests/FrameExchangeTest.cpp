@@ -0,0 +1,188 @@
+#include "Check.h"
+#include "FrameExchange.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+	const unsigned int VALUE_COUNT = 256;
+
+	// every value of a frame is its sequence number, so a frame which the producer writes while the consumer reads it
+	// is torn. the consumer marks the frame which it reads, so the producer can't get it as its back frame
+	struct TEST_FRAME
+	{
+		unsigned long long sequence;
+		unsigned long long values[VALUE_COUNT];
+		std::atomic<bool> isRead;
+	};
+
+	struct CONSUMER_RESULT
+	{
+		unsigned long long takenCount;
+		unsigned long long lastSequence;
+		bool isOrdered;				// every taken frame is newer than the one before
+		bool isConsecutive;			// no frame has been skipped
+		bool isWhole;				// no frame has been torn
+	};
+
+	void FillFrame(TEST_FRAME &a_frame, const unsigned long long a_sequence, std::atomic<unsigned int> &a_reusedCount)
+	{
+		if (a_frame.isRead.load(std::memory_order_acquire)) {
+			a_reusedCount++;
+		}
+		a_frame.sequence = a_sequence;
+		for (unsigned long long &value : a_frame.values) {
+			value = a_sequence;
+		}
+	}
+
+	// reads the front frame twice with a pause, so a producer which writes into it meanwhile is caught
+	void ReadFrame(TEST_FRAME &a_frame, CONSUMER_RESULT &a_result, const bool a_isPaused)
+	{
+		a_frame.isRead.store(true, std::memory_order_release);
+		const unsigned long long sequence = a_frame.sequence;
+		for (const unsigned long long value : a_frame.values) {
+			a_result.isWhole = a_result.isWhole && sequence == value;
+		}
+		if (a_isPaused) {
+			std::this_thread::yield();
+		}
+		for (const unsigned long long value : a_frame.values) {
+			a_result.isWhole = a_result.isWhole && sequence == value;
+		}
+		a_frame.isRead.store(false, std::memory_order_release);
+
+		a_result.isOrdered = a_result.isOrdered && sequence > a_result.lastSequence;
+		a_result.isConsecutive = a_result.isConsecutive && sequence == a_result.lastSequence + 1;
+		a_result.lastSequence = sequence;
+		a_result.takenCount++;
+	}
+
+	// the producer publishes the frames and closes the exchange, the consumer takes frames until it is closed
+	CONSUMER_RESULT RunExchange(FrameExchange<TEST_FRAME> &a_exchange, const unsigned long long a_frameCount, std::atomic<unsigned int> &a_reusedCount)
+	{
+		CONSUMER_RESULT result = { 0, 0, true, true, true };
+		std::thread producer([&a_exchange, a_frameCount, &a_reusedCount]() {
+			for (unsigned long long sequence = 1; sequence <= a_frameCount; sequence++) {
+				FillFrame(a_exchange.GetBackFrame(), sequence, a_reusedCount);
+				a_exchange.Publish();
+				if (0 == sequence % 64) {
+					std::this_thread::yield();
+				}
+			}
+			a_exchange.Close();
+		});
+
+		while (a_exchange.WaitFrame()) {
+			ReadFrame(a_exchange.GetFrontFrame(), result, 0 == result.takenCount % 16);
+		}
+		producer.join();
+
+		return result;
+	}
+
+	// a frame which hasn't been taken is replaced by a newer one, so the consumer always takes the latest frame
+	void TestLatestFrameWins()
+	{
+		FrameExchange<TEST_FRAME> exchange;
+		std::atomic<unsigned int> reusedCount = 0;
+		CHECK(!exchange.Acquire());
+		for (unsigned long long sequence = 1; sequence <= 3; sequence++) {
+			FillFrame(exchange.GetBackFrame(), sequence, reusedCount);
+			CHECK(exchange.Publish());
+		}
+		CHECK(exchange.Acquire());
+		CHECK(3 == exchange.GetFrontFrame().sequence);
+		CHECK(!exchange.Acquire());
+		CHECK(3 == exchange.GetFrontFrame().sequence);
+		CHECK(3 == exchange.GetPublishedCount() && 2 == exchange.GetDroppedCount());
+
+		// the front frame isn't handed to the producer, the dropped frames are
+		CHECK(&exchange.GetBackFrame() != &exchange.GetFrontFrame());
+		FillFrame(exchange.GetBackFrame(), 4, reusedCount);
+		CHECK(exchange.Publish());
+		CHECK(&exchange.GetBackFrame() != &exchange.GetFrontFrame());
+		CHECK(3 == exchange.GetFrontFrame().sequence);
+
+		// the frame which is published before closing is still taken
+		exchange.Close();
+		CHECK(exchange.IsClosed());
+		CHECK(!exchange.Publish());
+		CHECK(exchange.WaitFrame());
+		CHECK(4 == exchange.GetFrontFrame().sequence);
+		CHECK(!exchange.WaitFrame());
+	}
+
+	// the producer never waits and never gets the frame which the consumer reads. the consumer takes newer and newer
+	// frames and ends with the last one, every other frame is dropped
+	void TestTripleBufferedStress()
+	{
+		const unsigned long long FRAME_COUNT = 200000;
+		FrameExchange<TEST_FRAME> exchange;
+		std::atomic<unsigned int> reusedCount = 0;
+		const CONSUMER_RESULT result = RunExchange(exchange, FRAME_COUNT, reusedCount);
+
+		CHECK(result.isWhole);
+		CHECK(result.isOrdered);
+		CHECK(0 == reusedCount);
+		CHECK(FRAME_COUNT == result.lastSequence);
+		CHECK(FRAME_COUNT == exchange.GetPublishedCount());
+		CHECK(FRAME_COUNT == result.takenCount + exchange.GetDroppedCount());
+	}
+
+	// without triple buffering `Publish` blocks until the previous frame has been taken, so every frame is taken
+	// in order and none is dropped
+	void TestDoubleBuffered()
+	{
+		FrameExchange<TEST_FRAME> exchange(false);
+		std::atomic<unsigned int> reusedCount = 0;
+		FillFrame(exchange.GetBackFrame(), 1, reusedCount);
+		CHECK(exchange.Publish());
+
+		std::atomic<bool> isPublished = false;
+		std::thread producer([&exchange, &isPublished, &reusedCount]() {
+			FillFrame(exchange.GetBackFrame(), 2, reusedCount);
+			exchange.Publish();
+			isPublished = true;
+		});
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		CHECK(!isPublished);
+		CHECK(exchange.Acquire());
+		CHECK(1 == exchange.GetFrontFrame().sequence);
+		producer.join();
+		CHECK(isPublished);
+		CHECK(exchange.Acquire());
+		CHECK(2 == exchange.GetFrontFrame().sequence);
+
+		// a waiting producer is woken by `Close`
+		FillFrame(exchange.GetBackFrame(), 3, reusedCount);
+		CHECK(exchange.Publish());
+		std::atomic<bool> isRefused = false;
+		std::thread closedProducer([&exchange, &isRefused]() {
+			isRefused = !exchange.Publish();
+		});
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		exchange.Close();
+		closedProducer.join();
+		CHECK(isRefused);
+		CHECK(0 == exchange.GetDroppedCount());
+
+		const unsigned long long FRAME_COUNT = 50000;
+		FrameExchange<TEST_FRAME> stressExchange(false);
+		const CONSUMER_RESULT result = RunExchange(stressExchange, FRAME_COUNT, reusedCount);
+		CHECK(result.isWhole);
+		CHECK(result.isConsecutive);
+		CHECK(0 == reusedCount);
+		CHECK(FRAME_COUNT == result.takenCount);
+		CHECK(0 == stressExchange.GetDroppedCount());
+	}
+}
+
+int main()
+{
+	TestLatestFrameWins();
+	TestTripleBufferedStress();
+	TestDoubleBuffered();
+	return GetCheckResult();
+}
\ No newline at end of file
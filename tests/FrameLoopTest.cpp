@@ -0,0 +1,281 @@
+#include "Check.h"
+#include "FrameLoop.h"
+#include <cmath>
+#include <functional>
+#include <vector>
+
+namespace
+{
+	struct SCRIPT_EVENT
+	{
+		unsigned long long time;
+		std::function<void()> action;		// a message which is handled by `PumpMessages`
+	};
+
+	struct WAIT_ENTRY
+	{
+		unsigned long long timeout;
+		bool isInfinite;
+	};
+
+	// a window on a fake clock. the messages arrive at the times of the script, a wait oversleeps by the scripted
+	// amounts like a coarse timer, and a frame costs the scripted render times
+	class ScriptedWindow : public FrameClock, public MessageSource, public FrameHandler
+	{
+	public:
+		unsigned long long m_time;
+		unsigned long long m_endTime;					// `PumpMessages` ends the loop from this time on
+		std::vector<SCRIPT_EVENT> m_events;				// in the order of their times
+		size_t m_nextEvent;
+		std::vector<unsigned long long> m_oversleeps;	// repeated for the finite waits which aren't woken by a message
+		size_t m_waitCount;
+		std::vector<unsigned long long> m_renderCosts;	// repeated for the frames
+		std::vector<WAIT_ENTRY> m_waits;
+		std::vector<unsigned long long> m_frameTimes;
+		std::vector<unsigned int> m_updateCounts;		// the updates of each frame
+		std::vector<double> m_steps;
+		std::vector<double> m_alphas;
+		unsigned int m_updateCount;
+
+		ScriptedWindow()
+		{
+			m_time = 1000000;
+			m_endTime = ~0ull;
+			m_nextEvent = 0;
+			m_waitCount = 0;
+			m_updateCount = 0;
+		}
+
+		const unsigned long long GetTime() override
+		{
+			return m_time;
+		}
+
+		bool PumpMessages() override
+		{
+			for (; m_nextEvent < m_events.size() && m_events[m_nextEvent].time <= m_time; m_nextEvent++) {
+				m_events[m_nextEvent].action();
+			}
+			return m_time < m_endTime;
+		}
+
+		void WaitMessage(const unsigned long long a_timeout, const bool a_isInfinite) override
+		{
+			m_waits.push_back({ a_timeout, a_isInfinite });
+			const unsigned long long messageTime = m_nextEvent < m_events.size() ? m_events[m_nextEvent].time : m_endTime;
+			if (a_isInfinite) {
+				m_time = messageTime;
+				return;
+			}
+
+			const unsigned long long oversleep = m_oversleeps.empty() ? 0 : m_oversleeps[m_waitCount++ % m_oversleeps.size()];
+			const unsigned long long wakeTime = m_time + a_timeout + oversleep;
+			m_time = messageTime < wakeTime ? messageTime : wakeTime;
+		}
+
+		void OnFrameUpdate(const double a_step) override
+		{
+			m_steps.push_back(a_step);
+			m_updateCount++;
+		}
+
+		void OnFrameRender(const double a_alpha) override
+		{
+			m_frameTimes.push_back(m_time);
+			m_updateCounts.push_back(m_updateCount);
+			m_updateCount = 0;
+			m_alphas.push_back(a_alpha);
+			if (!m_renderCosts.empty()) {
+				m_time += m_renderCosts[(m_frameTimes.size() - 1) % m_renderCosts.size()];
+			}
+		}
+
+		void AddEvent(const unsigned long long a_time, const std::function<void()> &a_action)
+		{
+			m_events.push_back({ a_time, a_action });
+		}
+
+		// the timeouts of the finite waits
+		std::vector<unsigned long long> GetWaitTimeouts()
+		{
+			std::vector<unsigned long long> timeouts;
+			for (const WAIT_ENTRY &wait : m_waits) {
+				if (!wait.isInfinite) {
+					timeouts.push_back(wait.timeout);
+				}
+			}
+			return timeouts;
+		}
+	};
+
+	bool IsNear(const double a_value, const double a_expected)
+	{
+		return std::fabs(a_value - a_expected) < 1e-9;
+	}
+
+	// the variable step updates once per frame by the measured interval. the loop sleeps for the rest of the interval
+	// after the render time, and a message in between doesn't move the frames off their grid
+	void TestVariableStep()
+	{
+		ScriptedWindow window;
+		FrameLoop loop(&window, &window, &window);
+		loop.SetInterval(10000);
+		loop.BeginAnimation();
+		window.m_renderCosts = { 3000 };
+		window.AddEvent(window.m_time + 24000, []() {});
+		window.m_endTime = window.m_time + 100000;
+		loop.Run();
+
+		CHECK(10 == window.m_frameTimes.size());
+		for (size_t i = 0; i < window.m_frameTimes.size(); i++) {
+			CHECK(window.m_time - 100000 + i * 10000 == window.m_frameTimes[i]);
+			CHECK(1 == window.m_updateCounts[i]);
+			CHECK(IsNear(window.m_steps[i], 0.01));
+			CHECK(0.0 == window.m_alphas[i]);
+		}
+		// the message at 24 ms splits the wait for the frame at 30 ms
+		const std::vector<unsigned long long> timeouts = window.GetWaitTimeouts();
+		CHECK(11 == timeouts.size());
+		for (size_t i = 0; i < timeouts.size(); i++) {
+			CHECK((3 == i ? 6000 : 7000) == timeouts[i]);
+		}
+		CHECK(0 == loop.GetStatistics().missedCount && 0 == loop.GetStatistics().idleCount);
+
+		// a slow frame restarts the grid instead of catching up, and its update is limited to 5 steps
+		ScriptedWindow slowWindow;
+		FrameLoop slowLoop(&slowWindow, &slowWindow, &slowWindow);
+		slowLoop.SetInterval(10000);
+		slowLoop.BeginAnimation();
+		slowWindow.m_renderCosts = { 1000, 80000, 1000, 1000 };
+		slowWindow.m_endTime = slowWindow.m_time + 110000;
+		slowLoop.Run();
+		const unsigned long long startTime = slowWindow.m_frameTimes[0];
+		CHECK(4 <= slowWindow.m_frameTimes.size());
+		CHECK(startTime + 10000 == slowWindow.m_frameTimes[1]);
+		CHECK(startTime + 90000 == slowWindow.m_frameTimes[2]);
+		CHECK(startTime + 100000 == slowWindow.m_frameTimes[3]);
+		CHECK(IsNear(slowWindow.m_steps[2], 0.05));
+		CHECK(IsNear(slowWindow.m_steps[3], 0.01));
+		CHECK(1 == slowLoop.GetStatistics().missedCount);
+	}
+
+	// the fixed step updates as many steps as the intervals contain and passes the rest as the interpolation.
+	// the steps beyond the limit of a frame are dropped
+	void TestFixedStep()
+	{
+		ScriptedWindow window;
+		FrameLoop loop(&window, &window, &window);
+		loop.SetInterval(10000);
+		loop.SetStepMode(FRAME_FIXED_STEP, 4000, 3);
+		loop.BeginAnimation();
+		// the sixth frame takes 30 ms
+		window.m_renderCosts = { 0, 0, 0, 0, 0, 30000, 0, 0, 0, 0 };
+		window.m_endTime = window.m_time + 100000;
+		loop.Run();
+
+		// the first frame updates one step. 10 ms contain 2.5 steps, so the frames alternate between 2 and 3 steps
+		const unsigned int UPDATE_COUNTS[] = { 1, 2, 3, 2, 3, 2, 3, 2 };
+		const double ALPHAS[] = { 0.0, 0.5, 0.0, 0.5, 0.0, 0.5, 0.0, 0.5 };
+		CHECK(8 == window.m_frameTimes.size());
+		for (size_t i = 0; i < 8 && i < window.m_frameTimes.size(); i++) {
+			CHECK(UPDATE_COUNTS[i] == window.m_updateCounts[i]);
+			CHECK(IsNear(ALPHAS[i], window.m_alphas[i]));
+		}
+		for (const double step : window.m_steps) {
+			CHECK(IsNear(step, 0.004));
+		}
+		// the frame 30 ms after the slow one would need 8 steps. 3 run and the rest is dropped
+		CHECK(30000 == window.m_frameTimes[6] - window.m_frameTimes[5]);
+		CHECK(18 == loop.GetStatistics().updateCount);
+		CHECK(1 == loop.GetStatistics().missedCount);
+	}
+
+	// the statistics measure the intervals between the frames against the target interval. a late wake-up shortens
+	// the next interval, because the frames stay on their grid
+	void TestJitterStatistics()
+	{
+		ScriptedWindow window;
+		FrameLoop loop(&window, &window, &window);
+		loop.SetInterval(10000);
+		loop.BeginAnimation();
+		window.m_renderCosts = { 2000, 500, 4000 };
+		window.m_oversleeps = { 0, 700, 1500, 0, 300 };
+		window.m_endTime = window.m_time + 300000;
+		loop.Run();
+
+		const std::vector<unsigned long long> &frameTimes = window.m_frameTimes;
+		double intervalSum = 0.0;
+		double jitterSum = 0.0;
+		unsigned long long maxJitter = 0;
+		for (size_t i = 1; i < frameTimes.size(); i++) {
+			const unsigned long long interval = frameTimes[i] - frameTimes[i - 1];
+			const unsigned long long jitter = interval > 10000 ? interval - 10000 : 10000 - interval;
+			intervalSum += static_cast<double>(interval);
+			jitterSum += static_cast<double>(jitter);
+			maxJitter = jitter > maxJitter ? jitter : maxJitter;
+			// every frame is due on the grid, so a late one is late only by its own oversleep
+			CHECK((frameTimes[i] - frameTimes[0]) % 10000 <= 1500);
+		}
+
+		const FRAME_STATISTICS &statistics = loop.GetStatistics();
+		const double intervalCount = static_cast<double>(frameTimes.size() - 1);
+		CHECK(frameTimes.size() > 20);
+		CHECK(frameTimes.size() == statistics.frameCount);
+		CHECK(frameTimes.back() - frameTimes[frameTimes.size() - 2] == statistics.lastInterval);
+		CHECK(std::fabs(statistics.averageInterval - intervalSum / intervalCount) < 1e-6);
+		CHECK(std::fabs(statistics.averageJitter - jitterSum / intervalCount) < 1e-6);
+		CHECK(maxJitter == statistics.maxJitter);
+		CHECK(1500 == statistics.maxJitter);
+		CHECK(0 == statistics.missedCount);
+
+		loop.ResetStatistics();
+		CHECK(0 == loop.GetStatistics().frameCount && 0.0 == loop.GetStatistics().averageJitter);
+	}
+
+	// the loop waits without a timeout as soon as every animation has ended, and the first frame after idle
+	// advances by one interval instead of the idle time
+	void TestIdleWait()
+	{
+		ScriptedWindow window;
+		FrameLoop loop(&window, &window, &window);
+		loop.SetInterval(10000);
+		const unsigned long long startTime = window.m_time;
+		window.AddEvent(startTime + 1000, [&loop]() { loop.BeginAnimation(); loop.BeginAnimation(); });
+		window.AddEvent(startTime + 25000, [&loop]() { loop.EndAnimation(); });
+		window.AddEvent(startTime + 45000, [&loop]() { loop.EndAnimation(); loop.EndAnimation(); });
+		window.AddEvent(startTime + 500000, [&loop]() { loop.BeginAnimation(); });
+		window.m_endTime = startTime + 515000;
+		loop.Run();
+
+		// the loop blocks until the first message, animates, blocks again until the third animation begins
+		CHECK(window.m_waits.size() >= 3);
+		CHECK(window.m_waits[0].isInfinite);
+		size_t infiniteCount = 0;
+		for (const WAIT_ENTRY &wait : window.m_waits) {
+			infiniteCount += wait.isInfinite ? 1 : 0;
+		}
+		CHECK(2 == infiniteCount);
+		CHECK(2 == loop.GetStatistics().idleCount);
+		CHECK(loop.IsAnimating());
+		loop.EndAnimation();
+		CHECK(!loop.IsAnimating());
+
+		// the frames at 1, 11, 21, 31 and 41 ms while animating, then at 500 and 510 ms
+		const std::vector<unsigned long long> FRAME_OFFSETS = { 1000, 11000, 21000, 31000, 41000, 500000, 510000 };
+		CHECK(FRAME_OFFSETS.size() == window.m_frameTimes.size());
+		for (size_t i = 0; i < FRAME_OFFSETS.size() && i < window.m_frameTimes.size(); i++) {
+			CHECK(startTime + FRAME_OFFSETS[i] == window.m_frameTimes[i]);
+			CHECK(IsNear(window.m_steps[i], 0.01));
+		}
+		CHECK(0 == loop.GetStatistics().missedCount);
+	}
+}
+
+int main()
+{
+	TestVariableStep();
+	TestFixedStep();
+	TestJitterStatistics();
+	TestIdleWait();
+	return GetCheckResult();
+}
\ No newline at end of file
@@ -0,0 +1,201 @@
+#include "Check.h"
+#include "GlyphAtlas.h"
+#include <algorithm>
+
+namespace
+{
+	// rasterizes a glyph as a block of `a_glyphIndex` by `a_glyphIndex / 2` pixels filled with its index.
+	// the glyph 0 is blank and the glyph 1 fails
+	class StandInRasterizer : public GlyphRasterizer
+	{
+	public:
+		unsigned int m_rasterizeCount = 0;
+		float m_lastOffsetX = -1.0f;
+
+		bool RasterizeGlyph(
+			const void *const ap_fontFace, const unsigned short a_glyphIndex, const float a_size,
+			const float a_offsetX, GLYPH_BITMAP &a_bitmap
+		) override
+		{
+			m_rasterizeCount++;
+			m_lastOffsetX = a_offsetX;
+			if (1 == a_glyphIndex) {
+				return false;
+			}
+
+			a_bitmap.advance = a_size;
+			if (0 == a_glyphIndex) {
+				return true;
+			}
+
+			a_bitmap.left = 1;
+			a_bitmap.top = -a_glyphIndex;
+			a_bitmap.width = a_glyphIndex;
+			a_bitmap.height = a_glyphIndex / 2;
+			a_bitmap.alpha.assign(static_cast<size_t>(a_bitmap.width) * a_bitmap.height, static_cast<unsigned char>(a_glyphIndex));
+			return true;
+		}
+	};
+
+	const int FONT_FACE = 0;
+
+	// returns whether the pixels of the glyph hold its index and its padding is transparent
+	bool HasGlyphPixels(GlyphAtlas &a_atlas, const ATLAS_GLYPH &a_glyph)
+	{
+		const unsigned char *const p_pixels = a_atlas.GetPixels();
+		const int width = a_atlas.GetWidth();
+		for (int y = a_glyph.y; y <= a_glyph.y + a_glyph.height && y < a_atlas.GetHeight(); y++) {
+			for (int x = a_glyph.x; x <= a_glyph.x + a_glyph.width && x < width; x++) {
+				const bool isPadding = x == a_glyph.x + a_glyph.width || y == a_glyph.y + a_glyph.height;
+				if (p_pixels[static_cast<size_t>(y) * width + x] != (isPadding ? 0 : a_glyph.glyphIndex)) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	void TestHitAndSubpixels()
+	{
+		StandInRasterizer rasterizer;
+		GlyphAtlas atlas(&rasterizer, 128, 128, 4);
+
+		ATLAS_GLYPH glyph;
+		CHECK(atlas.Get(&FONT_FACE, 10, 12.0f, 3.0f, glyph));
+		CHECK(10 == glyph.width && 5 == glyph.height && 1 == glyph.left && -10 == glyph.top && 0 == glyph.subpixel);
+		CHECK(HasGlyphPixels(atlas, glyph));
+
+		// the same glyph at another whole pixel position is a hit
+		ATLAS_GLYPH hitGlyph;
+		CHECK(atlas.Get(&FONT_FACE, 10, 12.0f, 7.0f, hitGlyph));
+		CHECK(hitGlyph.x == glyph.x && hitGlyph.y == glyph.y);
+		CHECK(1 == rasterizer.m_rasterizeCount);
+
+		// a quarter pixel is another subpixel position, which is rasterized with its offset
+		CHECK(atlas.Get(&FONT_FACE, 10, 12.0f, 3.25f, glyph));
+		CHECK(1 == glyph.subpixel && 0.25f == rasterizer.m_lastOffsetX);
+		// almost a whole pixel rounds to the first position
+		CHECK(atlas.Get(&FONT_FACE, 10, 12.0f, 3.95f, glyph));
+		CHECK(0 == glyph.subpixel);
+		CHECK(2 == rasterizer.m_rasterizeCount);
+
+		// another size or font face is another glyph
+		const int otherFontFace = 0;
+		atlas.Get(&FONT_FACE, 10, 13.0f, 0.0f, glyph);
+		atlas.Get(&otherFontFace, 10, 12.0f, 0.0f, glyph);
+		CHECK(4 == rasterizer.m_rasterizeCount);
+
+		const ATLAS_STATISTICS statistics = atlas.GetStatistics();
+		CHECK(4 == statistics.glyphCount && 2 == statistics.hitCount && 4 == statistics.missCount);
+		CHECK(0 == statistics.evictionCount && 0 == atlas.GetGeneration());
+	}
+
+	void TestBlankAndFailedGlyphs()
+	{
+		StandInRasterizer rasterizer;
+		GlyphAtlas atlas(&rasterizer, 64, 64);
+		atlas.ClearDirtyRows();
+
+		// a blank glyph is cached without pixels
+		ATLAS_GLYPH glyph;
+		CHECK(atlas.Get(&FONT_FACE, 0, 12.0f, 0.0f, glyph));
+		CHECK(0 == glyph.width && 12.0f == glyph.advance);
+		int top = 0;
+		int bottom = 0;
+		CHECK(!atlas.GetDirtyRows(top, bottom));
+
+		CHECK(!atlas.Get(&FONT_FACE, 1, 12.0f, 0.0f, glyph));
+		// a glyph with its padding larger than the atlas can't be placed
+		CHECK(!atlas.Get(&FONT_FACE, 64, 12.0f, 0.0f, glyph));
+		CHECK(1 == atlas.GetStatistics().glyphCount);
+	}
+
+	void TestDirtyRows()
+	{
+		StandInRasterizer rasterizer;
+		GlyphAtlas atlas(&rasterizer, 64, 64);
+
+		// a new atlas is uploaded as a whole
+		int top = 0;
+		int bottom = 0;
+		CHECK(atlas.GetDirtyRows(top, bottom) && 0 == top && 64 == bottom);
+		atlas.ClearDirtyRows();
+		CHECK(!atlas.GetDirtyRows(top, bottom));
+
+		ATLAS_GLYPH glyph;
+		atlas.Get(&FONT_FACE, 20, 12.0f, 0.0f, glyph);
+		CHECK(atlas.GetDirtyRows(top, bottom) && glyph.y == top && glyph.y + glyph.height == bottom);
+
+		// the rows grow to cover every new glyph until they are cleared
+		ATLAS_GLYPH otherGlyph;
+		atlas.Get(&FONT_FACE, 40, 12.0f, 0.0f, otherGlyph);
+		CHECK(atlas.GetDirtyRows(top, bottom));
+		CHECK(top == std::min(glyph.y, otherGlyph.y));
+		CHECK(bottom == std::max(glyph.y + glyph.height, otherGlyph.y + otherGlyph.height));
+
+		// a hit doesn't change any row
+		atlas.ClearDirtyRows();
+		atlas.Get(&FONT_FACE, 20, 12.0f, 0.0f, glyph);
+		CHECK(!atlas.GetDirtyRows(top, bottom));
+
+		atlas.InvalidateRows();
+		CHECK(atlas.GetDirtyRows(top, bottom) && 0 == top && 64 == bottom);
+	}
+
+	void TestEviction()
+	{
+		StandInRasterizer rasterizer;
+		GlyphAtlas atlas(&rasterizer, 64, 64);
+		atlas.ClearDirtyRows();
+
+		// the glyphs of 30 by 15 pixels take 31 by 16 with the padding, so 8 of them fill the atlas
+		ATLAS_GLYPH glyph;
+		for (unsigned int i = 0; i < 8; i++) {
+			CHECK(atlas.Get(&FONT_FACE, 30, static_cast<float>(10 + i), 0.0f, glyph));
+		}
+		CHECK(0 == atlas.GetGeneration());
+		atlas.ClearDirtyRows();
+
+		// the next glyph evicts all others and starts a new generation
+		CHECK(atlas.Get(&FONT_FACE, 30, 20.0f, 0.0f, glyph));
+		CHECK(1 == atlas.GetGeneration());
+		const ATLAS_STATISTICS statistics = atlas.GetStatistics();
+		CHECK(1 == statistics.evictionCount && 1 == statistics.glyphCount);
+		CHECK(0 == glyph.x && 0 == glyph.y);
+		CHECK(HasGlyphPixels(atlas, glyph));
+
+		// the whole atlas is uploaded again and the old pixels are gone
+		int top = 0;
+		int bottom = 0;
+		CHECK(atlas.GetDirtyRows(top, bottom) && 0 == top && 64 == bottom);
+		unsigned int oldPixelCount = 0;
+		const unsigned char *const p_pixels = atlas.GetPixels();
+		for (int y = 0; y < 64; y++) {
+			for (int x = 0; x < 64; x++) {
+				const bool isGlyph = x < glyph.width && y < glyph.height;
+				if (!isGlyph && p_pixels[y * 64 + x]) {
+					oldPixelCount++;
+				}
+			}
+		}
+		CHECK(0 == oldPixelCount);
+
+		// an evicted glyph is rasterized again
+		const unsigned int rasterizeCount = rasterizer.m_rasterizeCount;
+		atlas.Get(&FONT_FACE, 30, 10.0f, 0.0f, glyph);
+		CHECK(rasterizeCount + 1 == rasterizer.m_rasterizeCount);
+
+		atlas.Clear();
+		CHECK(2 == atlas.GetGeneration() && 0 == atlas.GetStatistics().glyphCount);
+	}
+}
+
+int main()
+{
+	TestHitAndSubpixels();
+	TestBlankAndFailedGlyphs();
+	TestDirtyRows();
+	TestEviction();
+
+	return GetCheckResult();
+}
\ No newline at end of file
@@ -0,0 +1,335 @@
+#include "Check.h"
+#include "ImageCache.h"
+#include "TaskScheduler.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace
+{
+	// decodes every path into an image of the target size, or 16 x 16 for a size of 0. the paths starting
+	// with "missing" fail. while the decoder is closed the decodes wait until it is opened
+	class FakeImageDecoder : public ImageDecoder
+	{
+	public:
+		std::atomic<unsigned int> m_decodeCount;
+
+	protected:
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		bool m_isOpen;
+
+	public:
+		FakeImageDecoder()
+		{
+			m_decodeCount = 0;
+			m_isOpen = true;
+		}
+
+		void SetOpen(const bool a_isOpen)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_isOpen = a_isOpen;
+			}
+			m_condition.notify_all();
+		}
+
+		bool Decode(const wchar_t *const ap_path, const unsigned int a_width, const unsigned int a_height, IMAGE_PIXELS &a_image) override
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_condition.wait(lock, [this]() { return m_isOpen; });
+			}
+			m_decodeCount++;
+
+			const std::wstring path = ap_path;
+			if (0 == path.compare(0, 7, L"missing")) {
+				return false;
+			}
+
+			GetTargetSize(16, 16, a_width, a_height, a_image.width, a_image.height);
+			a_image.pixels.assign(static_cast<size_t>(a_image.width) * a_image.height * 4, static_cast<unsigned char>(path.size()));
+			return true;
+		}
+	};
+
+	void CountNotify(void *ap_data)
+	{
+		(*static_cast<std::atomic<unsigned int> *>(ap_data))++;
+	}
+
+	// waits for the worker thread until the counter reaches the count, at most a few seconds
+	void WaitForCount(const std::atomic<unsigned int> &a_counter, const unsigned int a_count)
+	{
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (a_counter < a_count && std::chrono::steady_clock::now() < deadline) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+
+	void WriteFile(const std::filesystem::path &a_path, const std::vector<unsigned char> &a_data)
+	{
+		std::ofstream file(a_path, std::ios::binary);
+		file.write(reinterpret_cast<const char *>(a_data.data()), static_cast<std::streamsize>(a_data.size()));
+	}
+
+	void AppendUInt16(std::vector<unsigned char> &a_data, const unsigned int a_value)
+	{
+		a_data.push_back(static_cast<unsigned char>(a_value));
+		a_data.push_back(static_cast<unsigned char>(a_value >> 8));
+	}
+
+	void AppendUInt32(std::vector<unsigned char> &a_data, const unsigned int a_value)
+	{
+		AppendUInt16(a_data, a_value & 0xFFFF);
+		AppendUInt16(a_data, a_value >> 16);
+	}
+
+	// the file header and a BITMAPINFOHEADER in front of the rows
+	std::vector<unsigned char> MakeBMP(const int a_width, const int a_height, const unsigned int a_bitCount, const std::vector<unsigned char> &a_rows)
+	{
+		std::vector<unsigned char> data = { 'B', 'M' };
+		AppendUInt32(data, static_cast<unsigned int>(54 + a_rows.size()));
+		AppendUInt32(data, 0);
+		AppendUInt32(data, 54);
+		AppendUInt32(data, 40);
+		AppendUInt32(data, static_cast<unsigned int>(a_width));
+		AppendUInt32(data, static_cast<unsigned int>(a_height));
+		AppendUInt16(data, 1);
+		AppendUInt16(data, a_bitCount);
+		for (unsigned int i = 0; i < 6; i++) {
+			AppendUInt32(data, 0);
+		}
+		data.insert(data.end(), a_rows.begin(), a_rows.end());
+		return data;
+	}
+
+	// rounds x * alpha / 255
+	unsigned char Premultiply(const unsigned int a_value, const unsigned int a_alpha)
+	{
+		return static_cast<unsigned char>((a_value * a_alpha + 127) / 255);
+	}
+
+	bool IsPixel(const IMAGE_PIXELS &a_image, const unsigned int a_x, const unsigned int a_y, const unsigned char (&a_bgra)[4])
+	{
+		const unsigned char *const p_pixel = a_image.pixels.data() + (static_cast<size_t>(a_y) * a_image.width + a_x) * 4;
+		return a_bgra[0] == p_pixel[0] && a_bgra[1] == p_pixel[1] && a_bgra[2] == p_pixel[2] && a_bgra[3] == p_pixel[3];
+	}
+
+	// an image is kept for its path and its size together, and a request of a kept image returns the same pixels
+	void TestKeying()
+	{
+		FakeImageDecoder decoder;
+		ImageCache cache(&decoder);
+
+		const std::shared_ptr<const IMAGE_PIXELS> p_image = cache.Request(L"a", 10, 10);
+		CHECK(p_image && 10 == p_image->width && 10 == p_image->height);
+		CHECK(p_image == cache.Request(L"a", 10, 10));
+		CHECK(1 == decoder.m_decodeCount);
+
+		const std::shared_ptr<const IMAGE_PIXELS> p_otherPath = cache.Request(L"bb", 10, 10);
+		const std::shared_ptr<const IMAGE_PIXELS> p_otherWidth = cache.Request(L"a", 12, 10);
+		const std::shared_ptr<const IMAGE_PIXELS> p_otherHeight = cache.Request(L"a", 10, 12);
+		CHECK(p_otherPath && p_otherPath != p_image && 2 == p_otherPath->pixels[0]);
+		CHECK(p_otherWidth && 12 == p_otherWidth->width && 10 == p_otherWidth->height);
+		CHECK(p_otherHeight && 10 == p_otherHeight->width && 12 == p_otherHeight->height);
+		CHECK(p_image->id != p_otherPath->id && p_image->id != p_otherWidth->id && p_otherWidth->id != p_otherHeight->id);
+		CHECK(4 == decoder.m_decodeCount);
+
+		const IMAGE_CACHE_STATISTICS statistics = cache.GetStatistics();
+		CHECK(1 == statistics.hitCount && 4 == statistics.missCount && 4 == statistics.decodedCount);
+		CHECK(2 * 10 * 10 * 4 + 2 * 10 * 12 * 4 == cache.GetByteCount());
+	}
+
+	// the images over the byte budget are evicted in the order of their last requests, but the most recent one stays
+	// even if it exceeds the budget alone
+	void TestEviction()
+	{
+		FakeImageDecoder decoder;
+		// 10 x 10 images have 400 bytes, so two of them fit
+		ImageCache cache(&decoder, nullptr, 1000);
+
+		const std::shared_ptr<const IMAGE_PIXELS> p_first = cache.Request(L"1", 10, 10);
+		cache.Request(L"2", 10, 10);
+		// the first image becomes more recent than the second one, so the second one is evicted
+		CHECK(p_first == cache.Request(L"1", 10, 10));
+		cache.Request(L"3", 10, 10);
+		CHECK(800 == cache.GetByteCount());
+		CHECK(1 == cache.GetStatistics().evictedCount);
+		CHECK(3 == decoder.m_decodeCount);
+
+		CHECK(p_first == cache.Request(L"1", 10, 10));
+		CHECK(3 == decoder.m_decodeCount);
+		cache.Request(L"2", 10, 10);
+		CHECK(4 == decoder.m_decodeCount);
+		// the third image was the least recent one then
+		cache.Request(L"1", 10, 10);
+		CHECK(4 == decoder.m_decodeCount);
+		cache.Request(L"3", 10, 10);
+		CHECK(5 == decoder.m_decodeCount);
+
+		// an evicted image stays alive while it is in use
+		CHECK(400 == p_first->pixels.size());
+
+		cache.Request(L"4", 40, 40);
+		CHECK(6400 == cache.GetByteCount());
+		CHECK(cache.Request(L"4", 40, 40));
+		CHECK(6 == decoder.m_decodeCount);
+
+		cache.SetByteBudget(100000);
+		cache.Request(L"1", 10, 10);
+		cache.Request(L"2", 10, 10);
+		CHECK(7200 == cache.GetByteCount());
+		cache.SetByteBudget(400);
+		CHECK(400 == cache.GetByteCount());
+		CHECK(cache.Request(L"2", 10, 10));
+		CHECK(8 == decoder.m_decodeCount);
+
+		cache.Clear();
+		CHECK(0 == cache.GetByteCount());
+		cache.Request(L"2", 10, 10);
+		CHECK(9 == decoder.m_decodeCount);
+	}
+
+	// a smaller size of a decoded image is resampled from the smallest one which covers it
+	void TestLargerImage()
+	{
+		FakeImageDecoder decoder;
+		ImageCache cache(&decoder);
+
+		// the smaller image is decoded first, so it can't be resampled from the larger one
+		cache.Request(L"a", 30, 30);
+		cache.Request(L"a", 40, 40);
+		CHECK(2 == decoder.m_decodeCount);
+
+		const std::shared_ptr<const IMAGE_PIXELS> p_image = cache.Request(L"a", 20, 10);
+		CHECK(p_image && 20 == p_image->width && 10 == p_image->height);
+		// the fake decoder fills with the length of the path, the resampling keeps the color
+		CHECK(p_image && 1 == p_image->pixels[0] && 1 == p_image->pixels.back());
+		CHECK(2 == decoder.m_decodeCount);
+		CHECK(1 == cache.GetStatistics().resampledCount);
+
+		// the other paths and the larger sizes are decoded
+		cache.Request(L"b", 20, 10);
+		cache.Request(L"a", 50, 10);
+		// a size of 0 depends on the file
+		cache.Request(L"a", 0, 0);
+		CHECK(5 == decoder.m_decodeCount);
+		CHECK(1 == cache.GetStatistics().resampledCount);
+	}
+
+	// a notify is called once when the pending image lands or fails, however often the image is requested meanwhile
+	void TestNotify()
+	{
+		FakeImageDecoder decoder;
+		ImageCache cache(&decoder, nullptr);
+		std::atomic<unsigned int> firstCount = 0;
+		std::atomic<unsigned int> secondCount = 0;
+		std::atomic<unsigned int> failedCount = 0;
+		{
+			// the scheduler is stopped before the cache is destroyed
+			std::unique_ptr<TaskScheduler> p_scheduler = std::make_unique<TaskScheduler>(1);
+			ImageCache asyncCache(&decoder, p_scheduler.get());
+
+			decoder.SetOpen(false);
+			for (unsigned int i = 0; i < 10; i++) {
+				// a paint requests the image again each time until it lands
+				CHECK(!asyncCache.Request(L"a", 10, 10, CountNotify, &firstCount));
+				CHECK(!asyncCache.Request(L"a", 10, 10, CountNotify, &secondCount));
+				CHECK(!asyncCache.Request(L"missing", 10, 10, CountNotify, &failedCount));
+			}
+			CHECK(2 == asyncCache.GetStatistics().missCount);
+			decoder.SetOpen(true);
+
+			WaitForCount(firstCount, 1);
+			WaitForCount(secondCount, 1);
+			WaitForCount(failedCount, 1);
+			CHECK(asyncCache.Request(L"a", 10, 10, CountNotify, &firstCount));
+			CHECK(!asyncCache.Request(L"missing", 10, 10, CountNotify, &failedCount));
+			CHECK(1 == asyncCache.GetStatistics().failedCount);
+			p_scheduler.reset();
+		}
+		CHECK(1 == firstCount);
+		CHECK(1 == secondCount);
+		CHECK(1 == failedCount);
+
+		// without a scheduler the image is decoded at once, so there is nothing to notify
+		CHECK(cache.Request(L"a", 10, 10, CountNotify, &firstCount));
+		CHECK(1 == firstCount);
+	}
+
+	// the stand-in decoder reads PPM and BMP files into premultiplied BGRA
+	void TestStandInDecoder()
+	{
+		const std::filesystem::path directory = std::filesystem::temp_directory_path();
+		const std::filesystem::path ppmPath = directory / "ImageCacheTest.ppm";
+		const std::filesystem::path bmpPath = directory / "ImageCacheTest.bmp";
+		StandInImageDecoder decoder;
+		IMAGE_PIXELS image = {};
+
+		// a comment in the header and 4 bit samples which are scaled to 8 bits
+		const std::string ppm = std::string("P6\n# comment\n2 1\n15\n") + '\x0F' + '\x05' + '\x00' + '\x01' + '\x02' + '\x03';
+		WriteFile(ppmPath, std::vector<unsigned char>(ppm.begin(), ppm.end()));
+		CHECK(decoder.Decode(ppmPath.wstring().c_str(), 0, 0, image));
+		CHECK(2 == image.width && 1 == image.height);
+		CHECK(IsPixel(image, 0, 0, { 0, 85, 255, 255 }));
+		CHECK(IsPixel(image, 1, 0, { 51, 34, 17, 255 }));
+
+		// 32 bit rows are bottom-up, with straight alpha
+		WriteFile(bmpPath, MakeBMP(2, 2, 32, {
+			200, 100, 50, 128, 255, 255, 255, 0,
+			10, 20, 30, 255, 90, 180, 250, 77
+		}));
+		CHECK(decoder.Decode(bmpPath.wstring().c_str(), 0, 0, image));
+		CHECK(2 == image.width && 2 == image.height);
+		CHECK(IsPixel(image, 0, 0, { 10, 20, 30, 255 }));
+		CHECK(IsPixel(image, 1, 0, { Premultiply(90, 77), Premultiply(180, 77), Premultiply(250, 77), 77 }));
+		CHECK(IsPixel(image, 0, 1, { Premultiply(200, 128), Premultiply(100, 128), Premultiply(50, 128), 128 }));
+		CHECK(IsPixel(image, 1, 1, { 0, 0, 0, 0 }));
+
+		// a negative height is top-down. 32 bit files whose fourth bytes are all 0 are opaque
+		WriteFile(bmpPath, MakeBMP(1, -2, 32, { 1, 2, 3, 0, 4, 5, 6, 0 }));
+		CHECK(decoder.Decode(bmpPath.wstring().c_str(), 0, 0, image));
+		CHECK(IsPixel(image, 0, 0, { 1, 2, 3, 255 }));
+		CHECK(IsPixel(image, 0, 1, { 4, 5, 6, 255 }));
+
+		// 24 bit rows are padded to 4 bytes
+		WriteFile(bmpPath, MakeBMP(3, 1, 24, { 1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 0, 0 }));
+		CHECK(decoder.Decode(bmpPath.wstring().c_str(), 0, 0, image));
+		CHECK(3 == image.width && 1 == image.height);
+		CHECK(IsPixel(image, 2, 0, { 7, 8, 9, 255 }));
+
+		// a target side of 0 keeps the aspect ratio
+		WriteFile(bmpPath, MakeBMP(4, 2, 24, std::vector<unsigned char>(24, 60)));
+		CHECK(decoder.Decode(bmpPath.wstring().c_str(), 0, 1, image));
+		CHECK(2 == image.width && 1 == image.height);
+		CHECK(IsPixel(image, 1, 0, { 60, 60, 60, 255 }));
+
+		// truncated files and other formats fail
+		WriteFile(bmpPath, MakeBMP(3, 3, 24, std::vector<unsigned char>(20, 0)));
+		CHECK(!decoder.Decode(bmpPath.wstring().c_str(), 0, 0, image));
+		WriteFile(bmpPath, { 'P', '3', '\n', '1', ' ', '1', '\n', '1', '\n' });
+		CHECK(!decoder.Decode(bmpPath.wstring().c_str(), 0, 0, image));
+		CHECK(!decoder.Decode((directory / "ImageCacheTest.missing").wstring().c_str(), 0, 0, image));
+
+		std::filesystem::remove(ppmPath);
+		std::filesystem::remove(bmpPath);
+	}
+}
+
+int main()
+{
+	TestKeying();
+	TestEviction();
+	TestLargerImage();
+	TestNotify();
+	TestStandInDecoder();
+	return GetCheckResult();
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "Check.h"
+#include "ImageResampler.h"
+#include "TaskScheduler.h"
+#include <random>
+
+namespace
+{
+	const RESAMPLE_FILTER FILTERS[] = { RESAMPLE_BOX, RESAMPLE_BILINEAR, RESAMPLE_LANCZOS3 };
+	const RESAMPLE_KERNEL KERNELS[] = { RESAMPLE_KERNEL_SCALAR, RESAMPLE_KERNEL_SSE2, RESAMPLE_KERNEL_AVX2 };
+
+	// random premultiplied pixels, a quarter of them opaque
+	IMAGE_PIXELS MakeImage(const unsigned int a_width, const unsigned int a_height, const unsigned int a_seed)
+	{
+		std::mt19937 random(a_seed);
+		IMAGE_PIXELS image = {};
+		image.width = a_width;
+		image.height = a_height;
+		image.pixels.resize(static_cast<size_t>(a_width) * a_height * 4);
+		for (size_t i = 0; i < image.pixels.size(); i += 4) {
+			const unsigned int alpha = 0 == random() % 4 ? 255 : random() % 256;
+			for (size_t channel = 0; channel < 3; channel++) {
+				image.pixels[i + channel] = static_cast<unsigned char>(random() % (alpha + 1));
+			}
+			image.pixels[i + 3] = static_cast<unsigned char>(alpha);
+		}
+		return image;
+	}
+
+	bool IsPremultiplied(const IMAGE_PIXELS &a_image)
+	{
+		for (size_t i = 0; i < a_image.pixels.size(); i += 4) {
+			if (a_image.pixels[i] > a_image.pixels[i + 3] || a_image.pixels[i + 1] > a_image.pixels[i + 3] ||
+				a_image.pixels[i + 2] > a_image.pixels[i + 3]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// every kernel returns exactly the pixels of the scalar one. a kernel which the processor lacks is lowered,
+	// so it is compared with a lower one then
+	void TestKernelEquivalence()
+	{
+		const unsigned int SIZES[][4] = {
+			{ 7, 5, 3, 2 }, { 100, 80, 37, 29 }, { 50, 40, 123, 97 }, { 33, 1, 5, 1 }, { 1, 1, 9, 9 },
+			{ 64, 64, 64, 64 }, { 5, 300, 17, 11 }, { 300, 5, 11, 17 }, { 3840, 64, 256, 4 }
+		};
+		for (const RESAMPLE_FILTER filter : FILTERS) {
+			for (const unsigned int (&size)[4] : SIZES) {
+				const IMAGE_PIXELS source = MakeImage(size[0], size[1], size[0] * size[1] + filter);
+				IMAGE_PIXELS scalarImage;
+				ImageResampler resampler(filter);
+				resampler.SetKernel(RESAMPLE_KERNEL_SCALAR);
+				CHECK(resampler.Resample(source, size[2], size[3], scalarImage));
+				CHECK(IsPremultiplied(scalarImage));
+
+				for (const RESAMPLE_KERNEL kernel : KERNELS) {
+					IMAGE_PIXELS image;
+					resampler.SetKernel(kernel);
+					CHECK(resampler.Resample(source, size[2], size[3], image));
+					CHECK(image.width == size[2] && image.height == size[3]);
+					CHECK(image.pixels == scalarImage.pixels);
+				}
+			}
+		}
+	}
+
+	void TestConstantImage()
+	{
+		IMAGE_PIXELS source = {};
+		source.width = 97;
+		source.height = 61;
+		for (unsigned int i = 0; i < source.width * source.height; i++) {
+			source.pixels.insert(source.pixels.end(), { 10, 100, 200, 255 });
+		}
+
+		for (const RESAMPLE_FILTER filter : FILTERS) {
+			for (const RESAMPLE_KERNEL kernel : KERNELS) {
+				ImageResampler resampler(filter);
+				resampler.SetKernel(kernel);
+				IMAGE_PIXELS image;
+				CHECK(resampler.Resample(source, 31, 200, image));
+
+				bool isConstant = true;
+				for (size_t i = 0; i < image.pixels.size(); i += 4) {
+					isConstant = isConstant && 10 == image.pixels[i] && 100 == image.pixels[i + 1] &&
+						200 == image.pixels[i + 2] && 255 == image.pixels[i + 3];
+				}
+				CHECK(isConstant);
+			}
+		}
+	}
+
+	void TestBands()
+	{
+		TaskScheduler scheduler(4);
+		const IMAGE_PIXELS source = MakeImage(640, 480, 1);
+		for (const RESAMPLE_FILTER filter : FILTERS) {
+			ImageResampler resampler(filter);
+			IMAGE_PIXELS image;
+			IMAGE_PIXELS bandImage;
+			CHECK(resampler.Resample(source, 200, 150, image));
+			CHECK(resampler.Resample(source, 200, 150, bandImage, &scheduler));
+			CHECK(image.pixels == bandImage.pixels);
+		}
+	}
+
+	void TestInvalidSizes()
+	{
+		ImageResampler resampler;
+		IMAGE_PIXELS image;
+		const IMAGE_PIXELS source = MakeImage(8, 8, 2);
+		CHECK(!resampler.Resample(source, 0, 4, image));
+		CHECK(!resampler.Resample(source, 4, 0, image));
+
+		IMAGE_PIXELS shortSource = source;
+		shortSource.pixels.resize(shortSource.pixels.size() - 4);
+		CHECK(!resampler.Resample(shortSource, 4, 4, image));
+	}
+}
+
+int main()
+{
+	TestKernelEquivalence();
+	TestConstantImage();
+	TestBands();
+	TestInvalidSizes();
+
+	return GetCheckResult();
+}
\ No newline at end of file
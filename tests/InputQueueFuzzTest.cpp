@@ -0,0 +1,158 @@
+#include "Check.h"
+#include "InputQueue.h"
+#include <random>
+#include <vector>
+
+namespace
+{
+	// a raw event which has been pushed with its history
+	struct RAW_INPUT
+	{
+		INPUT_EVENT event;
+		std::vector<INPUT_POINT> history;
+	};
+
+	bool IsCoalescable(const INPUT_EVENT &a_event, const INPUT_EVENT &a_nextEvent)
+	{
+		return INPUT_OTHER != a_nextEvent.type && a_event.type == a_nextEvent.type &&
+			a_event.messageID == a_nextEvent.messageID && a_event.modifiers == a_nextEvent.modifiers;
+	}
+
+	bool IsEqual(const INPUT_POINT &a_point, const INPUT_POINT &a_otherPoint)
+	{
+		return a_point.x == a_otherPoint.x && a_point.y == a_otherPoint.y && a_point.time == a_otherPoint.time;
+	}
+
+	// checks a batch against the raw events which have been pushed for it
+	bool IsBatchValid(const INPUT_BATCH &a_batch, const std::vector<RAW_INPUT> &a_rawInputs)
+	{
+		if (a_batch.rawCount != a_rawInputs.size()) {
+			return false;
+		}
+
+		size_t rawIndex = 0;
+		size_t pointCount = 0;
+		for (size_t i = 0; i < a_batch.events.size(); i++) {
+			const INPUT_EVENT &event = a_batch.events[i];
+			// the queue coalesces as much as it can, so two neighbours never could have been one event
+			if (0 == event.coalescedCount || (i > 0 && IsCoalescable(a_batch.events[i - 1], event))) {
+				return false;
+			}
+			if (INPUT_OTHER == event.type && 1 != event.coalescedCount) {
+				return false;
+			}
+			if (rawIndex + event.coalescedCount > a_rawInputs.size()) {
+				return false;
+			}
+
+			// the event is the last raw event of its group with the summed up delta and all points of the group
+			int delta = 0;
+			size_t pointIndex = event.historyIndex;
+			for (size_t j = rawIndex; j < rawIndex + event.coalescedCount; j++) {
+				const RAW_INPUT &rawInput = a_rawInputs[j];
+				if (rawInput.event.type != event.type || rawInput.event.messageID != event.messageID ||
+					rawInput.event.modifiers != event.modifiers) {
+					return false;
+				}
+				delta += rawInput.event.delta;
+
+				if (INPUT_POINTER_MOVE == event.type) {
+					for (const INPUT_POINT &point : rawInput.history) {
+						if (pointIndex >= a_batch.points.size() || !IsEqual(a_batch.points[pointIndex++], point)) {
+							return false;
+						}
+					}
+					const INPUT_POINT point = { rawInput.event.x, rawInput.event.y, rawInput.event.time };
+					if (pointIndex >= a_batch.points.size() || !IsEqual(a_batch.points[pointIndex++], point)) {
+						return false;
+					}
+				}
+			}
+			rawIndex += event.coalescedCount;
+
+			const INPUT_EVENT &lastEvent = a_rawInputs[rawIndex - 1].event;
+			if (event.wordParam != lastEvent.wordParam || event.longParam != lastEvent.longParam || event.time != lastEvent.time ||
+				event.x != lastEvent.x || event.y != lastEvent.y) {
+				return false;
+			}
+			if (event.delta != (INPUT_WHEEL == event.type ? delta : lastEvent.delta)) {
+				return false;
+			}
+			if (pointIndex - event.historyIndex != event.historyCount || (INPUT_POINTER_MOVE != event.type && event.historyCount)) {
+				return false;
+			}
+			pointCount += event.historyCount;
+		}
+
+		return rawIndex == a_rawInputs.size() && pointCount == a_batch.points.size();
+	}
+
+	RAW_INPUT CreateRawInput(std::mt19937 &a_random, const unsigned long long a_time)
+	{
+		RAW_INPUT rawInput = {};
+		INPUT_EVENT &event = rawInput.event;
+		const unsigned int kind = a_random() % 10;
+		// the moves and the wheels come in runs which a button or a modifier breaks
+		event.type = kind < 5 ? INPUT_POINTER_MOVE : (kind < 7 ? INPUT_WHEEL : (kind < 8 ? INPUT_RESIZE : INPUT_OTHER));
+		event.messageID = INPUT_WHEEL == event.type ? 0x020A + a_random() % 2 * 4 : static_cast<unsigned int>(event.type) * 16 + a_random() % 2;
+		event.modifiers = 0 == a_random() % 8 ? 1 : 0;
+		event.wordParam = a_random();
+		event.longParam = static_cast<long long>(a_random()) - 0x7FFFFFFF;
+		event.time = a_time;
+		event.x = static_cast<float>(a_random() % 2000);
+		event.y = static_cast<float>(a_random() % 2000);
+		event.delta = INPUT_WHEEL == event.type ? static_cast<int>(a_random() % 241) - 120 : static_cast<int>(a_random() % 5);
+		// the queue sets these, the values of the caller don't matter
+		event.coalescedCount = a_random();
+		event.historyIndex = a_random();
+		event.historyCount = a_random();
+
+		if (INPUT_POINTER_MOVE == event.type) {
+			const unsigned int historyCount = a_random() % 4;
+			for (unsigned int i = 0; i < historyCount; i++) {
+				rawInput.history.push_back(INPUT_POINT({
+					static_cast<float>(a_random() % 2000), static_cast<float>(a_random() % 2000), a_time - historyCount + i
+				}));
+			}
+		}
+		return rawInput;
+	}
+}
+
+// pushes random streams of events and checks every batch against the raw events which it was made of
+int main()
+{
+	for (unsigned int seed = 1; seed <= 200; seed++) {
+		std::mt19937 random(seed);
+		InputQueue queue;
+		INPUT_BATCH batch;
+		batch.rawCount = 0;
+		std::vector<RAW_INPUT> rawInputs;
+
+		unsigned long long rawCount = 0;
+		unsigned long long deliveredCount = 0;
+		unsigned long long time = 1000;
+		bool isValid = true;
+		for (unsigned int frame = 0; frame < 50 && isValid; frame++) {
+			rawInputs.clear();
+			const unsigned int eventCount = random() % 40;
+			for (unsigned int i = 0; i < eventCount; i++) {
+				time += 1 + random() % 500;
+				rawInputs.push_back(CreateRawInput(random, time));
+				const RAW_INPUT &rawInput = rawInputs.back();
+				queue.Push(rawInput.event, rawInput.history.data(), static_cast<unsigned int>(rawInput.history.size()));
+			}
+			rawCount += eventCount;
+			CHECK(queue.IsEmpty() == (0 == eventCount));
+
+			// the storage of the previous batch is handed back to the queue
+			queue.TakeBatch(batch);
+			deliveredCount += batch.events.size();
+			isValid = IsBatchValid(batch, rawInputs) && queue.IsEmpty();
+			isValid = isValid && rawCount == queue.GetRawCount() && deliveredCount == queue.GetDeliveredCount();
+		}
+		CHECK(isValid);
+	}
+
+	return GetCheckResult();
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "Check.h"
+#include "MessageDispatchTable.h"
+#include <random>
+#include <unordered_map>
+
+namespace
+{
+	// the handlers are addresses of this array
+	int g_handlerTargets[64];
+
+	typedef const int *Handler;
+
+	// compares every ID which the test can use with the reference map
+	template<class Table>
+	bool IsEqual(const Table &a_table, const std::unordered_map<unsigned int, Handler> &a_reference, const unsigned int *const ap_ids, const size_t a_idCount)
+	{
+		if (a_table.GetCount() != a_reference.size()) {
+			return false;
+		}
+		for (size_t i = 0; i < a_idCount; i++) {
+			auto entry = a_reference.find(ap_ids[i]);
+			if (a_table.Get(ap_ids[i]) != (a_reference.end() == entry ? nullptr : entry->second)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void TestDenseAndSparse()
+	{
+		MessageDispatchTable<Handler> table;
+		CHECK(nullptr == table.Get(0x0200) && nullptr == table.Get(0xC123));
+
+		table.Set(0x0200, &g_handlerTargets[0]);
+		table.Set(0x0400, &g_handlerTargets[1]);
+		table.Set(0xC123, &g_handlerTargets[2]);
+		CHECK(3 == table.GetCount());
+		CHECK(&g_handlerTargets[0] == table.Get(0x0200));
+		CHECK(&g_handlerTargets[1] == table.Get(0x0400));
+		CHECK(&g_handlerTargets[2] == table.Get(0xC123));
+
+		// replacing a handler doesn't count the ID again, a nullptr handler removes it
+		table.Set(0xC123, &g_handlerTargets[3]);
+		CHECK(3 == table.GetCount() && &g_handlerTargets[3] == table.Get(0xC123));
+		table.Set(0x0200, nullptr);
+		table.Remove(0x0400);
+		table.Remove(0x0401);
+		CHECK(1 == table.GetCount());
+		CHECK(nullptr == table.Get(0x0200) && nullptr == table.Get(0x0400));
+	}
+
+	// the IDs are chosen from a few clusters, so the probe sequences of the sparse table overlap
+	// and `Remove` has to shift the entries back across the end of the table
+	template<unsigned int DenseCount>
+	void TestRandomOperations(const unsigned int a_seed)
+	{
+		std::mt19937 random(a_seed);
+		unsigned int ids[256];
+		for (unsigned int i = 0; i < 256; i++) {
+			const unsigned int cluster = i % 4;
+			ids[i] = 0 == cluster ? i : (1 == cluster ? 0x0400 + i : (2 == cluster ? 0x8000 + i : 0xC000 + i * 7));
+		}
+
+		MessageDispatchTable<Handler, DenseCount> table;
+		std::unordered_map<unsigned int, Handler> reference;
+		bool isEqual = true;
+		for (unsigned int step = 0; step < 20000 && isEqual; step++) {
+			// the size drifts up and down, so the table grows and is emptied again
+			const unsigned int idCount = 16 + (step / 2000 % 2 ? 240 : 48);
+			const unsigned int id = ids[random() % idCount];
+			const unsigned int operation = random() % 10;
+			if (operation < 5) {
+				const Handler handler = &g_handlerTargets[random() % 64];
+				table.Set(id, handler);
+				reference[id] = handler;
+			}
+			else if (operation < 9) {
+				table.Remove(id);
+				reference.erase(id);
+			}
+			else {
+				table.Set(id, nullptr);
+				reference.erase(id);
+			}
+
+			auto entry = reference.find(id);
+			isEqual = table.Get(id) == (reference.end() == entry ? nullptr : entry->second);
+			if (0 == step % 64) {
+				isEqual = isEqual && IsEqual(table, reference, ids, 256);
+			}
+		}
+		CHECK(isEqual);
+		CHECK(IsEqual(table, reference, ids, 256));
+
+		// every entry can be removed and the table is empty afterwards
+		for (unsigned int i = 0; i < 256; i++) {
+			table.Remove(ids[i]);
+		}
+		CHECK(0 == table.GetCount());
+		reference.clear();
+		CHECK(IsEqual(table, reference, ids, 256));
+	}
+}
+
+int main()
+{
+	TestDenseAndSparse();
+	for (unsigned int seed = 1; seed <= 8; seed++) {
+		TestRandomOperations<0x0400>(seed);
+		// without a dense array every ID is in the sparse table
+		TestRandomOperations<1>(seed);
+	}
+
+	return GetCheckResult();
+}
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include "Check.h"
+#include "PixelCompositor.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+	const COMPOSITE_KERNEL KERNELS[] = { COMPOSITE_KERNEL_SCALAR, COMPOSITE_KERNEL_SSE2, COMPOSITE_KERNEL_AVX2 };
+
+	unsigned int Round255(const unsigned int a_value)
+	{
+		return static_cast<unsigned int>(std::lround(a_value / 255.0));
+	}
+
+	// a premultiplied pixel of an alpha whose colors are 0, the alpha and a random value between them
+	unsigned int MakePixel(const unsigned int a_alpha, std::mt19937 &a_random)
+	{
+		const unsigned int color = a_random() % (a_alpha + 1);
+		return a_alpha << 24 | color << 16 | a_alpha << 8;
+	}
+
+	unsigned int ScaleReference(const unsigned int a_pixel, const unsigned int a_scale)
+	{
+		unsigned int pixel = 0;
+		for (unsigned int shift = 0; shift < 32; shift += 8) {
+			pixel |= Round255((a_pixel >> shift & 0xFF) * a_scale) << shift;
+		}
+		return pixel;
+	}
+
+	unsigned int BlendReference(const unsigned int a_target, const unsigned int a_source)
+	{
+		unsigned int pixel = 0;
+		for (unsigned int shift = 0; shift < 32; shift += 8) {
+			const unsigned int value = (a_source >> shift & 0xFF) + Round255((a_target >> shift & 0xFF) * (255 - (a_source >> 24)));
+			pixel |= (value < 255 ? value : 255) << shift;
+		}
+		return pixel;
+	}
+
+	// every pair of a source alpha and a mask value, pixel i has the alpha i / 256 and the mask i % 256.
+	// the rows are split at odd offsets, so each kernel runs its vectors and its scalar tail
+	void TestMaskedBlending()
+	{
+		std::mt19937 random(1);
+		const unsigned int COUNT = 256 * 256;
+		std::vector<unsigned int> sources(COUNT);
+		std::vector<unsigned int> targets(COUNT);
+		std::vector<unsigned char> mask(COUNT);
+		for (unsigned int i = 0; i < COUNT; i++) {
+			sources[i] = MakePixel(i / 256, random);
+			targets[i] = MakePixel(random() % 256, random);
+			mask[i] = static_cast<unsigned char>(i % 256);
+		}
+
+		std::vector<unsigned int> expectedBlend(COUNT);
+		std::vector<unsigned int> expectedMask(COUNT);
+		for (unsigned int i = 0; i < COUNT; i++) {
+			expectedBlend[i] = BlendReference(targets[i], ScaleReference(sources[i], mask[i]));
+			expectedMask[i] = ScaleReference(sources[i], mask[i]);
+		}
+
+		for (const COMPOSITE_KERNEL kernel : KERNELS) {
+			PixelCompositor compositor;
+			compositor.SetKernel(kernel);
+
+			std::vector<unsigned int> pixels = targets;
+			for (unsigned int first = 0, length = 1; first < COUNT; first += length, length = length * 3 % 61 + 1) {
+				const unsigned int count = first + length < COUNT ? length : COUNT - first;
+				compositor.BlendOver(pixels.data() + first, sources.data() + first, mask.data() + first, count);
+			}
+			CHECK(expectedBlend == pixels);
+
+			pixels = sources;
+			compositor.ApplyMask(pixels.data() + 1, mask.data() + 1, COUNT - 1);
+			CHECK(expectedMask == pixels);
+
+			// a span of each pixel alpha over every mask value
+			pixels = targets;
+			bool isFillExact = true;
+			for (unsigned int alpha = 0; alpha < 256; alpha++) {
+				const unsigned int pixel = sources[alpha * 256];
+				compositor.FillSpan(pixels.data() + alpha * 256, pixel, mask.data() + alpha * 256, 256);
+				for (unsigned int i = alpha * 256; i < alpha * 256 + 256; i++) {
+					isFillExact = isFillExact && BlendReference(targets[i], ScaleReference(pixel, mask[i])) == pixels[i];
+				}
+			}
+			CHECK(isFillExact);
+		}
+	}
+
+	// every pair of a source alpha and a target alpha
+	void TestBlending()
+	{
+		std::mt19937 random(2);
+		const unsigned int COUNT = 256 * 256;
+		std::vector<unsigned int> sources(COUNT);
+		std::vector<unsigned int> targets(COUNT);
+		std::vector<unsigned int> expectedPixels(COUNT);
+		for (unsigned int i = 0; i < COUNT; i++) {
+			sources[i] = MakePixel(i / 256, random);
+			targets[i] = MakePixel(i % 256, random);
+			expectedPixels[i] = BlendReference(targets[i], sources[i]);
+		}
+
+		std::vector<unsigned int> scalarLinearPixels;
+		for (const COMPOSITE_KERNEL kernel : KERNELS) {
+			PixelCompositor compositor;
+			compositor.SetKernel(kernel);
+
+			std::vector<unsigned int> pixels = targets;
+			compositor.BlendOver(pixels.data(), sources.data(), 7);
+			compositor.BlendOver(pixels.data() + 7, sources.data() + 7, COUNT - 7);
+			CHECK(expectedPixels == pixels);
+
+			bool isFillExact = true;
+			for (unsigned int alpha = 0; alpha < 256; alpha++) {
+				pixels.assign(targets.begin() + alpha * 256, targets.begin() + alpha * 256 + 256);
+				compositor.FillSpan(pixels.data(), sources[alpha * 256], 255);
+				for (unsigned int i = 0; i < 255; i++) {
+					isFillExact = isFillExact && BlendReference(targets[alpha * 256 + i], sources[alpha * 256]) == pixels[i];
+				}
+			}
+			CHECK(isFillExact);
+
+			// the linear blending has no closed reference, the kernels return the pixels of the scalar code
+			pixels = targets;
+			compositor.BlendOverLinear(pixels.data() + 3, sources.data() + 3, COUNT - 3);
+			compositor.BlendOverLinear(pixels.data(), sources.data(), 3);
+			if (COMPOSITE_KERNEL_SCALAR == kernel) {
+				scalarLinearPixels = pixels;
+			}
+			CHECK(scalarLinearPixels == pixels);
+		}
+
+		// an opaque source replaces the target and a transparent one keeps it
+		PixelCompositor compositor;
+		bool isLinearExact = true;
+		for (unsigned int i = 0; i < 256; i++) {
+			const unsigned int opaqueSource = 0xFF000000 | (random() & 0x00FFFFFF);
+			const unsigned int transparentSource = 0;
+			unsigned int pixel = targets[i * 255];
+			compositor.BlendOverLinear(&pixel, &opaqueSource, 1);
+			isLinearExact = isLinearExact && opaqueSource == pixel;
+			pixel = targets[i * 255];
+			compositor.BlendOverLinear(&pixel, &transparentSource, 1);
+			isLinearExact = isLinearExact && targets[i * 255] == pixel;
+		}
+		CHECK(isLinearExact);
+	}
+
+	// every pair of an alpha and a color
+	void TestPremultiplying()
+	{
+		const unsigned int COUNT = 256 * 256;
+		std::vector<unsigned int> straightPixels(COUNT);
+		std::vector<unsigned int> premultipliedPixels(COUNT);
+		std::vector<unsigned int> expectedPremultiplied(COUNT);
+		std::vector<unsigned int> expectedStraight(COUNT);
+		for (unsigned int i = 0; i < COUNT; i++) {
+			const unsigned int alpha = i / 256;
+			const unsigned int color = i % 256;
+			straightPixels[i] = alpha << 24 | color << 16 | (255 - color) << 8 | color / 2;
+			expectedPremultiplied[i] = alpha << 24 | ScaleReference(straightPixels[i] & 0x00FFFFFF, alpha);
+
+			// a color above its alpha becomes 255
+			premultipliedPixels[i] = alpha << 24 | color << 16 | (color < alpha ? color : alpha) << 8;
+			expectedStraight[i] = alpha << 24;
+			if (alpha) {
+				for (unsigned int shift = 8; shift < 24; shift += 8) {
+					const unsigned int value = static_cast<unsigned int>(std::lround((premultipliedPixels[i] >> shift & 0xFF) * 255.0 / alpha));
+					expectedStraight[i] |= (value < 255 ? value : 255) << shift;
+				}
+			}
+		}
+
+		for (const COMPOSITE_KERNEL kernel : KERNELS) {
+			PixelCompositor compositor;
+			compositor.SetKernel(kernel);
+
+			std::vector<unsigned int> pixels = straightPixels;
+			compositor.Premultiply(pixels.data() + 5, COUNT - 5);
+			compositor.Premultiply(pixels.data(), 5);
+			CHECK(expectedPremultiplied == pixels);
+
+			pixels = premultipliedPixels;
+			compositor.Unpremultiply(pixels.data() + 5, COUNT - 5);
+			compositor.Unpremultiply(pixels.data(), 5);
+			CHECK(expectedStraight == pixels);
+
+			// a valid premultiplied pixel survives a round trip
+			bool isRoundTripExact = true;
+			for (unsigned int i = 0; i < COUNT; i++) {
+				const unsigned int alpha = i / 256;
+				if (i % 256 <= alpha) {
+					compositor.Premultiply(&pixels[i], 1);
+					isRoundTripExact = isRoundTripExact && premultipliedPixels[i] == pixels[i];
+				}
+			}
+			CHECK(isRoundTripExact);
+		}
+	}
+}
+
+int main()
+{
+	TestMaskedBlending();
+	TestBlending();
+	TestPremultiplying();
+
+	return GetCheckResult();
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include "Check.h"
+#include "ResizeThrottle.h"
+#include <random>
+
+namespace
+{
+	void TestImmediateResize()
+	{
+		ResizeThrottle throttle(1000);
+		for (unsigned int i = 0; i < 10; i++) {
+			CHECK(throttle.Request(100 + i, 50, 10));
+			CHECK(100 + i == throttle.GetWidth() && 50 == throttle.GetHeight());
+		}
+		const RESIZE_STATISTICS &statistics = throttle.GetStatistics();
+		CHECK(10 == statistics.requestCount && 10 == statistics.appliedCount && 0 == statistics.droppedCount);
+	}
+
+	void TestLiveResize()
+	{
+		ResizeThrottle throttle(1000);
+		throttle.BeginLiveResize();
+		CHECK(throttle.Request(10, 10, 5000));
+		CHECK(!throttle.Request(11, 10, 5100));
+		CHECK(!throttle.Request(12, 10, 5200));
+		CHECK(1 == throttle.GetStatistics().droppedCount);
+
+		// the interval has passed, so the waiting size is replaced by the new one
+		CHECK(throttle.Request(13, 10, 6000));
+		CHECK(13 == throttle.GetWidth());
+		CHECK(2 == throttle.GetStatistics().droppedCount);
+
+		CHECK(!throttle.Request(14, 10, 6100));
+		CHECK(!throttle.Poll(6500));
+		CHECK(throttle.Poll(7000));
+		CHECK(14 == throttle.GetWidth());
+		CHECK(!throttle.Poll(9000));
+
+		CHECK(!throttle.Request(15, 10, 7100));
+		CHECK(throttle.EndLiveResize(7200));
+		CHECK(15 == throttle.GetWidth());
+		CHECK(!throttle.IsLiveResize());
+
+		const RESIZE_STATISTICS &statistics = throttle.GetStatistics();
+		CHECK(6 == statistics.requestCount && 4 == statistics.appliedCount && 2 == statistics.droppedCount);
+	}
+
+	// every reported size is either applied or replaced by a newer one, and the last one is always applied
+	void TestRandomResize()
+	{
+		std::mt19937 random(3);
+		for (unsigned int run = 0; run < 50; run++) {
+			ResizeThrottle throttle(1000 + random() % 30000);
+			unsigned long long time = 1000000;
+			unsigned int lastWidth = 0;
+			for (unsigned int i = 0; i < 1000; i++) {
+				time += random() % 5000;
+				const unsigned int kind = random() % 16;
+				if (0 == kind) {
+					throttle.BeginLiveResize();
+				}
+				else if (1 == kind) {
+					throttle.EndLiveResize(time);
+				}
+				else if (kind < 4) {
+					throttle.Poll(time);
+				}
+				else {
+					lastWidth = 1 + random() % 2000;
+					throttle.Request(lastWidth, 100, time);
+				}
+			}
+			throttle.EndLiveResize(time);
+
+			const RESIZE_STATISTICS &statistics = throttle.GetStatistics();
+			CHECK(statistics.requestCount == statistics.appliedCount + statistics.droppedCount);
+			CHECK(lastWidth == throttle.GetWidth());
+		}
+	}
+}
+
+int main()
+{
+	TestImmediateResize();
+	TestLiveResize();
+	TestRandomResize();
+
+	return GetCheckResult();
+}
\ No newline at end of file
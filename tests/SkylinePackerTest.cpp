@@ -0,0 +1,107 @@
+#include "Check.h"
+#include "SkylinePacker.h"
+#include <random>
+#include <vector>
+
+namespace
+{
+	struct PACKED_RECT
+	{
+		int x;
+		int y;
+		int width;
+		int height;
+	};
+
+	// returns whether every rectangle lies inside the area and no pixel is covered twice
+	bool IsPackingValid(const std::vector<PACKED_RECT> &a_rects, const int a_width, const int a_height)
+	{
+		std::vector<unsigned char> coverage(static_cast<size_t>(a_width) * a_height, 0);
+		for (const PACKED_RECT &rect : a_rects) {
+			if (rect.x < 0 || rect.y < 0 || rect.x + rect.width > a_width || rect.y + rect.height > a_height) {
+				return false;
+			}
+			for (int y = rect.y; y < rect.y + rect.height; y++) {
+				for (int x = rect.x; x < rect.x + rect.width; x++) {
+					unsigned char &pixel = coverage[static_cast<size_t>(y) * a_width + x];
+					if (pixel) {
+						return false;
+					}
+					pixel = 1;
+				}
+			}
+		}
+		return true;
+	}
+
+	void TestExactFit()
+	{
+		SkylinePacker packer(64, 64);
+		std::vector<PACKED_RECT> rects;
+		int x = 0;
+		int y = 0;
+		for (int i = 0; i < 16; i++) {
+			CHECK(packer.Insert(16, 16, x, y));
+			rects.push_back({ x, y, 16, 16 });
+		}
+		CHECK(IsPackingValid(rects, 64, 64));
+		CHECK(16 == packer.GetRectCount());
+		CHECK(1.0f == packer.GetOccupancy());
+		// the area is full
+		CHECK(!packer.Insert(1, 1, x, y));
+
+		packer.Reset();
+		CHECK(0 == packer.GetRectCount() && 0 == packer.GetUsedArea());
+		CHECK(packer.Insert(64, 64, x, y) && 0 == x && 0 == y);
+	}
+
+	void TestInvalidSizes()
+	{
+		SkylinePacker packer(32, 32);
+		int x = 0;
+		int y = 0;
+		CHECK(!packer.Insert(0, 4, x, y));
+		CHECK(!packer.Insert(4, -1, x, y));
+		CHECK(!packer.Insert(33, 4, x, y));
+		CHECK(!packer.Insert(4, 33, x, y));
+		CHECK(0 == packer.GetRectCount());
+	}
+
+	void TestRandomRects()
+	{
+		std::mt19937 random(11);
+		for (int run = 0; run < 20; run++) {
+			const int width = 64 + static_cast<int>(random() % 192);
+			const int height = 64 + static_cast<int>(random() % 192);
+			SkylinePacker packer(width, height);
+
+			std::vector<PACKED_RECT> rects;
+			unsigned long long area = 0;
+			for (int i = 0; i < 2000; i++) {
+				const int rectWidth = 1 + static_cast<int>(random() % 24);
+				const int rectHeight = 1 + static_cast<int>(random() % 24);
+				int x = 0;
+				int y = 0;
+				if (packer.Insert(rectWidth, rectHeight, x, y)) {
+					rects.push_back({ x, y, rectWidth, rectHeight });
+					area += static_cast<unsigned long long>(rectWidth) * rectHeight;
+				}
+			}
+
+			CHECK(IsPackingValid(rects, width, height));
+			CHECK(rects.size() == packer.GetRectCount());
+			CHECK(area == packer.GetUsedArea());
+			// glyph-like rectangles leave little waste
+			CHECK(packer.GetOccupancy() > 0.7f);
+		}
+	}
+}
+
+int main()
+{
+	TestExactFit();
+	TestInvalidSizes();
+	TestRandomRects();
+
+	return GetCheckResult();
+}
\ No newline at end of file
@@ -0,0 +1,281 @@
+#include "Check.h"
+#include "SoftwareRasterizer.h"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+	const int VIEW_WIDTH = 128;
+	const int VIEW_HEIGHT = 128;
+	const RColor WHITE = { 1.0f, 1.0f, 1.0f, 1.0f };
+	const RColor TRANSPARENT_BLACK = { 0.0f, 0.0f, 0.0f, 0.0f };
+	const float PI = 3.14159265358979f;
+
+	unsigned int GetPixel(SoftwareRasterizer &a_rasterizer, const int a_x, const int a_y)
+	{
+		return a_rasterizer.GetPixels()[a_y * a_rasterizer.GetStride() + a_x];
+	}
+
+	// the coverage of opaque white over transparent black
+	unsigned int GetAlpha(SoftwareRasterizer &a_rasterizer, const int a_x, const int a_y)
+	{
+		return GetPixel(a_rasterizer, a_x, a_y) >> 24;
+	}
+
+	// the covered area in pixels
+	double GetCoveredArea(SoftwareRasterizer &a_rasterizer)
+	{
+		double area = 0.0;
+		for (int y = 0; y < a_rasterizer.GetHeight(); y++) {
+			for (int x = 0; x < a_rasterizer.GetWidth(); x++) {
+				area += GetAlpha(a_rasterizer, x, y) / 255.0;
+			}
+		}
+		return area;
+	}
+
+	bool IsNear(const unsigned int a_value, const unsigned int a_expected, const unsigned int a_tolerance = 1)
+	{
+		return static_cast<unsigned int>(std::abs(static_cast<int>(a_value) - static_cast<int>(a_expected))) <= a_tolerance;
+	}
+
+	void Reset(SoftwareRasterizer &a_rasterizer)
+	{
+		a_rasterizer.SetLimitRect(0, 0, a_rasterizer.GetWidth(), a_rasterizer.GetHeight());
+		a_rasterizer.Clear(TRANSPARENT_BLACK);
+		a_rasterizer.SetColor(WHITE);
+		a_rasterizer.SetStrokeWidth(1.0f);
+		a_rasterizer.SetTransform(IdentityMatrix());
+		a_rasterizer.SetTolerance(0.25f);
+	}
+
+	// a rectangle on pixel borders covers its pixels exactly. the partial pixels at fractional borders are covered
+	// by the part of them inside, both for the axis-aligned fill and for a polygon
+	void TestRectangle()
+	{
+		SoftwareRasterizer rasterizer(VIEW_WIDTH, VIEW_HEIGHT);
+		Reset(rasterizer);
+		rasterizer.FillRectangle({ 10.0f, 20.0f, 30.0f, 25.0f });
+		CHECK(0xFFFFFFFF == GetPixel(rasterizer, 10, 20));
+		CHECK(0xFFFFFFFF == GetPixel(rasterizer, 29, 24));
+		CHECK(0 == GetPixel(rasterizer, 9, 20) && 0 == GetPixel(rasterizer, 30, 24));
+		CHECK(0 == GetPixel(rasterizer, 10, 19) && 0 == GetPixel(rasterizer, 29, 25));
+		CHECK(100.0 == GetCoveredArea(rasterizer));
+
+		const RRect rect = { 10.25f, 40.5f, 30.75f, 45.0f };
+		const RPoint points[] = { { rect.left, rect.top }, { rect.right, rect.top }, { rect.right, rect.bottom }, { rect.left, rect.bottom } };
+		const unsigned int contourSize = 4;
+		for (unsigned int i = 0; i < 2; i++) {
+			Reset(rasterizer);
+			if (0 == i) {
+				rasterizer.FillRectangle(rect);
+			}
+			else {
+				rasterizer.FillPolygon(points, &contourSize, 1);
+			}
+			CHECK(IsNear(GetAlpha(rasterizer, 10, 42), 191));
+			CHECK(IsNear(GetAlpha(rasterizer, 30, 42), 191));
+			CHECK(IsNear(GetAlpha(rasterizer, 20, 40), 128));
+			CHECK(IsNear(GetAlpha(rasterizer, 10, 40), 96));
+			CHECK(IsNear(GetAlpha(rasterizer, 30, 40), 96));
+			CHECK(255 == GetAlpha(rasterizer, 11, 41) && 255 == GetAlpha(rasterizer, 29, 44));
+			CHECK(0 == GetAlpha(rasterizer, 9, 42) && 0 == GetAlpha(rasterizer, 31, 42) && 0 == GetAlpha(rasterizer, 20, 45));
+			CHECK(std::fabs(GetCoveredArea(rasterizer) - 20.5 * 4.5) < 0.1);
+		}
+
+		// a stroked rectangle covers its border with round outer corners
+		Reset(rasterizer);
+		rasterizer.SetStrokeWidth(4.0f);
+		rasterizer.DrawRectangle({ 20.0f, 20.0f, 60.0f, 50.0f });
+		CHECK(255 == GetAlpha(rasterizer, 18, 30) && 255 == GetAlpha(rasterizer, 21, 30));
+		CHECK(0 == GetAlpha(rasterizer, 17, 30) && 0 == GetAlpha(rasterizer, 22, 30) && 0 == GetAlpha(rasterizer, 40, 35));
+		CHECK(255 == GetAlpha(rasterizer, 20, 20));
+		CHECK(GetAlpha(rasterizer, 18, 18) < 255);
+		const double borderArea = 44.0 * 34.0 - 36.0 * 26.0 - (4.0 - PI) * 4.0;
+		CHECK(std::fabs(GetCoveredArea(rasterizer) - borderArea) < borderArea * 0.005);
+	}
+
+	// the lines end in round caps and the segments of a polyline meet in round joins
+	void TestCapsAndJoins()
+	{
+		SoftwareRasterizer rasterizer(VIEW_WIDTH, VIEW_HEIGHT);
+		Reset(rasterizer);
+		rasterizer.SetTolerance(0.02f);
+		rasterizer.SetStrokeWidth(10.0f);
+		rasterizer.DrawLine({ 20.0f, 20.0f }, { 60.0f, 20.0f });
+
+		CHECK(255 == GetAlpha(rasterizer, 40, 15) && 255 == GetAlpha(rasterizer, 40, 24));
+		CHECK(0 == GetAlpha(rasterizer, 40, 14) && 0 == GetAlpha(rasterizer, 40, 25));
+		// the caps reach the length of the half width beyond the ends, but not into the corners of a square cap
+		CHECK(255 == GetAlpha(rasterizer, 62, 19) && 255 == GetAlpha(rasterizer, 17, 20));
+		CHECK(GetAlpha(rasterizer, 64, 19) > 0 && GetAlpha(rasterizer, 16, 20) > 0);
+		CHECK(0 == GetAlpha(rasterizer, 65, 19) && 0 == GetAlpha(rasterizer, 14, 20));
+		CHECK(0 == GetAlpha(rasterizer, 64, 15) && 0 == GetAlpha(rasterizer, 64, 24));
+		CHECK(0 == GetAlpha(rasterizer, 15, 15) && 0 == GetAlpha(rasterizer, 15, 24));
+		CHECK(std::fabs(GetCoveredArea(rasterizer) - (40.0 * 10.0 + PI * 25.0)) < 0.5);
+
+		// a right angle. the outer corner of a miter join stays empty
+		Reset(rasterizer);
+		rasterizer.SetTolerance(0.02f);
+		rasterizer.SetStrokeWidth(10.0f);
+		const RPoint points[] = { { 20.0f, 60.0f }, { 60.0f, 60.0f }, { 60.0f, 100.0f } };
+		const unsigned int contourSize = 3;
+		rasterizer.DrawPolyline(points, &contourSize, 1);
+		CHECK(0 == GetAlpha(rasterizer, 64, 55));
+		CHECK(255 == GetAlpha(rasterizer, 62, 57) && 255 == GetAlpha(rasterizer, 56, 64) && 255 == GetAlpha(rasterizer, 60, 60));
+		CHECK(0 == GetAlpha(rasterizer, 54, 66));
+		// the overlapping caps don't cancel each other, and the area of the union is covered
+		const double polylineArea = 40.0 * 10.0 * 2.0 - 25.0 + PI * 25.0 * 1.25;
+		CHECK(std::fabs(GetCoveredArea(rasterizer) - polylineArea) < polylineArea * 0.01);
+
+		// a polyline of a single point is a dot. its polygon is inside the circle by up to the tolerance
+		Reset(rasterizer);
+		rasterizer.SetTolerance(0.02f);
+		rasterizer.SetStrokeWidth(6.0f);
+		const unsigned int dotSize = 1;
+		rasterizer.DrawPolyline(points, &dotSize, 1);
+		CHECK(std::fabs(GetCoveredArea(rasterizer) - PI * 9.0) < PI * 9.0 * 0.015);
+		CHECK(255 == GetAlpha(rasterizer, 20, 60) && 0 == GetAlpha(rasterizer, 23, 63));
+	}
+
+	// a filled ellipse covers its area, and the ring of a stroked one the area between the outer and the inner ellipse
+	void TestEllipse()
+	{
+		SoftwareRasterizer rasterizer(VIEW_WIDTH, VIEW_HEIGHT);
+		Reset(rasterizer);
+		rasterizer.SetTolerance(0.02f);
+		rasterizer.FillEllipse({ 20.0f, 30.0f, 80.0f, 70.0f });
+		const double area = PI * 30.0 * 20.0;
+		CHECK(std::fabs(GetCoveredArea(rasterizer) - area) < area * 0.002);
+		CHECK(255 == GetAlpha(rasterizer, 50, 50) && 255 == GetAlpha(rasterizer, 21, 49) && 255 == GetAlpha(rasterizer, 49, 31));
+		CHECK(0 == GetAlpha(rasterizer, 19, 50) && 0 == GetAlpha(rasterizer, 80, 50) && 0 == GetAlpha(rasterizer, 50, 29));
+		CHECK(0 == GetAlpha(rasterizer, 22, 32) && 0 == GetAlpha(rasterizer, 77, 67));
+		// the ellipse is symmetric around its center
+		for (int y = 30; y < 70; y++) {
+			for (int x = 20; x < 50; x++) {
+				CHECK(IsNear(GetAlpha(rasterizer, x, y), GetAlpha(rasterizer, 99 - x, y), 2));
+				CHECK(IsNear(GetAlpha(rasterizer, x, y), GetAlpha(rasterizer, x, 99 - y), 2));
+			}
+		}
+
+		Reset(rasterizer);
+		rasterizer.SetTolerance(0.02f);
+		rasterizer.SetStrokeWidth(4.0f);
+		rasterizer.DrawEllipse({ 20.0f, 30.0f, 80.0f, 70.0f });
+		const double ringArea = PI * (32.0 * 22.0 - 28.0 * 18.0);
+		CHECK(std::fabs(GetCoveredArea(rasterizer) - ringArea) < ringArea * 0.005);
+		CHECK(0 == GetAlpha(rasterizer, 50, 50) && 255 == GetAlpha(rasterizer, 50, 30) && 255 == GetAlpha(rasterizer, 19, 50));
+	}
+
+	// nothing is drawn outside of the clip rectangle and the limit rectangle. inside the clip the pixels are the same
+	// as without it, also when the shapes cross its sides
+	void TestClip()
+	{
+		SoftwareRasterizer rasterizer(VIEW_WIDTH, VIEW_HEIGHT);
+		SoftwareRasterizer clippedRasterizer(VIEW_WIDTH, VIEW_HEIGHT);
+		const RColor background = { 0.0f, 0.0f, 1.0f, 1.0f };
+		const unsigned int backgroundPixel = 0xFF0000FF;
+		auto drawShapes = [](SoftwareRasterizer &a_rasterizer) {
+			a_rasterizer.SetColor({ 1.0f, 0.5f, 0.0f, 0.75f });
+			a_rasterizer.FillEllipse({ 5.0f, 10.3f, 90.0f, 70.0f });
+			a_rasterizer.SetStrokeWidth(3.0f);
+			a_rasterizer.DrawLine({ -20.0f, 100.0f }, { 140.0f, 5.0f });
+			const RPoint points[] = { { 0.0f, 0.0f }, { 127.0f, 40.0f }, { 10.0f, 120.0f } };
+			const unsigned int contourSize = 3;
+			a_rasterizer.FillPolygon(points, &contourSize, 1);
+		};
+
+		Reset(rasterizer);
+		rasterizer.Clear(background);
+		drawShapes(rasterizer);
+
+		const int clipLeft = 30;
+		const int clipTop = 20;
+		const int clipRight = 71;
+		const int clipBottom = 60;
+		Reset(clippedRasterizer);
+		clippedRasterizer.Clear(background);
+		// the partially covered pixels of the rectangle are included
+		clippedRasterizer.SetClipRect(RRect({ 30.5f, 20.0f, 70.2f, 59.9f }));
+		drawShapes(clippedRasterizer);
+		for (int y = 0; y < VIEW_HEIGHT; y++) {
+			for (int x = 0; x < VIEW_WIDTH; x++) {
+				const bool isInside = x >= clipLeft && x < clipRight && y >= clipTop && y < clipBottom;
+				CHECK(GetPixel(clippedRasterizer, x, y) == (isInside ? GetPixel(rasterizer, x, y) : backgroundPixel));
+			}
+		}
+
+		// the limit bounds the clip rectangle and the clearing. the clips which don't overlap draw nothing
+		Reset(clippedRasterizer);
+		clippedRasterizer.SetLimitRect(64, 0, 200, 64);
+		clippedRasterizer.Clear(background);
+		clippedRasterizer.SetClipRect(0, 32, 96, 200);
+		clippedRasterizer.SetColor(WHITE);
+		clippedRasterizer.FillRectangle({ 0.0f, 0.0f, 128.0f, 128.0f });
+		clippedRasterizer.SetClipRect(RRect({ 10.0f, 10.0f, 5.0f, 20.0f }));
+		clippedRasterizer.SetColor({ 1.0f, 0.0f, 0.0f, 1.0f });
+		clippedRasterizer.FillRectangle({ 0.0f, 0.0f, 128.0f, 128.0f });
+		for (int y = 0; y < VIEW_HEIGHT; y++) {
+			for (int x = 0; x < VIEW_WIDTH; x++) {
+				const bool isLimited = x >= 64 && y < 64;
+				const bool isClipped = isLimited && x < 96 && y >= 32;
+				CHECK(GetPixel(clippedRasterizer, x, y) == (isClipped ? 0xFFFFFFFF : isLimited ? backgroundPixel : 0));
+			}
+		}
+	}
+
+	// the color is blended over the pixels as a premultiplied color, and the coverage scales all of its channels
+	void TestBlending()
+	{
+		SoftwareRasterizer rasterizer(VIEW_WIDTH, VIEW_HEIGHT);
+		Reset(rasterizer);
+		rasterizer.Clear({ 0.2f, 0.4f, 0.6f, 1.0f });
+		CHECK(0xFF336699 == GetPixel(rasterizer, 0, 0));
+
+		// a half transparent red over the opaque background, once fully and once half covered
+		rasterizer.SetColor({ 1.0f, 0.0f, 0.0f, 0.5f });
+		rasterizer.FillRectangle({ 10.0f, 10.0f, 20.0f, 20.0f });
+		rasterizer.FillRectangle({ 30.0f, 10.0f, 40.0f, 10.5f });
+		const unsigned int pixel = GetPixel(rasterizer, 15, 15);
+		CHECK(255 == pixel >> 24);
+		CHECK(IsNear((pixel >> 16) & 0xFF, 128 + 0x33 * 127 / 255));
+		CHECK(IsNear((pixel >> 8) & 0xFF, 0x66 * 127 / 255));
+		CHECK(IsNear(pixel & 0xFF, 0x99 * 127 / 255));
+		const unsigned int halfPixel = GetPixel(rasterizer, 35, 10);
+		CHECK(255 == halfPixel >> 24);
+		CHECK(IsNear((halfPixel >> 16) & 0xFF, 64 + 0x33 * 191 / 255));
+		CHECK(IsNear((halfPixel >> 8) & 0xFF, 0x66 * 191 / 255));
+		CHECK(IsNear(halfPixel & 0xFF, 0x99 * 191 / 255));
+
+		// over transparent black the premultiplied color itself is stored. the channels are clamped to [0, 1]
+		Reset(rasterizer);
+		rasterizer.SetColor({ 2.0f, 0.5f, -1.0f, 0.4f });
+		rasterizer.FillRectangle({ 10.0f, 10.0f, 20.0f, 20.0f });
+		rasterizer.FillRectangle({ 30.0f, 10.0f, 40.0f, 10.25f });
+		CHECK(0x66663300 == GetPixel(rasterizer, 15, 15));
+		const unsigned int quarterPixel = GetPixel(rasterizer, 35, 10);
+		CHECK(IsNear(quarterPixel >> 24, 26) && IsNear((quarterPixel >> 16) & 0xFF, 26));
+		CHECK(IsNear((quarterPixel >> 8) & 0xFF, 13) && 0 == (quarterPixel & 0xFF));
+		// every channel stays within the alpha
+		for (int x = 0; x < VIEW_WIDTH; x++) {
+			const unsigned int value = GetPixel(rasterizer, x, 10);
+			CHECK(((value >> 16) & 0xFF) <= value >> 24 && ((value >> 8) & 0xFF) <= value >> 24 && (value & 0xFF) <= value >> 24);
+		}
+
+		// opaque over anything replaces the pixels
+		rasterizer.SetColor({ 0.0f, 1.0f, 0.0f, 1.0f });
+		rasterizer.FillRectangle({ 0.0f, 0.0f, 128.0f, 128.0f });
+		CHECK(0xFF00FF00 == GetPixel(rasterizer, 15, 15) && 0xFF00FF00 == GetPixel(rasterizer, 127, 127));
+	}
+}
+
+int main()
+{
+	TestRectangle();
+	TestCapsAndJoins();
+	TestEllipse();
+	TestClip();
+	TestBlending();
+	return GetCheckResult();
+}
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include "Check.h"
+#include "TaskQueue.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// counts its destructions, so a task which is released twice or never shows up
+	struct TRACKER
+	{
+		unsigned int *p_destroyedCount;
+
+		~TRACKER()
+		{
+			(*p_destroyedCount)++;
+		}
+	};
+
+	struct TASK_RECORD
+	{
+		unsigned int producer;
+		unsigned int sequence;
+	};
+
+	// `Post` reports the queue as empty only for the first task after the queue has been drained
+	void TestEmptyTransition()
+	{
+		TaskQueue queue;
+		unsigned int runCount = 0;
+		CHECK(!queue.HasPendingTask());
+		CHECK(queue.Post([&runCount]() { runCount++; }));
+		CHECK(queue.HasPendingTask());
+		CHECK(!queue.Post([&runCount]() { runCount++; }));
+		CHECK(!queue.Post([&runCount]() { runCount++; }));
+		CHECK(0 == runCount);
+
+		CHECK(3 == queue.Drain());
+		CHECK(3 == runCount);
+		CHECK(!queue.HasPendingTask());
+		CHECK(0 == queue.Drain());
+
+		CHECK(queue.Post([&runCount]() { runCount++; }));
+		// a task which posts to its own queue doesn't find it empty, it runs in the same drain
+		CHECK(!queue.Post([&queue, &runCount]() {
+			runCount++;
+			queue.Post([&runCount]() { runCount++; });
+		}));
+		CHECK(3 == queue.Drain());
+		CHECK(6 == runCount);
+		CHECK(6 == queue.GetRunCount());
+		CHECK(queue.Post([]() {}));
+	}
+
+	// the tasks of every producer run in the order of posting while the consumer drains concurrently. none is lost or
+	// runs twice
+	void TestProducers()
+	{
+		const unsigned int PRODUCER_COUNT = 4;
+		const unsigned int TASK_COUNT = 50000;
+		TaskQueue queue;
+		std::vector<TASK_RECORD> records;
+		records.reserve(PRODUCER_COUNT * TASK_COUNT);
+		std::atomic<unsigned int> emptyCount = 0;
+		std::atomic<unsigned int> doneCount = 0;
+
+		std::vector<std::thread> producers;
+		for (unsigned int producer = 0; producer < PRODUCER_COUNT; producer++) {
+			producers.push_back(std::thread([&, producer]() {
+				for (unsigned int sequence = 0; sequence < TASK_COUNT; sequence++) {
+					if (queue.Post([&records, producer, sequence]() { records.push_back({ producer, sequence }); })) {
+						emptyCount++;
+					}
+					if (0 == sequence % 1024) {
+						std::this_thread::yield();
+					}
+				}
+				doneCount++;
+			}));
+		}
+
+		// a producer can be between raising the count and linking its task, then the drain ends early
+		while (doneCount < PRODUCER_COUNT || queue.HasPendingTask()) {
+			if (0 == queue.Drain()) {
+				std::this_thread::yield();
+			}
+		}
+		for (std::thread &producer : producers) {
+			producer.join();
+		}
+
+		CHECK(PRODUCER_COUNT * TASK_COUNT == records.size());
+		CHECK(records.size() == queue.GetRunCount());
+		std::vector<unsigned int> nextSequences(PRODUCER_COUNT, 0);
+		bool isOrdered = true;
+		for (const TASK_RECORD &record : records) {
+			isOrdered = isOrdered && record.producer < PRODUCER_COUNT && nextSequences[record.producer] == record.sequence;
+			if (record.producer < PRODUCER_COUNT) {
+				nextSequences[record.producer]++;
+			}
+		}
+		CHECK(isOrdered);
+		for (const unsigned int sequence : nextSequences) {
+			CHECK(TASK_COUNT == sequence);
+		}
+		// the consumer is woken at least once, and the drained queue is empty again
+		CHECK(emptyCount >= 1);
+		CHECK(queue.Post([]() {}));
+	}
+
+	// a drain stops once the budget is used up and leaves the other tasks queued in their order
+	void TestBudget()
+	{
+		const unsigned int TASK_COUNT = 20;
+		TaskQueue queue;
+		std::vector<unsigned int> order;
+		for (unsigned int i = 0; i < TASK_COUNT; i++) {
+			queue.Post([&order, i]() {
+				order.push_back(i);
+				const auto endTime = std::chrono::steady_clock::now() + std::chrono::microseconds(500);
+				while (std::chrono::steady_clock::now() < endTime);
+			});
+		}
+
+		// the budget is checked after each task, so at least one runs
+		const unsigned int firstCount = queue.Drain(1);
+		CHECK(1 == firstCount);
+		const unsigned int secondCount = queue.Drain(2000);
+		CHECK(secondCount >= 1 && secondCount < TASK_COUNT - 1);
+		CHECK(queue.HasPendingTask());
+		CHECK(!queue.Post([]() {}));
+
+		const unsigned int restCount = queue.Drain();
+		CHECK(TASK_COUNT + 1 == firstCount + secondCount + restCount);
+		CHECK(TASK_COUNT == order.size());
+		for (unsigned int i = 0; i < order.size(); i++) {
+			CHECK(i == order[i]);
+		}
+		CHECK(!queue.HasPendingTask());
+	}
+
+	// a move-only task is destroyed once after it has run, and once without running if the queue goes away first
+	void TestMoveOnlyTasks()
+	{
+		unsigned int destroyedCount = 0;
+		unsigned int runCount = 0;
+		{
+			TaskQueue queue;
+			for (unsigned int i = 0; i < 10; i++) {
+				std::unique_ptr<TRACKER> p_tracker(new TRACKER{ &destroyedCount });
+				queue.Post([p_tracker = std::move(p_tracker), &runCount]() {
+					if (p_tracker) {
+						runCount++;
+					}
+				});
+			}
+			// the tasks have been moved into the queue, none is destroyed yet
+			CHECK(0 == destroyedCount);
+
+			CHECK(10 == queue.Drain());
+			CHECK(10 == runCount && 10 == destroyedCount);
+
+			for (unsigned int i = 0; i < 5; i++) {
+				std::unique_ptr<TRACKER> p_tracker(new TRACKER{ &destroyedCount });
+				queue.Post([p_tracker = std::move(p_tracker), &runCount]() { runCount++; });
+			}
+			CHECK(10 == destroyedCount);
+		}
+		CHECK(10 == runCount);
+		CHECK(15 == destroyedCount);
+	}
+}
+
+int main()
+{
+	TestEmptyTransition();
+	TestProducers();
+	TestBudget();
+	TestMoveOnlyTasks();
+	return GetCheckResult();
+}
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include "Check.h"
+#include "TaskScheduler.h"
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// the event which `ResumeContext` signals when a coroutine is posted to the empty queue of a window
+	class WakeEvent
+	{
+	protected:
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		bool m_isSet;
+
+	public:
+		WakeEvent()
+		{
+			m_isSet = false;
+		}
+
+		static void Wake(void *ap_data)
+		{
+			WakeEvent *const p_event = static_cast<WakeEvent *>(ap_data);
+			{
+				std::lock_guard<std::mutex> lock(p_event->m_mutex);
+				p_event->m_isSet = true;
+			}
+			p_event->m_condition.notify_one();
+		}
+
+		void Wait(const std::chrono::steady_clock::time_point &a_deadline)
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait_until(lock, a_deadline, [this]() { return m_isSet; });
+			m_isSet = false;
+		}
+	};
+
+	// the parts of `WindowDialog` which resume its coroutines, without a window. the test thread is the window thread
+	class TaskWindow
+	{
+	public:
+		TaskQueue m_taskQueue;
+		WakeEvent m_wakeEvent;
+		std::shared_ptr<ResumeContext> mp_resumeContext;
+
+		TaskWindow()
+		{
+			mp_resumeContext = std::make_shared<ResumeContext>(&m_taskQueue, &WakeEvent::Wake, &m_wakeEvent);
+		}
+
+		~TaskWindow()
+		{
+			// the pending coroutines are destroyed with the queue
+			mp_resumeContext->Close();
+		}
+
+		CONTEXT_AWAITER SwitchToWindow()
+		{
+			return CONTEXT_AWAITER({ mp_resumeContext });
+		}
+
+		// drains the queue whenever it is woken until the condition holds, at most a few seconds
+		template<class Condition>
+		void RunUntil(Condition a_condition)
+		{
+			const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+			while (!a_condition() && std::chrono::steady_clock::now() < deadline) {
+				m_wakeEvent.Wait(deadline);
+				m_taskQueue.Drain();
+			}
+		}
+	};
+
+	struct SWITCH_RESULT
+	{
+		std::thread::id startThread;
+		std::thread::id workerThread;
+		std::thread::id endThread;
+		bool isDone;
+	};
+
+	// counts the coroutines which have been destroyed, resumed or not
+	struct FRAME_GUARD
+	{
+		std::atomic<unsigned int> *p_count;
+
+		~FRAME_GUARD()
+		{
+			(*p_count)++;
+		}
+	};
+
+	AsyncTask SwitchThreads(TaskScheduler *const ap_scheduler, TaskWindow *const ap_window, SWITCH_RESULT *const ap_result)
+	{
+		ap_result->startThread = std::this_thread::get_id();
+		co_await WORKER_AWAITER({ ap_scheduler });
+		ap_result->workerThread = std::this_thread::get_id();
+		co_await ap_window->SwitchToWindow();
+		ap_result->endThread = std::this_thread::get_id();
+		ap_result->isDone = true;
+	}
+
+	AsyncTask WaitForWindow(TaskWindow *const ap_window, std::atomic<unsigned int> *const ap_destroyedCount, bool *const ap_isResumed)
+	{
+		FRAME_GUARD guard = { ap_destroyedCount };
+		co_await ap_window->SwitchToWindow();
+		*ap_isResumed = true;
+	}
+
+	// the awaiter is taken while the window exists. the coroutine waits on a worker thread until the window is gone
+	AsyncTask LoadInBackground(
+		TaskScheduler *const ap_scheduler, const CONTEXT_AWAITER a_toWindow, std::shared_future<void> a_gate,
+		std::atomic<unsigned int> *const ap_destroyedCount, bool *const ap_isResumed
+	)
+	{
+		FRAME_GUARD guard = { ap_destroyedCount };
+		co_await WORKER_AWAITER({ ap_scheduler });
+		a_gate.wait();
+		co_await a_toWindow;
+		*ap_isResumed = true;
+	}
+
+	// a coroutine continues on a worker thread and comes back to the window thread through the queue
+	void TestSwitch()
+	{
+		const unsigned int COROUTINE_COUNT = 64;
+		TaskScheduler scheduler(2);
+		TaskWindow window;
+		std::vector<SWITCH_RESULT> results(COROUTINE_COUNT, SWITCH_RESULT());
+
+		for (SWITCH_RESULT &result : results) {
+			SwitchThreads(&scheduler, &window, &result);
+		}
+		window.RunUntil([&results]() {
+			for (const SWITCH_RESULT &result : results) {
+				if (!result.isDone) {
+					return false;
+				}
+			}
+			return true;
+		});
+
+		const std::thread::id mainThread = std::this_thread::get_id();
+		for (const SWITCH_RESULT &result : results) {
+			CHECK(result.isDone);
+			CHECK(mainThread == result.startThread);
+			CHECK(mainThread != result.workerThread);
+			CHECK(mainThread == result.endThread);
+		}
+		CHECK(COROUTINE_COUNT == window.m_taskQueue.GetRunCount());
+		CHECK(!window.m_taskQueue.HasPendingTask());
+	}
+
+	// after `Close` the queued coroutines are destroyed instead of resumed, and so are those which are posted later
+	// and those which are left in the queue when the window goes away
+	void TestClose()
+	{
+		std::atomic<unsigned int> destroyedCount = 0;
+		bool isResumed = false;
+		{
+			TaskWindow window;
+			for (unsigned int i = 0; i < 8; i++) {
+				WaitForWindow(&window, &destroyedCount, &isResumed);
+			}
+			CHECK(window.m_taskQueue.HasPendingTask());
+			CHECK(0 == destroyedCount);
+
+			window.mp_resumeContext->Close();
+			CHECK(window.mp_resumeContext->IsClosed());
+			CHECK(8 == window.m_taskQueue.Drain());
+			CHECK(8 == destroyedCount);
+
+			WaitForWindow(&window, &destroyedCount, &isResumed);
+			CHECK(9 == destroyedCount);
+			CHECK(!window.m_taskQueue.HasPendingTask());
+		}
+		{
+			TaskWindow window;
+			WaitForWindow(&window, &destroyedCount, &isResumed);
+			CHECK(9 == destroyedCount);
+		}
+		CHECK(10 == destroyedCount);
+		CHECK(!isResumed);
+	}
+
+	// a coroutine which awaits the window after the window has been destroyed is destroyed on the worker thread.
+	// its awaiter keeps the context alive, so neither the queue nor the event of the window is touched
+	void TestAwaiterOutlivesWindow()
+	{
+		std::atomic<unsigned int> destroyedCount = 0;
+		bool isResumed = false;
+		std::promise<void> gate;
+		std::unique_ptr<TaskScheduler> p_scheduler = std::make_unique<TaskScheduler>(1);
+		std::unique_ptr<TaskWindow> p_window = std::make_unique<TaskWindow>();
+		const std::weak_ptr<ResumeContext> p_context = p_window->mp_resumeContext;
+
+		LoadInBackground(p_scheduler.get(), p_window->SwitchToWindow(), gate.get_future().share(), &destroyedCount, &isResumed);
+		p_window.reset();
+		CHECK(!p_context.expired());
+		gate.set_value();
+		// the worker finishes the coroutine before it stops
+		p_scheduler.reset();
+
+		CHECK(1 == destroyedCount);
+		CHECK(!isResumed);
+		CHECK(p_context.expired());
+	}
+}
+
+int main()
+{
+	TestSwitch();
+	TestClose();
+	TestAwaiterOutlivesWindow();
+	return GetCheckResult();
+}
\ No newline at end of file
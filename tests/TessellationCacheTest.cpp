@@ -0,0 +1,121 @@
+#include "Check.h"
+#include "TessellationCache.h"
+#include <cmath>
+
+namespace
+{
+	// a filled square of 80 x 80 with a hollow bezier arc
+	VECTOR_PATH MakePath()
+	{
+		VECTOR_PATH path;
+		path.commands = {
+			PATH_BEGIN_FILLED, PATH_LINE, PATH_LINE, PATH_LINE, PATH_END_CLOSED,
+			PATH_BEGIN_HOLLOW, PATH_BEZIER, PATH_END_OPEN
+		};
+		path.points = {
+			{ 10.0f, 10.0f }, { 90.0f, 10.0f }, { 90.0f, 90.0f }, { 10.0f, 90.0f },
+			{ 0.0f, 100.0f }, { 30.0f, 60.0f }, { 70.0f, 60.0f }, { 100.0f, 100.0f }
+		};
+		return path;
+	}
+
+	float GetTriangleArea(const std::vector<RPoint> &a_triangles)
+	{
+		float area = 0.0f;
+		for (size_t i = 0; i + 2 < a_triangles.size(); i += 3) {
+			const RPoint &a = a_triangles[i];
+			const RPoint &b = a_triangles[i + 1];
+			const RPoint &c = a_triangles[i + 2];
+			area += std::abs((b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y)) * 0.5f;
+		}
+		return area;
+	}
+
+	void TestPaths()
+	{
+		TessellationCache cache;
+		const unsigned long long pathID = cache.AddPath(MakePath());
+		const unsigned long long otherPathID = cache.AddPath(MakePath());
+		CHECK(0 != pathID && 0 != otherPathID && pathID != otherPathID);
+		const VECTOR_PATH *const p_path = cache.GetPath(pathID);
+		CHECK(nullptr != p_path && MakePath().commands == p_path->commands && MakePath().points.size() == p_path->points.size());
+
+		RRect bounds = {};
+		CHECK(cache.GetBounds(pathID, bounds));
+		CHECK(0.0f == bounds.left && 10.0f == bounds.top && 100.0f == bounds.right && 100.0f == bounds.bottom);
+
+		cache.RemovePath(otherPathID);
+		CHECK(nullptr == cache.GetPath(otherPathID));
+		CHECK(!cache.GetBounds(otherPathID, bounds));
+		CHECK(nullptr == cache.Get(otherPathID, 1.0f));
+		CHECK(nullptr == cache.Get(0, 1.0f));
+	}
+
+	void TestTessellation()
+	{
+		TessellationCache cache(16, 0.25f);
+		const unsigned long long pathID = cache.AddPath(MakePath());
+
+		const PATH_TESSELLATION *p_entry = cache.Get(pathID, 1.0f);
+		CHECK(nullptr != p_entry);
+		CHECK(pathID == p_entry->pathID && 0 == p_entry->scaleBucket);
+		CHECK(1 == p_entry->filledContourCount && 2 == p_entry->contourSizes.size());
+		CHECK(p_entry->contourSizes[0] == p_entry->filledPointCount);
+		// the triangles are created only when they are asked for
+		CHECK(!p_entry->isTriangulated && p_entry->triangles.empty());
+
+		p_entry = cache.Get(pathID, 1.0f, true);
+		CHECK(p_entry->isTriangulated);
+		CHECK(0 == p_entry->triangles.size() % 3);
+		CHECK(std::abs(GetTriangleArea(p_entry->triangles) - 6400.0f) < 0.5f);
+
+		// every scale of a bucket keeps the tolerance in pixels, a larger scale flattens the arc finer
+		for (const float scale : { 0.5f, 0.9f, 1.0f, 1.09f, 3.0f, 16.0f }) {
+			p_entry = cache.Get(pathID, scale);
+			CHECK(p_entry->tolerance * scale <= 0.25f * 1.0001f);
+		}
+		const size_t coarseCount = cache.Get(pathID, 1.0f)->points.size();
+		CHECK(cache.Get(pathID, 16.0f)->points.size() > coarseCount);
+	}
+
+	void TestBuckets()
+	{
+		TessellationCache cache(2);
+		const unsigned long long pathID = cache.AddPath(MakePath());
+		const unsigned long long otherPathID = cache.AddPath(MakePath());
+
+		// a bucket covers a quarter of an octave
+		cache.Get(pathID, 1.0f);
+		cache.Get(pathID, 1.05f);
+		cache.Get(pathID, 0.95f);
+		CHECK(2 == cache.GetHitCount() && 1 == cache.GetMissCount());
+		cache.Get(pathID, 1.25f);
+		CHECK(2 == cache.GetMissCount() && 2 == cache.GetCount());
+
+		// the least recently used entry is removed
+		cache.Get(pathID, 1.0f);
+		cache.Get(otherPathID, 1.0f);
+		CHECK(2 == cache.GetCount());
+		cache.Get(pathID, 1.0f);
+		CHECK(4 == cache.GetHitCount());
+		cache.Get(pathID, 1.25f);
+		CHECK(4 == cache.GetMissCount());
+
+		cache.RemovePath(otherPathID);
+		CHECK(2 == cache.GetCount());
+		cache.SetCapacity(1);
+		CHECK(1 == cache.GetCount());
+		cache.Clear();
+		CHECK(0 == cache.GetCount());
+		CHECK(nullptr != cache.GetPath(pathID));
+	}
+}
+
+int main()
+{
+	TestPaths();
+	TestTessellation();
+	TestBuckets();
+
+	return GetCheckResult();
+}
\ No newline at end of file
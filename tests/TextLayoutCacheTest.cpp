@@ -0,0 +1,148 @@
+#include "Check.h"
+#include "TextLayoutCache.h"
+#include <set>
+
+namespace
+{
+	// lays out a text as a counter and keeps the layouts which haven't been released
+	class StandInMeasurer : public TextMeasurer
+	{
+	public:
+		std::set<unsigned int *> m_liveLayouts;
+		unsigned int m_createCount = 0;
+		unsigned int m_releaseCount = 0;
+		bool m_isFailing = false;
+
+		~StandInMeasurer()
+		{
+			for (unsigned int *p_layout : m_liveLayouts) {
+				delete p_layout;
+			}
+		}
+
+		void *CreateLayout(
+			const wchar_t *const ap_text, const unsigned int a_length, const DISPLAY_FONT &a_font,
+			const float a_maxWidth, const float a_maxHeight, TEXT_METRICS &a_metrics
+		) override
+		{
+			if (m_isFailing) {
+				return nullptr;
+			}
+
+			m_createCount++;
+			a_metrics = { a_length * a_font.size * 0.5f, a_font.size };
+			unsigned int *const p_layout = new unsigned int(m_createCount);
+			m_liveLayouts.insert(p_layout);
+			return p_layout;
+		}
+
+		void ReleaseLayout(void *const ap_layout) override
+		{
+			m_releaseCount++;
+			unsigned int *const p_layout = static_cast<unsigned int *>(ap_layout);
+			CHECK(1 == m_liveLayouts.erase(p_layout));
+			delete p_layout;
+		}
+	};
+
+	const DISPLAY_FONT FONT = { L"Segoe UI", 12.0f, 400, 0, 0, 0, 5, L"en-us" };
+
+	const TEXT_LAYOUT_ENTRY *const Get(TextLayoutCache &a_cache, const wchar_t *const ap_text, const float a_maxWidth = 100.0f)
+	{
+		return a_cache.Get(ap_text, static_cast<unsigned int>(std::char_traits<wchar_t>::length(ap_text)), FONT, a_maxWidth, 20.0f);
+	}
+
+	void TestHitAndMiss()
+	{
+		StandInMeasurer measurer;
+		TextLayoutCache cache(&measurer);
+
+		const TEXT_LAYOUT_ENTRY *const p_entry = Get(cache, L"hello");
+		CHECK(p_entry && L"hello" == p_entry->text);
+		CHECK(p_entry && 30.0f == p_entry->metrics.width && 12.0f == p_entry->metrics.height);
+		void *const p_layout = p_entry ? p_entry->p_layout : nullptr;
+
+		// the same text and font find the same layout without the measurer
+		const TEXT_LAYOUT_ENTRY *const p_hitEntry = Get(cache, L"hello");
+		CHECK(p_hitEntry && p_hitEntry->p_layout == p_layout);
+		CHECK(1 == measurer.m_createCount);
+		CHECK(1 == cache.GetHitCount() && 1 == cache.GetMissCount());
+
+		// every property of the key makes a different layout
+		Get(cache, L"hello", 50.0f);
+		Get(cache, L"hell");
+		DISPLAY_FONT boldFont = FONT;
+		boldFont.weight = 700;
+		cache.Get(L"hello", 5, boldFont, 100.0f, 20.0f);
+		CHECK(4 == measurer.m_createCount);
+		CHECK(4 == cache.GetCount() && 4 == cache.GetMissCount());
+
+		// a failed layout isn't cached
+		measurer.m_isFailing = true;
+		CHECK(nullptr == Get(cache, L"failed"));
+		CHECK(4 == cache.GetCount());
+	}
+
+	void TestLeastRecentlyUsedEviction()
+	{
+		StandInMeasurer measurer;
+		TextLayoutCache cache(&measurer, 3);
+
+		Get(cache, L"a");
+		Get(cache, L"b");
+		Get(cache, L"c");
+		// "a" becomes the most recently used one, so "b" is evicted by "d"
+		Get(cache, L"a");
+		Get(cache, L"d");
+		CHECK(3 == cache.GetCount());
+		CHECK(1 == measurer.m_releaseCount);
+		CHECK(3 == measurer.m_liveLayouts.size());
+
+		const unsigned int missCount = cache.GetMissCount();
+		Get(cache, L"a");
+		Get(cache, L"c");
+		Get(cache, L"d");
+		CHECK(missCount == cache.GetMissCount());
+		Get(cache, L"b");
+		CHECK(missCount + 1 == cache.GetMissCount());
+
+		// a smaller capacity releases the least recently used layouts at once
+		cache.SetCapacity(1);
+		CHECK(1 == cache.GetCount());
+		CHECK(1 == measurer.m_liveLayouts.size());
+		CHECK(4 == measurer.m_releaseCount);
+	}
+
+	void TestRelease()
+	{
+		StandInMeasurer measurer;
+		{
+			TextLayoutCache cache(&measurer, 2);
+			for (int i = 0; i < 10; i++) {
+				const wchar_t text[2] = { static_cast<wchar_t>(L'a' + i), 0 };
+				Get(cache, text);
+			}
+			CHECK(8 == measurer.m_releaseCount);
+
+			cache.Clear();
+			CHECK(0 == cache.GetCount());
+			CHECK(measurer.m_liveLayouts.empty());
+			CHECK(measurer.m_createCount == measurer.m_releaseCount);
+
+			// the cache works after it has been cleared and releases the rest when it is destroyed
+			Get(cache, L"a");
+			Get(cache, L"b");
+		}
+		CHECK(measurer.m_liveLayouts.empty());
+		CHECK(12 == measurer.m_createCount && 12 == measurer.m_releaseCount);
+	}
+}
+
+int main()
+{
+	TestHitAndMiss();
+	TestLeastRecentlyUsedEviction();
+	TestRelease();
+
+	return GetCheckResult();
+}
\ No newline at end of file
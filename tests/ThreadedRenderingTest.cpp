@@ -0,0 +1,96 @@
+#include "Check.h"
+#include "WindowDialog.h"
+#include <random>
+
+namespace
+{
+	// records a frame which changes with every paint, so the render thread redraws a part of it each time
+	class RenderDialog : public WindowDialog
+	{
+	public:
+		unsigned int m_paintCount;
+
+		RenderDialog() :
+			WindowDialog(L"ThreadedRenderingTest")
+		{
+			m_paintCount = 0;
+			m_showType = SW_SHOWNOACTIVATE;
+			m_style = WS_POPUP;
+			// every published frame waits until the render thread has taken the previous one
+			EnableThreadedRendering(true, false);
+		}
+
+		HWND GetWindow()
+		{
+			return mh_window;
+		}
+
+		const unsigned long long GetPublishedCount()
+		{
+			return m_frameExchange.GetPublishedCount();
+		}
+
+	protected:
+		void OnPaint() override
+		{
+			m_paintCount++;
+			mp_direct2d->SetBackgroundColor({ 1.0f, 1.0f, 1.0f, 1.0f });
+			mp_direct2d->Clear();
+			for (unsigned int i = 0; i < 64; i++) {
+				const float left = static_cast<float>((i % 8) * 40);
+				const float top = static_cast<float>((i / 8) * 30);
+				const unsigned int shade = (i + m_paintCount) % 16;
+				mp_direct2d->SetBrushColor({ shade / 15.0f, 0.5f, 1.0f - shade / 15.0f, 1.0f });
+				mp_direct2d->FillRectangle(DRect({ left, top, left + 36.0f, top + 26.0f }));
+			}
+
+			mp_direct2d->PushClipRect(DRect({ 10.0f, 10.0f, 200.0f, 150.0f }));
+			mp_direct2d->SetStrokeWidth(1.0f + m_paintCount % 4);
+			mp_direct2d->DrawEllipse(DRect({ 0.0f, 0.0f, 40.0f + m_paintCount % 160, 120.0f }));
+			mp_direct2d->PopClipRect();
+		}
+	};
+}
+
+// paints and resizes the window while the render thread draws the frames. the render thread keeps the regions of its frames
+// to itself, so a window which has been painted on its own thread stays valid
+int main()
+{
+	ApplicationCore appCore(::GetModuleHandle(nullptr));
+	if (S_OK != appCore.Create(true)) {
+		printf("the Direct2D factory can't be created\n");
+		return 1;
+	}
+
+	RenderDialog dialog;
+	dialog.RegistWindowClass();
+	CHECK(dialog.InitInstance(400, 300, 0, 0));
+	const HWND h_window = dialog.GetWindow();
+
+	std::mt19937 random(5);
+	for (unsigned int i = 0; i < 2000; i++) {
+		const unsigned int kind = random() % 8;
+		if (kind < 2) {
+			::SetWindowPos(
+				h_window, nullptr, 0, 0, 200 + random() % 400, 150 + random() % 300, SWP_NOMOVE | SWP_NOZORDER | SWP_NOACTIVATE
+			);
+		}
+		else if (kind < 5) {
+			const RECT rect = { static_cast<LONG>(random() % 300), static_cast<LONG>(random() % 200), 400, 300 };
+			::InvalidateRect(h_window, &rect, FALSE);
+		}
+		::SendMessage(h_window, WM_PAINT, 0, 0);
+	}
+
+	// the last frames are taken before the window is checked. without triple buffering a frame is published
+	// only after the previous one has been taken
+	::SendMessage(h_window, WM_PAINT, 0, 0);
+	::SendMessage(h_window, WM_PAINT, 0, 0);
+	::Sleep(200);
+
+	CHECK(dialog.m_paintCount == dialog.GetPublishedCount());
+	CHECK(!::GetUpdateRect(h_window, nullptr, FALSE));
+
+	::DestroyWindow(h_window);
+	return GetCheckResult();
+}
\ No newline at end of file
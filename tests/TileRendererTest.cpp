@@ -0,0 +1,174 @@
+#include "Check.h"
+#include "SoftwareRasterizer.h"
+#include "TaskScheduler.h"
+#include "TileRenderer.h"
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace
+{
+	const int VIEW_WIDTH = 300;
+	const int VIEW_HEIGHT = 200;
+
+	// random shapes, strokes, polygons and clips, some of them rotated and translucent
+	void MakeScene(DisplayList &a_list, const unsigned int a_seed)
+	{
+		std::mt19937 random(a_seed);
+		std::uniform_real_distribution<float> x(-20.0f, VIEW_WIDTH + 20.0f);
+		std::uniform_real_distribution<float> y(-20.0f, VIEW_HEIGHT + 20.0f);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+		a_list.Reset();
+		a_list.AddClear({ 0.1f, 0.1f, 0.1f, 1.0f });
+		int clipDepth = 0;
+		for (unsigned int i = 0; i < 60; i++) {
+			const RColor color = { unit(random), unit(random), unit(random), 0 == random() % 3 ? unit(random) : 1.0f };
+			const float strokeWidth = 0.5f + unit(random) * 6.0f;
+			RMatrix transform = IdentityMatrix();
+			if (0 == random() % 4) {
+				const float angle = unit(random) * 6.28f;
+				const float centerX = x(random);
+				const float centerY = y(random);
+				transform = {
+					std::cos(angle), std::sin(angle), -std::sin(angle), std::cos(angle),
+					centerX - centerX * std::cos(angle) + centerY * std::sin(angle), centerY - centerX * std::sin(angle) - centerY * std::cos(angle)
+				};
+			}
+
+			const float left = x(random);
+			const float top = y(random);
+			const RRect rect = { left, top, left + unit(random) * 120.0f, top + unit(random) * 90.0f };
+			const unsigned int kind = random() % 12;
+			if (kind < 7) {
+				static const DISPLAY_OPCODE SHAPES[] = {
+					DISPLAY_DRAW_LINE, DISPLAY_DRAW_RECTANGLE, DISPLAY_DRAW_ROUNDED_RECTANGLE, DISPLAY_DRAW_ELLIPSE,
+					DISPLAY_FILL_RECTANGLE, DISPLAY_FILL_ROUNDED_RECTANGLE, DISPLAY_FILL_ELLIPSE
+				};
+				a_list.AddShape(SHAPES[kind], rect, 2.0f + unit(random) * 10.0f, color, strokeWidth, transform);
+			}
+			else if (kind < 9) {
+				RPoint points[6];
+				for (RPoint &point : points) {
+					point = { x(random), y(random) };
+				}
+				const unsigned int contourSize = 6;
+				a_list.AddPolygon(7 == kind ? DISPLAY_DRAW_POLYLINE : DISPLAY_FILL_POLYGON, points, &contourSize, 1, color, strokeWidth, transform);
+			}
+			else if (9 == kind) {
+				a_list.AddShape(DISPLAY_PUSH_CLIP, rect, 0.0f, color, 1.0f, transform);
+				clipDepth++;
+			}
+			else if (clipDepth) {
+				a_list.AddShape(DISPLAY_POP_CLIP, {}, 0.0f, color, 1.0f, IdentityMatrix());
+				clipDepth--;
+			}
+		}
+		for (; clipDepth; clipDepth--) {
+			a_list.AddShape(DISPLAY_POP_CLIP, {}, 0.0f, { 0.0f, 0.0f, 0.0f, 0.0f }, 1.0f, IdentityMatrix());
+		}
+	}
+
+	// the largest difference of a channel and the number of different pixels
+	void ComparePixels(
+		const std::vector<unsigned int> &a_pixels, const std::vector<unsigned int> &a_tiledPixels, int &a_maxDifference,
+		unsigned int &a_differentCount
+	)
+	{
+		for (size_t i = 0; i < a_pixels.size(); i++) {
+			if (a_pixels[i] == a_tiledPixels[i]) {
+				continue;
+			}
+
+			a_differentCount++;
+			for (int shift = 0; shift < 32; shift += 8) {
+				const int difference = std::abs(static_cast<int>(a_pixels[i] >> shift & 0xFF) - static_cast<int>(a_tiledPixels[i] >> shift & 0xFF));
+				a_maxDifference = difference > a_maxDifference ? difference : a_maxDifference;
+			}
+		}
+	}
+
+	// the tiles draw the pixels of an untiled replay. the edges which cross a tile border are split there,
+	// so a few pixels of those primitives can differ by 1. a single tile draws exactly the same pixels
+	void TestTiledReplay()
+	{
+		std::vector<unsigned int> pixels(VIEW_WIDTH * VIEW_HEIGHT);
+		std::vector<unsigned int> tiledPixels(VIEW_WIDTH * VIEW_HEIGHT);
+		DisplayList list;
+		int maxDifference = 0;
+		unsigned int differentCount = 0;
+		unsigned int comparedCount = 0;
+
+		for (unsigned int seed = 1; seed <= 100; seed++) {
+			MakeScene(list, seed);
+			SoftwareRasterizer rasterizer(pixels.data(), VIEW_WIDTH, VIEW_HEIGHT, VIEW_WIDTH);
+			list.Replay(&rasterizer);
+
+			for (const int tileSize : { 16, 64, 100 }) {
+				TileRenderer renderer(tileSize);
+				renderer.Render(list, tiledPixels.data(), VIEW_WIDTH, VIEW_HEIGHT, VIEW_WIDTH);
+				ComparePixels(pixels, tiledPixels, maxDifference, differentCount);
+				comparedCount += VIEW_WIDTH * VIEW_HEIGHT;
+			}
+
+			TileRenderer singleRenderer(VIEW_WIDTH);
+			singleRenderer.Render(list, tiledPixels.data(), VIEW_WIDTH, VIEW_HEIGHT, VIEW_WIDTH);
+			CHECK(pixels == tiledPixels);
+		}
+
+		CHECK(maxDifference <= 1);
+		CHECK(differentCount * 1000 < comparedCount);
+	}
+
+	// the threads draw the same tiles as the calling thread alone
+	void TestThreadedReplay()
+	{
+		TaskScheduler scheduler(4);
+		std::vector<unsigned int> pixels(VIEW_WIDTH * VIEW_HEIGHT);
+		std::vector<unsigned int> threadedPixels(VIEW_WIDTH * VIEW_HEIGHT);
+		DisplayList list;
+		TileRenderer renderer(32);
+
+		for (unsigned int seed = 1; seed <= 50; seed++) {
+			MakeScene(list, seed);
+			renderer.Render(list, pixels.data(), VIEW_WIDTH, VIEW_HEIGHT, VIEW_WIDTH);
+			renderer.Render(list, threadedPixels.data(), VIEW_WIDTH, VIEW_HEIGHT, VIEW_WIDTH, &scheduler);
+			CHECK(pixels == threadedPixels);
+		}
+	}
+
+	void TestBinning()
+	{
+		std::vector<unsigned int> pixels(VIEW_WIDTH * VIEW_HEIGHT);
+		DisplayList list;
+		TileRenderer renderer(64);
+		CHECK(64 == renderer.GetTileSize());
+
+		// one rectangle inside a tile and one which crosses four tiles. the clear covers all 5 x 4 tiles
+		list.AddClear({ 0.0f, 0.0f, 0.0f, 1.0f });
+		list.AddShape(DISPLAY_FILL_RECTANGLE, { 10.0f, 10.0f, 20.0f, 20.0f }, 0.0f, { 1.0f, 1.0f, 1.0f, 1.0f }, 1.0f, IdentityMatrix());
+		list.AddShape(DISPLAY_FILL_RECTANGLE, { 100.0f, 100.0f, 150.0f, 150.0f }, 0.0f, { 1.0f, 1.0f, 1.0f, 1.0f }, 1.0f, IdentityMatrix());
+		renderer.Render(list, pixels.data(), VIEW_WIDTH, VIEW_HEIGHT, VIEW_WIDTH);
+		CHECK(20 == renderer.GetTileCount());
+		CHECK(20 + 1 + 4 == renderer.GetBinnedCount());
+
+		// a clip limits the commands inside it to its tiles
+		list.Reset();
+		list.AddShape(DISPLAY_PUSH_CLIP, { 0.0f, 0.0f, 60.0f, 60.0f }, 0.0f, { 0.0f, 0.0f, 0.0f, 0.0f }, 1.0f, IdentityMatrix());
+		list.AddShape(DISPLAY_FILL_RECTANGLE, { 0.0f, 0.0f, 300.0f, 200.0f }, 0.0f, { 1.0f, 1.0f, 1.0f, 1.0f }, 1.0f, IdentityMatrix());
+		list.AddShape(DISPLAY_POP_CLIP, {}, 0.0f, { 0.0f, 0.0f, 0.0f, 0.0f }, 1.0f, IdentityMatrix());
+		renderer.Render(list, pixels.data(), VIEW_WIDTH, VIEW_HEIGHT, VIEW_WIDTH);
+		CHECK(1 == renderer.GetTileCount());
+		CHECK(3 == renderer.GetBinnedCount());
+	}
+}
+
+int main()
+{
+	TestTiledReplay();
+	TestThreadedReplay();
+	TestBinning();
+
+	return GetCheckResult();
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include "Check.h"
+#include "SoftwareRasterizer.h"
+#include "TimeSeriesPyramid.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+	const int VIEW_WIDTH = 256;
+	const int VIEW_HEIGHT = 160;
+
+	// a random walk with spikes, so the minimum and the maximum of a column are anywhere in it
+	std::vector<float> MakeValues(const unsigned int a_count, const unsigned int a_seed)
+	{
+		std::mt19937 random(a_seed);
+		std::normal_distribution<float> step(0.0f, 0.05f);
+		std::vector<float> values(a_count);
+		float value = 0.0f;
+		for (float &sample : values) {
+			value = std::fmax(-1.0f, std::fmin(1.0f, value + step(random)));
+			sample = 0 == random() % 97 ? value + step(random) * 10.0f : value;
+		}
+		return values;
+	}
+
+	// the pixels which the polyline touches at all, as a rasterizer without antialiasing draws them. the points are
+	// moved to the centers of their pixels, so the samples of a column are on the same vertical line
+	std::vector<bool> RasterizePolyline(SoftwareRasterizer &a_rasterizer, std::vector<RPoint> a_points)
+	{
+		for (RPoint &point : a_points) {
+			point = { std::floor(point.x) + 0.5f, std::floor(point.y) + 0.5f };
+		}
+
+		a_rasterizer.BeginDraw();
+		a_rasterizer.Clear({ 0.0f, 0.0f, 0.0f, 0.0f });
+		a_rasterizer.SetColor({ 1.0f, 1.0f, 1.0f, 1.0f });
+		a_rasterizer.SetStrokeWidth(1.0f);
+		const unsigned int size = static_cast<unsigned int>(a_points.size());
+		a_rasterizer.DrawPolyline(a_points.data(), &size, 1);
+		a_rasterizer.EndDraw();
+
+		std::vector<bool> mask(static_cast<size_t>(VIEW_WIDTH) * VIEW_HEIGHT);
+		for (int y = 0; y < VIEW_HEIGHT; y++) {
+			for (int x = 0; x < VIEW_WIDTH; x++) {
+				mask[static_cast<size_t>(y) * VIEW_WIDTH + x] = 0 != a_rasterizer.GetPixels()[y * a_rasterizer.GetStride() + x];
+			}
+		}
+		return mask;
+	}
+
+	// the minimum and the maximum of random ranges are those of the samples in the range
+	void TestFindRange()
+	{
+		std::mt19937 random(3);
+		for (const unsigned int count : { 1u, 2u, 3u, 17u, 64u, 1000u, 65537u }) {
+			const std::vector<float> values = MakeValues(count, count);
+			TimeSeriesPyramid series;
+			series.SetUniformSamples(0.0, 1.0, values.data(), count);
+
+			for (unsigned int i = 0; i < 500; i++) {
+				const unsigned int first = random() % count;
+				const unsigned int last = first + 1 + random() % (count - first);
+				float minValue = values[first];
+				float maxValue = values[first];
+				for (unsigned int index = first; index < last; index++) {
+					minValue = std::fmin(minValue, values[index]);
+					maxValue = std::fmax(maxValue, values[index]);
+				}
+
+				unsigned int minIndex;
+				unsigned int maxIndex;
+				series.FindRange(first, last, minIndex, maxIndex);
+				CHECK(minIndex >= first && minIndex < last && maxIndex >= first && maxIndex < last);
+				CHECK(minValue == values[minIndex]);
+				CHECK(maxValue == values[maxIndex]);
+			}
+		}
+	}
+
+	// the reduced polyline of a view touches the same pixels as the polyline of all its samples. a column of 2^k samples
+	// maps its samples exactly into its pixel column. the views start and end inside the series, so the samples around
+	// them are drawn as well
+	void TestReducedPixels()
+	{
+		SoftwareRasterizer rasterizer(VIEW_WIDTH, VIEW_HEIGHT);
+		const RRect rect = { 0.0f, 0.0f, static_cast<float>(VIEW_WIDTH), static_cast<float>(VIEW_HEIGHT) };
+
+		for (const unsigned int columnSamples : { 2u, 4u, 8u, 64u, 1024u }) {
+			const unsigned int count = (VIEW_WIDTH + 3) * columnSamples;
+			const std::vector<float> values = MakeValues(count, columnSamples);
+			TimeSeriesPyramid series;
+			series.SetUniformSamples(0.0, 1.0, values.data(), count);
+
+			for (const unsigned int startColumn : { 0u, 1u, 3u }) {
+				TIME_SERIES_VIEW view = {};
+				view.firstX = static_cast<double>(startColumn) * columnSamples;
+				view.lastX = view.firstX + static_cast<double>(VIEW_WIDTH) * columnSamples;
+				view.minY = -1.6f;
+				view.maxY = 1.6f;
+				view.rect = rect;
+
+				// a column for every sample keeps all of them
+				std::vector<RPoint> points;
+				view.columnCount = count;
+				series.Reduce(view, points);
+				const std::vector<bool> mask = RasterizePolyline(rasterizer, points);
+
+				view.columnCount = VIEW_WIDTH;
+				series.Reduce(view, points);
+				CHECK(points.size() <= VIEW_WIDTH * 4 + 2);
+				CHECK(mask == RasterizePolyline(rasterizer, points));
+			}
+		}
+	}
+}
+
+int main()
+{
+	TestFindRange();
+	TestReducedPixels();
+	return GetCheckResult();
+}
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include "Check.h"
+#include "VectorPath.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace
+{
+	// the non-zero winding number of a point by the crossings of a ray to the right
+	int GetWinding(
+		const std::vector<RPoint> &a_points, const std::vector<unsigned int> &a_contourSizes, const unsigned int a_contourCount,
+		const float a_x, const float a_y
+	)
+	{
+		int winding = 0;
+		const RPoint *p_point = a_points.data();
+		for (unsigned int contour = 0; contour < a_contourCount; contour++) {
+			const unsigned int size = a_contourSizes[contour];
+			for (unsigned int i = 0; i < size; i++) {
+				const RPoint &startPoint = p_point[i];
+				const RPoint &endPoint = p_point[(i + 1) % size];
+				const float side = (endPoint.x - startPoint.x) * (a_y - startPoint.y) - (a_x - startPoint.x) * (endPoint.y - startPoint.y);
+				if (startPoint.y <= a_y && endPoint.y > a_y && side > 0.0f) {
+					winding++;
+				}
+				else if (startPoint.y > a_y && endPoint.y <= a_y && side < 0.0f) {
+					winding--;
+				}
+			}
+			p_point += size;
+		}
+		return winding;
+	}
+
+	// the distance to the nearest edge. the samples right on an edge can go either way.
+	// a closed contour has an edge from its last point to its first one
+	float GetEdgeDistance(
+		const std::vector<RPoint> &a_points, const std::vector<unsigned int> &a_contourSizes, const unsigned int a_contourCount,
+		const float a_x, const float a_y, const bool a_isClosed = true
+	)
+	{
+		float distance = INFINITY;
+		const RPoint *p_point = a_points.data();
+		for (unsigned int contour = 0; contour < a_contourCount; contour++) {
+			const unsigned int size = a_contourSizes[contour];
+			const unsigned int edgeCount = a_isClosed || size < 2 ? size : size - 1;
+			for (unsigned int i = 0; i < edgeCount; i++) {
+				const RPoint &startPoint = p_point[i];
+				const RPoint &endPoint = p_point[(i + 1) % size];
+				const float dx = endPoint.x - startPoint.x;
+				const float dy = endPoint.y - startPoint.y;
+				const float lengthSquare = dx * dx + dy * dy;
+				float t = lengthSquare > 0.0f ? ((a_x - startPoint.x) * dx + (a_y - startPoint.y) * dy) / lengthSquare : 0.0f;
+				t = std::clamp(t, 0.0f, 1.0f);
+				distance = std::min(distance, std::hypot(startPoint.x + t * dx - a_x, startPoint.y + t * dy - a_y));
+			}
+			p_point += size;
+		}
+		return distance;
+	}
+
+	bool IsInTriangles(const std::vector<RPoint> &a_triangles, const float a_x, const float a_y)
+	{
+		auto getSide = [a_x, a_y](const RPoint &a_startPoint, const RPoint &a_endPoint) {
+			return (a_endPoint.x - a_startPoint.x) * (a_y - a_startPoint.y) - (a_x - a_startPoint.x) * (a_endPoint.y - a_startPoint.y);
+		};
+		for (size_t i = 0; i + 2 < a_triangles.size(); i += 3) {
+			const float sides[] = {
+				getSide(a_triangles[i], a_triangles[i + 1]), getSide(a_triangles[i + 1], a_triangles[i + 2]), getSide(a_triangles[i + 2], a_triangles[i])
+			};
+			const bool hasNegative = sides[0] < 0.0f || sides[1] < 0.0f || sides[2] < 0.0f;
+			const bool hasPositive = sides[0] > 0.0f || sides[1] > 0.0f || sides[2] > 0.0f;
+			if (!(hasNegative && hasPositive)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool IsInSpans(const std::vector<PATH_SPAN> &a_spans, const float a_x, const float a_y)
+	{
+		for (const PATH_SPAN &span : a_spans) {
+			if (span.y == a_y && a_x >= span.left && a_x < span.right) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// the triangles and the spans of the filled contours cover the points of a non-zero winding number on a grid of 100 x 100
+	unsigned int CountWindingErrors(
+		const std::vector<RPoint> &a_points, const std::vector<unsigned int> &a_contourSizes, const unsigned int a_contourCount
+	)
+	{
+		std::vector<RPoint> triangles;
+		std::vector<PATH_SPAN> spans;
+		TessellatePolygon(a_points.data(), a_contourSizes.data(), a_contourCount, triangles);
+		TessellateSpans(a_points.data(), a_contourSizes.data(), a_contourCount, 1.0f, spans);
+
+		unsigned int errorCount = 0;
+		for (int row = 0; row < 100; row++) {
+			for (int column = 0; column < 100; column++) {
+				const float x = column + 0.37f;
+				const float y = row + 0.5f;
+				if (GetEdgeDistance(a_points, a_contourSizes, a_contourCount, x, y) < 1e-3f) {
+					continue;
+				}
+
+				const bool isInside = 0 != GetWinding(a_points, a_contourSizes, a_contourCount, x, y);
+				if (isInside != IsInTriangles(triangles, x, y) || isInside != IsInSpans(spans, x, y)) {
+					errorCount++;
+				}
+			}
+		}
+		return errorCount;
+	}
+
+	VECTOR_PATH MakeSquares(const bool a_isHoleReversed)
+	{
+		VECTOR_PATH path;
+		path.commands = {
+			PATH_BEGIN_FILLED, PATH_LINE, PATH_LINE, PATH_LINE, PATH_END_CLOSED,
+			PATH_BEGIN_FILLED, PATH_LINE, PATH_LINE, PATH_LINE, PATH_END_CLOSED
+		};
+		path.points = { { 10.0f, 10.0f }, { 90.0f, 10.0f }, { 90.0f, 90.0f }, { 10.0f, 90.0f } };
+		if (a_isHoleReversed) {
+			path.points.insert(path.points.end(), { { 30.0f, 30.0f }, { 30.0f, 70.0f }, { 70.0f, 70.0f }, { 70.0f, 30.0f } });
+		}
+		else {
+			path.points.insert(path.points.end(), { { 30.0f, 30.0f }, { 70.0f, 30.0f }, { 70.0f, 70.0f }, { 30.0f, 70.0f } });
+		}
+		return path;
+	}
+
+	void TestWinding()
+	{
+		std::vector<RPoint> points;
+		std::vector<unsigned int> contourSizes;
+		unsigned int filledContourCount = 0;
+
+		// a reversed inner square is a hole, one in the same direction fills the center twice
+		for (const bool isHoleReversed : { true, false }) {
+			FlattenPath(MakeSquares(isHoleReversed), 0.25f, points, contourSizes, filledContourCount);
+			CHECK(2 == filledContourCount);
+			CHECK(0 == CountWindingErrors(points, contourSizes, filledContourCount));
+
+			std::vector<PATH_SPAN> spans;
+			TessellateSpans(points.data(), contourSizes.data(), filledContourCount, 1.0f, spans);
+			CHECK(isHoleReversed != IsInSpans(spans, 50.0f, 50.5f));
+			CHECK(IsInSpans(spans, 20.0f, 50.5f));
+		}
+
+		// the center of a pentagram is wound twice
+		VECTOR_PATH star;
+		star.commands = { PATH_BEGIN_FILLED, PATH_LINE, PATH_LINE, PATH_LINE, PATH_LINE, PATH_END_CLOSED };
+		for (int i = 0; i < 5; i++) {
+			const float angle = i * 4.0f * 3.14159265f / 5.0f;
+			star.points.push_back({ 50.0f + 45.0f * std::sin(angle), 50.0f - 45.0f * std::cos(angle) });
+		}
+		FlattenPath(star, 0.25f, points, contourSizes, filledContourCount);
+		CHECK(2 == std::abs(GetWinding(points, contourSizes, filledContourCount, 50.0f, 50.0f)));
+		CHECK(0 == CountWindingErrors(points, contourSizes, filledContourCount));
+	}
+
+	// random figures of lines and curves: the bounds are tight, the polyline keeps the tolerance
+	// and the tessellation covers the same points as the winding rule
+	void TestRandomPaths()
+	{
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> coordinate(0.0f, 100.0f);
+		float maxBoundsError = 0.0f;
+		float maxFlattenError = 0.0f;
+		unsigned int windingErrorCount = 0;
+
+		for (unsigned int run = 0; run < 100; run++) {
+			VECTOR_PATH path;
+			const unsigned int figureCount = 1 + random() % 3;
+			for (unsigned int figure = 0; figure < figureCount; figure++) {
+				path.commands.push_back(random() % 5 ? PATH_BEGIN_FILLED : PATH_BEGIN_HOLLOW);
+				path.points.push_back({ coordinate(random), coordinate(random) });
+				const unsigned int segmentCount = 1 + random() % 5;
+				for (unsigned int segment = 0; segment < segmentCount; segment++) {
+					static const PATH_COMMAND COMMANDS[] = { PATH_LINE, PATH_QUADRATIC, PATH_BEZIER };
+					static const unsigned int POINT_COUNTS[] = { 1, 2, 3 };
+					const unsigned int kind = random() % 3;
+					path.commands.push_back(COMMANDS[kind]);
+					for (unsigned int i = 0; i < POINT_COUNTS[kind]; i++) {
+						path.points.push_back({ coordinate(random), coordinate(random) });
+					}
+				}
+				path.commands.push_back(random() % 2 ? PATH_END_CLOSED : PATH_END_OPEN);
+			}
+
+			std::vector<RPoint> finePoints;
+			std::vector<unsigned int> fineContourSizes;
+			unsigned int fineFilledCount = 0;
+			FlattenPath(path, 0.001f, finePoints, fineContourSizes, fineFilledCount);
+
+			const RRect bounds = GetPathBounds(path);
+			RRect fineBounds = { INFINITY, INFINITY, -INFINITY, -INFINITY };
+			for (const RPoint &point : finePoints) {
+				fineBounds = {
+					std::min(fineBounds.left, point.x), std::min(fineBounds.top, point.y),
+					std::max(fineBounds.right, point.x), std::max(fineBounds.bottom, point.y)
+				};
+			}
+			maxBoundsError = std::max({
+				maxBoundsError, std::abs(bounds.left - fineBounds.left), std::abs(bounds.top - fineBounds.top),
+				std::abs(bounds.right - fineBounds.right), std::abs(bounds.bottom - fineBounds.bottom)
+			});
+
+			std::vector<RPoint> points;
+			std::vector<unsigned int> contourSizes;
+			unsigned int filledContourCount = 0;
+			FlattenPath(path, 0.25f, points, contourSizes, filledContourCount);
+			// the closed figures repeat their first point, so the contours are measured as open polylines
+			const unsigned int contourCount = static_cast<unsigned int>(contourSizes.size());
+			for (const RPoint &point : finePoints) {
+				maxFlattenError = std::max(maxFlattenError, GetEdgeDistance(points, contourSizes, contourCount, point.x, point.y, false));
+			}
+			windingErrorCount += CountWindingErrors(points, contourSizes, filledContourCount);
+		}
+
+		CHECK(maxBoundsError < 0.01f);
+		CHECK(maxFlattenError < 0.25f + 0.01f);
+		CHECK(0 == windingErrorCount);
+	}
+}
+
+int main()
+{
+	TestWinding();
+	TestRandomPaths();
+
+	return GetCheckResult();
+}
\ No newline at end of file
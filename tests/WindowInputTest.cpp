@@ -0,0 +1,173 @@
+#include "Check.h"
+#include "WindowDialog.h"
+#include <random>
+#include <vector>
+
+namespace
+{
+	struct HANDLED_MESSAGE
+	{
+		UINT messageID;
+		WPARAM wordParam;
+		LPARAM longParam;
+
+		bool operator==(const HANDLED_MESSAGE &a_message) const
+		{
+			return messageID == a_message.messageID && wordParam == a_message.wordParam && longParam == a_message.longParam;
+		}
+	};
+
+	// records the messages which reach its handlers. the horizontal wheel and the right button up have no handler
+	class InputDialog : public WindowDialog
+	{
+	public:
+		std::vector<HANDLED_MESSAGE> m_handledMessages;
+
+		InputDialog() :
+			WindowDialog(L"WindowInputTest")
+		{
+			m_showType = SW_HIDE;
+			m_style = WS_POPUP;
+			AddMessageHandler(WM_MOUSEMOVE, static_cast<MessageHandler>(&InputDialog::MoveHandler));
+			AddMessageHandler(WM_MOUSEWHEEL, static_cast<MessageHandler>(&InputDialog::WheelHandler));
+			AddMessageHandler(WM_LBUTTONDOWN, static_cast<MessageHandler>(&InputDialog::ButtonDownHandler));
+			AddMessageHandler(WM_LBUTTONUP, static_cast<MessageHandler>(&InputDialog::ButtonUpHandler));
+			AddMessageHandler(WM_KEYDOWN, static_cast<MessageHandler>(&InputDialog::KeyDownHandler));
+			AddMessageHandler(WM_CONTEXTMENU, static_cast<MessageHandler>(&InputDialog::ContextMenuHandler));
+			AddMessageHandler(WM_USER, static_cast<MessageHandler>(&InputDialog::UserHandler));
+		}
+
+		HWND GetWindow()
+		{
+			return mh_window;
+		}
+
+		msg_handler int MoveHandler(WPARAM a_wordParam, LPARAM a_longParam) { return Record(WM_MOUSEMOVE, a_wordParam, a_longParam); }
+		msg_handler int WheelHandler(WPARAM a_wordParam, LPARAM a_longParam) { return Record(WM_MOUSEWHEEL, a_wordParam, a_longParam); }
+		msg_handler int ButtonDownHandler(WPARAM a_wordParam, LPARAM a_longParam) { return Record(WM_LBUTTONDOWN, a_wordParam, a_longParam); }
+		msg_handler int ButtonUpHandler(WPARAM a_wordParam, LPARAM a_longParam) { return Record(WM_LBUTTONUP, a_wordParam, a_longParam); }
+		msg_handler int KeyDownHandler(WPARAM a_wordParam, LPARAM a_longParam) { return Record(WM_KEYDOWN, a_wordParam, a_longParam); }
+		msg_handler int ContextMenuHandler(WPARAM a_wordParam, LPARAM a_longParam) { return Record(WM_CONTEXTMENU, a_wordParam, a_longParam); }
+		msg_handler int UserHandler(WPARAM a_wordParam, LPARAM a_longParam) { return Record(WM_USER, a_wordParam, a_longParam); }
+
+	protected:
+		int Record(const UINT a_messageID, const WPARAM a_wordParam, const LPARAM a_longParam)
+		{
+			m_handledMessages.push_back(HANDLED_MESSAGE({ a_messageID, a_wordParam, a_longParam }));
+			return S_OK;
+		}
+	};
+
+	// the messages which the window should hand to its handlers. the moves and the wheels of the same key state
+	// are coalesced until a handled message of another kind comes
+	class ExpectedInput
+	{
+	public:
+		std::vector<HANDLED_MESSAGE> m_messages;
+		std::vector<HANDLED_MESSAGE> m_pendingMessages;
+		std::vector<int> m_pendingDeltas;
+
+		void Queue(const UINT a_messageID, const WPARAM a_wordParam, const LPARAM a_longParam)
+		{
+			const int delta = WM_MOUSEWHEEL == a_messageID ? GET_WHEEL_DELTA_WPARAM(a_wordParam) : 0;
+			const WPARAM keyState = WM_MOUSEWHEEL == a_messageID ? GET_KEYSTATE_WPARAM(a_wordParam) : a_wordParam;
+			if (!m_pendingMessages.empty()) {
+				HANDLED_MESSAGE &lastMessage = m_pendingMessages.back();
+				const WPARAM lastKeyState = WM_MOUSEWHEEL == lastMessage.messageID ? GET_KEYSTATE_WPARAM(lastMessage.wordParam) : lastMessage.wordParam;
+				if (lastMessage.messageID == a_messageID && lastKeyState == keyState) {
+					m_pendingDeltas.back() += delta;
+					lastMessage.wordParam = WM_MOUSEWHEEL == a_messageID ? MAKEWPARAM(keyState, m_pendingDeltas.back()) : a_wordParam;
+					lastMessage.longParam = a_longParam;
+					return;
+				}
+			}
+			m_pendingMessages.push_back(HANDLED_MESSAGE({ a_messageID, a_wordParam, a_longParam }));
+			m_pendingDeltas.push_back(delta);
+		}
+
+		void Handle(const UINT a_messageID, const WPARAM a_wordParam, const LPARAM a_longParam)
+		{
+			m_messages.insert(m_messages.end(), m_pendingMessages.begin(), m_pendingMessages.end());
+			m_pendingMessages.clear();
+			m_pendingDeltas.clear();
+			m_messages.push_back(HANDLED_MESSAGE({ a_messageID, a_wordParam, a_longParam }));
+		}
+	};
+
+	// sends random input and checks that the handled messages keep their order and nothing is lost
+	void TestRandomInput(InputDialog &a_dialog, const unsigned int a_seed)
+	{
+		const HWND h_window = a_dialog.GetWindow();
+		std::mt19937 random(a_seed);
+		ExpectedInput expectedInput;
+		a_dialog.m_handledMessages.clear();
+
+		for (unsigned int i = 0; i < 500; i++) {
+			const unsigned int kind = random() % 16;
+			const LPARAM position = MAKELPARAM(random() % 400, random() % 300);
+			const WPARAM keyState = 0 == random() % 6 ? MK_SHIFT : 0;
+
+			if (kind < 7) {
+				::SendMessage(h_window, WM_MOUSEMOVE, keyState, position);
+				expectedInput.Queue(WM_MOUSEMOVE, keyState, position);
+			}
+			else if (kind < 10) {
+				const WPARAM wordParam = MAKEWPARAM(keyState, (random() % 2 ? 1 : -1) * WHEEL_DELTA);
+				::SendMessage(h_window, WM_MOUSEWHEEL, wordParam, position);
+				expectedInput.Queue(WM_MOUSEWHEEL, wordParam, position);
+			}
+			else if (kind < 11) {
+				// without a handler the wheel goes to the system and isn't queued
+				::SendMessage(h_window, WM_MOUSEHWHEEL, MAKEWPARAM(0, WHEEL_DELTA), position);
+			}
+			else if (kind < 12) {
+				::SendMessage(h_window, WM_LBUTTONDOWN, MK_LBUTTON, position);
+				expectedInput.Handle(WM_LBUTTONDOWN, MK_LBUTTON, position);
+			}
+			else if (kind < 13) {
+				::SendMessage(h_window, WM_LBUTTONUP, 0, position);
+				expectedInput.Handle(WM_LBUTTONUP, 0, position);
+			}
+			else if (kind < 14) {
+				const WPARAM key = 'A' + random() % 26;
+				::SendMessage(h_window, WM_KEYDOWN, key, 1);
+				expectedInput.Handle(WM_KEYDOWN, key, 1);
+			}
+			else {
+				// `DefWindowProc` turns the button without a handler into a context menu message with the screen position
+				::SendMessage(h_window, WM_RBUTTONUP, 0, position);
+				POINT point = { GET_X_LPARAM(position), GET_Y_LPARAM(position) };
+				::ClientToScreen(h_window, &point);
+				expectedInput.Handle(WM_CONTEXTMENU, reinterpret_cast<WPARAM>(h_window), MAKELPARAM(point.x, point.y));
+			}
+		}
+
+		// a handled message delivers the rest of the queue
+		::SendMessage(h_window, WM_USER, 0, 0);
+		expectedInput.Handle(WM_USER, 0, 0);
+
+		CHECK(expectedInput.m_messages.size() == a_dialog.m_handledMessages.size());
+		CHECK(expectedInput.m_messages == a_dialog.m_handledMessages);
+	}
+}
+
+int main()
+{
+	ApplicationCore appCore(::GetModuleHandle(nullptr));
+	if (S_OK != appCore.Create()) {
+		printf("the Direct2D factory can't be created\n");
+		return 1;
+	}
+
+	InputDialog dialog;
+	dialog.RegistWindowClass();
+	CHECK(dialog.InitInstance(400, 300, 0, 0));
+	dialog.EnableInputBatching(true);
+
+	for (unsigned int seed = 1; seed <= 20; seed++) {
+		TestRandomInput(dialog, seed);
+	}
+
+	::DestroyWindow(dialog.GetWindow());
+	return GetCheckResult();
+}
\ No newline at end of file